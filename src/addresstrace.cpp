@@ -0,0 +1,153 @@
+#include "addresstrace.h"
+#include <QtEndian>
+#include <algorithm>
+#include <charconv>
+
+namespace {
+
+const qint64 kReadBlockSize = 4 << 20;
+
+enum LineKind {
+    SKIPPED,    // 空行、注释或表头
+    ACCESS,
+    MALFORMED
+};
+
+bool isSeparator(char c)
+{
+    return c == ' ' || c == '\t' || c == ',' || c == '\r';
+}
+
+LineKind parseLine(const char *begin, const char *end, quint64 &address, quint8 &kind)
+{
+    const char *p = begin;
+    while (p < end && isSeparator(p[0])) ++p;
+    if (p == end || *p == '#' || *p < '0' || *p > '9') return SKIPPED;
+
+    int base = 10;
+    if (end - p > 2 && p[0] == '0' && (p[1] == 'x' || p[1] == 'X')) {
+        p += 2;
+        base = 16;
+    }
+    auto result = std::from_chars(p, end, address, base);
+    if (result.ec != std::errc()) return MALFORMED;
+    p = result.ptr;
+
+    while (p < end && isSeparator(p[0])) ++p;
+    kind = AddressTrace::READ;
+    if (p < end) {
+        switch (*p) {
+            case 'R': case 'r': case 'L': case 'l': kind = AddressTrace::READ; break;
+            case 'W': case 'w': case 'S': case 's': kind = AddressTrace::WRITE; break;
+            case 'I': case 'i': kind = AddressTrace::FETCH; break;
+            default: return MALFORMED;
+        }
+        ++p;
+        while (p < end && isSeparator(p[0])) ++p;
+    }
+    return p == end ? ACCESS : MALFORMED;
+}
+
+} // namespace
+
+AddressTrace::AddressTrace()
+    : m_binary(false)
+    , m_lineNumber(0)
+    , m_accessCount(0)
+{
+}
+
+bool AddressTrace::open(const QString &filename, QString *error)
+{
+    m_file.close();
+    m_pending.clear();
+    m_lineNumber = 0;
+    m_accessCount = 0;
+    m_error.clear();
+
+    m_file.setFileName(filename);
+    if (!m_file.open(QIODevice::ReadOnly)) {
+        m_error = "Cannot open address trace: " + filename;
+        if (error) *error = m_error;
+        return false;
+    }
+    m_binary = filename.endsWith(".bin", Qt::CaseInsensitive);
+    return true;
+}
+
+bool AddressTrace::readBlock(QVector<quint64> &addresses, QVector<quint8> &kinds)
+{
+    addresses.resize(0);
+    kinds.resize(0);
+    if (!m_file.isOpen()) return true;
+
+    addresses.reserve(kBlockAccesses);
+    kinds.reserve(kBlockAccesses);
+    const bool ok = m_binary ? readBinary(addresses, kinds) : readText(addresses, kinds);
+    m_accessCount += addresses.size();
+    return ok;
+}
+
+bool AddressTrace::readBinary(QVector<quint64> &addresses, QVector<quint8> &kinds)
+{
+    const QByteArray data = m_file.read(qint64(kBlockAccesses) * sizeof(quint64));
+    if (data.size() % sizeof(quint64) != 0) {
+        m_error = "Truncated record at end of binary address trace";
+        return false;
+    }
+
+    const int count = data.size() / int(sizeof(quint64));
+    addresses.resize(count);
+    kinds.resize(count);
+    const char *p = data.constData();
+    quint64 *out = addresses.data();
+    quint8 *outKinds = kinds.data();
+    const quint64 addressMask = (quint64(1) << kKindShift) - 1;
+    for (int i = 0; i < count; ++i) {
+        const quint64 record = qFromLittleEndian<quint64>(p + i * sizeof(quint64));
+        out[i] = record & addressMask;
+        outKinds[i] = quint8(record >> kKindShift);
+    }
+    return true;
+}
+
+bool AddressTrace::readText(QVector<quint64> &addresses, QVector<quint8> &kinds)
+{
+    // 先解析缓冲区中剩余的完整行，不够一块时再读入，缓冲区不超过一次读入的大小加一行
+    bool atEnd = m_file.atEnd();
+    while (true) {
+        const char *data = m_pending.constData();
+        const char *end = data + m_pending.size();
+        const char *p = data;
+        while (p < end && addresses.size() < kBlockAccesses) {
+            const char *lineEnd = std::find(p, end, '\n');
+            // 最后一行不完整时留到下一次读入，文件结束时按完整行处理
+            if (lineEnd == end && !atEnd) break;
+
+            ++m_lineNumber;
+            quint64 address = 0;
+            quint8 kind = READ;
+            switch (parseLine(p, lineEnd, address, kind)) {
+                case SKIPPED:
+                    break;
+                case MALFORMED:
+                    m_error = QString("Malformed address at line %1").arg(m_lineNumber);
+                    return false;
+                case ACCESS:
+                    addresses.append(address);
+                    kinds.append(kind);
+                    break;
+            }
+            p = lineEnd + (lineEnd < end ? 1 : 0);
+        }
+        m_pending.remove(0, int(p - data));
+        if (addresses.size() >= kBlockAccesses || atEnd) break;
+
+        const QByteArray block = m_file.read(kReadBlockSize);
+        if (block.isEmpty()) {
+            atEnd = true;
+        }
+        m_pending.append(block);
+    }
+    return true;
+}
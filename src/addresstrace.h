@@ -0,0 +1,50 @@
+#ifndef ADDRESSTRACE_H
+#define ADDRESSTRACE_H
+
+#include <QString>
+#include <QVector>
+#include <QFile>
+#include <QByteArray>
+
+// 内存地址轨迹：文本文件每行一个访问 "地址 [类型]"（空白或逗号分隔），
+// 地址为十进制或 0x 开头的十六进制，类型 I 为取指、R/L 为读、W/S 为写，缺省为读；
+// '#' 开头的行与非数字开头的表头行被忽略。
+// 扩展名为 .bin 的文件为连续的小端 64 位记录，低 62 位为地址，高 2 位为类型。
+// 按块流式读取，内存占用与轨迹长度无关
+class AddressTrace
+{
+public:
+    enum Kind : quint8 {
+        READ = 0,
+        WRITE = 1,
+        FETCH = 2
+    };
+
+    static const int kBlockAccesses = 1 << 20;  // 每次读入的最大访问数
+    static const int kKindShift = 62;           // 二进制记录中类型所在的位
+
+    AddressTrace();
+
+    bool open(const QString &filename, QString *error = nullptr);
+
+    // 读入下一块（至多 kBlockAccesses 个访问），文件结束时 addresses 为空；格式错误时返回 false
+    bool readBlock(QVector<quint64> &addresses, QVector<quint8> &kinds);
+
+    QString fileName() const { return m_file.fileName(); }
+    // 已读取的访问数
+    qint64 accessCount() const { return m_accessCount; }
+    QString errorString() const { return m_error; }
+
+private:
+    bool readBinary(QVector<quint64> &addresses, QVector<quint8> &kinds);
+    bool readText(QVector<quint64> &addresses, QVector<quint8> &kinds);
+
+    QFile m_file;
+    bool m_binary;
+    QByteArray m_pending;  // 上一块末尾不完整的行或记录
+    qint64 m_lineNumber;
+    qint64 m_accessCount;
+    QString m_error;
+};
+
+#endif // ADDRESSTRACE_H
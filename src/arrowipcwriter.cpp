@@ -0,0 +1,456 @@
+#include "arrowipcwriter.h"
+#include <QIODevice>
+#include <QSharedPointer>
+#include <QtEndian>
+#include <QtMath>
+
+namespace {
+
+// Arrow 格式中的枚举值（Schema.fbs / Message.fbs）
+const quint8 kTypeFloatingPoint = 3;
+const quint8 kTypeUtf8 = 5;
+const quint8 kHeaderSchema = 1;
+const quint8 kHeaderDictionaryBatch = 2;
+const quint8 kHeaderRecordBatch = 3;
+const qint16 kMetadataV5 = 4;
+const qint16 kPrecisionDouble = 2;
+const int kBodyAlignment = 8;
+const char kMagic[] = "ARROW1";
+
+// 最小的 FlatBuffers 构建器：子对象总是写在引用它的对象之后，偏移量均为正
+struct FbObject;
+using FbPtr = QSharedPointer<FbObject>;
+
+struct FbObject {
+    enum Kind { TABLE, STRING, TABLE_VECTOR, STRUCT_VECTOR };
+    struct Field {
+        int id;
+        QByteArray scalar;   // 内联标量
+        FbPtr child;         // 非空时为偏移字段
+    };
+
+    Kind kind = TABLE;
+    QVector<Field> fields;
+    QByteArray bytes;        // 字符串或结构体数组的内容
+    int count = 0;
+    int alignment = 4;
+    QVector<FbPtr> elements;
+
+    template<typename T>
+    void add(int id, T value) {
+        QByteArray scalar(int(sizeof(T)), '\0');
+        qToLittleEndian<T>(value, scalar.data());
+        fields.append({id, scalar, FbPtr()});
+    }
+    void addObject(int id, const FbPtr &child) {
+        fields.append({id, QByteArray(), child});
+    }
+};
+
+FbPtr fbTable()
+{
+    return FbPtr::create();
+}
+
+FbPtr fbString(const QByteArray &utf8)
+{
+    FbPtr object = FbPtr::create();
+    object->kind = FbObject::STRING;
+    object->bytes = utf8;
+    return object;
+}
+
+FbPtr fbTableVector(const QVector<FbPtr> &elements)
+{
+    FbPtr object = FbPtr::create();
+    object->kind = FbObject::TABLE_VECTOR;
+    object->elements = elements;
+    return object;
+}
+
+FbPtr fbStructVector(const QByteArray &bytes, int count)
+{
+    FbPtr object = FbPtr::create();
+    object->kind = FbObject::STRUCT_VECTOR;
+    object->bytes = bytes;
+    object->count = count;
+    object->alignment = 8;  // Arrow 中的结构体均含 int64 成员
+    return object;
+}
+
+class FbSerializer
+{
+public:
+    QByteArray finish(const FbPtr &root)
+    {
+        m_buffer = QByteArray(4, '\0');
+        patch(0, write(root));
+        pad(8);
+        return m_buffer;
+    }
+
+private:
+    void pad(int alignment)
+    {
+        while (m_buffer.size() % alignment) {
+            m_buffer.append('\0');
+        }
+    }
+
+    void append32(quint32 value)
+    {
+        char bytes[4];
+        qToLittleEndian<quint32>(value, bytes);
+        m_buffer.append(bytes, 4);
+    }
+
+    // 在 at 处写入指向 target 的无符号偏移
+    void patch(int at, int target)
+    {
+        qToLittleEndian<quint32>(quint32(target - at), m_buffer.data() + at);
+    }
+
+    int write(const FbPtr &object)
+    {
+        switch (object->kind) {
+            case FbObject::STRING: {
+                pad(4);
+                int position = m_buffer.size();
+                append32(quint32(object->bytes.size()));
+                m_buffer.append(object->bytes);
+                m_buffer.append('\0');
+                return position;
+            }
+            case FbObject::STRUCT_VECTOR: {
+                // 长度前缀之后的元素需要按结构体对齐
+                while ((m_buffer.size() + 4) % object->alignment) {
+                    m_buffer.append('\0');
+                }
+                int position = m_buffer.size();
+                append32(quint32(object->count));
+                m_buffer.append(object->bytes);
+                return position;
+            }
+            case FbObject::TABLE_VECTOR: {
+                pad(4);
+                int position = m_buffer.size();
+                append32(quint32(object->elements.size()));
+                int slots = m_buffer.size();
+                m_buffer.append(QByteArray(object->elements.size() * 4, '\0'));
+                for (int i = 0; i < object->elements.size(); ++i) {
+                    patch(slots + i * 4, write(object->elements[i]));
+                }
+                return position;
+            }
+            case FbObject::TABLE:
+                break;
+        }
+        return writeTable(*object);
+    }
+
+    int writeTable(const FbObject &table)
+    {
+        // 字段按自身大小对齐，表起始按 8 字节对齐
+        int slotCount = 0;
+        int tableSize = 4;
+        QVector<int> offsets;
+        for (const auto &field : table.fields) {
+            slotCount = qMax(slotCount, field.id + 1);
+            int size = field.child ? 4 : field.scalar.size();
+            tableSize = (tableSize + size - 1) / size * size;
+            offsets.append(tableSize);
+            tableSize += size;
+        }
+
+        const int vtableSize = 4 + 2 * slotCount;
+        pad(2);
+        while ((m_buffer.size() + vtableSize) % 8) {
+            m_buffer.append('\0');
+        }
+        const int vtablePosition = m_buffer.size();
+        QVector<quint16> vtable(2 + slotCount, 0);
+        vtable[0] = quint16(vtableSize);
+        vtable[1] = quint16(tableSize);
+        for (int i = 0; i < table.fields.size(); ++i) {
+            vtable[2 + table.fields[i].id] = quint16(offsets[i]);
+        }
+        for (quint16 entry : vtable) {
+            char bytes[2];
+            qToLittleEndian<quint16>(entry, bytes);
+            m_buffer.append(bytes, 2);
+        }
+
+        const int tablePosition = m_buffer.size();
+        m_buffer.append(QByteArray(tableSize, '\0'));
+        qToLittleEndian<qint32>(tablePosition - vtablePosition, m_buffer.data() + tablePosition);
+        for (int i = 0; i < table.fields.size(); ++i) {
+            const auto &field = table.fields[i];
+            if (!field.child) {
+                memcpy(m_buffer.data() + tablePosition + offsets[i], field.scalar.constData(), size_t(field.scalar.size()));
+            }
+        }
+        for (int i = 0; i < table.fields.size(); ++i) {
+            if (table.fields[i].child) {
+                patch(tablePosition + offsets[i], write(table.fields[i].child));
+            }
+        }
+        return tablePosition;
+    }
+
+    QByteArray m_buffer;
+};
+
+// 记录批次的消息体与缓冲区描述
+class BatchBody
+{
+public:
+    void addNode(qint64 length, qint64 nullCount)
+    {
+        appendStruct(m_nodes, length, nullCount);
+        ++m_nodeCount;
+    }
+
+    void addBuffer(const char *data, qint64 size)
+    {
+        appendStruct(m_buffers, m_body.size(), size);
+        ++m_bufferCount;
+        if (size > 0) {
+            m_body.append(data, int(size));
+        }
+        while (m_body.size() % kBodyAlignment) {
+            m_body.append('\0');
+        }
+    }
+
+    const QByteArray& body() const { return m_body; }
+
+    FbPtr recordBatch(qint64 length) const
+    {
+        FbPtr batch = fbTable();
+        batch->add<qint64>(0, length);
+        batch->addObject(1, fbStructVector(m_nodes, m_nodeCount));
+        batch->addObject(2, fbStructVector(m_buffers, m_bufferCount));
+        return batch;
+    }
+
+private:
+    static void appendStruct(QByteArray &target, qint64 first, qint64 second)
+    {
+        char bytes[16];
+        qToLittleEndian<qint64>(first, bytes);
+        qToLittleEndian<qint64>(second, bytes + 8);
+        target.append(bytes, 16);
+    }
+
+    QByteArray m_body;
+    QByteArray m_nodes;
+    QByteArray m_buffers;
+    int m_nodeCount = 0;
+    int m_bufferCount = 0;
+};
+
+// 有效位图；没有空值时返回空数组（Arrow 允许省略）
+template<typename T, typename IsValid>
+QByteArray validityBitmap(const T *values, int count, IsValid isValid, qint64 &nullCount)
+{
+    nullCount = 0;
+    QByteArray bitmap((count + 7) / 8, '\0');
+    for (int i = 0; i < count; ++i) {
+        if (isValid(values[i])) {
+            bitmap[i / 8] = char(quint8(bitmap[i / 8]) | (1u << (i % 8)));
+        } else {
+            ++nullCount;
+        }
+    }
+    return nullCount > 0 ? bitmap : QByteArray();
+}
+
+QByteArray message(quint8 headerType, const FbPtr &header, qint64 bodyLength)
+{
+    FbPtr message = fbTable();
+    message->add<qint16>(0, kMetadataV5);
+    message->add<quint8>(1, headerType);
+    message->addObject(2, header);
+    message->add<qint64>(3, bodyLength);
+    return FbSerializer().finish(message);
+}
+
+FbPtr schemaTable(const QVector<ArrowIpcWriter::Column> &columns)
+{
+    QVector<FbPtr> fields;
+    for (const auto &column : columns) {
+        FbPtr field = fbTable();
+        field->addObject(0, fbString(column.name.toUtf8()));
+        field->add<quint8>(1, 1);  // nullable
+        if (column.dictionary) {
+            FbPtr indexType = fbTable();
+            indexType->add<qint32>(0, 32);
+            indexType->add<quint8>(1, 1);
+            FbPtr encoding = fbTable();
+            encoding->add<qint64>(0, column.dictionaryId);
+            encoding->addObject(1, indexType);
+            field->add<quint8>(2, kTypeUtf8);
+            field->addObject(3, fbTable());
+            field->addObject(4, encoding);
+        } else {
+            FbPtr floatType = fbTable();
+            floatType->add<qint16>(0, kPrecisionDouble);
+            field->add<quint8>(2, kTypeFloatingPoint);
+            field->addObject(3, floatType);
+        }
+        field->addObject(5, fbTableVector({}));
+        fields.append(field);
+    }
+
+    FbPtr schema = fbTable();
+    schema->add<qint16>(0, 0);  // little endian
+    schema->addObject(1, fbTableVector(fields));
+    return schema;
+}
+
+} // namespace
+
+ArrowIpcWriter::ArrowIpcWriter(QIODevice *device)
+    : m_device(device)
+    , m_position(0)
+{
+}
+
+int ArrowIpcWriter::addDictionaryColumn(const QString &name, const QVector<QByteArray> &dictionary)
+{
+    int dictionaryId = 0;
+    for (const auto &column : m_columns) {
+        if (column.dictionary) ++dictionaryId;
+    }
+    m_columns.append({name, true, dictionaryId, dictionary});
+    return m_columns.size() - 1;
+}
+
+int ArrowIpcWriter::addFloat64Column(const QString &name)
+{
+    m_columns.append({name, false, -1, {}});
+    return m_columns.size() - 1;
+}
+
+bool ArrowIpcWriter::writeBytes(const QByteArray &data)
+{
+    if (m_device->write(data) != data.size()) {
+        m_error = m_device->errorString();
+        return false;
+    }
+    m_position += data.size();
+    return true;
+}
+
+bool ArrowIpcWriter::writeMessage(const QByteArray &metadata, const QByteArray &body, Block *block)
+{
+    // 封装格式：0xFFFFFFFF、元数据长度、元数据（8 字节对齐）、消息体
+    char prefix[8];
+    qToLittleEndian<quint32>(0xFFFFFFFFu, prefix);
+    qToLittleEndian<qint32>(qint32(metadata.size()), prefix + 4);
+
+    if (block) {
+        block->offset = m_position;
+        block->metadataLength = qint32(sizeof(prefix) + metadata.size());
+        block->bodyLength = body.size();
+    }
+    return writeBytes(QByteArray(prefix, sizeof(prefix)) + metadata) && writeBytes(body);
+}
+
+bool ArrowIpcWriter::begin()
+{
+    if (!writeBytes(QByteArray(kMagic, 6) + QByteArray(2, '\0'))) return false;
+    if (!writeMessage(message(kHeaderSchema, schemaTable(m_columns), 0), QByteArray(), nullptr)) return false;
+
+    for (const auto &column : m_columns) {
+        if (!column.dictionary) continue;
+
+        QVector<qint32> offsets;
+        offsets.reserve(column.values.size() + 1);
+        QByteArray data;
+        offsets.append(0);
+        for (const QByteArray &value : column.values) {
+            data.append(value);
+            offsets.append(qToLittleEndian<qint32>(qint32(data.size())));
+        }
+
+        BatchBody body;
+        body.addNode(column.values.size(), 0);
+        body.addBuffer(nullptr, 0);
+        body.addBuffer(reinterpret_cast<const char*>(offsets.constData()), offsets.size() * qint64(sizeof(qint32)));
+        body.addBuffer(data.constData(), data.size());
+
+        FbPtr dictionaryBatch = fbTable();
+        dictionaryBatch->add<qint64>(0, column.dictionaryId);
+        dictionaryBatch->addObject(1, body.recordBatch(column.values.size()));
+
+        Block block;
+        if (!writeMessage(message(kHeaderDictionaryBatch, dictionaryBatch, body.body().size()), body.body(), &block)) {
+            return false;
+        }
+        m_dictionaryBlocks.append(block);
+    }
+    return true;
+}
+
+bool ArrowIpcWriter::writeBatch(int rowCount, const QVector<const void*> &columns)
+{
+    if (rowCount <= 0) return true;
+
+    BatchBody body;
+    for (int i = 0; i < m_columns.size(); ++i) {
+        qint64 nullCount = 0;
+        if (m_columns[i].dictionary) {
+            auto indices = static_cast<const qint32*>(columns[i]);
+            QByteArray validity = validityBitmap(indices, rowCount, [](qint32 v) { return v >= 0; }, nullCount);
+            body.addNode(rowCount, nullCount);
+            body.addBuffer(validity.constData(), validity.size());
+            body.addBuffer(reinterpret_cast<const char*>(indices), rowCount * qint64(sizeof(qint32)));
+        } else {
+            auto values = static_cast<const double*>(columns[i]);
+            QByteArray validity = validityBitmap(values, rowCount, [](double v) { return !qIsNaN(v); }, nullCount);
+            body.addNode(rowCount, nullCount);
+            body.addBuffer(validity.constData(), validity.size());
+            body.addBuffer(reinterpret_cast<const char*>(values), rowCount * qint64(sizeof(double)));
+        }
+    }
+
+    Block block;
+    if (!writeMessage(message(kHeaderRecordBatch, body.recordBatch(rowCount), body.body().size()), body.body(), &block)) {
+        return false;
+    }
+    m_batchBlocks.append(block);
+    return true;
+}
+
+bool ArrowIpcWriter::finish()
+{
+    // 流结束标记
+    char endOfStream[8];
+    qToLittleEndian<quint32>(0xFFFFFFFFu, endOfStream);
+    qToLittleEndian<qint32>(0, endOfStream + 4);
+    if (!writeBytes(QByteArray(endOfStream, sizeof(endOfStream)))) return false;
+
+    auto blockVector = [](const QVector<Block> &blocks) {
+        QByteArray bytes;
+        for (const Block &block : blocks) {
+            char entry[24] = {};
+            qToLittleEndian<qint64>(block.offset, entry);
+            qToLittleEndian<qint32>(block.metadataLength, entry + 8);
+            qToLittleEndian<qint64>(block.bodyLength, entry + 16);
+            bytes.append(entry, sizeof(entry));
+        }
+        return fbStructVector(bytes, blocks.size());
+    };
+
+    FbPtr footer = fbTable();
+    footer->add<qint16>(0, kMetadataV5);
+    footer->addObject(1, schemaTable(m_columns));
+    footer->addObject(2, blockVector(m_dictionaryBlocks));
+    footer->addObject(3, blockVector(m_batchBlocks));
+    QByteArray footerBytes = FbSerializer().finish(footer);
+
+    char footerLength[4];
+    qToLittleEndian<qint32>(qint32(footerBytes.size()), footerLength);
+    return writeBytes(footerBytes + QByteArray(footerLength, 4) + QByteArray(kMagic, 6));
+}
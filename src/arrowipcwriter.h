@@ -0,0 +1,57 @@
+#ifndef ARROWIPCWRITER_H
+#define ARROWIPCWRITER_H
+
+#include <QString>
+#include <QVector>
+#include <QByteArray>
+
+class QIODevice;
+
+// Arrow IPC 文件格式（Feather V2）写入器，按记录批次流式写出
+// 只支持两种列：字典编码的字符串列（int32 下标）与 float64 数值列
+// pandas/pyarrow 可直接以零拷贝方式读取数值列
+class ArrowIpcWriter
+{
+public:
+    explicit ArrowIpcWriter(QIODevice *device);
+
+    // 字典列：每行为字典下标，-1 表示空值；字典为 UTF-8 编码
+    int addDictionaryColumn(const QString &name, const QVector<QByteArray> &dictionary);
+    // 数值列：NaN 表示空值
+    int addFloat64Column(const QString &name);
+
+    // 写入文件头、表结构与字典，之后不能再添加列
+    bool begin();
+    // 写入一个记录批次，columns[i] 指向第 i 列的 rowCount 个值（字典列为 qint32，数值列为 double）
+    bool writeBatch(int rowCount, const QVector<const void*> &columns);
+    // 写入文件尾（批次索引）
+    bool finish();
+
+    QString errorString() const { return m_error; }
+
+    struct Column {
+        QString name;
+        bool dictionary;
+        int dictionaryId;
+        QVector<QByteArray> values;  // 字典列的字典
+    };
+
+private:
+    struct Block {
+        qint64 offset;
+        qint32 metadataLength;
+        qint64 bodyLength;
+    };
+
+    bool writeMessage(const QByteArray &metadata, const QByteArray &body, Block *block);
+    bool writeBytes(const QByteArray &data);
+
+    QIODevice *m_device;
+    QVector<Column> m_columns;
+    QVector<Block> m_dictionaryBlocks;
+    QVector<Block> m_batchBlocks;
+    qint64 m_position;
+    QString m_error;
+};
+
+#endif // ARROWIPCWRITER_H
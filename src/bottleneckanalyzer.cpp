@@ -0,0 +1,345 @@
+#include "bottleneckanalyzer.h"
+#include "statkeyregistry.h"
+#include <QRegularExpression>
+#include <QQueue>
+#include <algorithm>
+
+BottleneckAnalyzer::BottleneckAnalyzer(QObject *parent)
+    : QObject(parent)
+    , m_allDirty(false)
+    , m_tracer(nullptr)
+    , m_ticks(0.0)
+    , m_l2MissLatency(0.0)
+    , m_memoryLatency(0.0)
+{
+    auto &registry = StatKeyRegistry::instance();
+    m_totalTickKey = registry.intern("total_tick_processed");
+    m_ldMemTickKey = registry.intern("ld_mem_tick_sum");
+    m_l2MissKey = registry.intern("l2_miss_count");
+    m_llcMissKey = registry.intern("llc_miss_count");
+    m_messageKey = registry.intern("message_precossed");
+    m_busyRateKey = registry.intern("busy_rate");
+    m_avgLatencyKey = registry.intern("avg_transmit_latency");
+
+    for (const char *eventClass : {"l1miss_l2miss_l3hit", "l1miss_l2miss_l3forward", "l1miss_l2miss_l3miss"}) {
+        m_l2MissCountKeys.append(registry.intern(QString("%1_cnt").arg(eventClass)));
+        m_l2MissTickKeys.append(registry.intern(QString("%1_tick").arg(eventClass)));
+    }
+    m_l3MissCountKey = registry.intern("l1miss_l2miss_l3miss_cnt");
+    m_l3MissTickKey = registry.intern("l1miss_l2miss_l3miss_tick");
+    m_l3MemShareKey = registry.intern("l1miss_l2miss_l3miss_l3_mem_avg");
+    m_memL2ShareKey = registry.intern("l1miss_l2miss_l3miss_mem_l2_avg");
+
+    m_timer.setSingleShot(true);
+    m_timer.setInterval(50);
+    connect(&m_timer, &QTimer::timeout, this, &BottleneckAnalyzer::recompute);
+}
+
+void BottleneckAnalyzer::addModule(HardwareModule* module)
+{
+    if (!module || m_modules.contains(module)) return;
+
+    m_modules.append(module);
+    if (module->type() == HardwareModule::CACHE_EVENT_TRACER) {
+        m_tracer = module;
+        m_allDirty = true;
+    } else {
+        m_dirty.insert(module);
+    }
+
+    connect(module, &HardwareModule::statisticChanged,
+            this, &BottleneckAnalyzer::onStatisticChanged);
+    scheduleRecompute();
+}
+
+void BottleneckAnalyzer::removeModule(HardwareModule* module)
+{
+    if (!m_modules.removeOne(module)) return;
+
+    disconnect(module, nullptr, this, nullptr);
+    m_resources.remove(module);
+    m_dirty.remove(module);
+    if (module == m_tracer) {
+        m_tracer = nullptr;
+        m_allDirty = true;
+    }
+    scheduleRecompute();
+}
+
+void BottleneckAnalyzer::clear()
+{
+    for (auto module : m_modules) {
+        disconnect(module, nullptr, this, nullptr);
+    }
+    m_modules.clear();
+    m_resources.clear();
+    m_dirty.clear();
+    m_allDirty = false;
+    m_tracer = nullptr;
+    m_timer.stop();
+    emit rankingChanged();
+}
+
+QVector<BottleneckAnalyzer::Resource> BottleneckAnalyzer::ranking() const
+{
+    QVector<Resource> resources;
+    for (auto it = m_resources.begin(); it != m_resources.end(); ++it) {
+        resources += it.value();
+    }
+    std::sort(resources.begin(), resources.end(), [](const Resource &a, const Resource &b) {
+        return a.utilization > b.utilization;
+    });
+    return resources;
+}
+
+QString BottleneckAnalyzer::categoryName(Category category)
+{
+    switch (category) {
+        case BUS_NODE:
+            return "Bus Node";
+        case BUS_EDGE:
+            return "Bus Edge";
+        case BUS_QUEUEING:
+            return "Bus Queueing";
+        case MEMORY_BANDWIDTH:
+            return "Memory Bandwidth";
+        case MEMORY_OCCUPANCY:
+            return "Memory Occupancy";
+        case CACHE_MSHR:
+            return "Cache MSHR";
+        case CORE_LOAD_STALL:
+            return "Core Load Stall";
+        default:
+            return "Unknown";
+    }
+}
+
+void BottleneckAnalyzer::onStatisticChanged(int keyId, double oldValue, double newValue)
+{
+    Q_UNUSED(oldValue);
+    Q_UNUSED(newValue);
+
+    auto module = qobject_cast<HardwareModule*>(sender());
+    if (!module) return;
+
+    // 仿真总周期与事件追踪器的延迟会影响所有基于时间的资源
+    if (module == m_tracer || keyId == m_totalTickKey) {
+        m_allDirty = true;
+    } else {
+        m_dirty.insert(module);
+    }
+    scheduleRecompute();
+}
+
+void BottleneckAnalyzer::scheduleRecompute()
+{
+    if (!m_timer.isActive()) {
+        m_timer.start();
+    }
+}
+
+void BottleneckAnalyzer::recompute()
+{
+    m_ticks = simulationTicks();
+    m_l2MissLatency = averageLatency(m_l2MissCountKeys, m_l2MissTickKeys);
+
+    m_memoryLatency = averageLatency({m_l3MissCountKey}, {m_l3MissTickKey});
+    if (m_tracer) {
+        double share = m_tracer->statistic(m_l3MemShareKey) + m_tracer->statistic(m_memL2ShareKey);
+        if (share > 0.0) {
+            m_memoryLatency *= share;
+        }
+    }
+
+    if (m_allDirty) {
+        for (auto module : m_modules) {
+            m_dirty.insert(module);
+        }
+        m_allDirty = false;
+    }
+
+    for (auto module : m_dirty) {
+        QVector<Resource> resources;
+        analyzeModule(module, resources);
+        if (resources.isEmpty()) {
+            m_resources.remove(module);
+        } else {
+            m_resources[module] = resources;
+        }
+    }
+    m_dirty.clear();
+
+    emit rankingChanged();
+}
+
+void BottleneckAnalyzer::analyzeModule(HardwareModule* module, QVector<Resource> &out)
+{
+    switch (module->type()) {
+        case HardwareModule::BUS:
+            analyzeBus(module, out);
+            break;
+        case HardwareModule::MEMORY_CTRL: {
+            int dataWidth = module->memoryDataWidth();
+            if (dataWidth > 0 && m_ticks > 0 && module->hasStatistic(m_messageKey)) {
+                double demand = module->statistic(m_messageKey) * kCacheLineBytes * 8;
+                double capacity = double(dataWidth) * m_ticks;
+                out.append({module, MEMORY_BANDWIDTH, module->name() + " bandwidth",
+                            demand, capacity, demand / capacity});
+            }
+            if (module->hasStatistic(m_busyRateKey)) {
+                double busyRate = module->statistic(m_busyRateKey);
+                out.append({module, MEMORY_OCCUPANCY, module->name() + " occupancy",
+                            busyRate, 1.0, busyRate});
+            }
+            break;
+        }
+        case HardwareModule::CACHE_L2:
+        case HardwareModule::CACHE_L3: {
+            bool isL2 = module->type() == HardwareModule::CACHE_L2;
+            int mshrCount = isL2 ? module->l2Config().mshrCount : module->l3Config().mshrCount;
+            int missKey = isL2 ? m_l2MissKey : m_llcMissKey;
+            double latency = isL2 ? m_l2MissLatency : m_memoryLatency;
+            if (mshrCount > 0 && m_ticks > 0 && latency > 0 && module->hasStatistic(missKey)) {
+                // Little 定律：平均在途未命中数 = 未命中到达率 × 未命中延迟
+                double outstanding = module->statistic(missKey) * latency / m_ticks;
+                out.append({module, CACHE_MSHR, module->name() + " MSHR",
+                            outstanding, double(mshrCount), outstanding / mshrCount});
+            }
+            break;
+        }
+        case HardwareModule::CPU_CORE: {
+            double ticks = module->statistic(m_totalTickKey);
+            if (ticks > 0 && module->hasStatistic(m_ldMemTickKey)) {
+                double stall = module->statistic(m_ldMemTickKey);
+                out.append({module, CORE_LOAD_STALL, module->name() + " load stall",
+                            stall, ticks, stall / ticks});
+            }
+            break;
+        }
+        default:
+            break;
+    }
+}
+
+void BottleneckAnalyzer::analyzeBus(HardwareModule* bus, QVector<Resource> &out)
+{
+    QHash<int, QVector<int>> adjacency;
+    for (const auto &edge : bus->busEdges()) {
+        adjacency[edge.first].append(edge.second);
+    }
+
+    // 按源节点缓存的 BFS 跳数表
+    QHash<int, QHash<int, int>> hopTables;
+    auto hops = [&](int from, int to) -> int {
+        auto tableIt = hopTables.find(from);
+        if (tableIt == hopTables.end()) {
+            QHash<int, int> table;
+            QQueue<int> queue;
+            table[from] = 0;
+            queue.enqueue(from);
+            while (!queue.isEmpty()) {
+                int node = queue.dequeue();
+                for (int next : adjacency.value(node)) {
+                    if (!table.contains(next)) {
+                        table[next] = table[node] + 1;
+                        queue.enqueue(next);
+                    }
+                }
+            }
+            tableIt = hopTables.insert(from, table);
+        }
+        return tableIt->value(to, -1);
+    };
+
+    const auto &portMap = bus->busPortToNodeMap();
+    double traffic = 0.0;
+    double weightedHops = 0.0;
+
+    const auto &values = bus->statisticValues();
+    for (auto it = values.begin(); it != values.end(); ++it) {
+        BusKey key = busKey(it.key());
+        switch (key.kind) {
+            case BusKey::NODE_BUSY:
+                out.append({bus, BUS_NODE, QString("%1 node %2").arg(bus->name()).arg(key.a),
+                            it.value(), 1.0, it.value()});
+                break;
+            case BusKey::EDGE_BUSY:
+                out.append({bus, BUS_EDGE, QString("%1 edge %2→%3").arg(bus->name()).arg(key.a).arg(key.b),
+                            it.value(), 1.0, it.value()});
+                break;
+            case BusKey::TRAFFIC: {
+                int fromNode = portMap.value(key.a, -1);
+                int toNode = portMap.value(key.b, -1);
+                if (fromNode < 0 || toNode < 0) break;
+                int distance = hops(fromNode, toNode);
+                if (distance >= 0) {
+                    traffic += it.value();
+                    weightedHops += it.value() * distance;
+                }
+                break;
+            }
+            default:
+                break;
+        }
+    }
+
+    // 平均传输延迟与无竞争时按跳数估计的理想延迟之比，反映排队程度
+    if (traffic > 0 && bus->hasStatistic(m_avgLatencyKey)) {
+        double actual = bus->statistic(m_avgLatencyKey);
+        double ideal = qMax(1.0, weightedHops / traffic);
+        double queueing = actual > 0 ? qMax(0.0, (actual - ideal) / actual) : 0.0;
+        out.append({bus, BUS_QUEUEING, bus->name() + " queueing", actual, ideal, queueing});
+    }
+}
+
+BottleneckAnalyzer::BusKey BottleneckAnalyzer::busKey(int keyId)
+{
+    auto it = m_busKeys.constFind(keyId);
+    if (it != m_busKeys.constEnd()) {
+        return it.value();
+    }
+
+    static const QRegularExpression nodeRe("^node_(\\d+)_busy_rate$");
+    static const QRegularExpression edgeRe("^edge_(\\d+)_to_(\\d+)_busy_rate$");
+    static const QRegularExpression trafficRe("^transmit_package_number_from_(\\d+)_to_(\\d+)$");
+
+    QString name = StatKeyRegistry::instance().name(keyId);
+    BusKey key{BusKey::OTHER, -1, -1};
+    QRegularExpressionMatch match;
+    if ((match = nodeRe.match(name)).hasMatch()) {
+        key = {BusKey::NODE_BUSY, match.captured(1).toInt(), -1};
+    } else if ((match = edgeRe.match(name)).hasMatch()) {
+        key = {BusKey::EDGE_BUSY, match.captured(1).toInt(), match.captured(2).toInt()};
+    } else if ((match = trafficRe.match(name)).hasMatch()) {
+        key = {BusKey::TRAFFIC, match.captured(1).toInt(), match.captured(2).toInt()};
+    }
+
+    m_busKeys.insert(keyId, key);
+    return key;
+}
+
+double BottleneckAnalyzer::simulationTicks() const
+{
+    double ticks = 0.0;
+    for (auto module : m_modules) {
+        if (module->type() == HardwareModule::CPU_CORE) {
+            ticks = qMax(ticks, module->statistic(m_totalTickKey));
+        }
+    }
+    return ticks;
+}
+
+double BottleneckAnalyzer::averageLatency(const QVector<int> &countKeys, const QVector<int> &tickKeys) const
+{
+    if (!m_tracer) return 0.0;
+
+    double count = 0.0;
+    double ticks = 0.0;
+    for (int key : countKeys) {
+        count += m_tracer->statistic(key);
+    }
+    for (int key : tickKeys) {
+        ticks += m_tracer->statistic(key);
+    }
+    return count > 0 ? ticks / count : 0.0;
+}
@@ -0,0 +1,105 @@
+#ifndef BOTTLENECKANALYZER_H
+#define BOTTLENECKANALYZER_H
+
+#include <QObject>
+#include <QString>
+#include <QVector>
+#include <QHash>
+#include <QSet>
+#include <QTimer>
+#include "hardwaremodule.h"
+
+// 瓶颈分析：把各资源的负载按 setup 中的容量归一化为利用率并排序
+// 统计数据变化时只重新分析受影响的模块
+class BottleneckAnalyzer : public QObject
+{
+    Q_OBJECT
+
+public:
+    // 资源类别
+    enum Category {
+        BUS_NODE,          // 总线节点占用率
+        BUS_EDGE,          // 总线信道占用率
+        BUS_QUEUEING,      // 总线排队延迟占比
+        MEMORY_BANDWIDTH,  // 内存节点带宽
+        MEMORY_OCCUPANCY,  // 内存节点占用率
+        CACHE_MSHR,        // 缓存 MSHR 占用
+        CORE_LOAD_STALL    // 处理器访存等待
+    };
+
+    struct Resource {
+        HardwareModule* module;
+        Category category;
+        QString name;
+        double demand;       // 实际负载
+        double capacity;     // 配置容量
+        double utilization;  // demand / capacity
+    };
+
+    // 计算内存带宽时假定的缓存行大小（字节）
+    static constexpr int kCacheLineBytes = 64;
+
+    explicit BottleneckAnalyzer(QObject *parent = nullptr);
+
+    void addModule(HardwareModule* module);
+    void removeModule(HardwareModule* module);
+    void clear();
+
+    // 按利用率从高到低排序的资源列表
+    QVector<Resource> ranking() const;
+    static QString categoryName(Category category);
+
+signals:
+    void rankingChanged();
+
+private slots:
+    void onStatisticChanged(int keyId, double oldValue, double newValue);
+    void recompute();
+
+private:
+    // 总线统计项名称解析结果，按驻留ID缓存
+    struct BusKey {
+        enum Kind { OTHER, NODE_BUSY, EDGE_BUSY, TRAFFIC } kind;
+        int a;
+        int b;
+    };
+
+    void scheduleRecompute();
+    void analyzeModule(HardwareModule* module, QVector<Resource> &out);
+    void analyzeBus(HardwareModule* bus, QVector<Resource> &out);
+    BusKey busKey(int keyId);
+    // 仿真总周期数（各处理器 total_tick_processed 的最大值）
+    double simulationTicks() const;
+    // 由 cache_event_trace 计算的平均未命中延迟
+    double averageLatency(const QVector<int> &countKeys, const QVector<int> &tickKeys) const;
+
+    QVector<HardwareModule*> m_modules;
+    QHash<HardwareModule*, QVector<Resource>> m_resources;
+    QSet<HardwareModule*> m_dirty;
+    bool m_allDirty;
+    QTimer m_timer;
+    HardwareModule* m_tracer;
+    QHash<int, BusKey> m_busKeys;
+
+    // 每次重新计算时更新的全局量
+    double m_ticks;
+    double m_l2MissLatency;
+    double m_memoryLatency;
+
+    // 常用统计项的驻留ID
+    int m_totalTickKey;
+    int m_ldMemTickKey;
+    int m_l2MissKey;
+    int m_llcMissKey;
+    int m_messageKey;
+    int m_busyRateKey;
+    int m_avgLatencyKey;
+    QVector<int> m_l2MissCountKeys;
+    QVector<int> m_l2MissTickKeys;
+    int m_l3MissCountKey;
+    int m_l3MissTickKey;
+    int m_l3MemShareKey;
+    int m_memL2ShareKey;
+};
+
+#endif // BOTTLENECKANALYZER_H
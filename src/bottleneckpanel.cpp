@@ -0,0 +1,122 @@
+#include "bottleneckpanel.h"
+#include <QVBoxLayout>
+#include <QHBoxLayout>
+#include <QHeaderView>
+#include <QLabel>
+
+namespace {
+
+// 按 UserRole 中的数值排序的表格项
+class NumericItem : public QTableWidgetItem
+{
+public:
+    NumericItem(const QString &text, double value)
+        : QTableWidgetItem(text)
+    {
+        setData(Qt::UserRole, value);
+        setTextAlignment(Qt::AlignRight | Qt::AlignVCenter);
+    }
+
+    bool operator<(const QTableWidgetItem &other) const override
+    {
+        return data(Qt::UserRole).toDouble() < other.data(Qt::UserRole).toDouble();
+    }
+};
+
+} // namespace
+
+BottleneckPanel::BottleneckPanel(BottleneckAnalyzer* analyzer, HardwareVisualizer* visualizer, QWidget *parent)
+    : QDockWidget("瓶颈分析", parent)
+    , m_analyzer(analyzer)
+    , m_visualizer(visualizer)
+{
+    QWidget* content = new QWidget(this);
+    QVBoxLayout* layout = new QVBoxLayout(content);
+    layout->setContentsMargins(4, 4, 4, 4);
+
+    QHBoxLayout* optionLayout = new QHBoxLayout;
+    m_highlightCheck = new QCheckBox("在场景中高亮前", content);
+    m_highlightCheck->setChecked(true);
+    m_topCount = new QSpinBox(content);
+    m_topCount->setRange(1, 50);
+    m_topCount->setValue(5);
+    optionLayout->addWidget(m_highlightCheck);
+    optionLayout->addWidget(m_topCount);
+    optionLayout->addWidget(new QLabel("项", content));
+    optionLayout->addStretch();
+    layout->addLayout(optionLayout);
+
+    m_table = new QTableWidget(0, 5, content);
+    m_table->setHorizontalHeaderLabels({"Resource", "Category", "Utilization", "Demand", "Capacity"});
+    m_table->horizontalHeader()->setSectionResizeMode(0, QHeaderView::Stretch);
+    m_table->verticalHeader()->setVisible(false);
+    m_table->setEditTriggers(QAbstractItemView::NoEditTriggers);
+    m_table->setSelectionBehavior(QAbstractItemView::SelectRows);
+    m_table->setSortingEnabled(true);
+    m_table->sortByColumn(2, Qt::DescendingOrder);
+    layout->addWidget(m_table);
+
+    setWidget(content);
+
+    connect(m_analyzer, &BottleneckAnalyzer::rankingChanged, this, &BottleneckPanel::refresh);
+    connect(m_table, &QTableWidget::cellClicked, this, &BottleneckPanel::onCellClicked);
+    connect(m_highlightCheck, &QCheckBox::toggled, this, &BottleneckPanel::updateHighlight);
+    connect(m_topCount, QOverload<int>::of(&QSpinBox::valueChanged), this, &BottleneckPanel::updateHighlight);
+    connect(this, &QDockWidget::visibilityChanged, this, &BottleneckPanel::updateHighlight);
+}
+
+void BottleneckPanel::refresh()
+{
+    m_ranking = m_analyzer->ranking();
+
+    // 填充期间关闭排序，结束后按当前排序列重新排序
+    m_table->setSortingEnabled(false);
+    m_table->setRowCount(m_ranking.size());
+
+    for (int row = 0; row < m_ranking.size(); ++row) {
+        const auto &resource = m_ranking[row];
+
+        auto nameItem = new QTableWidgetItem(resource.name);
+        nameItem->setData(Qt::UserRole, QVariant::fromValue(resource.module));
+        m_table->setItem(row, 0, nameItem);
+        m_table->setItem(row, 1, new QTableWidgetItem(BottleneckAnalyzer::categoryName(resource.category)));
+        m_table->setItem(row, 2, new NumericItem(QString("%1%").arg(resource.utilization * 100, 0, 'f', 1),
+                                                 resource.utilization));
+        m_table->setItem(row, 3, new NumericItem(QString::number(resource.demand, 'g', 6), resource.demand));
+        m_table->setItem(row, 4, new NumericItem(QString::number(resource.capacity, 'g', 6), resource.capacity));
+
+        // 利用率越高底色越红
+        QColor color = QColor::fromHsvF(0.33 * (1.0 - qBound(0.0, resource.utilization, 1.0)), 0.6, 0.9);
+        m_table->item(row, 2)->setBackground(color);
+        m_table->item(row, 2)->setForeground(Qt::black);
+    }
+
+    m_table->setSortingEnabled(true);
+
+    updateHighlight();
+}
+
+void BottleneckPanel::onCellClicked(int row, int column)
+{
+    Q_UNUSED(column);
+
+    if (auto item = m_table->item(row, 0)) {
+        if (auto module = item->data(Qt::UserRole).value<HardwareModule*>()) {
+            m_visualizer->focusModule(module);
+        }
+    }
+}
+
+void BottleneckPanel::updateHighlight()
+{
+    if (!isVisible() || !m_highlightCheck->isChecked()) return;
+
+    QList<HardwareModule*> offenders;
+    for (const auto &resource : m_ranking) {
+        if (offenders.size() >= m_topCount->value()) break;
+        if (!offenders.contains(resource.module)) {
+            offenders.append(resource.module);
+        }
+    }
+    m_visualizer->highlightModules(offenders);
+}
@@ -0,0 +1,35 @@
+#ifndef BOTTLENECKPANEL_H
+#define BOTTLENECKPANEL_H
+
+#include <QDockWidget>
+#include <QTableWidget>
+#include <QCheckBox>
+#include <QSpinBox>
+#include "bottleneckanalyzer.h"
+#include "hardwarevisualizer.h"
+
+// 瓶颈排序面板：可排序的资源利用率表格，并在场景中高亮最严重的模块
+class BottleneckPanel : public QDockWidget
+{
+    Q_OBJECT
+
+public:
+    explicit BottleneckPanel(BottleneckAnalyzer* analyzer, HardwareVisualizer* visualizer,
+                             QWidget *parent = nullptr);
+
+private slots:
+    void refresh();
+    void onCellClicked(int row, int column);
+
+private:
+    void updateHighlight();
+
+    BottleneckAnalyzer* m_analyzer;
+    HardwareVisualizer* m_visualizer;
+    QTableWidget* m_table;
+    QCheckBox* m_highlightCheck;
+    QSpinBox* m_topCount;
+    QVector<BottleneckAnalyzer::Resource> m_ranking;
+};
+
+#endif // BOTTLENECKPANEL_H
@@ -0,0 +1,275 @@
+#include "bustopology.h"
+#include "statkeyregistry.h"
+#include <QRegularExpression>
+#include <QtNumeric>
+
+BusTopology::BusTopology(QObject *parent)
+    : QObject(parent)
+{
+}
+
+void BusTopology::rebuild(const QList<HardwareModule*> &modules)
+{
+    clear();
+
+    for (auto module : modules) {
+        int index = parseHardwareIndex(module->name());
+        m_indices.insert(module, index);
+        m_typeIndex.insert(qMakePair(int(module->type()), index), module);
+
+        if (module->type() == HardwareModule::BUS) {
+            m_buses.append(module);
+            m_busByName.insert(module->name(), module);
+        }
+    }
+
+    HardwareModule* defaultBus = m_buses.value(0, nullptr);
+
+    // 先解析有端口或显式指定总线的模块
+    for (auto module : modules) {
+        HardwareModule* bus = nullptr;
+        switch (module->type()) {
+            case HardwareModule::BUS:
+                bus = module;
+                break;
+            case HardwareModule::CPU_CORE:
+            case HardwareModule::CACHE_EVENT_TRACER:
+                break;
+            default:
+                bus = module->busName().isEmpty() ? defaultBus : m_busByName.value(module->busName());
+                break;
+        }
+        if (!bus) continue;
+
+        m_moduleBus.insert(module, bus);
+        if (module != bus) {
+            m_busMembers[bus].append(module);
+            if (module->portId() >= 0) {
+                m_portIndex[bus].insert(module->portId(), module);
+            }
+        }
+    }
+
+    // 处理器核心跟随同编号的 L2 缓存所在的总线
+    for (auto module : modules) {
+        if (module->type() != HardwareModule::CPU_CORE) continue;
+
+        HardwareModule* l2 = moduleByIndex(HardwareModule::CACHE_L2, hardwareIndex(module));
+        HardwareModule* bus = l2 ? m_moduleBus.value(l2) : nullptr;
+        if (!bus && !module->busName().isEmpty()) {
+            bus = m_busByName.value(module->busName());
+        }
+        if (bus) {
+            m_moduleBus.insert(module, bus);
+            m_busMembers[bus].append(module);
+        }
+    }
+
+    for (auto bus : m_buses) {
+        connect(bus, &HardwareModule::statisticChanged, this, &BusTopology::onBusStatisticChanged);
+        const auto &values = bus->statisticValues();
+        for (auto it = values.begin(); it != values.end(); ++it) {
+            setTraffic(bus, it.key(), it.value());
+        }
+    }
+}
+
+void BusTopology::clear()
+{
+    for (auto bus : m_buses) {
+        disconnect(bus, nullptr, this, nullptr);
+    }
+    m_buses.clear();
+    m_busByName.clear();
+    m_moduleBus.clear();
+    m_portIndex.clear();
+    m_busMembers.clear();
+    m_indices.clear();
+    m_typeIndex.clear();
+    m_traffic.clear();
+}
+
+HardwareModule* BusTopology::busOf(HardwareModule* module) const
+{
+    return m_moduleBus.value(module, nullptr);
+}
+
+HardwareModule* BusTopology::moduleAtPort(HardwareModule* bus, int port) const
+{
+    auto it = m_portIndex.constFind(bus);
+    return it != m_portIndex.constEnd() ? it->value(port, nullptr) : nullptr;
+}
+
+HardwareModule* BusTopology::moduleByIndex(HardwareModule::ModuleType type, int index) const
+{
+    return m_typeIndex.value(qMakePair(int(type), index), nullptr);
+}
+
+const BusTopology::PortTraffic& BusTopology::outgoingTraffic(HardwareModule* bus) const
+{
+    static const PortTraffic empty;
+    auto it = m_traffic.constFind(bus);
+    return it != m_traffic.constEnd() ? it->outgoing : empty;
+}
+
+const BusTopology::PortTraffic& BusTopology::incomingTraffic(HardwareModule* bus) const
+{
+    static const PortTraffic empty;
+    auto it = m_traffic.constFind(bus);
+    return it != m_traffic.constEnd() ? it->incoming : empty;
+}
+
+double BusTopology::traffic(HardwareModule* from, HardwareModule* to) const
+{
+    if (!from || !to) return 0.0;
+
+    HardwareModule* bus = busOf(from);
+    if (!bus || bus != busOf(to)) return 0.0;
+
+    int fromPort = from->portId();
+    int toPort = to->portId();
+    if (fromPort < 0 || toPort < 0) return 0.0;
+
+    const PortTraffic &outgoing = outgoingTraffic(bus);
+    double forward = outgoing.value(fromPort).value(toPort, 0.0);
+    double backward = outgoing.value(toPort).value(fromPort, 0.0);
+    return qMax(forward, backward);
+}
+
+BusTopology::LinkTraffic BusTopology::link(HardwareModule* from, HardwareModule* to) const
+{
+    if (!from || !to) return LinkTraffic();
+
+    HardwareModule* bus = busOf(from);
+    if (!bus || bus != busOf(to)) return LinkTraffic();
+
+    auto matrixIt = m_traffic.constFind(bus);
+    if (matrixIt == m_traffic.constEnd()) return LinkTraffic();
+    const TrafficMatrix &matrix = matrixIt.value();
+    const QMap<int, int> &nodes = bus->busPortToNodeMap();
+
+    LinkTraffic result;
+    if (from == bus || to == bus) {
+        // 模块与总线之间：模块端口发出与收到的全部数据包，使用率取端口所在节点
+        HardwareModule* module = from == bus ? to : from;
+        int port = module->portId();
+        if (port < 0) return LinkTraffic();
+
+        double sent = matrix.sentFromPort.value(port, 0.0);
+        double received = matrix.receivedByPort.value(port, 0.0);
+        result.known = true;
+        result.forward = from == bus ? received : sent;
+        result.backward = from == bus ? sent : received;
+
+        int node = nodes.value(port, -1);
+        result.busyRate = matrix.nodeBusy.value(node, -1.0);
+        return result;
+    }
+
+    int fromPort = from->portId();
+    int toPort = to->portId();
+    if (fromPort < 0 || toPort < 0) return LinkTraffic();
+
+    result.known = true;
+    result.forward = matrix.outgoing.value(fromPort).value(toPort, 0.0);
+    result.backward = matrix.outgoing.value(toPort).value(fromPort, 0.0);
+
+    // 两端节点直接相连时取信道使用率，否则取两端节点使用率的较大值
+    int fromNode = nodes.value(fromPort, -1);
+    int toNode = nodes.value(toPort, -1);
+    double forwardBusy = matrix.edgeBusy.value(qMakePair(fromNode, toNode), -1.0);
+    double backwardBusy = matrix.edgeBusy.value(qMakePair(toNode, fromNode), -1.0);
+    if (forwardBusy >= 0 || backwardBusy >= 0) {
+        result.busyRate = qMax(forwardBusy, backwardBusy);
+    } else {
+        result.busyRate = qMax(matrix.nodeBusy.value(fromNode, -1.0), matrix.nodeBusy.value(toNode, -1.0));
+    }
+    return result;
+}
+
+int BusTopology::parseHardwareIndex(const QString &name)
+{
+    int end = name.size();
+    int start = end;
+    while (start > 0 && name[start - 1].isDigit()) {
+        --start;
+    }
+    return start < end ? name.mid(start).toInt() : -1;
+}
+
+void BusTopology::onBusStatisticChanged(int keyId, double oldValue, double newValue)
+{
+    Q_UNUSED(oldValue);
+
+    if (auto bus = qobject_cast<HardwareModule*>(sender())) {
+        if (setTraffic(bus, keyId, newValue)) {
+            emit trafficChanged();
+        }
+    }
+}
+
+const BusTopology::TrafficKey& BusTopology::trafficKey(int keyId)
+{
+    auto keyIt = m_trafficKeys.constFind(keyId);
+    if (keyIt != m_trafficKeys.constEnd()) return keyIt.value();
+
+    static const QRegularExpression packetsRe("^transmit_package_number_from_(\\d+)_to_(\\d+)$");
+    static const QRegularExpression nodeBusyRe("^node_(\\d+)_busy_rate$");
+    static const QRegularExpression edgeBusyRe("^edge_(\\d+)_to_(\\d+)_busy_rate$");
+
+    const QString name = StatKeyRegistry::instance().name(keyId);
+    TrafficKey key = {NOT_TRAFFIC, -1, -1};
+    QRegularExpressionMatch match;
+    if ((match = packetsRe.match(name)).hasMatch()) {
+        key = {PACKETS, match.captured(1).toInt(), match.captured(2).toInt()};
+    } else if ((match = nodeBusyRe.match(name)).hasMatch()) {
+        key = {NODE_BUSY, match.captured(1).toInt(), -1};
+    } else if ((match = edgeBusyRe.match(name)).hasMatch()) {
+        key = {EDGE_BUSY, match.captured(1).toInt(), match.captured(2).toInt()};
+    }
+    return m_trafficKeys.insert(keyId, key).value();
+}
+
+bool BusTopology::setTraffic(HardwareModule* bus, int keyId, double value)
+{
+    const TrafficKey &key = trafficKey(keyId);
+    if (key.kind == NOT_TRAFFIC) return false;
+
+    // 统计项被删除时 value 为 NaN
+    const bool removed = qIsNaN(value);
+    TrafficMatrix &matrix = m_traffic[bus];
+    switch (key.kind) {
+        case PACKETS: {
+            // 端口总数按差值增量维护
+            double &cell = matrix.outgoing[key.first][key.second];
+            double delta = (removed ? 0.0 : value) - cell;
+            matrix.sentFromPort[key.first] += delta;
+            matrix.receivedByPort[key.second] += delta;
+            if (removed) {
+                matrix.outgoing[key.first].remove(key.second);
+                matrix.incoming[key.second].remove(key.first);
+            } else {
+                cell = value;
+                matrix.incoming[key.second][key.first] = value;
+            }
+            break;
+        }
+        case NODE_BUSY:
+            if (removed) {
+                matrix.nodeBusy.remove(key.first);
+            } else {
+                matrix.nodeBusy[key.first] = value;
+            }
+            break;
+        case EDGE_BUSY:
+            if (removed) {
+                matrix.edgeBusy.remove(qMakePair(key.first, key.second));
+            } else {
+                matrix.edgeBusy[qMakePair(key.first, key.second)] = value;
+            }
+            break;
+        default:
+            break;
+    }
+    return true;
+}
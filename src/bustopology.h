@@ -0,0 +1,101 @@
+#ifndef BUSTOPOLOGY_H
+#define BUSTOPOLOGY_H
+
+#include <QObject>
+#include <QString>
+#include <QVector>
+#include <QHash>
+#include <QList>
+#include "hardwaremodule.h"
+
+// 多总线拓扑索引：总线按名称索引，端口按所属总线解析，
+// 并为每条总线维护按端口组织的流量矩阵（transmit_package_number_from_X_to_Y）
+class BusTopology : public QObject
+{
+    Q_OBJECT
+
+public:
+    explicit BusTopology(QObject *parent = nullptr);
+
+    // 按模块集合重建索引
+    void rebuild(const QList<HardwareModule*> &modules);
+    void clear();
+
+    const QVector<HardwareModule*>& buses() const { return m_buses; }
+    HardwareModule* bus(const QString &name) const { return m_busByName.value(name); }
+    // 模块所连接的总线：按模块的 bus 字段解析，未指定时为第一条总线
+    HardwareModule* busOf(HardwareModule* module) const;
+    // 总线上指定端口连接的模块
+    HardwareModule* moduleAtPort(HardwareModule* bus, int port) const;
+    // 连接到总线的所有模块（不含总线本身）
+    QVector<HardwareModule*> modulesOnBus(HardwareModule* bus) const { return m_busMembers.value(bus); }
+    // 模块名末尾的编号（如 L2Cache3 -> 3），没有编号时为-1
+    int hardwareIndex(HardwareModule* module) const { return m_indices.value(module, -1); }
+    // 按类型与编号查找模块
+    HardwareModule* moduleByIndex(HardwareModule::ModuleType type, int index) const;
+
+    // 流量矩阵：端口 -> 对端端口 -> 数据包数
+    using PortTraffic = QHash<int, QHash<int, double>>;
+    const PortTraffic& outgoingTraffic(HardwareModule* bus) const;
+    const PortTraffic& incomingTraffic(HardwareModule* bus) const;
+    // 同一总线上两个模块之间较大方向的数据包数
+    double traffic(HardwareModule* from, HardwareModule* to) const;
+
+    // 一条连接（模块与总线之间，或同一总线上的两个模块之间）的流量
+    struct LinkTraffic {
+        bool known = false;      // 总线有流量统计且两端端口可解析
+        double forward = 0.0;    // from -> to 的数据包数
+        double backward = 0.0;   // to -> from 的数据包数
+        double busyRate = -1.0;  // 所经节点或信道的使用率，没有统计时为-1
+    };
+    LinkTraffic link(HardwareModule* from, HardwareModule* to) const;
+
+    static int parseHardwareIndex(const QString &name);
+
+signals:
+    // 总线的流量或使用率统计项发生变化
+    void trafficChanged();
+
+private slots:
+    void onBusStatisticChanged(int keyId, double oldValue, double newValue);
+
+private:
+    struct TrafficMatrix {
+        PortTraffic outgoing;
+        PortTraffic incoming;
+        QHash<int, double> sentFromPort;      // 端口 -> 发出的数据包总数
+        QHash<int, double> receivedByPort;    // 端口 -> 收到的数据包总数
+        QHash<int, double> nodeBusy;          // 节点 -> node_N_busy_rate
+        QHash<QPair<int, int>, double> edgeBusy;  // (节点, 节点) -> edge_A_to_B_busy_rate
+    };
+
+    enum TrafficKind {
+        NOT_TRAFFIC,
+        PACKETS,     // transmit_package_number_from_X_to_Y（端口）
+        NODE_BUSY,   // node_N_busy_rate
+        EDGE_BUSY    // edge_A_to_B_busy_rate（节点）
+    };
+
+    struct TrafficKey {
+        TrafficKind kind;
+        int first;
+        int second;
+    };
+
+    // 返回统计项是否为流量或使用率
+    bool setTraffic(HardwareModule* bus, int keyId, double value);
+    const TrafficKey& trafficKey(int keyId);
+
+    QVector<HardwareModule*> m_buses;
+    QHash<QString, HardwareModule*> m_busByName;
+    QHash<HardwareModule*, HardwareModule*> m_moduleBus;
+    QHash<HardwareModule*, QHash<int, HardwareModule*>> m_portIndex;
+    QHash<HardwareModule*, QVector<HardwareModule*>> m_busMembers;
+    QHash<HardwareModule*, int> m_indices;
+    QHash<QPair<int, int>, HardwareModule*> m_typeIndex;
+    QHash<HardwareModule*, TrafficMatrix> m_traffic;
+    // 统计项ID到流量类别与端口/节点编号的解析缓存
+    QHash<int, TrafficKey> m_trafficKeys;
+};
+
+#endif // BUSTOPOLOGY_H
@@ -0,0 +1,238 @@
+#include "bustrace.h"
+#include <algorithm>
+#include <charconv>
+#include <limits>
+
+namespace {
+
+const qint64 kReadBlockSize = 1 << 20;
+
+enum LineKind {
+    SKIPPED,    // 空行、注释或表头
+    PACKET,
+    MALFORMED
+};
+
+bool isSeparator(char c)
+{
+    return c == ' ' || c == '\t' || c == ',' || c == '\r';
+}
+
+LineKind parseLine(const char *begin, const char *end, BusTrace::Packet &packet)
+{
+    const char *p = begin;
+    while (p < end && isSeparator(p[0])) ++p;
+    if (p == end || *p == '#' || *p < '0' || *p > '9') return SKIPPED;
+
+    qint64 values[4];
+    for (qint64 &value : values) {
+        while (p < end && isSeparator(p[0])) ++p;
+        auto result = std::from_chars(p, end, value);
+        if (result.ec != std::errc()) return MALFORMED;
+        p = result.ptr;
+    }
+    while (p < end && isSeparator(p[0])) ++p;
+    if (p != end || values[0] > std::numeric_limits<int>::max() || values[1] > std::numeric_limits<int>::max()) {
+        return MALFORMED;
+    }
+
+    packet.source = int(values[0]);
+    packet.destination = int(values[1]);
+    packet.inject = values[2];
+    packet.arrive = values[3];
+    return PACKET;
+}
+
+} // namespace
+
+BusTrace::BusTrace()
+    : m_treeLeaves(0)
+    , m_lastTick(0)
+    , m_packetCount(0)
+{
+}
+
+bool BusTrace::open(const QString &filename, QString *error)
+{
+    m_fileName = filename;
+    m_chunks.clear();
+    m_arriveTree.clear();
+    m_treeLeaves = 0;
+    m_lastTick = 0;
+    m_packetCount = 0;
+    m_file.close();
+
+    QFile file(filename);
+    if (!file.open(QIODevice::ReadOnly)) {
+        if (error) *error = "Cannot open trace file: " + filename;
+        return false;
+    }
+
+    Chunk current = {0, 0, 0, 0, 0};
+    qint64 lastInject = std::numeric_limits<qint64>::min();
+    qint64 maxArrive = std::numeric_limits<qint64>::min();
+    qint64 lineNumber = 0;
+    QString failure;
+
+    auto finishChunk = [&](qint64 endOffset) {
+        current.size = endOffset - current.offset;
+        current.maxArrive = maxArrive;
+        m_chunks.append(current);
+        current.count = 0;
+        maxArrive = std::numeric_limits<qint64>::min();
+    };
+
+    // 逐行建立索引，lineOffset 为行首在文件中的字节偏移
+    auto processLine = [&](const char *begin, const char *end, qint64 lineOffset) {
+        ++lineNumber;
+        Packet packet;
+        switch (parseLine(begin, end, packet)) {
+            case SKIPPED:
+                return true;
+            case MALFORMED:
+                failure = QString("Malformed packet at line %1").arg(lineNumber);
+                return false;
+            case PACKET:
+                break;
+        }
+        if (packet.inject < lastInject) {
+            failure = QString("Trace is not sorted by inject tick at line %1").arg(lineNumber);
+            return false;
+        }
+        if (packet.arrive < packet.inject) {
+            failure = QString("Packet arrives before it is injected at line %1").arg(lineNumber);
+            return false;
+        }
+
+        if (current.count == kChunkPackets) {
+            finishChunk(lineOffset);
+        }
+        if (current.count == 0) {
+            current.offset = lineOffset;
+            current.firstInject = packet.inject;
+        }
+        ++current.count;
+        ++m_packetCount;
+        lastInject = packet.inject;
+        maxArrive = std::max(maxArrive, packet.arrive);
+        return true;
+    };
+
+    QByteArray buffer;
+    qint64 bufferOffset = 0;
+    bool ok = true;
+    while (ok) {
+        QByteArray block = file.read(kReadBlockSize);
+        const bool atEnd = block.isEmpty();
+        buffer.append(block);
+
+        int start = 0;
+        while (ok) {
+            int newline = buffer.indexOf('\n', start);
+            if (newline < 0) break;
+            ok = processLine(buffer.constData() + start, buffer.constData() + newline, bufferOffset + start);
+            start = newline + 1;
+        }
+        if (atEnd) {
+            if (ok && start < buffer.size()) {
+                ok = processLine(buffer.constData() + start, buffer.constData() + buffer.size(), bufferOffset + start);
+            }
+            break;
+        }
+        // 只保留不完整的最后一行
+        buffer.remove(0, start);
+        bufferOffset += start;
+    }
+
+    if (ok && current.count > 0) {
+        finishChunk(file.size());
+    }
+    if (!ok) {
+        m_chunks.clear();
+        m_packetCount = 0;
+        if (error) *error = failure;
+        return false;
+    }
+    buildArriveTree();
+    return true;
+}
+
+void BusTrace::buildArriveTree()
+{
+    m_treeLeaves = 1;
+    while (m_treeLeaves < m_chunks.size()) m_treeLeaves *= 2;
+    m_arriveTree.fill(std::numeric_limits<qint64>::min(), m_treeLeaves * 2);
+    for (int i = 0; i < m_chunks.size(); ++i) {
+        m_arriveTree[m_treeLeaves + i] = m_chunks[i].maxArrive;
+    }
+    for (int node = m_treeLeaves - 1; node >= 1; --node) {
+        m_arriveTree[node] = std::max(m_arriveTree[node * 2], m_arriveTree[node * 2 + 1]);
+    }
+    m_lastTick = m_chunks.isEmpty() ? 0 : m_arriveTree[1];
+}
+
+QVector<int> BusTrace::chunksInFlight(qint64 tick, int last) const
+{
+    QVector<int> chunks;
+    if (last >= 0 && !m_chunks.isEmpty()) {
+        collectInFlight(1, 0, m_treeLeaves - 1, tick, std::min(last, m_chunks.size() - 1), chunks);
+    }
+    return chunks;
+}
+
+void BusTrace::collectInFlight(int node, int low, int high, qint64 tick, int last, QVector<int> &chunks) const
+{
+    // 子树中所有数据包都已在 tick 之前到达，或整段都在 last 之后时剪枝
+    if (low > last || m_arriveTree[node] <= tick) return;
+    if (low == high) {
+        chunks.append(low);
+        return;
+    }
+    const int middle = (low + high) / 2;
+    collectInFlight(node * 2, low, middle, tick, last, chunks);
+    collectInFlight(node * 2 + 1, middle + 1, high, tick, last, chunks);
+}
+
+int BusTrace::lastChunkInjectedBy(qint64 tick) const
+{
+    auto it = std::partition_point(m_chunks.begin(), m_chunks.end(),
+                                   [tick](const Chunk &chunk) { return chunk.firstInject <= tick; });
+    return int(it - m_chunks.begin()) - 1;
+}
+
+bool BusTrace::readChunk(int index, QVector<Packet> &packets)
+{
+    packets.clear();
+    if (index < 0 || index >= m_chunks.size()) return true;
+
+    if (!m_file.isOpen()) {
+        m_file.setFileName(m_fileName);
+        if (!m_file.open(QIODevice::ReadOnly)) {
+            m_error = "Cannot open trace file: " + m_fileName;
+            return false;
+        }
+    }
+
+    const Chunk &chunk = m_chunks[index];
+    QByteArray data;
+    if (m_file.seek(chunk.offset)) {
+        data = m_file.read(chunk.size);
+    }
+    if (data.size() != chunk.size) {
+        m_error = "Trace file changed or could not be read: " + m_fileName;
+        return false;
+    }
+
+    packets.reserve(chunk.count);
+    const char *p = data.constData();
+    const char *end = p + data.size();
+    while (p < end) {
+        const char *lineEnd = std::find(p, end, '\n');
+        Packet packet;
+        if (parseLine(p, lineEnd, packet) == PACKET) {
+            packets.append(packet);
+        }
+        p = lineEnd + (lineEnd < end ? 1 : 0);
+    }
+    return true;
+}
@@ -0,0 +1,69 @@
+#ifndef BUSTRACE_H
+#define BUSTRACE_H
+
+#include <QString>
+#include <QVector>
+#include <QFile>
+
+// 总线数据包轨迹文件：每行一个数据包 "源端口 目的端口 注入周期 到达周期"（空白或逗号分隔），
+// 按注入周期非递减排序，'#' 开头的行与非数字开头的表头行被忽略。
+// 打开时只建立按时间的分块索引，数据包按块从磁盘读取；
+// 各块的最大到达周期另建一棵最大值线段树，跳转时只需找出在该时刻仍有在途数据包的块
+class BusTrace
+{
+public:
+    struct Packet {
+        int source;
+        int destination;
+        qint64 inject;
+        qint64 arrive;
+    };
+
+    // 索引中的一块：连续 kChunkPackets 个数据包在文件中的字节范围
+    struct Chunk {
+        qint64 offset;
+        qint64 size;
+        qint64 firstInject;
+        qint64 maxArrive;   // 本块数据包的最大到达周期
+        int count;
+    };
+
+    static const int kChunkPackets = 4096;
+
+    BusTrace();
+
+    // 扫描整个文件建立分块索引，可在工作线程中调用
+    bool open(const QString &filename, QString *error = nullptr);
+
+    QString fileName() const { return m_fileName; }
+    qint64 packetCount() const { return m_packetCount; }
+    qint64 firstTick() const { return m_chunks.isEmpty() ? 0 : m_chunks.first().firstInject; }
+    qint64 lastTick() const { return m_lastTick; }
+    int chunkCount() const { return m_chunks.size(); }
+    const Chunk& chunk(int index) const { return m_chunks[index]; }
+
+    // 下标不超过 last 且含有到达周期晚于 tick 的数据包的块，按下标升序；
+    // 耗时为 O(log n + 结果块数)，早期的一个长寿命数据包只会多出它所在的一块
+    QVector<int> chunksInFlight(qint64 tick, int last) const;
+    // 最后一个首包注入周期不晚于 tick 的块，没有时返回-1（二分查找）
+    int lastChunkInjectedBy(qint64 tick) const;
+
+    // 读取一块中的所有数据包，只在调用线程中使用
+    bool readChunk(int index, QVector<Packet> &packets);
+    QString errorString() const { return m_error; }
+
+private:
+    void buildArriveTree();
+    void collectInFlight(int node, int low, int high, qint64 tick, int last, QVector<int> &chunks) const;
+
+    QString m_fileName;
+    QVector<Chunk> m_chunks;
+    QVector<qint64> m_arriveTree;  // 各块 maxArrive 的最大值线段树，叶子从 m_treeLeaves 开始
+    int m_treeLeaves;
+    qint64 m_lastTick;             // 所有数据包的最大到达周期
+    qint64 m_packetCount;
+    QFile m_file;
+    QString m_error;
+};
+
+#endif // BUSTRACE_H
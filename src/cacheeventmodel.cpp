@@ -0,0 +1,183 @@
+#include "cacheeventmodel.h"
+#include "statkeyregistry.h"
+#include <QtMath>
+#include <algorithm>
+
+namespace {
+
+const int kCountSlot = -1;
+const int kTickSlot = -2;
+
+// 把分段按请求路径排序：从 l1 出发，依次衔接上一段的终点
+QVector<CacheEventModel::Segment> orderSegments(QVector<CacheEventModel::Segment> segments)
+{
+    QVector<CacheEventModel::Segment> ordered;
+    QString next = "l1";
+    while (!segments.isEmpty()) {
+        auto it = std::find_if(segments.begin(), segments.end(), [&next](const CacheEventModel::Segment &segment) {
+            return segment.from == next;
+        });
+        if (it == segments.end()) {
+            it = segments.begin();
+        }
+        ordered.append(*it);
+        next = it->to;
+        segments.erase(it);
+    }
+    return ordered;
+}
+
+} // namespace
+
+QString CacheEventModel::Segment::label() const
+{
+    return tokenLabel(from) + "→" + tokenLabel(to);
+}
+
+CacheEventModel::CacheEventModel(QObject *parent)
+    : QObject(parent)
+    , m_module(nullptr)
+{
+}
+
+void CacheEventModel::setModule(HardwareModule* module)
+{
+    if (m_module) {
+        disconnect(m_module, nullptr, this, nullptr);
+    }
+    m_module = module;
+    if (m_module) {
+        connect(m_module, &HardwareModule::statisticChanged, this, &CacheEventModel::onStatisticChanged);
+        connect(m_module, &QObject::destroyed, this, [this]() {
+            m_module = nullptr;
+            parse();
+        });
+    }
+    parse();
+}
+
+QString CacheEventModel::tokenLabel(const QString &token)
+{
+    if (token == "mem") return "Mem";
+    if (token.startsWith('o')) return "o" + token.mid(1).toUpper();
+    return token.toUpper();
+}
+
+void CacheEventModel::onStatisticChanged(int keyId, double oldValue, double newValue)
+{
+    // 统计项新增或删除时重新解析结构
+    if (qIsNaN(oldValue) || qIsNaN(newValue)) {
+        parse();
+        return;
+    }
+
+    auto it = m_slots.constFind(keyId);
+    if (it == m_slots.constEnd()) return;
+
+    EventClass &eventClass = m_classes[it->first];
+    if (it->second == kCountSlot) {
+        eventClass.count = newValue;
+    } else if (it->second == kTickSlot) {
+        eventClass.ticks = newValue;
+    } else {
+        eventClass.segments[it->second].share = newValue;
+    }
+    emit changed();
+}
+
+void CacheEventModel::parse()
+{
+    m_classes.clear();
+    m_slots.clear();
+
+    if (!m_module) {
+        emit changed();
+        return;
+    }
+
+    const StatKeyRegistry &registry = StatKeyRegistry::instance();
+    const auto &values = m_module->statisticValues();
+
+    // 以 xxx_cnt 确定事件类别
+    QHash<QString, int> classIndex;
+    QStringList classNames;
+    for (auto it = values.begin(); it != values.end(); ++it) {
+        QString key = registry.name(it.key());
+        if (key.endsWith("_cnt")) {
+            classNames.append(key.chopped(4));
+        }
+    }
+    std::sort(classNames.begin(), classNames.end());
+    for (const QString &name : classNames) {
+        EventClass eventClass;
+        eventClass.name = name;
+        classIndex.insert(name, m_classes.size());
+        m_classes.append(eventClass);
+    }
+
+    // 分段名称为 <类别>_<起点>_<终点>_avg；部分类别的分段只带公共前缀
+    // （如 l1miss_l2miss_l1_l2_avg 属于 l1miss_l2miss_l3hit），稍后归入没有分段的同前缀类别
+    QVector<QPair<QString, Segment>> unresolved;
+    for (auto it = values.begin(); it != values.end(); ++it) {
+        QString key = registry.name(it.key());
+        if (key.endsWith("_cnt")) {
+            int index = classIndex.value(key.chopped(4));
+            m_classes[index].countKeyId = it.key();
+            m_classes[index].count = it.value();
+        } else if (key.endsWith("_tick")) {
+            auto classIt = classIndex.constFind(key.chopped(5));
+            if (classIt != classIndex.constEnd()) {
+                m_classes[classIt.value()].tickKeyId = it.key();
+                m_classes[classIt.value()].ticks = it.value();
+            }
+        } else if (key.endsWith("_avg")) {
+            QStringList tokens = key.chopped(4).split('_');
+            if (tokens.size() < 3) continue;
+
+            Segment segment;
+            segment.to = tokens.takeLast();
+            segment.from = tokens.takeLast();
+            segment.keyId = it.key();
+            segment.share = it.value();
+
+            QString prefix = tokens.join('_');
+            auto classIt = classIndex.constFind(prefix);
+            if (classIt != classIndex.constEnd()) {
+                m_classes[classIt.value()].segments.append(segment);
+            } else {
+                unresolved.append(qMakePair(prefix, segment));
+            }
+        }
+    }
+
+    QHash<QString, QVector<Segment>> pendingByPrefix;
+    for (const auto &pending : unresolved) {
+        pendingByPrefix[pending.first].append(pending.second);
+    }
+    for (auto it = pendingByPrefix.begin(); it != pendingByPrefix.end(); ++it) {
+        int target = -1;
+        int candidates = 0;
+        for (int i = 0; i < m_classes.size(); ++i) {
+            if (m_classes[i].segments.isEmpty() && m_classes[i].name.startsWith(it.key() + "_")) {
+                target = i;
+                ++candidates;
+            }
+        }
+        if (candidates == 1) {
+            m_classes[target].segments = it.value();
+        }
+    }
+
+    for (int i = 0; i < m_classes.size(); ++i) {
+        EventClass &eventClass = m_classes[i];
+        eventClass.segments = orderSegments(eventClass.segments);
+
+        if (eventClass.countKeyId >= 0) m_slots.insert(eventClass.countKeyId, qMakePair(i, kCountSlot));
+        if (eventClass.tickKeyId >= 0) m_slots.insert(eventClass.tickKeyId, qMakePair(i, kTickSlot));
+        for (int j = 0; j < eventClass.segments.size(); ++j) {
+            m_slots.insert(eventClass.segments[j].keyId, qMakePair(i, j));
+        }
+    }
+
+    emit changed();
+}
@@ -0,0 +1,67 @@
+#ifndef CACHEEVENTMODEL_H
+#define CACHEEVENTMODEL_H
+
+#include <QObject>
+#include <QString>
+#include <QVector>
+#include <QHash>
+#include <QPair>
+#include "hardwaremodule.h"
+
+// cache_event_trace 统计的结构化模型：事件类别 -> 延迟分段 -> 时间占比
+// 统计项名称只在统计项集合变化时解析一次，之后按驻留ID增量更新数值
+class CacheEventModel : public QObject
+{
+    Q_OBJECT
+
+public:
+    // 事件中的一个传输步骤（如 l2_l3 表示 L2 到 L3 的请求）
+    struct Segment {
+        QString from;
+        QString to;
+        int keyId = -1;
+        double share = 0.0;  // 该步骤在这一类事件中消耗的时间比例
+
+        QString name() const { return from + "_" + to; }
+        // 显示名称，如 L2→L3、L3→oL2
+        QString label() const;
+    };
+
+    // 一类缓存事件（如 l1miss_l2miss_l3miss）
+    struct EventClass {
+        QString name;
+        int countKeyId = -1;
+        int tickKeyId = -1;
+        double count = 0.0;
+        double ticks = 0.0;
+        QVector<Segment> segments;  // 按请求路径顺序排列
+
+        double averageLatency() const { return count > 0 ? ticks / count : 0.0; }
+    };
+
+    explicit CacheEventModel(QObject *parent = nullptr);
+
+    // 设置数据来源的缓存事件追踪模块，传入 nullptr 时清空
+    void setModule(HardwareModule* module);
+    HardwareModule* module() const { return m_module; }
+
+    const QVector<EventClass>& eventClasses() const { return m_classes; }
+
+    static QString tokenLabel(const QString &token);
+
+signals:
+    void changed();
+
+private slots:
+    void onStatisticChanged(int keyId, double oldValue, double newValue);
+
+private:
+    void parse();
+
+    HardwareModule* m_module;
+    QVector<EventClass> m_classes;
+    // 统计项ID -> (事件类别下标, 槽位)，槽位 -1 为次数、-2 为周期数、>=0 为分段下标
+    QHash<int, QPair<int, int>> m_slots;
+};
+
+#endif // CACHEEVENTMODEL_H
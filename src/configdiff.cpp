@@ -0,0 +1,31 @@
+#include "configdiff.h"
+#include <QSet>
+
+ConfigDiff ConfigDiff::compute(const QMap<QString, HardwareModule*> &loaded,
+                               const QVector<ModuleSetup> &setups)
+{
+    ConfigDiff diff;
+
+    QSet<QString> names;
+    for (int i = 0; i < setups.size(); ++i) {
+        const ModuleSetup &setup = setups[i];
+        names.insert(setup.name);
+
+        HardwareModule* module = loaded.value(setup.name);
+        if (!module) {
+            diff.added.append(i);
+        } else if (module->type() != setup.type) {
+            diff.removed.append(module);
+            diff.added.append(i);
+        } else {
+            diff.matched.append(qMakePair(module, i));
+        }
+    }
+
+    for (auto it = loaded.constBegin(); it != loaded.constEnd(); ++it) {
+        if (!names.contains(it.key())) {
+            diff.removed.append(it.value());
+        }
+    }
+    return diff;
+}
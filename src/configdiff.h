@@ -0,0 +1,22 @@
+#ifndef CONFIGDIFF_H
+#define CONFIGDIFF_H
+
+#include <QMap>
+#include <QVector>
+#include <QPair>
+#include "hardwaremodule.h"
+#include "setupparser.h"
+
+// 重新加载配置时新旧模块集合的差异：按模块名匹配，只有类型改变的模块重建，
+// 其余同名模块原地更新（SetupParser::applySetup，统计数据由 replaceStatistics 整体替换），
+// 只比较名称与属性，不创建临时模块
+struct ConfigDiff {
+    QVector<HardwareModule*> removed;             // 新配置中不存在或需要重建的模块
+    QVector<int> added;                           // 需要创建的模块在 setups 中的下标
+    QVector<QPair<HardwareModule*, int>> matched; // 原地更新的模块与其在 setups 中的下标
+
+    static ConfigDiff compute(const QMap<QString, HardwareModule*> &loaded,
+                              const QVector<ModuleSetup> &setups);
+};
+
+#endif // CONFIGDIFF_H
@@ -0,0 +1,520 @@
+#include "connectionlayer.h"
+#include "workstealingpool.h"
+#include "memoryaccounting.h"
+#include <QPainter>
+#include <QPen>
+#include <QtMath>
+#include <algorithm>
+#include <cmath>
+#include <limits>
+
+namespace {
+
+const int kEdgeGrain = 512;          // 每个并行分块计算的连接数
+const int kParallelPathEdges = 2048; // 连接数超过该值时按类别并行构建路径
+const int kHitSegments = 16;         // 命中测试时曲线的分段数
+const double kBoundsMargin = 6.0;    // 为画笔宽度与悬停高亮预留的边距
+
+// 流量宽度级别 0 只用于没有数据包的连接；末尾的桶为没有流量统计的连接
+const int kWidthLevels = 6;
+const int kOpacityLevels = 4;
+const int kBucketsPerStyle = kWidthLevels * kOpacityLevels + 1;
+const double kMinWidth = 1.0;
+const double kMaxWidth = 6.0;
+const double kBaseWidth = 1.5;
+const double kPacketUnit = 1.0;      // 数据包数的对数刻度单位
+const double kBusyUnit = 1e-3;       // 使用率的对数刻度单位（0.1%）
+
+// 对数归一化到 [0, 1]：log(1 + v/unit) / log(1 + max/unit)
+double logScale(double value, double max, double unit)
+{
+    if (value <= 0 || max <= 0) return 0.0;
+    return qMin(1.0, std::log1p(value / unit) / std::log1p(max / unit));
+}
+
+double inverseLogScale(double t, double max, double unit)
+{
+    return unit * std::expm1(t * std::log1p(max / unit));
+}
+
+// 连接在其类别内的桶下标
+int trafficBucket(const BusTopology::LinkTraffic &traffic, double maxPackets, double maxBusyRate)
+{
+    if (!traffic.known) return kBucketsPerStyle - 1;
+
+    double packets = traffic.forward + traffic.backward;
+    double packetScale = logScale(packets, maxPackets, kPacketUnit);
+    int width = packets > 0 ? 1 + qRound(packetScale * (kWidthLevels - 2)) : 0;
+
+    // 没有使用率统计时透明度跟随流量
+    double busyScale = traffic.busyRate >= 0 ? logScale(traffic.busyRate, maxBusyRate, kBusyUnit) : packetScale;
+    int opacity = qRound(busyScale * (kOpacityLevels - 1));
+    return width * kOpacityLevels + opacity;
+}
+
+double distanceToSegment(const QPointF &point, const QPointF &a, const QPointF &b)
+{
+    QPointF ab = b - a;
+    double lengthSquared = QPointF::dotProduct(ab, ab);
+    double t = lengthSquared > 0 ? QPointF::dotProduct(point - a, ab) / lengthSquared : 0.0;
+    t = qBound(0.0, t, 1.0);
+    QPointF nearest = a + ab * t;
+    return QLineF(point, nearest).length();
+}
+
+} // namespace
+
+ConnectionLayer::ConnectionLayer()
+    : m_hovered(-1)
+    , m_maxPackets(0)
+    , m_maxBusyRate(0)
+    , m_flowAnimated(false)
+    , m_flowPhase(0)
+    , m_cellSize(0)
+    , m_gridColumns(0)
+    , m_gridRows(0)
+{
+    setZValue(-1);
+    setAcceptedMouseButtons(Qt::NoButton);
+
+    // 每个桶的画笔只与桶下标有关，绘制时直接查表
+    const auto &list = styles();
+    m_pens.resize(list.size() * kBucketsPerStyle);
+    m_flowSpeeds.fill(0.0, m_pens.size());
+    for (int style = 0; style < list.size(); ++style) {
+        const int base = style * kBucketsPerStyle;
+        for (int width = 0; width < kWidthLevels; ++width) {
+            for (int opacity = 0; opacity < kOpacityLevels; ++opacity) {
+                QColor color = list[style].color;
+                color.setAlphaF(0.25 + 0.75 * opacity / (kOpacityLevels - 1));
+                double penWidth = kMinWidth + (kMaxWidth - kMinWidth) * width / (kWidthLevels - 1);
+                m_pens[base + width * kOpacityLevels + opacity] = QPen(color, penWidth, Qt::SolidLine, Qt::RoundCap);
+                m_flowSpeeds[base + width * kOpacityLevels + opacity] = width > 0 ? 0.5 + double(width) / (kWidthLevels - 1) : 0.0;
+            }
+        }
+        m_pens[base + kBucketsPerStyle - 1] = QPen(list[style].color, kBaseWidth);
+    }
+}
+
+const QVector<ConnectionLayer::Style>& ConnectionLayer::styles()
+{
+    // 下标即 styleOf 返回的类别
+    static const QVector<Style> list = {
+        {QColor(220, 20, 60), 0.1},    // CPU - L2
+        {QColor(0, 128, 0), 0.15},     // L2 - L3
+        {QColor(70, 130, 180), 0.25},  // L3 - 总线
+        {QColor(255, 140, 0), 0.2},    // 总线 - 内存
+        {QColor(138, 43, 226), 0.2},   // 总线 - DMA
+        {QColor(30, 144, 255), 0.2},   // L3 - L3
+        {QColor(105, 105, 105), 0.2},  // 其它
+    };
+    return list;
+}
+
+int ConnectionLayer::styleOf(HardwareModule::ModuleType a, HardwareModule::ModuleType b)
+{
+    static const int typeCount = HardwareModule::CACHE_EVENT_TRACER + 1;
+    static const QVector<int> table = []() {
+        QVector<int> result(typeCount * typeCount, 6);
+        auto set = [&result](HardwareModule::ModuleType x, HardwareModule::ModuleType y, int style) {
+            result[x * typeCount + y] = style;
+            result[y * typeCount + x] = style;
+        };
+        set(HardwareModule::CPU_CORE, HardwareModule::CACHE_L2, 0);
+        set(HardwareModule::CACHE_L2, HardwareModule::CACHE_L3, 1);
+        set(HardwareModule::CACHE_L3, HardwareModule::BUS, 2);
+        set(HardwareModule::BUS, HardwareModule::MEMORY_CTRL, 3);
+        set(HardwareModule::BUS, HardwareModule::DMA, 4);
+        set(HardwareModule::CACHE_L3, HardwareModule::CACHE_L3, 5);
+        return result;
+    }();
+    return table[a * typeCount + b];
+}
+
+QPointF ConnectionLayer::connectionPoint(const QPointF &pos, const QPointF &otherPos)
+{
+    QPointF center(pos.x() + 75, pos.y() + 50);
+
+    if (otherPos.x() > pos.x()) {
+        return QPointF(pos.x() + 150, center.y());
+    } else if (otherPos.x() < pos.x()) {
+        return QPointF(pos.x(), center.y());
+    } else if (otherPos.y() > pos.y()) {
+        return QPointF(center.x(), pos.y() + 100);
+    } else {
+        return QPointF(center.x(), pos.y());
+    }
+}
+
+ConnectionLayer::Edge ConnectionLayer::computeEdge(const EdgeInput &input)
+{
+    Edge edge;
+    edge.from = input.from;
+    edge.to = input.to;
+    edge.start = connectionPoint(input.fromPos, input.toPos);
+    edge.end = connectionPoint(input.toPos, input.fromPos);
+    edge.style = styleOf(input.from->type(), input.to->type());
+    edge.traffic = input.traffic;
+    edge.bucket = edge.style * kBucketsPerStyle + kBucketsPerStyle - 1;
+
+    // 控制点沿连线法向偏移，偏移量按类别的曲率与连线长度缩放
+    QPointF midPoint = (edge.start + edge.end) / 2;
+    QPointF dir = edge.end - edge.start;
+    double length = QLineF(edge.start, edge.end).length();
+    edge.control = midPoint;
+    if (length > 0) {
+        QPointF normal(-dir.y() / length, dir.x() / length);
+        edge.control += normal * (length * styles()[edge.style].curvature);
+    }
+
+    // 二次曲线位于三个点的凸包内
+    double left = std::min({edge.start.x(), edge.control.x(), edge.end.x()});
+    double right = std::max({edge.start.x(), edge.control.x(), edge.end.x()});
+    double top = std::min({edge.start.y(), edge.control.y(), edge.end.y()});
+    double bottom = std::max({edge.start.y(), edge.control.y(), edge.end.y()});
+    edge.bounds = QRectF(QPointF(left, top), QPointF(right, bottom));
+    return edge;
+}
+
+void ConnectionLayer::setEdges(const QVector<EdgeInput> &inputs)
+{
+    prepareGeometryChange();
+    m_hovered = -1;
+
+    const int count = inputs.size();
+    m_edges.resize(count);
+    Edge *edges = m_edges.data();
+    WorkStealingPool &pool = WorkStealingPool::shared();
+    pool.parallelFor(count, kEdgeGrain, [edges, &inputs](int begin, int end) {
+        for (int i = begin; i < end; ++i) {
+            edges[i] = computeEdge(inputs[i]);
+        }
+    });
+
+    updateTrafficStyles();
+
+    m_bounds = QRectF();
+    for (const Edge &edge : m_edges) {
+        m_bounds |= edge.bounds;
+    }
+    m_bounds.adjust(-kBoundsMargin, -kBoundsMargin, kBoundsMargin, kBoundsMargin);
+
+    rebuildIndex();
+    update();
+}
+
+void ConnectionLayer::setTraffic(const QVector<BusTopology::LinkTraffic> &traffic)
+{
+    if (traffic.size() != m_edges.size()) return;
+
+    for (int i = 0; i < m_edges.size(); ++i) {
+        m_edges[i].traffic = traffic[i];
+    }
+    updateTrafficStyles();
+    update();
+}
+
+void ConnectionLayer::updateTrafficStyles()
+{
+    // 归一化范围为本次运行所有连接的最大值
+    m_maxPackets = 0;
+    m_maxBusyRate = 0;
+    for (const Edge &edge : m_edges) {
+        if (!edge.traffic.known) continue;
+        m_maxPackets = qMax(m_maxPackets, edge.traffic.forward + edge.traffic.backward);
+        m_maxBusyRate = qMax(m_maxBusyRate, edge.traffic.busyRate);
+    }
+
+    const int count = m_edges.size();
+    const double maxPackets = m_maxPackets;
+    const double maxBusyRate = m_maxBusyRate;
+    Edge *edges = m_edges.data();
+    WorkStealingPool &pool = WorkStealingPool::shared();
+    pool.parallelFor(count, kEdgeGrain, [edges, maxPackets, maxBusyRate](int begin, int end) {
+        for (int i = begin; i < end; ++i) {
+            edges[i].bucket = edges[i].style * kBucketsPerStyle
+                              + trafficBucket(edges[i].traffic, maxPackets, maxBusyRate);
+        }
+    });
+
+    // 每个桶合并为一条路径，绘制时每个桶只设置一次画笔；曲线沿主要流向，供动画虚线使用
+    const int styleCount = styles().size();
+    m_paths = QVector<QPainterPath>(m_pens.size());
+    QPainterPath *paths = m_paths.data();
+    auto buildPaths = [this, paths](int begin, int end) {
+        for (const Edge &edge : m_edges) {
+            if (edge.style < begin || edge.style >= end) continue;
+
+            QPainterPath &path = paths[edge.bucket];
+            if (edge.traffic.backward > edge.traffic.forward) {
+                path.moveTo(edge.end);
+                path.quadTo(edge.control, edge.start);
+            } else {
+                path.moveTo(edge.start);
+                path.quadTo(edge.control, edge.end);
+            }
+        }
+    };
+    if (count >= kParallelPathEdges) {
+        pool.parallelFor(styleCount, 1, buildPaths);
+    } else {
+        buildPaths(0, styleCount);
+    }
+
+    rebuildLegend();
+}
+
+void ConnectionLayer::rebuildLegend()
+{
+    if (m_maxPackets <= 0) {
+        m_legend = QImage();
+        return;
+    }
+
+    const int padding = 8;
+    const int rowHeight = 16;
+    const int sampleWidth = 36;
+    const int width = 200;
+    const bool hasBusy = m_maxBusyRate > 0;
+    int rows = 1 + (kWidthLevels - 1);
+    if (hasBusy) rows += 1 + kOpacityLevels;
+    if (m_flowAnimated) rows += 1;
+
+    m_legend = QImage(width, rows * rowHeight + 2 * padding, QImage::Format_ARGB32_Premultiplied);
+    m_legend.fill(Qt::transparent);
+
+    QPainter painter(&m_legend);
+    painter.setRenderHint(QPainter::Antialiasing);
+    painter.setPen(Qt::NoPen);
+    painter.setBrush(QColor(20, 20, 22, 200));
+    painter.drawRoundedRect(m_legend.rect(), 6, 6);
+
+    QFont font = painter.font();
+    font.setPointSize(8);
+    painter.setFont(font);
+    const QColor textColor(230, 230, 230);
+    const QColor sampleColor(200, 200, 200);
+    int y = padding;
+
+    auto title = [&](const QString &text) {
+        painter.setPen(textColor);
+        painter.drawText(QRect(padding, y, width - 2 * padding, rowHeight), Qt::AlignVCenter, text);
+        y += rowHeight;
+    };
+    auto label = [&](const QString &text) {
+        painter.setPen(textColor);
+        painter.drawText(QRect(padding + sampleWidth + 8, y, width - sampleWidth - 3 * padding, rowHeight),
+                         Qt::AlignVCenter, text);
+        y += rowHeight;
+    };
+
+    // 宽度级别 w 对应的对数刻度中点
+    title("连接流量（数据包，对数刻度）");
+    for (int level = 1; level < kWidthLevels; ++level) {
+        double t = double(level - 1) / (kWidthLevels - 2);
+        double packets = qMax(1.0, inverseLogScale(t, m_maxPackets, kPacketUnit));
+        double penWidth = kMinWidth + (kMaxWidth - kMinWidth) * level / (kWidthLevels - 1);
+        painter.setPen(QPen(sampleColor, penWidth, Qt::SolidLine, Qt::RoundCap));
+        painter.drawLine(QPointF(padding + 4, y + rowHeight / 2.0), QPointF(padding + sampleWidth - 4, y + rowHeight / 2.0));
+        label(QString::number(packets, 'f', 0));
+    }
+
+    if (hasBusy) {
+        title("使用率（透明度，对数刻度）");
+        for (int level = 0; level < kOpacityLevels; ++level) {
+            double t = double(level) / (kOpacityLevels - 1);
+            double rate = inverseLogScale(t, m_maxBusyRate, kBusyUnit);
+            QColor color = sampleColor;
+            color.setAlphaF(0.25 + 0.75 * t);
+            painter.setPen(QPen(color, 4.0, Qt::SolidLine, Qt::RoundCap));
+            painter.drawLine(QPointF(padding + 4, y + rowHeight / 2.0), QPointF(padding + sampleWidth - 4, y + rowHeight / 2.0));
+            label(QString("%1%").arg(rate * 100, 0, 'f', 2));
+        }
+    }
+
+    if (m_flowAnimated) {
+        title("虚线移动方向为主要流向");
+    }
+}
+
+void ConnectionLayer::setFlowAnimated(bool animated)
+{
+    if (m_flowAnimated == animated) return;
+
+    m_flowAnimated = animated;
+    rebuildLegend();
+    update();
+}
+
+void ConnectionLayer::advanceFlow(double distance)
+{
+    m_flowPhase += distance;
+    update();
+}
+
+void ConnectionLayer::clear()
+{
+    prepareGeometryChange();
+    m_edges.clear();
+    m_paths.clear();
+    m_cells.clear();
+    m_bounds = QRectF();
+    m_hovered = -1;
+    m_maxPackets = 0;
+    m_maxBusyRate = 0;
+    m_legend = QImage();
+    m_gridColumns = 0;
+    m_gridRows = 0;
+    update();
+}
+
+void ConnectionLayer::rebuildIndex()
+{
+    m_cells.clear();
+    if (m_edges.isEmpty()) {
+        m_gridColumns = 0;
+        m_gridRows = 0;
+        return;
+    }
+
+    // 网格不超过 128 × 128 格
+    m_gridRect = m_bounds;
+    m_cellSize = std::max(50.0, std::max(m_gridRect.width(), m_gridRect.height()) / 128);
+    m_gridColumns = qCeil(m_gridRect.width() / m_cellSize) + 1;
+    m_gridRows = qCeil(m_gridRect.height() / m_cellSize) + 1;
+    m_cells.resize(m_gridColumns * m_gridRows);
+
+    for (int i = 0; i < m_edges.size(); ++i) {
+        const QRectF &bounds = m_edges[i].bounds;
+        int left = int((bounds.left() - m_gridRect.left()) / m_cellSize);
+        int right = int((bounds.right() - m_gridRect.left()) / m_cellSize);
+        int top = int((bounds.top() - m_gridRect.top()) / m_cellSize);
+        int bottom = int((bounds.bottom() - m_gridRect.top()) / m_cellSize);
+        for (int row = top; row <= bottom; ++row) {
+            for (int column = left; column <= right; ++column) {
+                m_cells[row * m_gridColumns + column].append(i);
+            }
+        }
+    }
+}
+
+double ConnectionLayer::distanceTo(const Edge &edge, const QPointF &point)
+{
+    double best = std::numeric_limits<double>::max();
+    QPointF previous = edge.start;
+    for (int i = 1; i <= kHitSegments; ++i) {
+        double t = double(i) / kHitSegments;
+        double u = 1.0 - t;
+        QPointF current = edge.start * (u * u) + edge.control * (2 * u * t) + edge.end * (t * t);
+        best = std::min(best, distanceToSegment(point, previous, current));
+        previous = current;
+    }
+    return best;
+}
+
+int ConnectionLayer::edgeAt(const QPointF &scenePos, double tolerance) const
+{
+    if (m_cells.isEmpty()) return -1;
+
+    QPointF pos = mapFromScene(scenePos);
+    int left = qMax(0, int((pos.x() - tolerance - m_gridRect.left()) / m_cellSize));
+    int right = qMin(m_gridColumns - 1, int((pos.x() + tolerance - m_gridRect.left()) / m_cellSize));
+    int top = qMax(0, int((pos.y() - tolerance - m_gridRect.top()) / m_cellSize));
+    int bottom = qMin(m_gridRows - 1, int((pos.y() + tolerance - m_gridRect.top()) / m_cellSize));
+
+    int nearest = -1;
+    double nearestDistance = tolerance;
+    for (int row = top; row <= bottom; ++row) {
+        for (int column = left; column <= right; ++column) {
+            for (int index : m_cells[row * m_gridColumns + column]) {
+                const Edge &edge = m_edges[index];
+                if (!edge.bounds.adjusted(-tolerance, -tolerance, tolerance, tolerance).contains(pos)) continue;
+
+                double distance = distanceTo(edge, pos);
+                if (distance <= nearestDistance) {
+                    nearestDistance = distance;
+                    nearest = index;
+                }
+            }
+        }
+    }
+    return nearest;
+}
+
+void ConnectionLayer::setHoveredEdge(int index)
+{
+    if (index == m_hovered) return;
+
+    if (m_hovered >= 0 && m_hovered < m_edges.size()) {
+        update(m_edges[m_hovered].bounds.adjusted(-kBoundsMargin, -kBoundsMargin, kBoundsMargin, kBoundsMargin));
+    }
+    m_hovered = index;
+    if (m_hovered >= 0) {
+        update(m_edges[m_hovered].bounds.adjusted(-kBoundsMargin, -kBoundsMargin, kBoundsMargin, kBoundsMargin));
+    }
+}
+
+QRectF ConnectionLayer::boundingRect() const
+{
+    return m_bounds;
+}
+
+QPainterPath ConnectionLayer::shape() const
+{
+    return QPainterPath();
+}
+
+void ConnectionLayer::paint(QPainter *painter, const QStyleOptionGraphicsItem *option, QWidget *widget)
+{
+    Q_UNUSED(option);
+    Q_UNUSED(widget);
+
+    painter->setBrush(Qt::NoBrush);
+    for (int bucket = 0; bucket < m_paths.size(); ++bucket) {
+        if (m_paths[bucket].isEmpty()) continue;
+        painter->setPen(m_pens[bucket]);
+        painter->drawPath(m_paths[bucket]);
+    }
+
+    // 虚线沿路径方向移动，偏移量以画笔宽度为单位
+    if (m_flowAnimated) {
+        for (int bucket = 0; bucket < m_paths.size(); ++bucket) {
+            if (m_flowSpeeds[bucket] <= 0 || m_paths[bucket].isEmpty()) continue;
+            QPen pen(QColor(255, 255, 255, 180), qMax(1.0, m_pens[bucket].widthF() * 0.4), Qt::CustomDashLine, Qt::FlatCap);
+            pen.setDashPattern({3, 5});
+            pen.setDashOffset(-m_flowPhase * m_flowSpeeds[bucket] / pen.widthF());
+            painter->setPen(pen);
+            painter->drawPath(m_paths[bucket]);
+        }
+    }
+
+    if (m_hovered >= 0) {
+        const Edge &edge = m_edges[m_hovered];
+        QPainterPath path(edge.start);
+        path.quadTo(edge.control, edge.end);
+        QColor color = styles()[edge.style].color.lighter(160);
+        painter->setPen(QPen(color, m_pens[edge.bucket].widthF() + 2.0, Qt::SolidLine, Qt::RoundCap));
+        painter->drawPath(path);
+    }
+}
+
+void ConnectionLayer::accountMemory(MemoryAccounting &accounting) const
+{
+    qint64 pathBytes = MemoryAccounting::vectorBytes(m_paths) + MemoryAccounting::vectorBytes(m_pens)
+                     + MemoryAccounting::vectorBytes(m_flowSpeeds);
+    for (const QPainterPath &path : m_paths) {
+        pathBytes += MemoryAccounting::kArrayHeaderBytes + path.elementCount() * qint64(sizeof(QPainterPath::Element));
+    }
+    qint64 indexBytes = MemoryAccounting::vectorBytes(m_cells);
+    for (const auto &cell : m_cells) {
+        indexBytes += MemoryAccounting::vectorBytes(cell) - qint64(sizeof(cell));
+    }
+    accounting.add(MemoryAccounting::GRAPHICS_ITEMS, "connection edges", m_edges.size(),
+                   MemoryAccounting::vectorBytes(m_edges));
+    accounting.add(MemoryAccounting::GRAPHICS_ITEMS, "connection paths", m_paths.size(), pathBytes);
+    accounting.add(MemoryAccounting::GRAPHICS_ITEMS, "connection grid index", m_cells.size(), indexBytes);
+    if (!m_legend.isNull()) {
+        accounting.add(MemoryAccounting::PIXMAPS, "connection legend", 1, m_legend.sizeInBytes());
+    }
+}
+
@@ -0,0 +1,117 @@
+#ifndef CONNECTIONLAYER_H
+#define CONNECTIONLAYER_H
+
+#include <QGraphicsItem>
+#include <QPainterPath>
+#include <QVector>
+#include <QColor>
+#include <QPen>
+#include <QImage>
+#include "hardwaremodule.h"
+#include "bustopology.h"
+
+class MemoryAccounting;
+
+// 所有连接线的单个图形项：几何在工作线程中并行计算，
+// 连接按（类别, 流量宽度级别, 使用率透明度级别）分桶，每桶合并为一条路径一次绘制，
+// 并提供按位置查找连接的空间索引
+class ConnectionLayer : public QGraphicsItem
+{
+public:
+    enum { Type = UserType + 1 };
+
+    // 一条连接的输入：两端模块（折叠时为分组的代表模块）与两端图形项的位置
+    struct EdgeInput {
+        HardwareModule* from;
+        HardwareModule* to;
+        QPointF fromPos;
+        QPointF toPos;
+        BusTopology::LinkTraffic traffic;
+    };
+
+    // 预先计算的连接几何：二次曲线的起点、控制点与终点
+    struct Edge {
+        HardwareModule* from;
+        HardwareModule* to;
+        QPointF start;
+        QPointF control;
+        QPointF end;
+        int style;
+        QRectF bounds;
+        BusTopology::LinkTraffic traffic;
+        int bucket;  // 所在的绘制桶，每次流量更新时重新计算
+    };
+
+    ConnectionLayer();
+
+    void setEdges(const QVector<EdgeInput> &inputs);
+    // 按下标更新每条连接的流量（与 setEdges 的顺序一致），几何不变
+    void setTraffic(const QVector<BusTopology::LinkTraffic> &traffic);
+    void clear();
+
+    // 流量动画：有流量的连接上叠加沿主要流向移动的虚线
+    void setFlowAnimated(bool animated);
+    bool isFlowAnimated() const { return m_flowAnimated; }
+    // 动画前进 distance 个场景单位（流量越大的连接移动越快）
+    void advanceFlow(double distance);
+
+    // 流量宽度与使用率透明度的图例，没有流量统计时为空图像
+    const QImage& legend() const { return m_legend; }
+
+    int edgeCount() const { return m_edges.size(); }
+    const Edge& edge(int index) const { return m_edges[index]; }
+    // 距离 scenePos 不超过 tolerance 的最近连接，没有时返回-1
+    int edgeAt(const QPointF &scenePos, double tolerance) const;
+    // 悬停高亮的连接，-1 表示无
+    void setHoveredEdge(int index);
+    int hoveredEdge() const { return m_hovered; }
+
+    // 模块图形项的连接点：朝向另一端的一侧边的中点
+    static QPointF connectionPoint(const QPointF &pos, const QPointF &otherPos);
+
+    // 上报连接几何、绘制路径、空间索引与图例占用的内存
+    void accountMemory(MemoryAccounting &accounting) const;
+
+    int type() const override { return Type; }
+    QRectF boundingRect() const override;
+    // 返回空路径，不拦截对模块的点击与框选
+    QPainterPath shape() const override;
+    void paint(QPainter *painter, const QStyleOptionGraphicsItem *option, QWidget *widget) override;
+
+private:
+    struct Style {
+        QColor color;
+        double curvature;
+    };
+
+    static const QVector<Style>& styles();
+    static int styleOf(HardwareModule::ModuleType a, HardwareModule::ModuleType b);
+    static Edge computeEdge(const EdgeInput &input);
+    static double distanceTo(const Edge &edge, const QPointF &point);
+
+    // 按当前流量的对数归一化结果重新分桶，预先计算每桶的画笔、路径与图例
+    void updateTrafficStyles();
+    void rebuildLegend();
+    void rebuildIndex();
+
+    QVector<Edge> m_edges;
+    QVector<QPainterPath> m_paths;   // 每个绘制桶一条合并路径，方向为主要流向
+    QVector<QPen> m_pens;            // 每个绘制桶的画笔
+    QVector<double> m_flowSpeeds;    // 每个绘制桶的动画速度系数，0 表示不动画
+    QRectF m_bounds;
+    int m_hovered;
+    double m_maxPackets;             // 本次运行所有连接的最大数据包数
+    double m_maxBusyRate;            // 本次运行所有连接的最大使用率
+    bool m_flowAnimated;
+    double m_flowPhase;
+    QImage m_legend;
+
+    // 均匀网格空间索引：格子 -> 经过该格子的连接
+    QRectF m_gridRect;
+    double m_cellSize;
+    int m_gridColumns;
+    int m_gridRows;
+    QVector<QVector<int>> m_cells;
+};
+
+#endif // CONNECTIONLAYER_H
@@ -1,4 +1,8 @@
 #include "hardwaremodule.h"
+#include "statkeyregistry.h"
+#include "memoryaccounting.h"
+#include <QSet>
+#include <QtNumeric>
 
 HardwareModule::HardwareModule(ModuleType type, const QString &name, QObject *parent)
     : QObject(parent)
@@ -43,13 +47,24 @@ void HardwareModule::setL3CacheConfig(const CacheConfig &l3,
 }
 
 void HardwareModule::setStatistic(const QString &key, double value)
+{
+    if (updateStatistic(StatKeyRegistry::instance().intern(key), key, value)) {
+        emit statisticsChanged();
+    }
+}
+
+void HardwareModule::setStatistic(int keyId, double value)
+{
+    if (updateStatistic(keyId, StatKeyRegistry::instance().name(keyId), value)) {
+        emit statisticsChanged();
+    }
+}
+
+void HardwareModule::setStatistics(const QVector<QPair<int, double>> &values)
 {
     bool changed = false;
-    auto it = m_statistics.find(key);
-    
-    if (it == m_statistics.end() || it.value() != value) {
-        m_statistics[key] = value;
-        changed = true;
+    for (const auto &entry : values) {
+        changed |= updateStatistic(entry.first, StatKeyRegistry::instance().name(entry.first), entry.second);
     }
     
     if (changed) {
@@ -57,8 +72,141 @@ void HardwareModule::setStatistic(const QString &key, double value)
     }
 }
 
+void HardwareModule::replaceStatistics(const QVector<QPair<int, double>> &values)
+{
+    // 先找出要删除的统计项，发出通知时不再遍历 m_statValues
+    QSet<int> keep;
+    keep.reserve(values.size());
+    for (const auto &entry : values) {
+        keep.insert(entry.first);
+    }
+    QVector<int> removed;
+    for (auto it = m_statValues.constBegin(); it != m_statValues.constEnd(); ++it) {
+        if (!keep.contains(it.key())) {
+            removed.append(it.key());
+        }
+    }
+
+    for (int keyId : removed) {
+        const double oldValue = m_statValues.take(keyId);
+        m_statistics.remove(StatKeyRegistry::instance().name(keyId));
+        emit statisticChanged(keyId, oldValue, qQNaN());
+    }
+
+    bool changed = !removed.isEmpty();
+    for (const auto &entry : values) {
+        changed |= updateStatistic(entry.first, StatKeyRegistry::instance().name(entry.first), entry.second);
+    }
+
+    if (changed) {
+        emit statisticsChanged();
+    }
+}
+
+void HardwareModule::setHistograms(const QVector<QPair<int, StatisticHistogram>> &histograms)
+{
+    if (mergeHistograms(histograms)) {
+        emit histogramsChanged();
+    }
+}
+
+void HardwareModule::replaceHistograms(const QVector<QPair<int, StatisticHistogram>> &histograms)
+{
+    QSet<int> keep;
+    keep.reserve(histograms.size());
+    for (const auto &entry : histograms) {
+        keep.insert(entry.first);
+    }
+
+    bool changed = false;
+    for (auto it = m_histograms.begin(); it != m_histograms.end();) {
+        if (keep.contains(it.key())) {
+            ++it;
+        } else {
+            it = m_histograms.erase(it);
+            changed = true;
+        }
+    }
+
+    if (mergeHistograms(histograms) || changed) {
+        emit histogramsChanged();
+    }
+}
+
+bool HardwareModule::mergeHistograms(const QVector<QPair<int, StatisticHistogram>> &histograms)
+{
+    bool changed = false;
+    for (const auto &entry : histograms) {
+        auto it = m_histograms.find(entry.first);
+        if (it == m_histograms.end()) {
+            m_histograms.insert(entry.first, entry.second);
+            changed = true;
+        } else if (it.value() != entry.second) {
+            it.value() = entry.second;
+            changed = true;
+        }
+    }
+    return changed;
+}
+
+const StatisticHistogram* HardwareModule::histogram(int keyId) const
+{
+    auto it = m_histograms.constFind(keyId);
+    return it != m_histograms.constEnd() ? &it.value() : nullptr;
+}
+
+bool HardwareModule::updateStatistic(int keyId, const QString &key, double value)
+{
+    double oldValue = qQNaN();
+    auto it = m_statValues.find(keyId);
+    
+    if (it != m_statValues.end()) {
+        if (it.value() == value) {
+            return false;
+        }
+        oldValue = it.value();
+        it.value() = value;
+    } else {
+        m_statValues.insert(keyId, value);
+    }
+    
+    m_statistics[key] = value;
+    emit statisticChanged(keyId, oldValue, value);
+    return true;
+}
+
 double HardwareModule::statistic(const QString &key) const
 {
     auto it = m_statistics.find(key);
     return it != m_statistics.end() ? it.value() : 0.0;
-} 
\ No newline at end of file
+}
+
+void HardwareModule::accountMemory(MemoryAccounting &accounting) const
+{
+    // 键字符串可能与驻留表共享，按未共享计入，结果偏大
+    qint64 keyBytes = 0;
+    for (auto it = m_statistics.constBegin(); it != m_statistics.constEnd(); ++it) {
+        keyBytes += MemoryAccounting::stringBytes(it.key()) - qint64(sizeof(QString));
+    }
+    accounting.add(MemoryAccounting::MODULE_STATISTICS, "QMap<QString, double>",
+                   m_statistics.size(), MemoryAccounting::mapBytes(m_statistics) + keyBytes);
+    accounting.add(MemoryAccounting::MODULE_STATISTICS, "QHash<int, double>",
+                   m_statValues.size(), MemoryAccounting::hashBytes(m_statValues));
+
+    qint64 histogramBytes = MemoryAccounting::hashBytes(m_histograms);
+    for (const auto &histogram : m_histograms) {
+        histogramBytes += MemoryAccounting::kArrayHeaderBytes + histogram.bucketCount() * qint64(sizeof(quint64));
+    }
+    accounting.add(MemoryAccounting::MODULE_HISTOGRAMS, "StatisticHistogram", m_histograms.size(), histogramBytes);
+
+    accounting.add(MemoryAccounting::MODULE_CONFIG, "HardwareModule", 1,
+                   sizeof(HardwareModule) + MemoryAccounting::kObjectBytes
+                   + MemoryAccounting::stringBytes(m_name) + MemoryAccounting::stringBytes(m_busName)
+                   + MemoryAccounting::stringBytes(m_clusterName) - 3 * qint64(sizeof(QString)));
+    if (m_type == BUS) {
+        accounting.add(MemoryAccounting::MODULE_CONFIG, "bus port map", m_busPortToNodeMap.size(),
+                       MemoryAccounting::mapBytes(m_busPortToNodeMap) - qint64(sizeof(m_busPortToNodeMap)));
+        accounting.add(MemoryAccounting::MODULE_CONFIG, "bus edges", m_busEdges.size(),
+                       MemoryAccounting::vectorBytes(m_busEdges) - qint64(sizeof(m_busEdges)));
+    }
+}
@@ -5,7 +5,11 @@
 #include <QString>
 #include <QPointF>
 #include <QMap>
+#include <QHash>
 #include <QVector>
+#include "statistichistogram.h"
+
+class MemoryAccounting;
 
 class HardwareModule : public QObject
 {
@@ -41,6 +45,12 @@ public:
     // 设置和获取端口ID
     void setPortId(int id) { m_portId = id; }
     int portId() const { return m_portId; }
+    // 端口所属的总线名称，为空时表示连接到第一条总线
+    void setBusName(const QString &name) { m_busName = name; }
+    QString busName() const { return m_busName; }
+    // 核心所属的簇名称，为空时按编号与 NUCA 分片推断
+    void setClusterName(const QString &name) { m_clusterName = name; }
+    QString clusterName() const { return m_clusterName; }
 
     // 总线配置
     void setBusConfig(int portNumber, const QMap<int, int> &portToNodeMap,
@@ -51,11 +61,17 @@ public:
 
     // 缓存配置
     struct CacheConfig {
-        int wayCount;
-        int setCount;
-        int mshrCount;
-        int indexWidth;
-        int indexLatency;
+        int wayCount = 0;
+        int setCount = 0;
+        int mshrCount = 0;
+        int indexWidth = 0;
+        int indexLatency = 0;
+
+        bool operator==(const CacheConfig &other) const {
+            return wayCount == other.wayCount && setCount == other.setCount && mshrCount == other.mshrCount
+                && indexWidth == other.indexWidth && indexLatency == other.indexLatency;
+        }
+        bool operator!=(const CacheConfig &other) const { return !(*this == other); }
     };
 
     void setL2CacheConfig(const CacheConfig &l1i,
@@ -78,21 +94,54 @@ public:
     void setStatistic(const QString &key, double value);
     double statistic(const QString &key) const;
     const QMap<QString, double>& statistics() const { return m_statistics; }
+    // 按驻留ID访问统计数据（ID由 StatKeyRegistry 分配）
+    void setStatistic(int keyId, double value);
+    // 批量更新统计数据，只发出一次 statisticsChanged
+    void setStatistics(const QVector<QPair<int, double>> &values);
+    // 整体替换统计数据：values 中没有的统计项被删除，只发出一次 statisticsChanged
+    void replaceStatistics(const QVector<QPair<int, double>> &values);
+    double statistic(int keyId) const { return m_statValues.value(keyId, 0.0); }
+    bool hasStatistic(int keyId) const { return m_statValues.contains(keyId); }
+    const QHash<int, double>& statisticValues() const { return m_statValues; }
+
+    // 分布型统计项（按驻留ID），整体替换同名直方图
+    void setHistograms(const QVector<QPair<int, StatisticHistogram>> &histograms);
+    // 整体替换所有直方图，histograms 中没有的分布被删除
+    void replaceHistograms(const QVector<QPair<int, StatisticHistogram>> &histograms);
+    const StatisticHistogram* histogram(int keyId) const;
+    const QHash<int, StatisticHistogram>& histograms() const { return m_histograms; }
 
     // 内存控制器配置
     void setMemoryConfig(int dataWidth) { m_memoryDataWidth = dataWidth; }
     int memoryDataWidth() const { return m_memoryDataWidth; }
 
+    // 上报统计项、分布与配置占用的内存
+    void accountMemory(MemoryAccounting &accounting) const;
+
 signals:
     void positionChanged(const QPointF &newPos);
     void statisticsChanged();
+    // 单个统计项变化，首次设置时 oldValue 为 NaN，被删除时 newValue 为 NaN
+    void statisticChanged(int keyId, double oldValue, double newValue);
+    void histogramsChanged();
+    // 重新加载配置时原地更新了缓存、内存、端口或总线配置
+    void configChanged();
 
 private:
+    // 更新单个统计项，值发生变化时返回 true
+    bool updateStatistic(int keyId, const QString &key, double value);
+    // 合并直方图，有变化时返回 true
+    bool mergeHistograms(const QVector<QPair<int, StatisticHistogram>> &histograms);
+
     ModuleType m_type;
     QString m_name;
     QPointF m_position;
     int m_portId;  // 新增：存储端口ID
+    QString m_busName;  // 端口所属总线
+    QString m_clusterName;  // 配置指定的簇
     QMap<QString, double> m_statistics;
+    QHash<int, double> m_statValues;  // 驻留ID到统计值的映射
+    QHash<int, StatisticHistogram> m_histograms;  // 驻留ID到分布的映射
 
     // 总线属性
     int m_busPortNumber;
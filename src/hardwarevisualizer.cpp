@@ -1,4 +1,6 @@
 #include "hardwarevisualizer.h"
+#include "statkeyregistry.h"
+#include "memoryaccounting.h"
 #include <QMouseEvent>
 #include <QWheelEvent>
 #include <QGraphicsRectItem>
@@ -7,7 +9,6 @@
 #include <QPen>
 #include <QColor>
 #include <QGraphicsItemGroup>
-#include <QGraphicsLineItem>
 #include <QFontMetrics>
 #include <QtMath>
 #include <QDebug>
@@ -18,13 +19,38 @@
 #include <QGraphicsDropShadowEffect>
 #include <QPixmap>
 #include <QPainter>
+#include <QToolTip>
+#include <QMenu>
+#include <QContextMenuEvent>
+#include <QTextDocument>
+
+namespace {
+
+// 内存估算：图形项私有数据、文本文档及其每个文本块的排版结构
+const qint64 kItemPrivateBytes = 320;
+const qint64 kTextDocumentBytes = 2048;
+const qint64 kTextBlockBytes = 256;
+
+} // namespace
 
 HardwareVisualizer::HardwareVisualizer(QWidget *parent)
     : QGraphicsView(parent)
     , m_scene(new QGraphicsScene(this))
+    , m_connections(new ConnectionLayer)
+    , m_packetReplay(nullptr)
+    , m_packets(nullptr)
+    , m_latencyModel(nullptr)
     , m_draggedItem(nullptr)
-    , m_busModule(nullptr)
+    , m_draggedModule(nullptr)
+    , m_layoutInProgress(false)
+    , m_topologyDirty(false)
+    , m_zoomLevel(ModuleGroups::MODULE)
+    , m_semanticZoom(true)
     , m_infoDialog(nullptr)
+    , m_history(nullptr)
+    , m_sparklinesEnabled(false)
+    , m_selectionGroupCounter(0)
+    , m_compareDialog(nullptr)
 {
     setScene(m_scene);
     setRenderHint(QPainter::Antialiasing);
@@ -42,12 +68,61 @@ HardwareVisualizer::HardwareVisualizer(QWidget *parent)
     setBackgroundBrush(QBrush(bgGradient));
     
     loadModuleIcons();
-    drawGrid();
+    m_scene->addItem(m_connections);
+
+    // 分组汇总统计合并刷新，避免高频统计更新逐条重绘文本
+    m_groupUpdateTimer.setSingleShot(true);
+    m_groupUpdateTimer.setInterval(100);
+    connect(&m_groupUpdateTimer, &QTimer::timeout, this, &HardwareVisualizer::flushGroupStatistics);
+    connect(&m_groups, &ModuleGroups::groupChanged, this, [this](int level, int index) {
+        if (level == m_zoomLevel) {
+            m_dirtyGroups.insert(index);
+            if (!m_groupUpdateTimer.isActive()) {
+                m_groupUpdateTimer.start();
+            }
+        }
+    });
+
+    // 连接的宽度与透明度在流量变化时按桶重新计算，绘制时只查表
+    m_trafficUpdateTimer.setSingleShot(true);
+    m_trafficUpdateTimer.setInterval(100);
+    connect(&m_topology, &BusTopology::trafficChanged, this, [this]() {
+        if (!m_trafficUpdateTimer.isActive()) {
+            m_trafficUpdateTimer.start();
+        }
+    });
+    connect(&m_trafficUpdateTimer, &QTimer::timeout, this, [this]() {
+        QVector<BusTopology::LinkTraffic> traffic(m_connections->edgeCount());
+        for (int i = 0; i < traffic.size(); ++i) {
+            const auto &edge = m_connections->edge(i);
+            traffic[i] = m_topology.link(edge.from, edge.to);
+        }
+        m_connections->setTraffic(traffic);
+    });
+
+    // 走势图的默认统计项：计数器显示每秒变化量
+    auto &registry = StatKeyRegistry::instance();
+    m_sparklineMetrics.insert(HardwareModule::CPU_CORE, {registry.intern("finished_inst_count"), true});
+    m_sparklineMetrics.insert(HardwareModule::CACHE_L2, {registry.intern("l2_miss_count"), true});
+    m_sparklineMetrics.insert(HardwareModule::CACHE_L3, {registry.intern("llc_miss_count"), true});
+    m_sparklineMetrics.insert(HardwareModule::BUS, {registry.intern("transmit_package_number"), true});
+    m_sparklineMetrics.insert(HardwareModule::MEMORY_CTRL, {registry.intern("message_precossed"), true});
+
+    // 走势图合并高频样本，每次刷新每个模块最多追加一列
+    m_sparklineTimer.setSingleShot(true);
+    m_sparklineTimer.setInterval(100);
+    connect(&m_sparklineTimer, &QTimer::timeout, this, &HardwareVisualizer::flushSparklines);
+
+    m_flowTimer.setInterval(33);
+    connect(&m_flowTimer, &QTimer::timeout, this, [this]() {
+        m_connections->advanceFlow(2.0);
+    });
 }
 
 HardwareVisualizer::~HardwareVisualizer()
 {
     delete m_infoDialog;
+    delete m_compareDialog;
     clearModules();
 }
 
@@ -57,12 +132,12 @@ void HardwareVisualizer::addModule(HardwareModule* module)
         return;
     }
 
-    if (module->type() == HardwareModule::BUS) {
-        m_busModule = module;
-    }
+    m_topologyDirty = true;
 
     QGraphicsItem* item = createModuleItem(module);
+    item->setPos(module->position());
     m_moduleItems[module] = item;
+    m_itemModules.insert(item, module);
     m_scene->addItem(item);
     
     connect(module, &HardwareModule::positionChanged,
@@ -70,7 +145,9 @@ void HardwareVisualizer::addModule(HardwareModule* module)
                 if (auto item = m_moduleItems.value(module)) {
                     if (item->pos() != newPos) {
                         item->setPos(newPos);
-                        drawConnections();
+                        if (!m_layoutInProgress) {
+                            drawConnections();
+                        }
                     }
                 }
             });
@@ -78,16 +155,72 @@ void HardwareVisualizer::addModule(HardwareModule* module)
     connect(module, &HardwareModule::statisticsChanged,
             this, [this, module]() {
                 updateStatistics(module);
+                // 手动折叠时刷新所在分组的汇总
+                if (QGraphicsItem* groupItem = m_collapsedInto.value(module)) {
+                    const int index = selectionGroupAt(groupItem);
+                    if (index >= 0) {
+                        m_dirtySelectionGroups.insert(index);
+                        if (!m_groupUpdateTimer.isActive()) {
+                            m_groupUpdateTimer.start();
+                        }
+                    }
+                }
             });
-            
-    if (m_busModule) {
-        autoLayout();
+
+    if (m_sparklinesEnabled) {
+        updateSparkline(module);
     }
 }
 
+void HardwareVisualizer::removeModule(HardwareModule* module)
+{
+    QGraphicsItem* item = m_moduleItems.take(module);
+    if (!item) return;
+    m_itemModules.remove(item);
+
+    disconnect(module, nullptr, this, nullptr);
+    m_scene->removeItem(item);
+    delete item;
+    m_collapsedInto.remove(module);
+    m_sparklines.remove(module);
+    m_dirtySparklines.remove(module);
+    if (m_draggedModule == module) {
+        m_draggedModule = nullptr;
+        m_draggedItem = nullptr;
+    }
+    if (m_infoDialog && m_infoDialog->releaseModule(module)) {
+        delete m_infoDialog;
+        m_infoDialog = nullptr;
+    }
+    if (m_compareDialog && m_compareDialog->containsModule(module)) {
+        delete m_compareDialog;
+        m_compareDialog = nullptr;
+    }
+
+    // 从手动分组中移除，不足两个模块的分组解散
+    bool groupsChanged = false;
+    for (int i = m_selectionGroups.size() - 1; i >= 0; --i) {
+        SelectionGroup &selection = m_selectionGroups[i];
+        if (!selection.group.members.removeOne(module)) continue;
+        groupsChanged = true;
+        if (selection.group.members.size() < 2) {
+            m_scene->removeItem(selection.item);
+            delete selection.item;
+            m_selectionGroups.remove(i);
+        }
+    }
+    if (groupsChanged) {
+        m_dirtySelectionGroups.clear();
+        updateCollapsedItems();
+    }
+    m_topologyDirty = true;
+}
+
 QGraphicsItem* HardwareVisualizer::createModuleItem(HardwareModule* module)
 {
     QGraphicsItemGroup* group = new QGraphicsItemGroup;
+    // 框选由场景的 BSP 空间索引查找相交的图形项
+    group->setFlag(QGraphicsItem::ItemIsSelectable);
     
     QGraphicsPixmapItem* pixmapItem = new QGraphicsPixmapItem(m_moduleIcons[module->type()]);
     
@@ -98,6 +231,13 @@ QGraphicsItem* HardwareVisualizer::createModuleItem(HardwareModule* module)
     pixmapItem->setGraphicsEffect(shadow);
     
     group->addToGroup(pixmapItem);
+
+    QGraphicsRectItem* highlightItem = new QGraphicsRectItem(pixmapItem->boundingRect().adjusted(-4, -4, 4, 4));
+    highlightItem->setPen(QPen(QColor(255, 215, 0), 2.5, Qt::DashLine));
+    highlightItem->setBrush(Qt::NoBrush);
+    highlightItem->setData(Qt::UserRole, "highlight");
+    highlightItem->setVisible(false);
+    group->addToGroup(highlightItem);
     
     QGraphicsTextItem* nameText = new QGraphicsTextItem(module->name());
     nameText->setDefaultTextColor(Qt::white);
@@ -122,14 +262,90 @@ QGraphicsItem* HardwareVisualizer::createModuleItem(HardwareModule* module)
     return group;
 }
 
-void HardwareVisualizer::autoLayout()
+void HardwareVisualizer::autoLayout(const QSet<HardwareModule*> &fixedModules)
+{
+    if (m_topologyDirty) refreshTopology();
+    if (m_topology.buses().isEmpty()) return;
+
+    m_layoutInProgress = true;
+    auto place = [&fixedModules](HardwareModule* module, const QPointF &pos) {
+        if (!fixedModules.contains(module)) {
+            module->setPosition(pos);
+        }
+    };
+
+    const double verticalSpacing = 150.0;
+    const double dmaX = 200.0 * 1.5;
+
+    // 未解析到总线的模块归入第一条总线的布局带
+    HardwareModule* firstBus = m_topology.buses().first();
+    QHash<HardwareModule*, QVector<HardwareModule*>> members;
+    QList<HardwareModule*> tracers;
+    for (auto it = m_moduleItems.begin(); it != m_moduleItems.end(); ++it) {
+        HardwareModule* module = it.key();
+        if (module->type() == HardwareModule::BUS) continue;
+        if (module->type() == HardwareModule::CACHE_EVENT_TRACER) {
+            tracers.append(module);
+            continue;
+        }
+        HardwareModule* bus = m_topology.busOf(module);
+        members[bus ? bus : firstBus].append(module);
+    }
+
+    // 每条总线一个水平布局带，自上而下依次排列
+    double bandTop = 0.0;
+    double firstBandTop = 0.0;
+    for (int i = 0; i < m_topology.buses().size(); ++i) {
+        HardwareModule* bus = m_topology.buses()[i];
+        QHash<HardwareModule*, QPointF> band = layoutBusBand(bus, members.value(bus));
+
+        double minY = 0.0;
+        double maxY = 0.0;
+        for (const QPointF &pos : band) {
+            minY = qMin(minY, pos.y());
+            maxY = qMax(maxY, pos.y());
+        }
+
+        // 第一条总线保持居中，后续总线依次向下排列
+        double offsetY = i == 0 ? 0.0 : bandTop - minY;
+        if (i == 0) firstBandTop = minY;
+        for (auto it = band.begin(); it != band.end(); ++it) {
+            place(it.key(), it.value() + QPointF(0, offsetY));
+        }
+        bandTop = maxY + offsetY + verticalSpacing * 1.5;
+    }
+
+    for (int i = 0; i < tracers.size(); ++i) {
+        place(tracers[i], QPointF(dmaX, firstBandTop - verticalSpacing * (i + 1)));
+    }
+
+    m_layoutInProgress = false;
+    if (m_zoomLevel != ModuleGroups::MODULE || !m_selectionGroups.isEmpty()) {
+        updateCollapsedItems();
+    }
+    m_scene->setSceneRect(m_scene->itemsBoundingRect().adjusted(-200, -200, 200, 200)
+                          .united(QRectF(-500, -500, 1000, 1000)));
+    drawConnections();
+}
+
+void HardwareVisualizer::autoLayout(const QHash<HardwareModule*, QPointF> &fixedPositions)
 {
-    if (!m_busModule) return;
+    QSet<HardwareModule*> fixedModules;
+    m_layoutInProgress = true;
+    for (auto it = fixedPositions.constBegin(); it != fixedPositions.constEnd(); ++it) {
+        it.key()->setPosition(it.value());
+        fixedModules.insert(it.key());
+    }
+    m_layoutInProgress = false;
+    autoLayout(fixedModules);
+}
+
+QHash<HardwareModule*, QPointF> HardwareVisualizer::layoutBusBand(HardwareModule* bus, const QVector<HardwareModule*> &members) const
+{
+    QHash<HardwareModule*, QPointF> positions;
 
     const double centerX = 0.0;
     const double centerY = 0.0;
-    const double moduleWidth = 150.0;
-    const double moduleHeight = 100.0;
     const double horizontalSpacing = 200.0;
     const double verticalSpacing = 150.0;
 
@@ -142,18 +358,11 @@ void HardwareVisualizer::autoLayout()
     QMap<int, HardwareModule*> cpuModules;
     QMap<int, HardwareModule*> l2Modules;
     QMap<int, HardwareModule*> l3Modules;
-    QList<HardwareModule*> busModules;
-    
-    for (auto it = m_moduleItems.begin(); it != m_moduleItems.end(); ++it) {
-        HardwareModule* module = it.key();
-        
-        QRegularExpression re("(\\d+)$");
-        QRegularExpressionMatch match = re.match(module->name());
-        int index = -1;
-        if (match.hasMatch()) {
-            index = match.captured(1).toInt();
-        }
-        
+    QList<HardwareModule*> dmaModules;
+    QList<HardwareModule*> memoryModules;
+
+    for (auto module : members) {
+        int index = m_topology.hardwareIndex(module);
         switch (module->type()) {
             case HardwareModule::CPU_CORE:
                 cpuModules[index] = module;
@@ -164,87 +373,68 @@ void HardwareVisualizer::autoLayout()
             case HardwareModule::CACHE_L3:
                 l3Modules[index] = module;
                 break;
-            case HardwareModule::BUS:
-            case HardwareModule::MEMORY_CTRL:
             case HardwareModule::DMA:
-            case HardwareModule::CACHE_EVENT_TRACER:
-                busModules.append(module);
+                dmaModules.append(module);
+                break;
+            case HardwareModule::MEMORY_CTRL:
+                memoryModules.append(module);
+                break;
+            default:
                 break;
         }
     }
 
-    QList<int> cpuIndices = cpuModules.keys();
-    std::sort(cpuIndices.begin(), cpuIndices.end());
-    
-    int rowCount = cpuIndices.size();
+    int rowCount = cpuModules.size();
     double startY = centerY - (rowCount - 1) * verticalSpacing / 2;
-    
+
     QMap<int, QPointF> cpuPositions;
-    for (int i = 0; i < cpuIndices.size(); ++i) {
-        int index = cpuIndices[i];
-        double rowY = startY + i * verticalSpacing;
-        
-        cpuModules[index]->setPosition(QPointF(cpuX, rowY));
-        cpuPositions[index] = QPointF(cpuX, rowY);
+    int row = 0;
+    for (auto it = cpuModules.begin(); it != cpuModules.end(); ++it, ++row) {
+        QPointF pos(cpuX, startY + row * verticalSpacing);
+        positions.insert(it.value(), pos);
+        cpuPositions[it.key()] = pos;
     }
 
     for (auto it = l2Modules.begin(); it != l2Modules.end(); ++it) {
-        HardwareModule* l2Module = it.value();
-        int index = it.key();
-        
-        if (cpuPositions.contains(index)) {
-            QPointF cpuPos = cpuPositions[index];
-            l2Module->setPosition(QPointF(l2X, cpuPos.y()));
+        if (cpuPositions.contains(it.key())) {
+            positions.insert(it.value(), QPointF(l2X, cpuPositions[it.key()].y()));
         } else {
-            l2Module->setPosition(QPointF(l2X, centerY));
+            positions.insert(it.value(), QPointF(l2X, centerY));
         }
     }
 
-    QList<int> l3Indices = l3Modules.keys();
-    std::sort(l3Indices.begin(), l3Indices.end());
-    
-    if (!l3Indices.isEmpty()) {
+    if (!l3Modules.isEmpty()) {
         double minY = centerY;
         double maxY = centerY;
         if (!cpuPositions.isEmpty()) {
-            minY = maxY = cpuPositions.begin().value().y();
-            for (auto pos : cpuPositions) {
-                minY = qMin(minY, pos.y());
-                maxY = qMax(maxY, pos.y());
-            }
+            minY = cpuPositions.first().y();
+            maxY = cpuPositions.last().y();
         }
-        
+
         double l3Range = qMax(maxY - minY, 10.0);
-        
-        for (int i = 0; i < l3Indices.size(); ++i) {
-            int l3Index = l3Indices[i];
+        int i = 0;
+        for (auto it = l3Modules.begin(); it != l3Modules.end(); ++it, ++i) {
             double yPos;
-            
-            if (l3Indices.size() == 1) {
+            if (l3Modules.size() == 1) {
                 yPos = (minY + maxY) / 2;
             } else {
-                yPos = minY + (l3Range * i) / (l3Indices.size() - 1);
+                yPos = minY + (l3Range * i) / (l3Modules.size() - 1);
             }
-            
-            l3Modules[l3Index]->setPosition(QPointF(l3X, yPos));
+            positions.insert(it.value(), QPointF(l3X, yPos));
         }
     }
 
-    for (auto module : busModules) {
-        QPointF pos;
-        if (module->type() == HardwareModule::BUS) {
-            pos = QPointF(busX, centerY);
-        } else if (module->type() == HardwareModule::DMA) {
-            pos = QPointF(dmaX, centerY - verticalSpacing * 0.5);
-        } else if (module->type() == HardwareModule::MEMORY_CTRL) {
-            pos = QPointF(dmaX, centerY + verticalSpacing * 0.5);
-        } else if (module->type() == HardwareModule::CACHE_EVENT_TRACER) {
-            pos = QPointF(dmaX, centerY - verticalSpacing * 1.5);
-        }
-        module->setPosition(pos);
+    positions.insert(bus, QPointF(busX, centerY));
+
+    // DMA 自总线上方、内存节点自总线下方依次堆叠
+    for (int i = 0; i < dmaModules.size(); ++i) {
+        positions.insert(dmaModules[i], QPointF(dmaX, centerY - verticalSpacing * (0.5 + i)));
+    }
+    for (int i = 0; i < memoryModules.size(); ++i) {
+        positions.insert(memoryModules[i], QPointF(dmaX, centerY + verticalSpacing * (0.5 + i)));
     }
 
-    drawConnections();
+    return positions;
 }
 
 void HardwareVisualizer::updateModulePosition(HardwareModule* module)
@@ -262,6 +452,34 @@ void HardwareVisualizer::clearModules()
         delete item;
     }
     m_moduleItems.clear();
+    m_itemModules.clear();
+    m_sparklines.clear();
+    m_dirtySparklines.clear();
+    for (const auto &items : m_groupItems) {
+        for (auto item : items) {
+            m_scene->removeItem(item);
+            delete item;
+        }
+    }
+    m_groupItems.clear();
+    for (const auto &selection : m_selectionGroups) {
+        m_scene->removeItem(selection.item);
+        delete selection.item;
+    }
+    m_selectionGroups.clear();
+    m_dirtySelectionGroups.clear();
+    delete m_compareDialog;
+    m_compareDialog = nullptr;
+    m_collapsedInto.clear();
+    m_dirtyGroups.clear();
+    m_groups.clear();
+    m_zoomLevel = ModuleGroups::MODULE;
+    m_topology.clear();
+    m_topologyDirty = false;
+    m_connections->clear();
+    m_draggedModule = nullptr;
+    m_draggedItem = nullptr;
+    emit topologyChanged();
 }
 
 void HardwareVisualizer::wheelEvent(QWheelEvent *event)
@@ -271,123 +489,693 @@ void HardwareVisualizer::wheelEvent(QWheelEvent *event)
         scaleFactor = 1.0 / scaleFactor;
     }
     scale(scaleFactor, scaleFactor);
+    applySemanticZoom();
 }
 
 void HardwareVisualizer::drawConnections()
 {
-    for (QGraphicsItem* item : m_scene->items()) {
-        if (item->type() == QGraphicsLineItem::Type ||
-            item->type() == QGraphicsPathItem::Type ||
-            (item->type() == QGraphicsTextItem::Type && 
-             item->parentItem() == nullptr)) {
+    if (m_topologyDirty) refreshTopology();
+
+    if (m_topology.buses().isEmpty()) {
+        m_connections->clear();
+        updatePacketRoutes();
+        return;
+    }
+
+    // 被折叠的模块连接到所在分组，同一对图形项之间只画一条线
+    QSet<QPair<QGraphicsItem*, QGraphicsItem*>> drawnConnections;
+    QVector<ConnectionLayer::EdgeInput> edges;
+
+    for (const auto &connection : logicalConnections()) {
+        HardwareModule* fromModule = connection.first;
+        HardwareModule* toModule = connection.second;
+
+        QGraphicsItem* fromItem = m_collapsedInto.value(fromModule, m_moduleItems.value(fromModule));
+        QGraphicsItem* toItem = m_collapsedInto.value(toModule, m_moduleItems.value(toModule));
+        if (!fromItem || !toItem || fromItem == toItem) continue;
+
+        QPair<QGraphicsItem*, QGraphicsItem*> connectionPair(qMin(fromItem, toItem), qMax(fromItem, toItem));
+        if (drawnConnections.contains(connectionPair)) continue;
+        drawnConnections.insert(connectionPair);
+
+        edges.append({fromModule, toModule, fromItem->pos(), toItem->pos(), m_topology.link(fromModule, toModule)});
+    }
+
+    // 曲线几何与类别在工作线程中计算，按类别与流量级别合并绘制
+    m_connections->setEdges(edges);
+    updatePacketRoutes();
+}
+
+void HardwareVisualizer::refreshTopology()
+{
+    m_topology.rebuild(m_moduleItems.keys());
+    m_topologyDirty = false;
+
+    for (const auto &items : m_groupItems) {
+        for (auto item : items) {
             m_scene->removeItem(item);
             delete item;
         }
     }
+    m_groupItems.clear();
+    m_collapsedInto.clear();
+    m_dirtyGroups.clear();
 
-    if (!m_busModule) return;
+    m_groups.rebuild(m_moduleItems.keys(), m_topology);
+    m_groupItems.resize(ModuleGroups::LEVEL_COUNT);
+    for (int level = ModuleGroups::CLUSTER; level < ModuleGroups::LEVEL_COUNT; ++level) {
+        for (const auto &group : m_groups.groups(ModuleGroups::Level(level))) {
+            QGraphicsItem* item = createGroupItem(group);
+            item->setVisible(false);
+            m_scene->addItem(item);
+            m_groupItems[level].append(item);
+        }
+    }
 
-    QSet<QPair<HardwareModule*, HardwareModule*>> drawnConnections;
+    m_zoomLevel = zoomLevelForScale(transform().m11());
+    updateCollapsedItems();
+    emit topologyChanged();
+}
 
-    for (auto it1 = m_moduleItems.begin(); it1 != m_moduleItems.end(); ++it1) {
-        HardwareModule* fromModule = it1.key();
-        
-        for (auto it2 = m_moduleItems.begin(); it2 != m_moduleItems.end(); ++it2) {
-            HardwareModule* toModule = it2.key();
-            
-            if (fromModule == toModule) continue;
-            
-            QPair<HardwareModule*, HardwareModule*> connectionPair(
-                qMin(fromModule, toModule), qMax(fromModule, toModule));
-            if (drawnConnections.contains(connectionPair)) continue;
-            
-            if (!isValidLogicalConnection(fromModule, toModule)) continue;
-            
-            drawnConnections.insert(connectionPair);
-            
-            QPointF fromPoint = getConnectionPoint(fromModule, toModule->position());
-            QPointF toPoint = getConnectionPoint(toModule, fromModule->position());
-            
-            auto fromType = fromModule->type();
-            auto toType = toModule->type();
-            
-            double curvature = 0.2;
-            
-            if ((fromType == HardwareModule::CPU_CORE && toType == HardwareModule::CACHE_L2) ||
-                (fromType == HardwareModule::CACHE_L2 && toType == HardwareModule::CPU_CORE)) {
-                curvature = 0.1;
-            } else if ((fromType == HardwareModule::CACHE_L2 && toType == HardwareModule::CACHE_L3) ||
-                      (fromType == HardwareModule::CACHE_L3 && toType == HardwareModule::CACHE_L2)) {
-                curvature = 0.15;
-            } else if ((fromType == HardwareModule::CACHE_L3 && toType == HardwareModule::BUS) ||
-                      (fromType == HardwareModule::BUS && toType == HardwareModule::CACHE_L3)) {
-                curvature = 0.25;
+void HardwareVisualizer::setSemanticZoomEnabled(bool enabled)
+{
+    if (m_semanticZoom == enabled) return;
+    m_semanticZoom = enabled;
+    applySemanticZoom();
+}
+
+ModuleGroups::Level HardwareVisualizer::zoomLevelForScale(double scale) const
+{
+    if (!m_semanticZoom || scale >= 0.6) return ModuleGroups::MODULE;
+    if (scale >= 0.35) return ModuleGroups::CLUSTER;
+    if (scale >= 0.2) return ModuleGroups::SOCKET;
+    return ModuleGroups::CHIP;
+}
+
+void HardwareVisualizer::setFlowAnimationEnabled(bool enabled)
+{
+    m_connections->setFlowAnimated(enabled);
+    if (enabled) {
+        m_flowTimer.start();
+    } else {
+        m_flowTimer.stop();
+    }
+}
+
+void HardwareVisualizer::setStatisticHistory(StatisticHistory* history)
+{
+    m_history = history;
+    connect(m_history, &StatisticHistory::sampleAdded, this, [this](HardwareModule* module, int keyId) {
+        if (!m_sparklines.contains(module)) return;
+        if (m_sparklineMetrics.value(module->type()).keyId != keyId) return;
+        m_dirtySparklines.insert(module);
+        if (!m_sparklineTimer.isActive()) {
+            m_sparklineTimer.start();
+        }
+    });
+}
+
+void HardwareVisualizer::setSparklineMetric(HardwareModule::ModuleType type, const QString &key, bool rate)
+{
+    if (key.isEmpty()) {
+        m_sparklineMetrics.remove(type);
+    } else {
+        m_sparklineMetrics.insert(type, {StatKeyRegistry::instance().intern(key), rate});
+    }
+    if (!m_sparklinesEnabled) return;
+
+    for (auto it = m_moduleItems.constBegin(); it != m_moduleItems.constEnd(); ++it) {
+        if (it.key()->type() == type) {
+            updateSparkline(it.key());
+        }
+    }
+}
+
+QString HardwareVisualizer::sparklineMetric(HardwareModule::ModuleType type) const
+{
+    auto it = m_sparklineMetrics.constFind(type);
+    if (it == m_sparklineMetrics.constEnd()) return QString();
+    const QString name = StatKeyRegistry::instance().name(it->keyId);
+    return it->rate ? name + "/s" : name;
+}
+
+void HardwareVisualizer::setSparklinesEnabled(bool enabled)
+{
+    if (m_sparklinesEnabled == enabled) return;
+    m_sparklinesEnabled = enabled;
+    for (auto it = m_moduleItems.constBegin(); it != m_moduleItems.constEnd(); ++it) {
+        updateSparkline(it.key());
+    }
+}
+
+void HardwareVisualizer::updateSparkline(HardwareModule* module)
+{
+    auto group = static_cast<QGraphicsItemGroup*>(m_moduleItems.value(module));
+    if (!group) return;
+
+    auto existing = m_sparklines.find(module);
+    if (existing != m_sparklines.end()) {
+        delete existing->item;
+        m_sparklines.erase(existing);
+        m_dirtySparklines.remove(module);
+    }
+
+    auto metric = m_sparklineMetrics.constFind(module->type());
+    if (!m_sparklinesEnabled || metric == m_sparklineMetrics.constEnd()) return;
+
+    Sparkline sparkline;
+    sparkline.item = new SparklineItem(sparklineMetric(module->type()), getModuleColor(module->type()).lighter(150), group);
+    sparkline.item->setPos(10, 66);
+    group->addToGroup(sparkline.item);
+    sparkline.lastTime = 0.0;
+    sparkline.lastValue = 0.0;
+    sparkline.hasLast = false;
+
+    // 用历史中最近的样本填满走势图
+    if (const TimeSeries* series = m_history ? m_history->series(module, metric->keyId) : nullptr) {
+        for (int i = qMax(0, series->size() - SparklineItem::kColumns - 1); i < series->size(); ++i) {
+            appendSparklineSample(sparkline, series->timeAt(i), series->valueAt(i), metric->rate);
+        }
+    }
+    m_sparklines.insert(module, sparkline);
+}
+
+void HardwareVisualizer::appendSparklineSample(Sparkline &sparkline, double time, double value, bool rate)
+{
+    if (!rate) {
+        sparkline.item->addSample(value);
+        return;
+    }
+    // 同一时刻的样本并入下一个间隔
+    if (sparkline.hasLast && time <= sparkline.lastTime) return;
+    if (sparkline.hasLast) {
+        sparkline.item->addSample((value - sparkline.lastValue) / (time - sparkline.lastTime));
+    }
+    sparkline.lastTime = time;
+    sparkline.lastValue = value;
+    sparkline.hasLast = true;
+}
+
+void HardwareVisualizer::flushSparklines()
+{
+    for (auto module : m_dirtySparklines) {
+        auto it = m_sparklines.find(module);
+        if (it == m_sparklines.end()) continue;
+        const SparklineMetric metric = m_sparklineMetrics.value(module->type());
+        if (const TimeSeries* series = m_history->series(module, metric.keyId)) {
+            appendSparklineSample(*it, series->lastTime(), series->lastValue(), metric.rate);
+        }
+    }
+    m_dirtySparklines.clear();
+}
+
+void HardwareVisualizer::setPacketReplay(PacketReplay* replay)
+{
+    m_packetReplay = replay;
+    m_packets = new PacketFlowLayer(replay);
+    m_scene->addItem(m_packets);
+
+    connect(replay, &PacketReplay::tickChanged, this, [this]() {
+        m_packets->update();
+    });
+    connect(replay, &PacketReplay::busChanged, this, &HardwareVisualizer::updatePacketRoutes);
+    updatePacketRoutes();
+}
+
+void HardwareVisualizer::updatePacketRoutes()
+{
+    if (!m_packets) return;
+
+    HardwareModule* bus = m_packetReplay->bus();
+    if (!bus || !m_moduleItems.contains(bus) || m_topologyDirty) {
+        m_packets->setRoutes(nullptr, QPointF(), {});
+        return;
+    }
+
+    // 数据包在模块图形项（折叠时为分组）的中心之间移动
+    auto center = [this](HardwareModule* module) {
+        QGraphicsItem* item = m_collapsedInto.value(module, m_moduleItems.value(module));
+        return item->pos() + QPointF(75, 50);
+    };
+    QHash<int, QPointF> ports;
+    for (HardwareModule* module : m_topology.modulesOnBus(bus)) {
+        if (module->portId() >= 0 && m_moduleItems.contains(module)) {
+            ports.insert(module->portId(), center(module));
+        }
+    }
+    m_packets->setRoutes(bus, center(bus), ports);
+}
+
+void HardwareVisualizer::drawForeground(QPainter *painter, const QRectF &rect)
+{
+    Q_UNUSED(rect);
+
+    const QImage &legend = m_connections->legend();
+    if (legend.isNull()) return;
+
+    painter->save();
+    painter->resetTransform();
+    painter->drawImage(QPoint(10, viewport()->height() - legend.height() - 10), legend);
+    painter->restore();
+}
+
+void HardwareVisualizer::applySemanticZoom()
+{
+    ModuleGroups::Level level = zoomLevelForScale(transform().m11());
+    if (level == m_zoomLevel) return;
+
+    m_zoomLevel = level;
+    updateCollapsedItems();
+    drawConnections();
+}
+
+void HardwareVisualizer::updateCollapsedItems()
+{
+    m_collapsedInto.clear();
+    m_dirtyGroups.clear();
+    for (const auto &items : m_groupItems) {
+        for (auto item : items) {
+            item->setVisible(false);
+        }
+    }
+    for (auto item : m_moduleItems) {
+        item->setVisible(true);
+    }
+    for (const auto &selection : m_selectionGroups) {
+        selection.item->setVisible(false);
+    }
+
+    if (m_zoomLevel == ModuleGroups::MODULE) {
+        applySelectionGroups();
+        return;
+    }
+
+    // 只折叠包含多个模块的分组，分组放在成员所占区域的中心
+    const auto &groups = m_groups.groups(m_zoomLevel);
+    for (int i = 0; i < groups.size(); ++i) {
+        const auto &group = groups[i];
+        if (group.members.size() < 2) continue;
+
+        QGraphicsItem* groupItem = m_groupItems[m_zoomLevel][i];
+        QRectF bounds;
+        for (auto module : group.members) {
+            bounds |= QRectF(module->position(), QSizeF(150, 100));
+            if (auto item = m_moduleItems.value(module)) {
+                item->setVisible(false);
             }
-            
-            QPointF midPoint = (fromPoint + toPoint) / 2;
-            double dist = QLineF(fromPoint, toPoint).length() * curvature;
-            
-            QPointF dir = toPoint - fromPoint;
-            double len = QLineF(QPointF(0, 0), dir).length();
-            QPointF normal(-dir.y() / len, dir.x() / len);
-            
-            QPainterPath path;
-            path.moveTo(fromPoint);
-            QPointF ctrl = midPoint + normal * dist;
-            path.quadTo(ctrl, toPoint);
-            
-            QColor lineColor;
-            
-            if ((fromType == HardwareModule::CPU_CORE && toType == HardwareModule::CACHE_L2) ||
-                (fromType == HardwareModule::CACHE_L2 && toType == HardwareModule::CPU_CORE)) {
-                lineColor = QColor(220, 20, 60);
-            } else if ((fromType == HardwareModule::CACHE_L2 && toType == HardwareModule::CACHE_L3) ||
-                      (fromType == HardwareModule::CACHE_L3 && toType == HardwareModule::CACHE_L2)) {
-                lineColor = QColor(0, 128, 0);
-            } else if ((fromType == HardwareModule::CACHE_L3 && toType == HardwareModule::BUS) ||
-                      (fromType == HardwareModule::BUS && toType == HardwareModule::CACHE_L3)) {
-                lineColor = QColor(70, 130, 180);
-            } else if ((fromType == HardwareModule::BUS && toType == HardwareModule::MEMORY_CTRL) ||
-                      (fromType == HardwareModule::MEMORY_CTRL && toType == HardwareModule::BUS)) {
-                lineColor = QColor(255, 140, 0);
-            } else if ((fromType == HardwareModule::BUS && toType == HardwareModule::DMA) ||
-                      (fromType == HardwareModule::DMA && toType == HardwareModule::BUS)) {
-                lineColor = QColor(138, 43, 226);
-            } else if ((fromType == HardwareModule::CACHE_L3 && toType == HardwareModule::CACHE_L3)) {
-                lineColor = QColor(30, 144, 255);
-            } else {
-                lineColor = QColor(105, 105, 105);
+            m_collapsedInto.insert(module, groupItem);
+        }
+        groupItem->setPos(bounds.center() - QPointF(75, 50));
+        groupItem->setVisible(true);
+        updateGroupStatistics(i);
+    }
+}
+
+void HardwareVisualizer::updateGroupStatistics(int index)
+{
+    if (m_zoomLevel == ModuleGroups::MODULE) return;
+
+    QGraphicsItem* item = m_groupItems[m_zoomLevel].value(index, nullptr);
+    if (!item || !item->isVisible()) return;
+
+    for (auto child : item->childItems()) {
+        if (auto textItem = qgraphicsitem_cast<QGraphicsTextItem*>(child)) {
+            if (textItem->data(Qt::UserRole).toString() == "stats") {
+                textItem->setPlainText(createGroupStatsText(m_groups.groups(m_zoomLevel)[index]));
+                break;
             }
-            
-            QPen pen(lineColor, 1.5);
-            
-            QGraphicsPathItem* pathItem = new QGraphicsPathItem(path);
-            pathItem->setPen(pen);
-            m_scene->addItem(pathItem);
         }
     }
 }
 
-double HardwareVisualizer::getDataTransferRate(HardwareModule* from, HardwareModule* to) const
+void HardwareVisualizer::flushGroupStatistics()
 {
-    if (!from || !to || !m_busModule) return 0.0;
-    
-    int fromPort = from->portId();
-    int toPort = to->portId();
-    
-    if (fromPort >= 0 && toPort >= 0) {
-        QString key1 = QString("transmit_package_number_from_%1_to_%2")
-                      .arg(fromPort).arg(toPort);
-        double rate1 = m_busModule->statistic(key1);
-        
-        QString key2 = QString("transmit_package_number_from_%1_to_%2")
-                      .arg(toPort).arg(fromPort);
-        double rate2 = m_busModule->statistic(key2);  
-        
-        return qMax(rate1, rate2);
+    for (int index : m_dirtyGroups) {
+        updateGroupStatistics(index);
+    }
+    m_dirtyGroups.clear();
+    for (int index : m_dirtySelectionGroups) {
+        updateSelectionGroupStatistics(index);
+    }
+    m_dirtySelectionGroups.clear();
+}
+
+void HardwareVisualizer::applySelectionGroups()
+{
+    for (int i = 0; i < m_selectionGroups.size(); ++i) {
+        const SelectionGroup &selection = m_selectionGroups[i];
+        QRectF bounds;
+        for (auto module : selection.group.members) {
+            bounds |= QRectF(module->position(), QSizeF(150, 100));
+            if (auto item = m_moduleItems.value(module)) {
+                item->setVisible(false);
+            }
+            m_collapsedInto.insert(module, selection.item);
+        }
+        selection.item->setPos(bounds.center() - QPointF(75, 50));
+        selection.item->setVisible(true);
+        updateSelectionGroupStatistics(i);
+    }
+}
+
+void HardwareVisualizer::updateSelectionGroupStatistics(int index)
+{
+    if (index < 0 || index >= m_selectionGroups.size()) return;
+
+    SelectionGroup &selection = m_selectionGroups[index];
+    selection.group.sums.clear();
+    for (auto module : selection.group.members) {
+        for (auto it = module->statisticValues().constBegin(); it != module->statisticValues().constEnd(); ++it) {
+            selection.group.sums[it.key()] += it.value();
+        }
+    }
+    for (auto child : selection.item->childItems()) {
+        if (auto textItem = qgraphicsitem_cast<QGraphicsTextItem*>(child)) {
+            if (textItem->data(Qt::UserRole).toString() == "stats") {
+                textItem->setPlainText(createGroupStatsText(selection.group));
+                break;
+            }
+        }
     }
-    
-    return 0.0;
+}
+
+int HardwareVisualizer::selectionGroupAt(QGraphicsItem* item) const
+{
+    if (!item) return -1;
+    for (int i = 0; i < m_selectionGroups.size(); ++i) {
+        if (m_selectionGroups[i].item == item) return i;
+    }
+    return -1;
+}
+
+QList<HardwareModule*> HardwareVisualizer::selectedModules() const
+{
+    QList<HardwareModule*> modules;
+    for (auto item : m_scene->selectedItems()) {
+        if (HardwareModule* module = m_itemModules.value(item, nullptr)) {
+            modules.append(module);
+        }
+    }
+    return modules;
+}
+
+void HardwareVisualizer::setModulePositions(const QHash<HardwareModule*, QPointF> &positions)
+{
+    if (positions.isEmpty()) return;
+
+    m_layoutInProgress = true;
+    for (auto it = positions.constBegin(); it != positions.constEnd(); ++it) {
+        it.key()->setPosition(it.value());
+    }
+    m_layoutInProgress = false;
+    drawConnections();
+}
+
+void HardwareVisualizer::accountMemory(MemoryAccounting &accounting) const
+{
+    // 图标先于像素图项计入，共享同一图像数据的像素图项不重复计算
+    for (auto it = m_moduleIcons.constBegin(); it != m_moduleIcons.constEnd(); ++it) {
+        const QPixmap &icon = it.value();
+        accounting.addPixmap("module icons", icon.cacheKey(), icon.width(), icon.height(), icon.depth());
+    }
+
+    for (QGraphicsItem* item : m_scene->items()) {
+        QString name;
+        qint64 bytes = kItemPrivateBytes;
+        switch (item->type()) {
+            case QGraphicsRectItem::Type:
+                name = "QGraphicsRectItem";
+                bytes += sizeof(QGraphicsRectItem);
+                break;
+            case QGraphicsItemGroup::Type:
+                name = "QGraphicsItemGroup";
+                bytes += sizeof(QGraphicsItemGroup);
+                break;
+            case QGraphicsPixmapItem::Type: {
+                name = "QGraphicsPixmapItem";
+                bytes += sizeof(QGraphicsPixmapItem);
+                const QPixmap pixmap = static_cast<QGraphicsPixmapItem*>(item)->pixmap();
+                accounting.addPixmap("pixmap items", pixmap.cacheKey(), pixmap.width(), pixmap.height(), pixmap.depth());
+                break;
+            }
+            case QGraphicsTextItem::Type: {
+                name = "QGraphicsTextItem";
+                bytes += sizeof(QGraphicsTextItem) + MemoryAccounting::kObjectBytes;
+                const QTextDocument* document = static_cast<QGraphicsTextItem*>(item)->document();
+                accounting.add(MemoryAccounting::TEXT_DOCUMENTS, "QTextDocument", 1,
+                               kTextDocumentBytes + document->characterCount() * qint64(sizeof(QChar))
+                               + document->blockCount() * kTextBlockBytes);
+                break;
+            }
+            case QGraphicsPathItem::Type:
+                name = "QGraphicsPathItem";
+                bytes += sizeof(QGraphicsPathItem)
+                       + static_cast<QGraphicsPathItem*>(item)->path().elementCount() * qint64(sizeof(QPainterPath::Element));
+                break;
+            case ConnectionLayer::Type:
+                name = "ConnectionLayer";
+                bytes += sizeof(ConnectionLayer);
+                static_cast<ConnectionLayer*>(item)->accountMemory(accounting);
+                break;
+            case SparklineItem::Type:
+                name = "SparklineItem";
+                bytes += sizeof(SparklineItem);
+                static_cast<SparklineItem*>(item)->accountMemory(accounting);
+                break;
+            default:
+                name = QString("item type %1").arg(item->type());
+                break;
+        }
+        accounting.add(MemoryAccounting::GRAPHICS_ITEMS, name, 1, bytes);
+    }
+
+    accounting.add(MemoryAccounting::GRAPHICS_ITEMS, "item lookup tables", m_moduleItems.size(),
+                   MemoryAccounting::mapBytes(m_moduleItems) + MemoryAccounting::hashBytes(m_itemModules)
+                   + MemoryAccounting::hashBytes(m_collapsedInto) + MemoryAccounting::hashBytes(m_sparklines));
+}
+
+void HardwareVisualizer::alignModules(const QList<HardwareModule*> &modules, Alignment alignment)
+{
+    if (modules.size() < 2) return;
+
+    double left = modules.first()->position().x();
+    double right = left;
+    double top = modules.first()->position().y();
+    double bottom = top;
+    for (auto module : modules) {
+        left = qMin(left, module->position().x());
+        right = qMax(right, module->position().x());
+        top = qMin(top, module->position().y());
+        bottom = qMax(bottom, module->position().y());
+    }
+
+    // 模块图形项大小相同，按左上角位置对齐
+    QHash<HardwareModule*, QPointF> positions;
+    QList<HardwareModule*> ordered = modules;
+    switch (alignment) {
+        case DISTRIBUTE_HORIZONTAL:
+        case DISTRIBUTE_VERTICAL: {
+            const bool horizontal = alignment == DISTRIBUTE_HORIZONTAL;
+            std::sort(ordered.begin(), ordered.end(), [horizontal](HardwareModule* a, HardwareModule* b) {
+                return horizontal ? a->position().x() < b->position().x() : a->position().y() < b->position().y();
+            });
+            const double step = ((horizontal ? right - left : bottom - top)) / (ordered.size() - 1);
+            for (int i = 0; i < ordered.size(); ++i) {
+                QPointF pos = ordered[i]->position();
+                if (horizontal) {
+                    pos.setX(left + step * i);
+                } else {
+                    pos.setY(top + step * i);
+                }
+                positions.insert(ordered[i], pos);
+            }
+            break;
+        }
+        default:
+            for (auto module : modules) {
+                QPointF pos = module->position();
+                switch (alignment) {
+                    case ALIGN_LEFT: pos.setX(left); break;
+                    case ALIGN_HCENTER: pos.setX((left + right) / 2.0); break;
+                    case ALIGN_RIGHT: pos.setX(right); break;
+                    case ALIGN_TOP: pos.setY(top); break;
+                    case ALIGN_VCENTER: pos.setY((top + bottom) / 2.0); break;
+                    case ALIGN_BOTTOM: pos.setY(bottom); break;
+                    default: break;
+                }
+                positions.insert(module, pos);
+            }
+            break;
+    }
+
+    setModulePositions(positions);
+    emit moduleMoved(modules.first());
+}
+
+void HardwareVisualizer::collapseModules(const QList<HardwareModule*> &modules)
+{
+    if (modules.size() < 2) return;
+
+    SelectionGroup selection;
+    selection.group.level = ModuleGroups::MODULE;
+    selection.group.name = QString("Selection %1").arg(++m_selectionGroupCounter);
+    selection.group.members = QVector<HardwareModule*>(modules.begin(), modules.end());
+    selection.item = createGroupItem(selection.group);
+    selection.item->setData(Qt::UserRole, "selectionGroup");
+    selection.item->setVisible(false);
+    m_scene->addItem(selection.item);
+    m_selectionGroups.append(selection);
+
+    for (auto module : modules) {
+        if (auto item = m_moduleItems.value(module)) {
+            item->setSelected(false);
+        }
+    }
+    updateCollapsedItems();
+    drawConnections();
+}
+
+void HardwareVisualizer::expandSelectionGroup(int index)
+{
+    if (index < 0 || index >= m_selectionGroups.size()) return;
+
+    QGraphicsItem* item = m_selectionGroups[index].item;
+    const QVector<HardwareModule*> members = m_selectionGroups[index].group.members;
+    m_selectionGroups.remove(index);
+    m_dirtySelectionGroups.clear();
+    m_scene->removeItem(item);
+    delete item;
+
+    updateCollapsedItems();
+    drawConnections();
+    // 展开后选中原来的成员，便于继续批量操作
+    for (auto module : members) {
+        if (auto moduleItem = m_moduleItems.value(module)) {
+            moduleItem->setSelected(true);
+        }
+    }
+}
+
+void HardwareVisualizer::compareModules(const QList<HardwareModule*> &modules)
+{
+    if (modules.size() < 2) return;
+
+    delete m_compareDialog;
+    QVector<HardwareModule*> ordered(modules.begin(), modules.end());
+    std::sort(ordered.begin(), ordered.end(), [](HardwareModule* a, HardwareModule* b) {
+        return a->name() < b->name();
+    });
+    m_compareDialog = new ModuleCompareDialog(ordered, this);
+    m_compareDialog->show();
+}
+
+void HardwareVisualizer::contextMenuEvent(QContextMenuEvent *event)
+{
+    QGraphicsItem* item = scene()->itemAt(mapToScene(event->pos()), transform());
+    if (item && item->group()) {
+        item = item->group();
+    }
+
+    QMenu menu(this);
+    const int groupIndex = selectionGroupAt(item);
+    if (groupIndex >= 0) {
+        connect(menu.addAction("展开分组"), &QAction::triggered, this, [this, groupIndex]() {
+            expandSelectionGroup(groupIndex);
+        });
+        menu.exec(event->globalPos());
+        return;
+    }
+
+    // 在未选中的模块上右击时只选中该模块
+    if (item && m_itemModules.contains(item) && !item->isSelected()) {
+        m_scene->clearSelection();
+        item->setSelected(true);
+    }
+    const QList<HardwareModule*> modules = selectedModules();
+    if (modules.isEmpty()) {
+        QGraphicsView::contextMenuEvent(event);
+        return;
+    }
+
+    QMenu* alignMenu = menu.addMenu(QString("对齐 %1 个模块").arg(modules.size()));
+    alignMenu->setEnabled(modules.size() >= 2);
+    const QVector<QPair<QString, Alignment>> alignments = {
+        {"左对齐", ALIGN_LEFT}, {"水平居中", ALIGN_HCENTER}, {"右对齐", ALIGN_RIGHT},
+        {"顶端对齐", ALIGN_TOP}, {"垂直居中", ALIGN_VCENTER}, {"底端对齐", ALIGN_BOTTOM},
+        {"水平等距分布", DISTRIBUTE_HORIZONTAL}, {"垂直等距分布", DISTRIBUTE_VERTICAL}
+    };
+    for (const auto &entry : alignments) {
+        if (entry.second == DISTRIBUTE_HORIZONTAL) {
+            alignMenu->addSeparator();
+        }
+        QAction* action = alignMenu->addAction(entry.first);
+        action->setEnabled(entry.second < DISTRIBUTE_HORIZONTAL || modules.size() >= 3);
+        const Alignment alignment = entry.second;
+        connect(action, &QAction::triggered, this, [this, modules, alignment]() {
+            alignModules(modules, alignment);
+        });
+    }
+
+    QAction* collapseAction = menu.addAction("折叠为分组");
+    collapseAction->setEnabled(modules.size() >= 2);
+    connect(collapseAction, &QAction::triggered, this, [this, modules]() {
+        collapseModules(modules);
+    });
+    QAction* compareAction = menu.addAction("比较统计…");
+    compareAction->setEnabled(modules.size() >= 2);
+    connect(compareAction, &QAction::triggered, this, [this, modules]() {
+        compareModules(modules);
+    });
+
+    menu.exec(event->globalPos());
+}
+
+QVector<QPair<HardwareModule*, HardwareModule*>> HardwareVisualizer::logicalConnections() const
+{
+    QVector<QPair<HardwareModule*, HardwareModule*>> connections;
+
+    for (auto bus : m_topology.buses()) {
+        QVector<HardwareModule*> l2Modules;
+        QVector<HardwareModule*> l3Modules;
+
+        for (auto module : m_topology.modulesOnBus(bus)) {
+            switch (module->type()) {
+                case HardwareModule::CPU_CORE: {
+                    HardwareModule* l2 = m_topology.moduleByIndex(HardwareModule::CACHE_L2, m_topology.hardwareIndex(module));
+                    if (l2) {
+                        connections.append({module, l2});
+                    }
+                    break;
+                }
+                case HardwareModule::CACHE_L2:
+                    l2Modules.append(module);
+                    break;
+                case HardwareModule::CACHE_L3:
+                    l3Modules.append(module);
+                    connections.append({module, bus});
+                    break;
+                case HardwareModule::MEMORY_CTRL:
+                case HardwareModule::DMA:
+                    connections.append({bus, module});
+                    break;
+                default:
+                    break;
+            }
+        }
+
+        for (auto l2 : l2Modules) {
+            for (auto l3 : l3Modules) {
+                connections.append({l2, l3});
+            }
+        }
+        for (int i = 0; i < l3Modules.size(); ++i) {
+            for (int j = i + 1; j < l3Modules.size(); ++j) {
+                connections.append({l3Modules[i], l3Modules[j]});
+            }
+        }
+    }
+
+    return connections;
 }
 
 QString HardwareVisualizer::formatStatistic(const QString& key, double value) const
@@ -523,27 +1311,31 @@ QString HardwareVisualizer::getModuleTypeName(HardwareModule::ModuleType type) c
     }
 }
 
-QPointF HardwareVisualizer::getConnectionPoint(HardwareModule* module, const QPointF& otherPos)
-{
-    QPointF pos = module->position();
-    QPointF center(pos.x() + 75, pos.y() + 50);
-    
-    if (otherPos.x() > pos.x()) {
-        return QPointF(pos.x() + 150, center.y());
-    } else if (otherPos.x() < pos.x()) {
-        return QPointF(pos.x(), center.y());
-    } else if (otherPos.y() > pos.y()) {
-        return QPointF(center.x(), pos.y() + 100);
-    } else {
-        return QPointF(center.x(), pos.y());
-    }
-}
-
 void HardwareVisualizer::mouseDoubleClickEvent(QMouseEvent *event)
 {
     if (event->button() == Qt::LeftButton) {
         QPointF scenePos = mapToScene(event->pos());
         HardwareModule* module = getModuleAtPosition(scenePos);
+
+        // 双击分组时放大到逐个模块显示
+        QGraphicsItem* item = scene()->itemAt(scenePos, transform());
+        if (item && item->group()) {
+            item = item->group();
+        }
+        const int selectionIndex = selectionGroupAt(item);
+        if (selectionIndex >= 0) {
+            expandSelectionGroup(selectionIndex);
+            event->accept();
+            return;
+        }
+        if (!module && item && item->data(Qt::UserRole).toString() == "group") {
+            QPointF center = item->sceneBoundingRect().center();
+            resetTransform();
+            applySemanticZoom();
+            centerOn(center);
+            event->accept();
+            return;
+        }
         
         if (module) {
             if (m_infoDialog) {
@@ -551,7 +1343,13 @@ void HardwareVisualizer::mouseDoubleClickEvent(QMouseEvent *event)
                 m_infoDialog = nullptr;
             }
             
-            m_infoDialog = new ModuleInfoDialog(module, m_moduleItems, this);
+            QVector<HardwareModule*> peers;
+            for (auto it = m_moduleItems.constBegin(); it != m_moduleItems.constEnd(); ++it) {
+                if (it.key()->type() == module->type()) {
+                    peers.append(it.key());
+                }
+            }
+            m_infoDialog = new ModuleInfoDialog(module, m_topology, peers, m_latencyModel, this);
             m_infoDialog->show();
         }
     }
@@ -566,104 +1364,7 @@ HardwareModule* HardwareVisualizer::getModuleAtPosition(const QPointF& pos) cons
     if (item->group()) {
         item = item->group();
     }
-
-    for (auto it = m_moduleItems.begin(); it != m_moduleItems.end(); ++it) {
-        if (it.value() == item) {
-            return it.key();
-        }
-    }
-    
-    return nullptr;
-}
-
-bool HardwareVisualizer::isValidLogicalConnection(HardwareModule* from, HardwareModule* to) const
-{
-    if (!from || !to) return false;
-    
-    auto fromType = from->type();
-    auto toType = to->type();
-
-    if (fromType == HardwareModule::CACHE_EVENT_TRACER || toType == HardwareModule::CACHE_EVENT_TRACER) {
-        return false;
-    }
-
-    auto getHardwareIndex = [](HardwareModule* module) -> int {
-        QRegularExpression re("(\\d+)$");
-        QRegularExpressionMatch match = re.match(module->name());
-        if (match.hasMatch()) {
-            return match.captured(1).toInt();
-        }
-        return -1;
-    };
-
-    int fromIndex = getHardwareIndex(from);
-    int toIndex = getHardwareIndex(to);
-
-    if (fromType == HardwareModule::CPU_CORE && toType == HardwareModule::CACHE_L2) {
-        return fromIndex == toIndex;
-    }
-    
-    if (fromType == HardwareModule::CACHE_L2) {
-        if (toType == HardwareModule::CPU_CORE) {
-            return fromIndex == toIndex;
-        }
-        else if (toType == HardwareModule::CACHE_L3) {
-            return true;
-        }
-        else {
-            return false;
-        }
-    }
-    
-    if (fromType == HardwareModule::CACHE_L3) {
-        if (toType == HardwareModule::CACHE_L2) {
-            return true;
-        }
-        else if (toType == HardwareModule::BUS) {
-            return true;
-        }
-        else if (toType == HardwareModule::CACHE_L3) {
-            return true;
-        }
-        else {
-            return false;
-        }
-    }
-    
-    if (fromType == HardwareModule::BUS) {
-        return toType == HardwareModule::CACHE_L3 || 
-               toType == HardwareModule::MEMORY_CTRL || 
-               toType == HardwareModule::DMA;
-    }
-    
-    if (fromType == HardwareModule::MEMORY_CTRL) {
-        return toType == HardwareModule::BUS;
-    }
-    
-    if (fromType == HardwareModule::DMA) {
-        return toType == HardwareModule::BUS;
-    }
-    
-    return false;
-}
-
-void HardwareVisualizer::drawGrid()
-{
-    const int gridSize = 50;
-    const int sceneWidth = 1000;
-    const int sceneHeight = 1000;
-    
-    QPen gridPen(QColor(60, 60, 60, 120), 1, Qt::DotLine);
-    
-    for (int y = -sceneHeight/2; y <= sceneHeight/2; y += gridSize) {
-        QGraphicsLineItem *line = m_scene->addLine(-sceneWidth/2, y, sceneWidth/2, y, gridPen);
-        line->setZValue(-1000);
-    }
-    
-    for (int x = -sceneWidth/2; x <= sceneWidth/2; x += gridSize) {
-        QGraphicsLineItem *line = m_scene->addLine(x, -sceneHeight/2, x, sceneHeight/2, gridPen);
-        line->setZValue(-1000);
-    }
+    return m_itemModules.value(item, nullptr);
 }
 
 void HardwareVisualizer::loadModuleIcons()
@@ -732,22 +1433,217 @@ void HardwareVisualizer::loadModuleIcons()
     }
 }
 
+QGraphicsItem* HardwareVisualizer::createGroupItem(const ModuleGroups::Group& group)
+{
+    QGraphicsItemGroup* item = new QGraphicsItemGroup;
+    item->setData(Qt::UserRole, "group");
+
+    QGraphicsPixmapItem* pixmapItem = new QGraphicsPixmapItem(createGroupIcon(group.level));
+    QGraphicsDropShadowEffect* shadow = new QGraphicsDropShadowEffect();
+    shadow->setOffset(3, 3);
+    shadow->setBlurRadius(10);
+    shadow->setColor(QColor(0, 0, 0, 80));
+    pixmapItem->setGraphicsEffect(shadow);
+    item->addToGroup(pixmapItem);
+
+    QGraphicsTextItem* nameText = new QGraphicsTextItem(group.name);
+    nameText->setDefaultTextColor(Qt::white);
+    QFont nameFont = nameText->font();
+    nameFont.setBold(true);
+    nameFont.setPointSize(10);
+    nameText->setFont(nameFont);
+    nameText->setPos(10, -10);
+    nameText->setData(Qt::UserRole, "name");
+    item->addToGroup(nameText);
+
+    QGraphicsTextItem* statsTextItem = new QGraphicsTextItem(createGroupStatsText(group));
+    statsTextItem->setDefaultTextColor(Qt::white);
+    QFont statsFont = statsTextItem->font();
+    statsFont.setPointSize(8);
+    statsTextItem->setFont(statsFont);
+    statsTextItem->setPos(10, 90);
+    statsTextItem->setData(Qt::UserRole, "stats");
+    item->addToGroup(statsTextItem);
+
+    return item;
+}
+
+QPixmap HardwareVisualizer::createGroupIcon(ModuleGroups::Level level) const
+{
+    QColor color;
+    switch (level) {
+        case ModuleGroups::CLUSTER:
+            color = QColor(65, 105, 225);
+            break;
+        case ModuleGroups::SOCKET:
+            color = QColor(106, 90, 205);
+            break;
+        default:
+            color = QColor(112, 128, 144);
+            break;
+    }
+
+    QPixmap icon(150, 100);
+    icon.fill(Qt::transparent);
+    QPainter painter(&icon);
+    painter.setRenderHint(QPainter::Antialiasing);
+
+    // 叠放的卡片表示折叠的多个模块
+    QLinearGradient gradient(0, 0, 0, 100);
+    gradient.setColorAt(0, color.lighter(120));
+    gradient.setColorAt(1, color);
+    painter.setPen(QPen(Qt::black, 1));
+    painter.setBrush(color.darker(130));
+    painter.drawRoundedRect(18, 4, 126, 78, 10, 10);
+    painter.setBrush(QBrush(gradient));
+    painter.drawRoundedRect(10, 12, 126, 78, 10, 10);
+
+    painter.setPen(Qt::white);
+    QFont font = painter.font();
+    font.setBold(true);
+    font.setPointSize(12);
+    painter.setFont(font);
+
+    QString typeName = ModuleGroups::levelName(level);
+    QFontMetrics fm(font);
+    painter.drawText(QPointF(73 - fm.horizontalAdvance(typeName) / 2, 57), typeName);
+
+    return icon;
+}
+
+QString HardwareVisualizer::createGroupStatsText(const ModuleGroups::Group& group) const
+{
+    static const int instKey = StatKeyRegistry::instance().intern("finished_inst_count");
+    static const int ldHitKey = StatKeyRegistry::instance().intern("ld_cache_hit_count");
+    static const int ldMissKey = StatKeyRegistry::instance().intern("ld_cache_miss_count");
+    static const int llcHitKey = StatKeyRegistry::instance().intern("llc_hit_count");
+    static const int llcMissKey = StatKeyRegistry::instance().intern("llc_miss_count");
+
+    QString text;
+    if (group.coreCount > 0) {
+        text += QString("Cores: %1\n").arg(group.coreCount);
+    } else {
+        text += QString("Modules: %1\n").arg(group.members.size());
+    }
+
+    const auto &sums = group.sums;
+    if (sums.contains(instKey)) {
+        text += formatStatistic("Instructions", sums.value(instKey)) + "\n";
+    }
+    double ldTotal = sums.value(ldHitKey) + sums.value(ldMissKey);
+    if (ldTotal > 0) {
+        text += formatStatistic("Load Hit Rate", sums.value(ldHitKey) / ldTotal) + "\n";
+    }
+    double llcTotal = sums.value(llcHitKey) + sums.value(llcMissKey);
+    if (llcTotal > 0) {
+        text += formatStatistic("Cache Hit Rate", sums.value(llcHitKey) / llcTotal) + "\n";
+    }
+
+    return text;
+}
+
 void HardwareVisualizer::setBackgroundBrush(const QBrush &brush)
 {
     QGraphicsView::setBackgroundBrush(brush);
 }
 
+void HardwareVisualizer::highlightModules(const QList<HardwareModule*> &modules)
+{
+    QSet<HardwareModule*> highlightedModules(modules.begin(), modules.end());
+    for (auto it = m_moduleItems.begin(); it != m_moduleItems.end(); ++it) {
+        bool highlighted = highlightedModules.contains(it.key());
+        for (auto child : it.value()->childItems()) {
+            if (child->data(Qt::UserRole).toString() == "highlight") {
+                child->setVisible(highlighted);
+                break;
+            }
+        }
+    }
+}
+
+void HardwareVisualizer::focusModule(HardwareModule* module)
+{
+    if (auto item = m_moduleItems.value(module)) {
+        centerOn(item);
+        ensureVisible(item, 50, 50);
+    }
+}
+
 void HardwareVisualizer::mousePressEvent(QMouseEvent *event)
 {
+    if (event->button() == Qt::LeftButton) {
+        QPointF scenePos = mapToScene(event->pos());
+        if (HardwareModule* module = getModuleAtPosition(scenePos)) {
+            QGraphicsItem* item = m_moduleItems.value(module);
+            // Ctrl+单击切换选中；单击未选中的模块时只选中该模块，拖动时移动全部选中的模块
+            if (event->modifiers() & Qt::ControlModifier) {
+                item->setSelected(!item->isSelected());
+                event->accept();
+                return;
+            }
+            if (!item->isSelected()) {
+                m_scene->clearSelection();
+                item->setSelected(true);
+            }
+            m_draggedModule = module;
+            m_draggedItem = item;
+            m_lastMousePos = scenePos;
+            event->accept();
+            return;
+        }
+    }
     QGraphicsView::mousePressEvent(event);
 }
 
 void HardwareVisualizer::mouseMoveEvent(QMouseEvent *event)
 {
+    if (m_draggedModule) {
+        QPointF scenePos = mapToScene(event->pos());
+        const QPointF delta = scenePos - m_lastMousePos;
+        QHash<HardwareModule*, QPointF> positions;
+        for (auto module : selectedModules()) {
+            positions.insert(module, module->position() + delta);
+        }
+        positions.insert(m_draggedModule, m_draggedModule->position() + delta);
+        setModulePositions(positions);
+        m_lastMousePos = scenePos;
+        event->accept();
+        return;
+    }
+
+    // 悬停在连接上时高亮并显示两个方向的数据包数与使用率
+    if (event->buttons() == Qt::NoButton) {
+        QPointF scenePos = mapToScene(event->pos());
+        int index = getModuleAtPosition(scenePos) ? -1 : m_connections->edgeAt(scenePos, 6.0 / transform().m11());
+        if (index != m_connections->hoveredEdge()) {
+            m_connections->setHoveredEdge(index);
+            if (index >= 0) {
+                const auto &edge = m_connections->edge(index);
+                QString text = QString("%1 → %2: %3\n%2 → %1: %4")
+                    .arg(edge.from->name(), edge.to->name())
+                    .arg(edge.traffic.forward, 0, 'f', 0)
+                    .arg(edge.traffic.backward, 0, 'f', 0);
+                if (edge.traffic.busyRate >= 0) {
+                    text += QString("\n使用率: %1%").arg(edge.traffic.busyRate * 100, 0, 'f', 2);
+                }
+                QToolTip::showText(event->globalPosition().toPoint(), text, this);
+            } else {
+                QToolTip::hideText();
+            }
+        }
+    }
     QGraphicsView::mouseMoveEvent(event);
 }
 
 void HardwareVisualizer::mouseReleaseEvent(QMouseEvent *event)
 {
+    if (m_draggedModule && event->button() == Qt::LeftButton) {
+        HardwareModule* module = m_draggedModule;
+        m_draggedModule = nullptr;
+        m_draggedItem = nullptr;
+        emit moduleMoved(module);
+        event->accept();
+        return;
+    }
     QGraphicsView::mouseReleaseEvent(event);
 } 
@@ -7,8 +7,20 @@
 #include <QMap>
 #include <QColor>
 #include <QPixmap>
+#include <QSet>
+#include <QTimer>
 #include "hardwaremodule.h"
+#include "bustopology.h"
+#include "modulegroups.h"
 #include "moduleinfodialog.h"
+#include "connectionlayer.h"
+#include "packetreplay.h"
+#include "latencymodel.h"
+#include "statistichistory.h"
+#include "sparklineitem.h"
+#include "modulecomparedialog.h"
+
+class MemoryAccounting;
 
 class HardwareVisualizer : public QGraphicsView
 {
@@ -20,16 +32,56 @@ public:
 
     // 添加硬件模块到场景
     void addModule(HardwareModule* module);
+    // 从场景中移除模块（不删除模块对象），拓扑在下次布局或绘制连接时重建
+    void removeModule(HardwareModule* module);
     // 更新模块位置
     void updateModulePosition(HardwareModule* module);
     // 清除所有模块
     void clearModules();
-    // 自动布局所有模块
-    void autoLayout();
+    // 自动布局，fixedModules 中的模块保持当前位置（如从布局缓存恢复的模块）
+    void autoLayout(const QSet<HardwareModule*> &fixedModules = QSet<HardwareModule*>());
+    // 先放置给定位置的模块（如布局缓存中的位置），再对其余模块自动布局，只重绘一次连接线
+    void autoLayout(const QHash<HardwareModule*, QPointF> &fixedPositions);
     // 绘制连接线
     void drawConnections();
+    // 按当前模块的端口与总线配置重建总线拓扑索引（配置加载完成后调用）
+    void refreshTopology();
+    const BusTopology& topology() const { return m_topology; }
+    // 语义缩放：缩小视图时将核心折叠为簇、插槽或芯片，显示分组的汇总统计
+    void setSemanticZoomEnabled(bool enabled);
+    bool isSemanticZoomEnabled() const { return m_semanticZoom; }
+    // 流量动画：有流量的连接上显示沿主要流向移动的虚线
+    void setFlowAnimationEnabled(bool enabled);
+    bool isFlowAnimationEnabled() const { return m_connections->isFlowAnimated(); }
+    // 在场景中显示数据包回放的在途数据包
+    void setPacketReplay(PacketReplay* replay);
+    // 模块信息对话框中编辑 What-if 参数所用的延迟模型
+    void setLatencyModel(LatencyModel* model) { m_latencyModel = model; }
+    // 迷你走势图的数据来源
+    void setStatisticHistory(StatisticHistory* history);
+    // 按模块类型设置走势图显示的统计项，key 为空时该类型不显示；rate 为 true 时显示每秒变化量
+    void setSparklineMetric(HardwareModule::ModuleType type, const QString &key, bool rate);
+    QString sparklineMetric(HardwareModule::ModuleType type) const;
+    void setSparklinesEnabled(bool enabled);
+    bool isSparklinesEnabled() const { return m_sparklinesEnabled; }
     // 设置背景样式
     void setBackgroundBrush(const QBrush &brush);
+    // 高亮指定模块（清除其它模块的高亮）
+    void highlightModules(const QList<HardwareModule*> &modules);
+    // 将视图聚焦到指定模块
+    void focusModule(HardwareModule* module);
+    // 当前选中的模块（框选或 Ctrl+单击）
+    QList<HardwareModule*> selectedModules() const;
+    // 批量设置模块位置，全部更新后只重绘一次连接线
+    void setModulePositions(const QHash<HardwareModule*, QPointF> &positions);
+    // 上报场景图形项、文本文档与像素图占用的内存
+    void accountMemory(MemoryAccounting &accounting) const;
+
+signals:
+    // 用户拖动模块结束
+    void moduleMoved(HardwareModule* module);
+    // 模块集合或总线拓扑发生变化
+    void topologyChanged();
 
 protected:
     // 处理鼠标事件，用于拖拽模块
@@ -40,20 +92,73 @@ protected:
     void wheelEvent(QWheelEvent *event) override;
     // 处理双击事件
     void mouseDoubleClickEvent(QMouseEvent *event) override;
+    // 在视图左下角绘制连接流量图例
+    void drawForeground(QPainter *painter, const QRectF &rect) override;
+    // 所选模块的批量操作菜单
+    void contextMenuEvent(QContextMenuEvent *event) override;
 
 private:
     QGraphicsScene *m_scene;
     QMap<HardwareModule*, QGraphicsItem*> m_moduleItems;
+    QHash<QGraphicsItem*, HardwareModule*> m_itemModules;  // 模块图形项到模块的反向映射
+    ConnectionLayer* m_connections;  // 所有连接线的批量绘制图形项
+    PacketReplay* m_packetReplay;
+    PacketFlowLayer* m_packets;      // 数据包回放的在途数据包
+    LatencyModel* m_latencyModel;    // What-if 延迟模型
     QGraphicsItem* m_draggedItem;
+    HardwareModule* m_draggedModule;
     QPointF m_lastMousePos;
-    HardwareModule* m_busModule;  // 保存总线模块的引用
+    bool m_layoutInProgress;  // 批量布局期间暂停逐个模块重绘连接线
+    BusTopology m_topology;  // 多总线拓扑与端口索引
+    bool m_topologyDirty;  // 模块集合变化后需要重建拓扑索引
+    ModuleGroups m_groups;  // 语义缩放的分层分组
+    QVector<QVector<QGraphicsItem*>> m_groupItems;  // 层级 -> 分组下标 -> 分组图形项
+    QHash<HardwareModule*, QGraphicsItem*> m_collapsedInto;  // 被折叠的模块 -> 所在分组图形项
+    ModuleGroups::Level m_zoomLevel;
+    bool m_semanticZoom;
+    QSet<int> m_dirtyGroups;  // 当前层级中汇总统计待刷新的分组
+    QTimer m_groupUpdateTimer;
+    QTimer m_trafficUpdateTimer;  // 合并总线流量变化，定时重新计算连接的绘制样式
+    QTimer m_flowTimer;           // 流量动画帧
     ModuleInfoDialog* m_infoDialog;  // 信息显示对话框
+
+    // 迷你走势图
+    struct SparklineMetric {
+        int keyId = -1;
+        bool rate = false;
+    };
+    struct Sparkline {
+        SparklineItem* item;
+        double lastTime;   // 上一个样本，用于计算每秒变化量
+        double lastValue;
+        bool hasLast;
+    };
+    StatisticHistory* m_history;
+    QHash<int, SparklineMetric> m_sparklineMetrics;  // 模块类型 -> 统计项
+    QHash<HardwareModule*, Sparkline> m_sparklines;
+    bool m_sparklinesEnabled;
+    QSet<HardwareModule*> m_dirtySparklines;  // 有新样本待追加的模块
+    QTimer m_sparklineTimer;
+
+    // 手动折叠的所选模块，只在逐个模块显示的层级生效
+    struct SelectionGroup {
+        ModuleGroups::Group group;
+        QGraphicsItem* item;
+    };
+    QVector<SelectionGroup> m_selectionGroups;
+    QSet<int> m_dirtySelectionGroups;
+    int m_selectionGroupCounter;
+    ModuleCompareDialog* m_compareDialog;
     
     // 硬件模块图标
     QMap<HardwareModule::ModuleType, QPixmap> m_moduleIcons;
 
     // 创建不同类型硬件模块的图形项
     QGraphicsItem* createModuleItem(HardwareModule* module);
+    // 按当前设置创建、替换或移除模块的走势图，新建时用历史中最近的样本填充
+    void updateSparkline(HardwareModule* module);
+    void appendSparklineSample(Sparkline &sparkline, double time, double value, bool rate);
+    void flushSparklines();
     // 更新模块的统计信息显示
     void updateStatistics(HardwareModule* module);
     // 获取模块颜色
@@ -62,20 +167,52 @@ private:
     QString getModuleTypeName(HardwareModule::ModuleType type) const;
     // 创建统计信息文本
     QString createStatsText(HardwareModule* module) const;
-    // 获取模块的连接点位置
-    QPointF getConnectionPoint(HardwareModule* module, const QPointF& otherPos);
+    // 按当前模块位置更新数据包回放的路由
+    void updatePacketRoutes();
     // 获取点击位置对应的模块
     HardwareModule* getModuleAtPosition(const QPointF& pos) const;
-    // 获取两个模块之间的数据传输量
-    double getDataTransferRate(HardwareModule* from, HardwareModule* to) const;
     // 格式化统计信息
     QString formatStatistic(const QString& key, double value) const;
-    // 检查两个模块之间是否有有效的逻辑连接
-    bool isValidLogicalConnection(HardwareModule* from, HardwareModule* to) const;
-    // 绘制网格线
-    void drawGrid();
+    // 按总线拓扑枚举所有逻辑连接（CPU-L2 同编号，L2/L3/内存/DMA 限于同一总线）
+    QVector<QPair<HardwareModule*, HardwareModule*>> logicalConnections() const;
+    // 单条总线及其模块的布局，坐标相对于总线带中心
+    QHash<HardwareModule*, QPointF> layoutBusBand(HardwareModule* bus, const QVector<HardwareModule*> &members) const;
     // 加载模块图标
     void loadModuleIcons();
+    // 创建分组图形项
+    QGraphicsItem* createGroupItem(const ModuleGroups::Group& group);
+    QPixmap createGroupIcon(ModuleGroups::Level level) const;
+    // 分组汇总统计文本
+    QString createGroupStatsText(const ModuleGroups::Group& group) const;
+    // 根据缩放比例选择显示层级
+    ModuleGroups::Level zoomLevelForScale(double scale) const;
+    // 缩放比例变化后切换显示层级
+    void applySemanticZoom();
+    // 按当前层级隐藏被折叠的模块并显示分组
+    void updateCollapsedItems();
+    void updateGroupStatistics(int index);
+    void flushGroupStatistics();
+
+    // 所选模块的批量操作
+    enum Alignment {
+        ALIGN_LEFT,
+        ALIGN_HCENTER,
+        ALIGN_RIGHT,
+        ALIGN_TOP,
+        ALIGN_VCENTER,
+        ALIGN_BOTTOM,
+        DISTRIBUTE_HORIZONTAL,
+        DISTRIBUTE_VERTICAL
+    };
+    void alignModules(const QList<HardwareModule*> &modules, Alignment alignment);
+    void collapseModules(const QList<HardwareModule*> &modules);
+    void expandSelectionGroup(int index);
+    void compareModules(const QList<HardwareModule*> &modules);
+    // 隐藏手动折叠的模块并显示其分组
+    void applySelectionGroups();
+    void updateSelectionGroupStatistics(int index);
+    // 图形项对应的手动分组下标，不是手动分组时为-1
+    int selectionGroupAt(QGraphicsItem* item) const;
 };
 
 #endif // HARDWAREVISUALIZER_H 
\ No newline at end of file
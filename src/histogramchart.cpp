@@ -0,0 +1,168 @@
+#include "histogramchart.h"
+#include <QPainter>
+#include <QPainterPath>
+#include <QFontMetrics>
+#include <cmath>
+
+namespace {
+
+const int kMargin = 8;
+const int kAxisWidth = 52;
+const int kAxisHeight = 20;
+const int kLegendHeight = 18;
+const int kMinFloorExponent = -6;
+
+QString formatValue(double value)
+{
+    return value >= 1e4 ? QString::number(value, 'g', 3) : QString::number(value, 'f', value < 10 ? 1 : 0);
+}
+
+} // namespace
+
+HistogramChart::HistogramChart(QWidget *parent)
+    : QWidget(parent)
+{
+    m_primary.color = QColor(30, 144, 255);
+    m_reference.color = QColor(255, 140, 0);
+    setMinimumHeight(180);
+}
+
+void HistogramChart::setHistogram(const StatisticHistogram &histogram, const QString &label)
+{
+    m_primary.histogram = histogram;
+    m_primary.label = label;
+    update();
+}
+
+void HistogramChart::setReference(const StatisticHistogram &histogram, const QString &label)
+{
+    m_reference.histogram = histogram;
+    m_reference.label = label;
+    update();
+}
+
+QSize HistogramChart::sizeHint() const
+{
+    return QSize(420, 240);
+}
+
+void HistogramChart::paintEvent(QPaintEvent *event)
+{
+    Q_UNUSED(event);
+
+    QPainter painter(this);
+    painter.fillRect(rect(), palette().color(QPalette::Base));
+    painter.setPen(palette().color(QPalette::Text));
+
+    if (m_primary.histogram.isEmpty()) {
+        painter.drawText(rect(), Qt::AlignCenter, "No distribution data");
+        return;
+    }
+
+    QVector<const Series*> series = {&m_primary};
+    if (!m_reference.histogram.isEmpty()) {
+        series.append(&m_reference);
+    }
+
+    // 横轴为对数延迟，纵轴为对数比例，下限取最大样本数对应的最小比例
+    double xLow = m_primary.histogram.min();
+    double xHigh = m_primary.histogram.max();
+    quint64 maxCount = 0;
+    for (const Series *s : series) {
+        xLow = qMin(xLow, s->histogram.min());
+        xHigh = qMax(xHigh, s->histogram.max());
+        maxCount = qMax(maxCount, s->histogram.count());
+    }
+    xLow = qMax(1.0, xLow);
+    xHigh = qMax(xHigh * 1.05, xLow * 10);
+    const double logXLow = std::log10(xLow);
+    const double logXHigh = std::log10(xHigh);
+    const int floorExponent = qBound(kMinFloorExponent, int(std::floor(std::log10(1.0 / double(maxCount)))), -1);
+    const double yFloor = std::pow(10.0, floorExponent);
+
+    const int legendHeight = kLegendHeight * series.size();
+    const QRectF plot(kAxisWidth, kMargin + legendHeight,
+                      qMax(10, width() - kAxisWidth - kMargin),
+                      qMax(10, height() - kMargin * 2 - legendHeight - kAxisHeight));
+    auto mapX = [&](double value) {
+        return plot.left() + (std::log10(qMax(value, xLow)) - logXLow) / (logXHigh - logXLow) * plot.width();
+    };
+    auto mapY = [&](double fraction) {
+        return plot.top() + std::log10(qMax(fraction, yFloor)) / double(floorExponent) * plot.height();
+    };
+
+    // 坐标网格
+    QFontMetrics fm(font());
+    QColor gridColor = palette().color(QPalette::Mid);
+    gridColor.setAlpha(120);
+    for (int exponent = 0; exponent >= floorExponent; --exponent) {
+        double y = mapY(std::pow(10.0, exponent));
+        painter.setPen(gridColor);
+        painter.drawLine(QPointF(plot.left(), y), QPointF(plot.right(), y));
+        painter.setPen(palette().color(QPalette::Text));
+        QString label = exponent >= -2 ? QString("%1%").arg(std::pow(10.0, exponent + 2), 0, 'f', 0)
+                                       : QString("1e%1").arg(exponent);
+        painter.drawText(QRectF(0, y - 8, kAxisWidth - 4, 16), Qt::AlignRight | Qt::AlignVCenter, label);
+    }
+    for (int exponent = int(std::ceil(logXLow)); exponent <= int(std::floor(logXHigh)); ++exponent) {
+        double x = mapX(std::pow(10.0, exponent));
+        painter.setPen(gridColor);
+        painter.drawLine(QPointF(x, plot.top()), QPointF(x, plot.bottom()));
+        painter.setPen(palette().color(QPalette::Text));
+        painter.drawText(QRectF(x - 30, plot.bottom() + 2, 60, kAxisHeight - 2), Qt::AlignHCenter | Qt::AlignTop,
+                         formatValue(std::pow(10.0, exponent)));
+    }
+    painter.drawText(QRectF(plot.right() - 120, plot.bottom() + 2, 120, kAxisHeight - 2),
+                     Qt::AlignRight | Qt::AlignTop, "cycles");
+
+    // 百分位参考线
+    QPen guidePen(palette().color(QPalette::Text), 1.0, Qt::DotLine);
+    for (const auto &suffix : StatisticHistogram::percentileSuffixes()) {
+        double fraction = 1.0 - suffix.second / 100.0;
+        if (fraction < yFloor) continue;
+        double y = mapY(fraction);
+        painter.setPen(guidePen);
+        painter.drawLine(QPointF(plot.left(), y), QPointF(plot.right(), y));
+        painter.drawText(QRectF(plot.right() - 60, y - 16, 58, 16), Qt::AlignRight | Qt::AlignBottom,
+                         suffix.first.mid(1));
+    }
+
+    // 互补累积分布：每个桶内按线性插值下降
+    painter.setRenderHint(QPainter::Antialiasing);
+    int legendY = kMargin;
+    for (const Series *s : series) {
+        const StatisticHistogram &histogram = s->histogram;
+        const double total = double(histogram.count());
+        QPainterPath path;
+        path.moveTo(mapX(xLow), mapY(1.0));
+        quint64 remaining = histogram.count();
+        for (int i = 0; i < histogram.bucketCount(); ++i) {
+            const quint64 samples = histogram.bucketSamples(i);
+            if (samples == 0) continue;
+
+            const double lower = qBound(histogram.min(), StatisticHistogram::bucketLowerBound(i), histogram.max());
+            const double upper = qBound(histogram.min(), StatisticHistogram::bucketUpperBound(i), histogram.max());
+            path.lineTo(mapX(lower), mapY(double(remaining) / total));
+            remaining -= samples;
+            if (remaining == 0) {
+                path.lineTo(mapX(upper), plot.bottom());
+                break;
+            }
+            path.lineTo(mapX(upper), mapY(double(remaining) / total));
+        }
+        painter.setPen(QPen(s->color, 2.0));
+        painter.drawPath(path);
+
+        QString legend = QString("%1  n=%2  p50=%3  p99=%4  p999=%5")
+                             .arg(s->label)
+                             .arg(histogram.count())
+                             .arg(formatValue(histogram.percentile(50)))
+                             .arg(formatValue(histogram.percentile(99)))
+                             .arg(formatValue(histogram.percentile(99.9)));
+        painter.fillRect(QRectF(kAxisWidth, legendY + 4, 10, 10), s->color);
+        painter.setPen(palette().color(QPalette::Text));
+        painter.drawText(QRectF(kAxisWidth + 14, legendY, plot.width() - 14, kLegendHeight), Qt::AlignLeft | Qt::AlignVCenter,
+                         fm.elidedText(legend, Qt::ElideMiddle, int(plot.width()) - 14));
+        legendY += kLegendHeight;
+    }
+}
@@ -0,0 +1,38 @@
+#ifndef HISTOGRAMCHART_H
+#define HISTOGRAMCHART_H
+
+#include <QWidget>
+#include <QString>
+#include <QColor>
+#include "statistichistogram.h"
+
+// 分布图：以双对数坐标绘制互补累积分布（超过某延迟的样本比例），
+// 尾部差异在右下方展开；p50/p99/p999 为水平参考线。可叠加一条参照分布（如同类模块合并）
+class HistogramChart : public QWidget
+{
+    Q_OBJECT
+
+public:
+    explicit HistogramChart(QWidget *parent = nullptr);
+
+    void setHistogram(const StatisticHistogram &histogram, const QString &label);
+    // 参照分布为空时不绘制
+    void setReference(const StatisticHistogram &histogram, const QString &label);
+
+    QSize sizeHint() const override;
+
+protected:
+    void paintEvent(QPaintEvent *event) override;
+
+private:
+    struct Series {
+        StatisticHistogram histogram;
+        QString label;
+        QColor color;
+    };
+
+    Series m_primary;
+    Series m_reference;
+};
+
+#endif // HISTOGRAMCHART_H
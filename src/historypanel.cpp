@@ -0,0 +1,119 @@
+#include "historypanel.h"
+#include "statkeyregistry.h"
+#include <QVBoxLayout>
+#include <QHBoxLayout>
+#include <QLabel>
+#include <QSignalBlocker>
+#include <algorithm>
+
+HistoryPanel::HistoryPanel(StatisticHistory* history, QWidget *parent)
+    : QDockWidget("统计历史", parent)
+    , m_history(history)
+    , m_shownModule(nullptr)
+    , m_shownKey(-1)
+{
+    QWidget* content = new QWidget(this);
+    QVBoxLayout* layout = new QVBoxLayout(content);
+    layout->setContentsMargins(4, 4, 4, 4);
+
+    QHBoxLayout* selectLayout = new QHBoxLayout;
+    m_moduleCombo = new QComboBox(content);
+    m_keyCombo = new QComboBox(content);
+    m_keyCombo->setMinimumContentsLength(24);
+    selectLayout->addWidget(new QLabel("模块", content));
+    selectLayout->addWidget(m_moduleCombo);
+    selectLayout->addWidget(new QLabel("统计项", content));
+    selectLayout->addWidget(m_keyCombo, 1);
+    layout->addLayout(selectLayout);
+
+    m_chart = new TimeSeriesChart(content);
+    m_chart->setToolTip("滚轮缩放，拖动平移，双击恢复全部范围并跟随最新数据");
+    layout->addWidget(m_chart, 1);
+
+    setWidget(content);
+
+    connect(m_history, &StatisticHistory::modulesChanged, this, &HistoryPanel::refreshModules);
+    connect(m_history, &StatisticHistory::sampleAdded, this, &HistoryPanel::onSampleAdded);
+    connect(m_history, &StatisticHistory::seriesRemoved, this, &HistoryPanel::onSeriesRemoved);
+    connect(m_moduleCombo, QOverload<int>::of(&QComboBox::currentIndexChanged), this, &HistoryPanel::refreshKeys);
+    connect(m_keyCombo, QOverload<int>::of(&QComboBox::currentIndexChanged), this, &HistoryPanel::showSelected);
+    refreshModules();
+}
+
+HardwareModule* HistoryPanel::selectedModule() const
+{
+    const QString name = m_moduleCombo->currentText();
+    for (auto module : m_history->modules()) {
+        if (module->name() == name) return module;
+    }
+    return nullptr;
+}
+
+void HistoryPanel::refreshModules()
+{
+    const QString current = m_moduleCombo->currentText();
+    {
+        QSignalBlocker blocker(m_moduleCombo);
+        m_moduleCombo->clear();
+        for (auto module : m_history->modules()) {
+            m_moduleCombo->addItem(module->name());
+        }
+        const int index = m_moduleCombo->findText(current);
+        m_moduleCombo->setCurrentIndex(index >= 0 ? index : 0);
+    }
+    refreshKeys();
+}
+
+void HistoryPanel::refreshKeys()
+{
+    const QString current = m_keyCombo->currentText();
+    {
+        QSignalBlocker blocker(m_keyCombo);
+        m_keyCombo->clear();
+        if (HardwareModule* module = selectedModule()) {
+            auto &registry = StatKeyRegistry::instance();
+            QVector<QPair<QString, int>> keys;
+            for (int keyId : m_history->keys(module)) {
+                keys.append(qMakePair(registry.name(keyId), keyId));
+            }
+            std::sort(keys.begin(), keys.end());
+            for (const auto &key : keys) {
+                m_keyCombo->addItem(key.first, key.second);
+            }
+        }
+        const int index = m_keyCombo->findText(current);
+        m_keyCombo->setCurrentIndex(index >= 0 ? index : 0);
+    }
+    showSelected();
+}
+
+void HistoryPanel::showSelected()
+{
+    HardwareModule* module = selectedModule();
+    const int keyId = m_keyCombo->currentIndex() >= 0 ? m_keyCombo->currentData().toInt() : -1;
+    if (module == m_shownModule && keyId == m_shownKey) return;
+
+    m_shownModule = module;
+    m_shownKey = keyId;
+    const TimeSeries* series = module ? m_history->series(module, keyId) : nullptr;
+    m_chart->setSeries(series, series ? QString("%1.%2").arg(module->name(), m_keyCombo->currentText()) : QString());
+}
+
+void HistoryPanel::onSampleAdded(HardwareModule* module, int keyId)
+{
+    if (module == m_shownModule && keyId == m_shownKey) {
+        m_chart->seriesUpdated();
+    } else if (module == selectedModule() && m_keyCombo->findData(keyId) < 0) {
+        // 所选模块出现新的统计项
+        refreshKeys();
+    }
+}
+
+void HistoryPanel::onSeriesRemoved(HardwareModule* module)
+{
+    if (!module || module == m_shownModule) {
+        m_shownModule = nullptr;
+        m_shownKey = -1;
+        m_chart->setSeries(nullptr, QString());
+    }
+}
@@ -0,0 +1,35 @@
+#ifndef HISTORYPANEL_H
+#define HISTORYPANEL_H
+
+#include <QDockWidget>
+#include <QComboBox>
+#include "statistichistory.h"
+#include "timeserieschart.h"
+
+// 统计历史面板：选择模块与统计项，绘制其随时间的变化
+class HistoryPanel : public QDockWidget
+{
+    Q_OBJECT
+
+public:
+    explicit HistoryPanel(StatisticHistory* history, QWidget *parent = nullptr);
+
+private slots:
+    void refreshModules();
+    void refreshKeys();
+    void showSelected();
+    void onSampleAdded(HardwareModule* module, int keyId);
+    void onSeriesRemoved(HardwareModule* module);
+
+private:
+    HardwareModule* selectedModule() const;
+
+    StatisticHistory* m_history;
+    QComboBox* m_moduleCombo;
+    QComboBox* m_keyCombo;
+    TimeSeriesChart* m_chart;
+    HardwareModule* m_shownModule;
+    int m_shownKey;
+};
+
+#endif // HISTORYPANEL_H
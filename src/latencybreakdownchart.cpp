@@ -0,0 +1,214 @@
+#include "latencybreakdownchart.h"
+#include <QPainter>
+#include <QHelpEvent>
+#include <QToolTip>
+#include <QFontMetrics>
+#include <algorithm>
+
+namespace {
+
+const int kMargin = 8;
+const int kRowHeight = 20;
+const int kLabelWidth = 190;
+const int kValueWidth = 130;
+
+} // namespace
+
+LatencyBreakdownChart::LatencyBreakdownChart(CacheEventModel* model, QWidget *parent)
+    : QWidget(parent)
+    , m_model(model)
+    , m_classMax(0.0)
+    , m_waterfallMax(0.0)
+{
+    setMinimumHeight(120);
+
+    // 高频的计数更新合并后再重新计算
+    m_rebuildTimer.setSingleShot(true);
+    m_rebuildTimer.setInterval(100);
+    connect(&m_rebuildTimer, &QTimer::timeout, this, [this]() {
+        rebuild();
+        updateGeometry();
+        update();
+    });
+    connect(m_model, &CacheEventModel::changed, this, [this]() {
+        if (!m_rebuildTimer.isActive()) {
+            m_rebuildTimer.start();
+        }
+    });
+
+    rebuild();
+}
+
+QSize LatencyBreakdownChart::sizeHint() const
+{
+    int rows = m_classRows.size() + m_waterfallRows.size() + 2;
+    return QSize(560, rows * kRowHeight + kMargin * 3);
+}
+
+QColor LatencyBreakdownChart::segmentColor(const QString &segmentName)
+{
+    static const QVector<QColor> palette = {
+        QColor(220, 20, 60), QColor(70, 130, 180), QColor(60, 179, 113), QColor(255, 140, 0),
+        QColor(138, 43, 226), QColor(30, 144, 255), QColor(218, 165, 32), QColor(199, 21, 133),
+        QColor(0, 139, 139), QColor(160, 82, 45)
+    };
+
+    auto it = m_segmentColors.constFind(segmentName);
+    if (it != m_segmentColors.constEnd()) return it.value();
+
+    QColor color = palette[m_segmentColors.size() % palette.size()];
+    m_segmentColors.insert(segmentName, color);
+    return color;
+}
+
+void LatencyBreakdownChart::rebuild()
+{
+    m_classRows.clear();
+    m_waterfallRows.clear();
+    m_classMax = 0.0;
+    m_waterfallMax = 0.0;
+
+    const QColor otherColor(128, 128, 128);
+    QHash<QString, double> segmentTicks;
+    QHash<QString, QString> segmentLabels;
+    double totalTicks = 0.0;
+    double attributedTicks = 0.0;
+
+    for (const auto &eventClass : m_model->eventClasses()) {
+        if (eventClass.count <= 0) continue;
+
+        double average = eventClass.averageLatency();
+        Row row;
+        row.label = eventClass.name;
+        row.valueText = QString("%1 cyc × %2").arg(average, 0, 'f', 1).arg(qint64(eventClass.count));
+
+        double start = 0.0;
+        double shareSum = 0.0;
+        for (const auto &segment : eventClass.segments) {
+            double length = average * segment.share;
+            row.bars.append({start, length, segmentColor(segment.name()),
+                             QString("%1 %2: %3 cyc (%4%)").arg(eventClass.name).arg(segment.label())
+                                 .arg(length, 0, 'f', 1).arg(segment.share * 100, 0, 'f', 1)});
+            start += length;
+            shareSum += segment.share;
+
+            segmentTicks[segment.name()] += eventClass.ticks * segment.share;
+            segmentLabels.insert(segment.name(), segment.label());
+            attributedTicks += eventClass.ticks * segment.share;
+        }
+        if (shareSum < 0.999) {
+            double length = average * (1.0 - shareSum);
+            row.bars.append({start, length, otherColor,
+                             QString("%1 未分段: %2 cyc").arg(eventClass.name).arg(length, 0, 'f', 1)});
+        }
+
+        m_classMax = qMax(m_classMax, average);
+        totalTicks += eventClass.ticks;
+        m_classRows.append(row);
+    }
+
+    if (totalTicks <= 0) return;
+
+    // 瀑布图：各分段按消耗周期从大到小依次接续，最后一行为总量
+    QStringList order = segmentTicks.keys();
+    std::sort(order.begin(), order.end(), [&segmentTicks](const QString &a, const QString &b) {
+        return segmentTicks.value(a) > segmentTicks.value(b);
+    });
+
+    double cumulative = 0.0;
+    for (const QString &name : order) {
+        double ticks = segmentTicks.value(name);
+        Row row;
+        row.label = segmentLabels.value(name);
+        row.valueText = QString("%1 cyc (%2%)").arg(qint64(ticks)).arg(ticks / totalTicks * 100, 0, 'f', 1);
+        row.bars.append({cumulative, ticks, segmentColor(name),
+                         QString("%1: %2 cyc").arg(row.label).arg(qint64(ticks))});
+        cumulative += ticks;
+        m_waterfallRows.append(row);
+    }
+
+    double residual = totalTicks - attributedTicks;
+    if (residual > 0.5) {
+        Row row;
+        row.label = "未分段";
+        row.valueText = QString("%1 cyc (%2%)").arg(qint64(residual)).arg(residual / totalTicks * 100, 0, 'f', 1);
+        row.bars.append({cumulative, residual, otherColor, QString("未分段: %1 cyc").arg(qint64(residual))});
+        m_waterfallRows.append(row);
+    }
+
+    Row total;
+    total.label = "Total";
+    total.valueText = QString("%1 cyc").arg(qint64(totalTicks));
+    total.bars.append({0.0, totalTicks, palette().color(QPalette::Mid), QString("Total: %1 cyc").arg(qint64(totalTicks))});
+    m_waterfallRows.append(total);
+    m_waterfallMax = qMax(totalTicks, cumulative);
+}
+
+void LatencyBreakdownChart::paintEvent(QPaintEvent *event)
+{
+    Q_UNUSED(event);
+
+    QPainter painter(this);
+    painter.fillRect(rect(), palette().color(QPalette::Base));
+    painter.setPen(palette().color(QPalette::Text));
+    m_hitRects.clear();
+
+    if (m_classRows.isEmpty()) {
+        painter.drawText(rect(), Qt::AlignCenter, "没有缓存事件数据");
+        return;
+    }
+
+    const double barLeft = kMargin + kLabelWidth;
+    const double barWidth = qMax(10.0, double(width()) - barLeft - kValueWidth - kMargin);
+    QFontMetrics fm(font());
+    int y = kMargin;
+
+    auto drawSection = [&](const QString &title, const QVector<Row> &rows, double maxValue) {
+        QFont titleFont = font();
+        titleFont.setBold(true);
+        painter.setFont(titleFont);
+        painter.setPen(palette().color(QPalette::Text));
+        painter.drawText(QRect(kMargin, y, width() - 2 * kMargin, kRowHeight), Qt::AlignLeft | Qt::AlignVCenter, title);
+        painter.setFont(font());
+        y += kRowHeight;
+
+        double scale = maxValue > 0 ? barWidth / maxValue : 0.0;
+        for (const Row &row : rows) {
+            painter.setPen(palette().color(QPalette::Text));
+            painter.drawText(QRect(kMargin, y, kLabelWidth - 6, kRowHeight), Qt::AlignLeft | Qt::AlignVCenter,
+                             fm.elidedText(row.label, Qt::ElideMiddle, kLabelWidth - 6));
+
+            for (const Bar &bar : row.bars) {
+                QRectF barRect(barLeft + bar.start * scale, y + 3, qMax(1.0, bar.length * scale), kRowHeight - 6);
+                painter.fillRect(barRect, bar.color);
+                m_hitRects.append(qMakePair(barRect, bar.tip));
+            }
+
+            painter.setPen(palette().color(QPalette::Text));
+            painter.drawText(QRect(int(barLeft + barWidth) + 6, y, kValueWidth - 6, kRowHeight),
+                             Qt::AlignLeft | Qt::AlignVCenter, row.valueText);
+            y += kRowHeight;
+        }
+        y += kMargin;
+    };
+
+    drawSection("平均缺失延迟（周期，按路径分段）", m_classRows, m_classMax);
+    drawSection("缺失周期去向", m_waterfallRows, m_waterfallMax);
+}
+
+bool LatencyBreakdownChart::event(QEvent *event)
+{
+    if (event->type() == QEvent::ToolTip) {
+        auto helpEvent = static_cast<QHelpEvent*>(event);
+        for (const auto &hit : m_hitRects) {
+            if (hit.first.contains(helpEvent->pos())) {
+                QToolTip::showText(helpEvent->globalPos(), hit.second, this);
+                return true;
+            }
+        }
+        QToolTip::hideText();
+        event->ignore();
+        return true;
+    }
+    return QWidget::event(event);
+}
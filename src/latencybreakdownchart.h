@@ -0,0 +1,57 @@
+#ifndef LATENCYBREAKDOWNCHART_H
+#define LATENCYBREAKDOWNCHART_H
+
+#include <QWidget>
+#include <QTimer>
+#include <QColor>
+#include <QVector>
+#include <QHash>
+#include <QRectF>
+#include "cacheeventmodel.h"
+
+// 缓存缺失延迟分解图：
+// 上半部分为每类事件的平均延迟堆叠条（按路径分段着色），
+// 下半部分为全部缺失周期按分段去向的瀑布图
+// 图形数据在模型变化时（合并后）重新计算，绘制时只做坐标换算
+class LatencyBreakdownChart : public QWidget
+{
+    Q_OBJECT
+
+public:
+    explicit LatencyBreakdownChart(CacheEventModel* model, QWidget *parent = nullptr);
+
+    QSize sizeHint() const override;
+
+protected:
+    void paintEvent(QPaintEvent *event) override;
+    bool event(QEvent *event) override;
+
+private:
+    struct Bar {
+        double start;   // 起始值（周期）
+        double length;  // 长度（周期）
+        QColor color;
+        QString tip;
+    };
+
+    struct Row {
+        QString label;
+        QString valueText;
+        QVector<Bar> bars;
+    };
+
+    void rebuild();
+    QColor segmentColor(const QString &segmentName);
+
+    CacheEventModel* m_model;
+    QTimer m_rebuildTimer;
+    QVector<Row> m_classRows;      // 每类事件的平均延迟
+    QVector<Row> m_waterfallRows;  // 缺失周期去向
+    double m_classMax;
+    double m_waterfallMax;
+    QHash<QString, QColor> m_segmentColors;
+    // 最近一次绘制的条形区域，用于提示
+    QVector<QPair<QRectF, QString>> m_hitRects;
+};
+
+#endif // LATENCYBREAKDOWNCHART_H
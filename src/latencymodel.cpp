@@ -0,0 +1,737 @@
+#include "latencymodel.h"
+#include "statkeyregistry.h"
+#include "bottleneckanalyzer.h"
+#include "bustopology.h"
+#include <QRegularExpression>
+#include <QQueue>
+#include <QtNumeric>
+
+namespace {
+
+// M/M/c 队列的平均排队等待（Erlang C），负载达到容量时为无穷大
+double mmcWait(double arrivalRate, double serviceTime, int servers)
+{
+    if (arrivalRate <= 0 || serviceTime <= 0 || servers <= 0) return 0.0;
+
+    const double load = arrivalRate * serviceTime;
+    const double utilization = load / servers;
+    if (utilization >= 1.0) return qInf();
+
+    double erlangB = 1.0;
+    for (int k = 1; k <= servers; ++k) {
+        erlangB = load * erlangB / (k + load * erlangB);
+    }
+    const double erlangC = erlangB / (1.0 - utilization * (1.0 - erlangB));
+    return erlangC * serviceTime / (servers - load);
+}
+
+// 固定服务时间（M/D/c）近似为 M/M/c 等待的一半，c = 1 时与 Pollaczek-Khinchine 公式一致
+double mdcWait(double arrivalRate, double serviceTime, int servers)
+{
+    return 0.5 * mmcWait(arrivalRate, serviceTime, servers);
+}
+
+quint64 edgeKey(int from, int to)
+{
+    return (quint64(quint32(from)) << 32) | quint32(to);
+}
+
+bool sameValue(double a, double b)
+{
+    return a == b || (qIsNaN(a) && qIsNaN(b));
+}
+
+} // namespace
+
+LatencyModel::LatencyModel(QObject *parent)
+    : QObject(parent)
+    , m_tracer(nullptr)
+    , m_systemNode(-1)
+    , m_penaltyNode(-1)
+    , m_graphDirty(false)
+    , m_lastEvaluated(0)
+    , m_ticks(0.0)
+{
+    auto &registry = StatKeyRegistry::instance();
+    m_totalTickKey = registry.intern("total_tick_processed");
+    m_ldHitKey = registry.intern("ld_cache_hit_count");
+    m_ldMissKey = registry.intern("ld_cache_miss_count");
+    m_ldInstKey = registry.intern("ld_inst_cnt");
+    m_ldMemTickKey = registry.intern("ld_mem_tick_sum");
+    m_l2HitKey = registry.intern("l2_hit_count");
+    m_l2MissKey = registry.intern("l2_miss_count");
+    m_llcHitKey = registry.intern("llc_hit_count");
+    m_llcMissKey = registry.intern("llc_miss_count");
+    m_messageKey = registry.intern("message_precossed");
+    m_avgLatencyKey = registry.intern("avg_transmit_latency");
+    for (const char *eventClass : {"l1miss_l2miss_l3hit", "l1miss_l2miss_l3forward", "l1miss_l2miss_l3miss"}) {
+        m_l2MissCountKeys.append(registry.intern(QString("%1_cnt").arg(eventClass)));
+        m_l2MissTickKeys.append(registry.intern(QString("%1_tick").arg(eventClass)));
+    }
+
+    m_timer.setSingleShot(true);
+    m_timer.setInterval(50);
+    connect(&m_timer, &QTimer::timeout, this, &LatencyModel::recompute);
+}
+
+void LatencyModel::addModule(HardwareModule* module)
+{
+    if (!module || m_modules.contains(module)) return;
+
+    m_modules.append(module);
+    connect(module, &HardwareModule::statisticChanged, this, &LatencyModel::onStatisticChanged);
+    m_graphDirty = true;
+    scheduleRecompute();
+}
+
+void LatencyModel::removeModule(HardwareModule* module)
+{
+    if (!m_modules.removeOne(module)) return;
+
+    disconnect(module, nullptr, this, nullptr);
+    m_overrides.remove(module);
+    m_graphDirty = true;
+    scheduleRecompute();
+}
+
+void LatencyModel::clear()
+{
+    for (auto module : m_modules) {
+        disconnect(module, nullptr, this, nullptr);
+    }
+    m_modules.clear();
+    m_overrides.clear();
+    m_timer.stop();
+    rebuildGraph();
+    m_lastEvaluated = 0;
+    emit changed();
+}
+
+QString LatencyModel::kindName(NodeKind kind)
+{
+    switch (kind) {
+        case BUS_HOPS:
+            return "Zero-load Latency";
+        case BUS_QUEUEING:
+            return "Queueing Delay";
+        case BUS_LATENCY:
+            return "Transmit Latency";
+        case MEMORY_LATENCY:
+            return "Memory Latency";
+        case CACHE_PORT:
+            return "Index Latency";
+        case CACHE_MSHR:
+            return "MSHR Wait";
+        case L2_MISS_PENALTY:
+            return "L2 Miss Penalty";
+        case CORE_AMAT:
+            return "AMAT";
+        case CORE_LOAD_LATENCY:
+            return "Load Latency";
+        case SYSTEM_AMAT:
+            return "System AMAT";
+        default:
+            return "Unknown";
+    }
+}
+
+int LatencyModel::parameter(HardwareModule* module, Parameter parameter) const
+{
+    return parameterValue(module, parameter, PREDICTED);
+}
+
+int LatencyModel::parameterValue(HardwareModule* module, Parameter parameter, Variant variant) const
+{
+    if (variant == PREDICTED) {
+        auto it = m_overrides.constFind(module);
+        if (it != m_overrides.constEnd() && it->parameters.contains(parameter)) {
+            return it->parameters.value(parameter);
+        }
+    }
+
+    if (parameter == DATA_WIDTH) {
+        return module->memoryDataWidth();
+    }
+    const HardwareModule::CacheConfig &config =
+        module->type() == HardwareModule::CACHE_L3 ? module->l3Config() : module->l2Config();
+    switch (parameter) {
+        case MSHR_COUNT:
+            return config.mshrCount;
+        case INDEX_WIDTH:
+            return config.indexWidth;
+        case INDEX_LATENCY:
+            return config.indexLatency;
+        default:
+            return 0;
+    }
+}
+
+void LatencyModel::setParameter(HardwareModule* module, Parameter parameter, int value)
+{
+    if (!m_modules.contains(module) || this->parameter(module, parameter) == value) return;
+
+    Overrides &overrides = m_overrides[module];
+    if (parameterValue(module, parameter, BASELINE) == value) {
+        overrides.parameters.remove(parameter);
+    } else {
+        overrides.parameters.insert(parameter, value);
+    }
+    if (overrides.parameters.isEmpty() && !overrides.hasEdges) {
+        m_overrides.remove(module);
+    }
+
+    markModule(module, DIRTY_PREDICTED);
+    recompute();
+}
+
+QVector<QPair<int, int>> LatencyModel::busEdges(HardwareModule* bus) const
+{
+    return edgesFor(bus, PREDICTED);
+}
+
+QVector<QPair<int, int>> LatencyModel::edgesFor(HardwareModule* bus, Variant variant) const
+{
+    if (variant == PREDICTED) {
+        auto it = m_overrides.constFind(bus);
+        if (it != m_overrides.constEnd() && it->hasEdges) {
+            return it->edges;
+        }
+    }
+    return bus->busEdges();
+}
+
+void LatencyModel::setBusEdges(HardwareModule* bus, const QVector<QPair<int, int>> &edges)
+{
+    if (!m_modules.contains(bus) || busEdges(bus) == edges) return;
+
+    Overrides &overrides = m_overrides[bus];
+    overrides.hasEdges = edges != bus->busEdges();
+    overrides.edges = overrides.hasEdges ? edges : QVector<QPair<int, int>>();
+    if (overrides.parameters.isEmpty() && !overrides.hasEdges) {
+        m_overrides.remove(bus);
+    }
+
+    markModule(bus, DIRTY_PREDICTED);
+    recompute();
+}
+
+void LatencyModel::resetParameters(HardwareModule* module)
+{
+    if (module) {
+        if (!m_overrides.remove(module)) return;
+        markModule(module, DIRTY_PREDICTED);
+    } else {
+        if (m_overrides.isEmpty()) return;
+        for (auto it = m_overrides.begin(); it != m_overrides.end(); ++it) {
+            markModule(it.key(), DIRTY_PREDICTED);
+        }
+        m_overrides.clear();
+    }
+    recompute();
+}
+
+bool LatencyModel::hasOverrides(HardwareModule* module) const
+{
+    return module ? m_overrides.contains(module) : !m_overrides.isEmpty();
+}
+
+QVector<int> LatencyModel::nodesOf(HardwareModule* module) const
+{
+    return m_moduleNodes.value(module);
+}
+
+void LatencyModel::onStatisticChanged(int keyId, double oldValue, double newValue)
+{
+    Q_UNUSED(oldValue);
+    Q_UNUSED(newValue);
+
+    auto module = qobject_cast<HardwareModule*>(sender());
+    if (!module) return;
+
+    // 仿真总周期变化时在重新计算中整体失效，其余只影响读取该模块统计数据的节点
+    if (keyId != m_totalTickKey) {
+        markModule(module, DIRTY_BASELINE);
+    }
+    scheduleRecompute();
+}
+
+void LatencyModel::markModule(HardwareModule* module, quint8 bits)
+{
+    if (m_graphDirty) return;
+
+    const QVector<int> readers = bits == DIRTY_BASELINE ? m_statReaders.value(module) : m_moduleNodes.value(module);
+    for (int index : readers) {
+        m_dirty[index] |= bits;
+    }
+}
+
+void LatencyModel::scheduleRecompute()
+{
+    if (!m_timer.isActive()) {
+        m_timer.start();
+    }
+}
+
+int LatencyModel::addNode(NodeKind kind, HardwareModule* module)
+{
+    const int index = m_nodes.size();
+    m_nodes.append({kind, module, 0.0, 0.0, 0.0, {}});
+    m_nodeIndex.insert({int(kind), module}, index);
+    if (module) {
+        m_moduleNodes[module].append(index);
+        m_statReaders[module].append(index);
+    }
+    return index;
+}
+
+void LatencyModel::addDependency(int from, int to)
+{
+    if (from >= 0 && to >= 0 && !m_nodes[from].dependents.contains(to)) {
+        m_nodes[from].dependents.append(to);
+    }
+}
+
+void LatencyModel::rebuildGraph()
+{
+    m_nodes.clear();
+    m_nodeIndex.clear();
+    m_moduleNodes.clear();
+    m_statReaders.clear();
+    m_routing[BASELINE].clear();
+    m_routing[PREDICTED].clear();
+    m_buses.clear();
+    m_memories.clear();
+    m_l3Caches.clear();
+    m_l2Caches.clear();
+    m_cores.clear();
+    m_l2ByIndex.clear();
+    m_tracer = nullptr;
+
+    for (auto module : m_modules) {
+        switch (module->type()) {
+            case HardwareModule::BUS:
+                m_buses.append(module);
+                break;
+            case HardwareModule::MEMORY_CTRL:
+                m_memories.append(module);
+                break;
+            case HardwareModule::CACHE_L3:
+                m_l3Caches.append(module);
+                break;
+            case HardwareModule::CACHE_L2:
+                m_l2Caches.append(module);
+                m_l2ByIndex.insert(BusTopology::parseHardwareIndex(module->name()), module);
+                break;
+            case HardwareModule::CPU_CORE:
+                m_cores.append(module);
+                break;
+            case HardwareModule::CACHE_EVENT_TRACER:
+                m_tracer = module;
+                break;
+            default:
+                break;
+        }
+    }
+
+    // 节点按依赖顺序创建，下标顺序即拓扑顺序
+    QVector<int> busLatencies;
+    for (auto bus : m_buses) {
+        int hops = addNode(BUS_HOPS, bus);
+        int queueing = addNode(BUS_QUEUEING, bus);
+        int latency = addNode(BUS_LATENCY, bus);
+        addDependency(hops, queueing);
+        addDependency(hops, latency);
+        addDependency(queueing, latency);
+        busLatencies.append(latency);
+    }
+
+    QVector<int> memoryLatencies;
+    for (auto memory : m_memories) {
+        memoryLatencies.append(addNode(MEMORY_LATENCY, memory));
+    }
+
+    QVector<int> l3Ports;
+    for (auto cache : m_l3Caches) {
+        l3Ports.append(addNode(CACHE_PORT, cache));
+    }
+
+    // L3 未命中经总线访问内存，MSHR 占用时间取决于内存与总线延迟
+    QVector<int> l3Mshrs;
+    for (auto cache : m_l3Caches) {
+        int mshr = addNode(CACHE_MSHR, cache);
+        for (int dependency : memoryLatencies + busLatencies) {
+            addDependency(dependency, mshr);
+        }
+        for (auto module : m_memories + m_buses) {
+            m_statReaders[module].append(mshr);
+        }
+        l3Mshrs.append(mshr);
+    }
+
+    m_penaltyNode = addNode(L2_MISS_PENALTY, nullptr);
+    for (int dependency : busLatencies + memoryLatencies + l3Ports + l3Mshrs) {
+        addDependency(dependency, m_penaltyNode);
+    }
+    for (auto module : m_buses + m_memories + m_l3Caches) {
+        m_statReaders[module].append(m_penaltyNode);
+    }
+    if (m_tracer) {
+        m_statReaders[m_tracer].append(m_penaltyNode);
+    }
+
+    for (auto cache : m_l2Caches) {
+        addNode(CACHE_PORT, cache);
+    }
+    for (auto cache : m_l2Caches) {
+        addDependency(m_penaltyNode, addNode(CACHE_MSHR, cache));
+    }
+
+    for (auto core : m_cores) {
+        int amat = addNode(CORE_AMAT, core);
+        addDependency(m_penaltyNode, amat);
+        if (HardwareModule* l2 = m_l2ByIndex.value(BusTopology::parseHardwareIndex(core->name()))) {
+            addDependency(nodeIndex(CACHE_PORT, l2), amat);
+            addDependency(nodeIndex(CACHE_MSHR, l2), amat);
+            m_statReaders[l2].append(amat);
+        }
+        addDependency(amat, addNode(CORE_LOAD_LATENCY, core));
+    }
+
+    m_systemNode = addNode(SYSTEM_AMAT, nullptr);
+    for (auto core : m_cores) {
+        addDependency(nodeIndex(CORE_AMAT, core), m_systemNode);
+        m_statReaders[core].append(m_systemNode);
+    }
+
+    m_dirty.fill(DIRTY_BASELINE | DIRTY_PREDICTED, m_nodes.size());
+    m_graphDirty = false;
+}
+
+void LatencyModel::recompute()
+{
+    m_timer.stop();
+    if (m_graphDirty) {
+        rebuildGraph();
+    }
+
+    double ticks = 0.0;
+    for (auto core : m_cores) {
+        ticks = qMax(ticks, core->statistic(m_totalTickKey));
+    }
+    if (ticks != m_ticks) {
+        m_ticks = ticks;
+        m_dirty.fill(DIRTY_BASELINE | DIRTY_PREDICTED);
+    }
+
+    // 按拓扑顺序求值；节点值变化时才使依赖它的节点失效
+    int evaluated = 0;
+    for (int index = 0; index < m_nodes.size(); ++index) {
+        quint8 bits = m_dirty[index];
+        if (!bits) continue;
+        m_dirty[index] = 0;
+        ++evaluated;
+
+        // 基准值变化会改变校准，预测值也需要重新计算
+        if (bits & DIRTY_BASELINE) {
+            bits |= DIRTY_PREDICTED;
+        }
+
+        Node &node = m_nodes[index];
+        quint8 changed = 0;
+        if (bits & DIRTY_BASELINE) {
+            const double baseline = node.baseline;
+            const double rawBaseline = node.rawBaseline;
+            evaluate(index, BASELINE);
+            if (!sameValue(baseline, node.baseline) || !sameValue(rawBaseline, node.rawBaseline)) {
+                changed |= DIRTY_BASELINE | DIRTY_PREDICTED;
+            }
+        }
+        const double predicted = node.predicted;
+        evaluate(index, PREDICTED);
+        if (!sameValue(predicted, node.predicted)) {
+            changed |= DIRTY_PREDICTED;
+        }
+        // 路由结果不只体现在平均跳数上，重新路由后总要重新计算排队延迟
+        if (node.kind == BUS_HOPS) {
+            changed |= bits;
+        }
+
+        for (int dependent : node.dependents) {
+            m_dirty[dependent] |= changed;
+        }
+    }
+
+    m_lastEvaluated = evaluated;
+    emit changed();
+}
+
+void LatencyModel::evaluate(int index, Variant variant)
+{
+    Node &node = m_nodes[index];
+    const double raw = rawValue(node, variant);
+    double measured = 0.0;
+    const bool hasMeasured = measuredValue(node, measured);
+
+    if (variant == BASELINE) {
+        node.rawBaseline = raw;
+        node.baseline = hasMeasured ? measured : raw;
+    } else if (hasMeasured && qIsFinite(node.rawBaseline) && qIsFinite(raw)) {
+        node.predicted = measured + raw - node.rawBaseline;
+    } else {
+        node.predicted = raw;
+    }
+}
+
+bool LatencyModel::measuredValue(const Node &node, double &measured) const
+{
+    switch (node.kind) {
+        case BUS_LATENCY:
+            if (!node.module->hasStatistic(m_avgLatencyKey)) return false;
+            measured = node.module->statistic(m_avgLatencyKey);
+            return true;
+        case L2_MISS_PENALTY: {
+            if (!m_tracer) return false;
+            double count = 0.0;
+            double ticks = 0.0;
+            for (int key : m_l2MissCountKeys) {
+                count += m_tracer->statistic(key);
+            }
+            for (int key : m_l2MissTickKeys) {
+                ticks += m_tracer->statistic(key);
+            }
+            if (count <= 0) return false;
+            measured = ticks / count;
+            return true;
+        }
+        case CORE_LOAD_LATENCY: {
+            double loads = node.module->statistic(m_ldInstKey);
+            if (loads <= 0 || !node.module->hasStatistic(m_ldMemTickKey)) return false;
+            measured = node.module->statistic(m_ldMemTickKey) / loads;
+            return true;
+        }
+        default:
+            return false;
+    }
+}
+
+double LatencyModel::nodeValue(int index, Variant variant) const
+{
+    if (index < 0) return 0.0;
+    return variant == BASELINE ? m_nodes[index].baseline : m_nodes[index].predicted;
+}
+
+double LatencyModel::weightedAverage(NodeKind kind, const QVector<HardwareModule*> &modules,
+                                     const QVector<double> &weights, Variant variant) const
+{
+    double sum = 0.0;
+    double weightSum = 0.0;
+    for (int i = 0; i < modules.size(); ++i) {
+        if (weights[i] <= 0) continue;
+        sum += nodeValue(nodeIndex(kind, modules[i]), variant) * weights[i];
+        weightSum += weights[i];
+    }
+    return weightSum > 0 ? sum / weightSum : 0.0;
+}
+
+double LatencyModel::busWeight(HardwareModule* bus) const
+{
+    const BusRouting &routing = m_routing[BASELINE].value(bus);
+    return routing.traffic + routing.unroutable;
+}
+
+double LatencyModel::accessCount(HardwareModule* cache) const
+{
+    if (cache->type() == HardwareModule::CACHE_L3) {
+        return cache->statistic(m_llcHitKey) + cache->statistic(m_llcMissKey);
+    }
+    return cache->statistic(m_l2HitKey) + cache->statistic(m_l2MissKey);
+}
+
+double LatencyModel::missCount(HardwareModule* cache) const
+{
+    return cache->statistic(cache->type() == HardwareModule::CACHE_L3 ? m_llcMissKey : m_l2MissKey);
+}
+
+double LatencyModel::rawValue(const Node &node, Variant variant)
+{
+    HardwareModule* module = node.module;
+    switch (node.kind) {
+        case BUS_HOPS: {
+            BusRouting routing = route(module, variant);
+            double hops = routing.traffic > 0 ? routing.hopSum / routing.traffic : 0.0;
+            m_routing[variant].insert(module, routing);
+            return hops;
+        }
+        case BUS_QUEUEING: {
+            // 每个信道每周期传输一个数据包
+            const BusRouting &routing = m_routing[variant].value(module);
+            if (routing.unroutable > 0) return qInf();
+            if (m_ticks <= 0 || routing.traffic <= 0) return 0.0;
+            double delay = 0.0;
+            for (auto it = routing.edgeLoad.constBegin(); it != routing.edgeLoad.constEnd(); ++it) {
+                delay += it.value() * mdcWait(it.value() / m_ticks, 1.0, 1);
+            }
+            return delay / routing.traffic;
+        }
+        case BUS_LATENCY:
+            return nodeValue(nodeIndex(BUS_HOPS, module), variant) + nodeValue(nodeIndex(BUS_QUEUEING, module), variant);
+        case MEMORY_LATENCY: {
+            // 每次访问传输一个缓存行，需要 行位数 / data_width 个周期
+            int dataWidth = parameterValue(module, DATA_WIDTH, variant);
+            if (dataWidth <= 0) return 0.0;
+            double service = BottleneckAnalyzer::kCacheLineBytes * 8.0 / dataWidth;
+            double rate = m_ticks > 0 ? module->statistic(m_messageKey) / m_ticks : 0.0;
+            return service + mdcWait(rate, service, 1);
+        }
+        case CACHE_PORT: {
+            // index_width 个端口并行索引，每次索引占用 index_latency 个周期
+            double service = qMax(1, parameterValue(module, INDEX_LATENCY, variant));
+            int ports = qMax(1, parameterValue(module, INDEX_WIDTH, variant));
+            double rate = m_ticks > 0 ? accessCount(module) / m_ticks : 0.0;
+            return service + mdcWait(rate, service, ports);
+        }
+        case CACHE_MSHR: {
+            // 每个未命中占用一个 MSHR 直到下一级返回数据
+            int mshrCount = parameterValue(module, MSHR_COUNT, variant);
+            if (mshrCount <= 0 || m_ticks <= 0) return 0.0;
+            double holdTime;
+            if (module->type() == HardwareModule::CACHE_L2) {
+                holdTime = nodeValue(m_penaltyNode, variant);
+            } else {
+                QVector<double> memoryWeights, busWeights;
+                for (auto memory : m_memories) {
+                    memoryWeights.append(memory->statistic(m_messageKey));
+                }
+                for (auto bus : m_buses) {
+                    busWeights.append(busWeight(bus));
+                }
+                holdTime = weightedAverage(MEMORY_LATENCY, m_memories, memoryWeights, variant)
+                         + 2 * weightedAverage(BUS_LATENCY, m_buses, busWeights, variant);
+            }
+            return mmcWait(missCount(module) / m_ticks, holdTime, mshrCount);
+        }
+        case L2_MISS_PENALTY: {
+            // 请求与响应各经过一次总线，L3 未命中时再经总线访问内存
+            QVector<double> busWeights, memoryWeights, accessWeights, missWeights;
+            for (auto bus : m_buses) {
+                busWeights.append(busWeight(bus));
+            }
+            for (auto memory : m_memories) {
+                memoryWeights.append(memory->statistic(m_messageKey));
+            }
+            double accesses = 0.0;
+            double misses = 0.0;
+            for (auto cache : m_l3Caches) {
+                accessWeights.append(accessCount(cache));
+                missWeights.append(missCount(cache));
+                accesses += accessWeights.last();
+                misses += missWeights.last();
+            }
+            const double bus = weightedAverage(BUS_LATENCY, m_buses, busWeights, variant);
+            const double missRatio = accesses > 0 ? misses / accesses : 0.0;
+            return 2 * bus + weightedAverage(CACHE_PORT, m_l3Caches, accessWeights, variant)
+                 + missRatio * (weightedAverage(CACHE_MSHR, m_l3Caches, missWeights, variant) + 2 * bus
+                                + weightedAverage(MEMORY_LATENCY, m_memories, memoryWeights, variant));
+        }
+        case CORE_AMAT: {
+            // L1 命中按 1 个周期计
+            double hits = module->statistic(m_ldHitKey);
+            double misses = module->statistic(m_ldMissKey);
+            double l1MissRatio = hits + misses > 0 ? misses / (hits + misses) : 0.0;
+            double penalty = nodeValue(m_penaltyNode, variant);
+            HardwareModule* l2 = m_l2ByIndex.value(BusTopology::parseHardwareIndex(module->name()));
+            if (!l2) {
+                return 1.0 + l1MissRatio * penalty;
+            }
+            double l2Accesses = accessCount(l2);
+            double l2MissRatio = l2Accesses > 0 ? missCount(l2) / l2Accesses : 0.0;
+            return 1.0 + l1MissRatio * (nodeValue(nodeIndex(CACHE_PORT, l2), variant)
+                                        + l2MissRatio * (nodeValue(nodeIndex(CACHE_MSHR, l2), variant) + penalty));
+        }
+        case CORE_LOAD_LATENCY:
+            return nodeValue(nodeIndex(CORE_AMAT, module), variant);
+        case SYSTEM_AMAT: {
+            QVector<double> weights;
+            for (auto core : m_cores) {
+                weights.append(core->statistic(m_ldInstKey));
+            }
+            return weightedAverage(CORE_AMAT, m_cores, weights, variant);
+        }
+        default:
+            return 0.0;
+    }
+}
+
+LatencyModel::BusRouting LatencyModel::route(HardwareModule* bus, Variant variant)
+{
+    QHash<int, QVector<int>> adjacency;
+    for (const auto &edge : edgesFor(bus, variant)) {
+        adjacency[edge.first].append(edge.second);
+    }
+
+    // 按源节点缓存的 BFS 前驱表，数据包沿最短路径传输
+    QHash<int, QHash<int, int>> parentTables;
+    auto parents = [&](int from) -> const QHash<int, int>& {
+        auto it = parentTables.find(from);
+        if (it == parentTables.end()) {
+            QHash<int, int> table;
+            QQueue<int> queue;
+            table.insert(from, from);
+            queue.enqueue(from);
+            while (!queue.isEmpty()) {
+                int node = queue.dequeue();
+                for (int next : adjacency.value(node)) {
+                    if (!table.contains(next)) {
+                        table.insert(next, node);
+                        queue.enqueue(next);
+                    }
+                }
+            }
+            it = parentTables.insert(from, table);
+        }
+        return it.value();
+    };
+
+    BusRouting routing;
+    const auto &portMap = bus->busPortToNodeMap();
+    const auto &values = bus->statisticValues();
+    for (auto it = values.begin(); it != values.end(); ++it) {
+        QPair<int, int> ports = trafficKey(it.key());
+        if (ports.first < 0 || it.value() <= 0) continue;
+
+        int from = portMap.value(ports.first, -1);
+        int to = portMap.value(ports.second, -1);
+        if (from < 0 || to < 0) continue;
+
+        const QHash<int, int> &table = parents(from);
+        if (!table.contains(to)) {
+            routing.unroutable += it.value();
+            continue;
+        }
+        int hops = 0;
+        for (int node = to; node != from; node = table.value(node)) {
+            routing.edgeLoad[edgeKey(table.value(node), node)] += it.value();
+            ++hops;
+        }
+        routing.traffic += it.value();
+        routing.hopSum += it.value() * hops;
+    }
+    return routing;
+}
+
+QPair<int, int> LatencyModel::trafficKey(int keyId)
+{
+    auto it = m_trafficKeys.constFind(keyId);
+    if (it != m_trafficKeys.constEnd()) {
+        return it.value();
+    }
+
+    static const QRegularExpression trafficRe("^transmit_package_number_from_(\\d+)_to_(\\d+)$");
+    QRegularExpressionMatch match = trafficRe.match(StatKeyRegistry::instance().name(keyId));
+    QPair<int, int> ports(-1, -1);
+    if (match.hasMatch()) {
+        ports = {match.captured(1).toInt(), match.captured(2).toInt()};
+    }
+    m_trafficKeys.insert(keyId, ports);
+    return ports;
+}
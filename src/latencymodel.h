@@ -0,0 +1,165 @@
+#ifndef LATENCYMODEL_H
+#define LATENCYMODEL_H
+
+#include <QObject>
+#include <QString>
+#include <QVector>
+#include <QHash>
+#include <QPair>
+#include <QTimer>
+#include "hardwaremodule.h"
+
+// 解析延迟模型：以 statistic 中测得的到达率驱动排队模型（总线信道 M/D/1、缓存索引端口 M/D/c、
+// MSHR M/M/c、内存通道 M/D/1），在不重新仿真的情况下预测修改缓存、内存与总线参数后的
+// AMAT、总线排队延迟与各核心的 LOAD 延迟
+// 各项指标组成依赖图，编辑参数时只重新计算受影响的节点，且值未变化的节点不再向下传播
+// 有测量值的指标按“测量值 + 模型预测值 - 模型基准值”校准，未修改参数时预测值等于测量值
+class LatencyModel : public QObject
+{
+    Q_OBJECT
+
+public:
+    // 依赖图节点（指标）类型，按依赖顺序排列
+    enum NodeKind {
+        BUS_HOPS,            // 总线零负载延迟（平均跳数）
+        BUS_QUEUEING,        // 总线平均排队延迟
+        BUS_LATENCY,         // 总线平均传输延迟
+        MEMORY_LATENCY,      // 内存节点访问延迟
+        CACHE_PORT,          // 缓存索引延迟（含端口排队）
+        CACHE_MSHR,          // 等待 MSHR 的延迟
+        L2_MISS_PENALTY,     // L2 未命中的平均代价
+        CORE_AMAT,           // 核心平均访存时间
+        CORE_LOAD_LATENCY,   // 核心 LOAD 指令平均延迟
+        SYSTEM_AMAT          // 全部核心按 LOAD 数加权的 AMAT
+    };
+
+    // 可编辑的参数
+    enum Parameter {
+        MSHR_COUNT,
+        INDEX_WIDTH,
+        INDEX_LATENCY,
+        DATA_WIDTH
+    };
+
+    struct Node {
+        NodeKind kind;
+        HardwareModule* module;   // 全局指标为 nullptr
+        double baseline;          // 原始参数下的值
+        double predicted;         // 修改参数后的值，饱和时为无穷大
+        double rawBaseline;       // 校准前的模型值
+        QVector<int> dependents;  // 依赖本节点的节点下标
+    };
+
+    explicit LatencyModel(QObject *parent = nullptr);
+
+    void addModule(HardwareModule* module);
+    void removeModule(HardwareModule* module);
+    void clear();
+
+    // 当前参数（有修改时为修改值）
+    int parameter(HardwareModule* module, Parameter parameter) const;
+    void setParameter(HardwareModule* module, Parameter parameter, int value);
+    QVector<QPair<int, int>> busEdges(HardwareModule* bus) const;
+    void setBusEdges(HardwareModule* bus, const QVector<QPair<int, int>> &edges);
+    // module 为 nullptr 时撤销所有修改
+    void resetParameters(HardwareModule* module = nullptr);
+    bool hasOverrides(HardwareModule* module = nullptr) const;
+
+    const QVector<Node>& nodes() const { return m_nodes; }
+    // 模块的指标节点下标
+    QVector<int> nodesOf(HardwareModule* module) const;
+    int systemNode() const { return m_systemNode; }
+    // 最近一次计算实际求值的节点数
+    int lastEvaluatedCount() const { return m_lastEvaluated; }
+    static QString kindName(NodeKind kind);
+
+signals:
+    void changed();
+
+private slots:
+    void onStatisticChanged(int keyId, double oldValue, double newValue);
+    void recompute();
+
+private:
+    enum Variant { BASELINE = 0, PREDICTED = 1 };
+    enum DirtyBits : quint8 { DIRTY_BASELINE = 1, DIRTY_PREDICTED = 2 };
+
+    struct Overrides {
+        QHash<int, int> parameters;            // Parameter -> 值
+        bool hasEdges = false;
+        QVector<QPair<int, int>> edges;
+    };
+
+    // 一条总线在某组参数下的路由结果
+    struct BusRouting {
+        QHash<quint64, double> edgeLoad;  // (源节点, 目的节点) -> 经过的数据包数
+        double traffic = 0.0;             // 可路由的数据包数
+        double hopSum = 0.0;              // 数据包数 × 跳数
+        double unroutable = 0.0;          // 新拓扑中无法到达的数据包数
+    };
+
+    void rebuildGraph();
+    int addNode(NodeKind kind, HardwareModule* module);
+    void addDependency(int from, int to);
+    int nodeIndex(NodeKind kind, HardwareModule* module) const { return m_nodeIndex.value({int(kind), module}, -1); }
+    void markModule(HardwareModule* module, quint8 bits);
+    void scheduleRecompute();
+    void evaluate(int index, Variant variant);
+    double rawValue(const Node &node, Variant variant);
+    // 有测量值时返回 true 并写入 measured
+    bool measuredValue(const Node &node, double &measured) const;
+
+    int parameterValue(HardwareModule* module, Parameter parameter, Variant variant) const;
+    QVector<QPair<int, int>> edgesFor(HardwareModule* bus, Variant variant) const;
+    BusRouting route(HardwareModule* bus, Variant variant);
+    // 下标为 -1 时返回 0
+    double nodeValue(int index, Variant variant) const;
+    // 按权重对一组节点的值取平均
+    double weightedAverage(NodeKind kind, const QVector<HardwareModule*> &modules,
+                           const QVector<double> &weights, Variant variant) const;
+    double busWeight(HardwareModule* bus) const;
+    double accessCount(HardwareModule* cache) const;
+    double missCount(HardwareModule* cache) const;
+    // transmit_package_number_from_a_to_b 的端口对，其它统计项为 (-1, -1)
+    QPair<int, int> trafficKey(int keyId);
+
+    QVector<HardwareModule*> m_modules;
+    HardwareModule* m_tracer;
+    QHash<HardwareModule*, Overrides> m_overrides;
+    QTimer m_timer;
+
+    QVector<Node> m_nodes;
+    QVector<quint8> m_dirty;
+    QHash<QPair<int, HardwareModule*>, int> m_nodeIndex;  // (类型, 模块) -> 节点下标
+    QHash<HardwareModule*, QVector<int>> m_moduleNodes;   // 模块自身的指标节点
+    QHash<HardwareModule*, QVector<int>> m_statReaders;   // 读取模块统计数据（含作为权重）的节点
+    QVector<HardwareModule*> m_buses;
+    QVector<HardwareModule*> m_memories;
+    QVector<HardwareModule*> m_l3Caches;
+    QVector<HardwareModule*> m_l2Caches;
+    QVector<HardwareModule*> m_cores;
+    QHash<HardwareModule*, BusRouting> m_routing[2];
+    QHash<int, HardwareModule*> m_l2ByIndex;
+    int m_systemNode;
+    int m_penaltyNode;
+    bool m_graphDirty;
+    int m_lastEvaluated;
+    double m_ticks;
+
+    QHash<int, QPair<int, int>> m_trafficKeys;
+    int m_totalTickKey;
+    int m_ldHitKey;
+    int m_ldMissKey;
+    int m_ldInstKey;
+    int m_ldMemTickKey;
+    int m_l2HitKey;
+    int m_l2MissKey;
+    int m_llcHitKey;
+    int m_llcMissKey;
+    int m_messageKey;
+    int m_avgLatencyKey;
+    QVector<int> m_l2MissCountKeys;
+    QVector<int> m_l2MissTickKeys;
+};
+
+#endif // LATENCYMODEL_H
@@ -0,0 +1,234 @@
+#include "layoutcache.h"
+#include <QCryptographicHash>
+#include <QStandardPaths>
+#include <QDir>
+#include <QFile>
+#include <QFileInfo>
+#include <QSaveFile>
+#include <QJsonDocument>
+#include <QJsonObject>
+#include <QJsonArray>
+#include <QDateTime>
+#include <algorithm>
+
+namespace {
+
+const char kIndexFileName[] = "index.json";
+
+} // namespace
+
+LayoutCache::LayoutCache(const QString &directory)
+    : m_directory(directory)
+{
+}
+
+QString LayoutCache::defaultDirectory()
+{
+    return QStandardPaths::writableLocation(QStandardPaths::AppLocalDataLocation) + "/layouts";
+}
+
+QString LayoutCache::topologyHash(const QVector<HardwareModule*> &modules)
+{
+    QVector<HardwareModule*> sorted = modules;
+    std::sort(sorted.begin(), sorted.end(), [](HardwareModule* a, HardwareModule* b) {
+        return a->name() < b->name();
+    });
+
+    QCryptographicHash hash(QCryptographicHash::Sha1);
+    for (auto module : sorted) {
+        hash.addData(QString("%1|%2|%3|%4\n").arg(module->name()).arg(int(module->type()))
+                     .arg(module->portId()).arg(module->busName()).toUtf8());
+        if (module->type() == HardwareModule::BUS) {
+            const auto &portMap = module->busPortToNodeMap();
+            for (auto it = portMap.begin(); it != portMap.end(); ++it) {
+                hash.addData(QString("p%1:%2\n").arg(it.key()).arg(it.value()).toUtf8());
+            }
+            for (const auto &edge : module->busEdges()) {
+                hash.addData(QString("e%1:%2\n").arg(edge.first).arg(edge.second).toUtf8());
+            }
+        }
+    }
+    return QString::fromLatin1(hash.result().toHex().left(20));
+}
+
+QHash<HardwareModule*, QPointF> LayoutCache::restore(const QVector<HardwareModule*> &modules)
+{
+    QHash<HardwareModule*, QPointF> restored;
+    if (modules.isEmpty()) return restored;
+
+    const QString hash = topologyHash(modules);
+    QHash<QString, QPointF> positions = readPositions(filePath(hash));
+
+    bool rebuilt = false;
+    QVector<IndexEntry> entries = readIndex(&rebuilt);
+    int bestEntry = -1;
+    if (positions.isEmpty()) {
+        // 拓扑有变化时，按索引选用与当前模块名重合最多的缓存
+        QSet<QString> names;
+        for (auto module : modules) {
+            names.insert(module->name());
+        }
+
+        int bestOverlap = 0;
+        for (int i = 0; i < entries.size(); ++i) {
+            int overlap = 0;
+            for (const QString &name : entries[i].modules) {
+                if (names.contains(name)) {
+                    ++overlap;
+                }
+            }
+            if (overlap > bestOverlap) {
+                bestOverlap = overlap;
+                bestEntry = i;
+            }
+        }
+        if (bestEntry >= 0) {
+            positions = readPositions(filePath(entries[bestEntry].hash));
+        }
+    } else {
+        for (int i = 0; i < entries.size() && bestEntry < 0; ++i) {
+            if (entries[i].hash == hash) bestEntry = i;
+        }
+    }
+
+    // 索引按最近使用排序，选中的已是第一项时淘汰顺序不变，不必重写索引
+    if (bestEntry > 0 || rebuilt) {
+        if (bestEntry >= 0) {
+            entries[bestEntry].used = QDateTime::currentMSecsSinceEpoch();
+        }
+        writeIndex(entries);
+    }
+
+    for (auto module : modules) {
+        auto it = positions.constFind(module->name());
+        if (it != positions.constEnd()) {
+            restored.insert(module, it.value());
+        }
+    }
+    return restored;
+}
+
+bool LayoutCache::store(const QVector<HardwareModule*> &modules) const
+{
+    if (modules.isEmpty() || !QDir().mkpath(m_directory)) return false;
+
+    QJsonObject positions;
+    for (auto module : modules) {
+        positions.insert(module->name(), QJsonArray{module->position().x(), module->position().y()});
+    }
+
+    QJsonObject root;
+    root.insert("version", 1);
+    root.insert("positions", positions);
+
+    const QString hash = topologyHash(modules);
+    QSaveFile file(filePath(hash));
+    if (!file.open(QIODevice::WriteOnly)) return false;
+    file.write(QJsonDocument(root).toJson(QJsonDocument::Compact));
+    if (!file.commit()) return false;
+
+    QVector<IndexEntry> entries = readIndex();
+    entries.erase(std::remove_if(entries.begin(), entries.end(), [&hash](const IndexEntry &entry) {
+        return entry.hash == hash;
+    }), entries.end());
+    IndexEntry current;
+    current.hash = hash;
+    for (auto module : modules) {
+        current.modules.append(module->name());
+    }
+    current.used = QDateTime::currentMSecsSinceEpoch();
+    entries.append(current);
+    return writeIndex(entries);
+}
+
+QString LayoutCache::filePath(const QString &hash) const
+{
+    return m_directory + "/" + hash + ".json";
+}
+
+QHash<QString, QPointF> LayoutCache::readPositions(const QString &path)
+{
+    QHash<QString, QPointF> positions;
+
+    QFile file(path);
+    if (!file.open(QIODevice::ReadOnly)) return positions;
+
+    QJsonObject object = QJsonDocument::fromJson(file.readAll()).object().value("positions").toObject();
+    for (auto it = object.begin(); it != object.end(); ++it) {
+        QJsonArray point = it.value().toArray();
+        if (point.size() == 2) {
+            positions.insert(it.key(), QPointF(point[0].toDouble(), point[1].toDouble()));
+        }
+    }
+    return positions;
+}
+
+QVector<LayoutCache::IndexEntry> LayoutCache::readIndex(bool *rebuilt) const
+{
+    QVector<IndexEntry> entries;
+    if (rebuilt) *rebuilt = false;
+
+    QFile file(m_directory + "/" + kIndexFileName);
+    if (file.open(QIODevice::ReadOnly)) {
+        const QJsonArray array = QJsonDocument::fromJson(file.readAll()).object().value("entries").toArray();
+        for (const auto &value : array) {
+            QJsonObject object = value.toObject();
+            IndexEntry entry;
+            entry.hash = object.value("hash").toString();
+            entry.used = qint64(object.value("used").toDouble());
+            for (const auto &name : object.value("modules").toArray()) {
+                entry.modules.append(name.toString());
+            }
+            if (!entry.hash.isEmpty()) {
+                entries.append(entry);
+            }
+        }
+        return entries;
+    }
+
+    // 旧版本的缓存目录没有索引：扫描一次已有的位置文件，之后只读索引
+    QDir dir(m_directory);
+    if (!dir.exists()) return entries;
+    for (const QFileInfo &info : dir.entryInfoList({"*.json"}, QDir::Files)) {
+        if (info.fileName() == kIndexFileName) continue;
+        IndexEntry entry;
+        entry.hash = info.completeBaseName();
+        entry.modules = readPositions(info.filePath()).keys();
+        entry.used = info.lastModified().toMSecsSinceEpoch();
+        entries.append(entry);
+    }
+    if (rebuilt) *rebuilt = true;
+    return entries;
+}
+
+bool LayoutCache::writeIndex(QVector<IndexEntry> entries) const
+{
+    if (!QDir().mkpath(m_directory)) return false;
+
+    // 超出上限时删除最久未用的缓存文件
+    std::sort(entries.begin(), entries.end(), [](const IndexEntry &a, const IndexEntry &b) {
+        return a.used > b.used;
+    });
+    while (entries.size() > kMaxEntries) {
+        QFile::remove(filePath(entries.last().hash));
+        entries.removeLast();
+    }
+
+    QJsonArray array;
+    for (const IndexEntry &entry : entries) {
+        QJsonObject object;
+        object.insert("hash", entry.hash);
+        object.insert("used", double(entry.used));
+        object.insert("modules", QJsonArray::fromStringList(entry.modules));
+        array.append(object);
+    }
+
+    QJsonObject root;
+    root.insert("version", 1);
+    root.insert("entries", array);
+
+    QSaveFile file(m_directory + "/" + kIndexFileName);
+    if (!file.open(QIODevice::WriteOnly)) return false;
+    file.write(QJsonDocument(root).toJson(QJsonDocument::Compact));
+    return file.commit();
+}
@@ -0,0 +1,51 @@
+#ifndef LAYOUTCACHE_H
+#define LAYOUTCACHE_H
+
+#include <QString>
+#include <QVector>
+#include <QSet>
+#include <QHash>
+#include <QPointF>
+#include <QStringList>
+#include "hardwaremodule.h"
+
+// 模块布局缓存：按拓扑哈希（模块集合与总线连接）为每个拓扑保存一个位置文件，
+// 重新加载时直接恢复位置，只对新增模块重新计算布局。
+// 目录中的索引文件记录各缓存的模块名与最近使用时间，超过 kMaxEntries 个拓扑时删除最久未用的缓存
+class LayoutCache
+{
+public:
+    static const int kMaxEntries = 32;
+
+    explicit LayoutCache(const QString &directory = defaultDirectory());
+
+    // 默认缓存目录（应用数据目录下的 layouts）
+    static QString defaultDirectory();
+    // 计算模块集合与总线拓扑的哈希
+    static QString topologyHash(const QVector<HardwareModule*> &modules);
+
+    // 查找模块的缓存位置，不修改模块，由调用方批量应用；
+    // 没有完全相同的拓扑时按索引选出模块名重合最多的缓存，只读取这一个位置文件。
+    // 选中的缓存不是最近使用的一个时更新索引中的使用时间
+    QHash<HardwareModule*, QPointF> restore(const QVector<HardwareModule*> &modules);
+    // 保存当前模块位置
+    bool store(const QVector<HardwareModule*> &modules) const;
+
+private:
+    struct IndexEntry {
+        QString hash;
+        QStringList modules;
+        qint64 used = 0;  // 最近使用时间（毫秒）
+    };
+
+    QString filePath(const QString &hash) const;
+    static QHash<QString, QPointF> readPositions(const QString &path);
+    // 读取索引，没有索引文件时扫描已有的缓存文件重建，rebuilt 置为 true
+    QVector<IndexEntry> readIndex(bool *rebuilt = nullptr) const;
+    // 按最近使用排序写入索引，超出 kMaxEntries 的缓存连同位置文件一起删除
+    bool writeIndex(QVector<IndexEntry> entries) const;
+
+    QString m_directory;
+};
+
+#endif // LAYOUTCACHE_H
@@ -0,0 +1,62 @@
+#ifndef LIVEFEEDPROTOCOL_H
+#define LIVEFEEDPROTOCOL_H
+
+#include <QByteArray>
+#include <QString>
+#include <QtEndian>
+#include <cstring>
+
+// 实时数据推送协议（本地套接字，小端字节序）
+// 每帧以1字节类型开头：
+//   DEFINE_KEY    u8 type, u16 keyId,    u16 len, len字节 UTF-8 统计项名
+//   DEFINE_MODULE u8 type, u16 moduleId, u16 len, len字节 UTF-8 模块名
+//   DELTA         u8 type, u16 moduleId, u16 keyId, f64 value
+// keyId/moduleId 由发送端自行分配，先通过 DEFINE 帧声明再在 DELTA 帧中使用
+namespace LiveFeed {
+
+// 默认的本地服务名
+inline const char* defaultServerName() { return "HardwareVisualizerLiveFeed"; }
+
+enum FrameType : quint8 {
+    DEFINE_KEY = 1,
+    DEFINE_MODULE = 2,
+    DELTA = 3
+};
+
+constexpr int kDefineHeaderSize = 5;
+constexpr int kDeltaFrameSize = 13;
+
+inline void appendDefine(QByteArray &out, FrameType type, quint16 id, const QString &name)
+{
+    QByteArray utf8 = name.toUtf8();
+    char header[kDefineHeaderSize];
+    header[0] = char(type);
+    qToLittleEndian<quint16>(id, header + 1);
+    qToLittleEndian<quint16>(quint16(utf8.size()), header + 3);
+    out.append(header, kDefineHeaderSize);
+    out.append(utf8);
+}
+
+inline void appendDelta(QByteArray &out, quint16 moduleId, quint16 keyId, double value)
+{
+    char frame[kDeltaFrameSize];
+    quint64 bits;
+    std::memcpy(&bits, &value, sizeof(bits));
+    frame[0] = char(DELTA);
+    qToLittleEndian<quint16>(moduleId, frame + 1);
+    qToLittleEndian<quint16>(keyId, frame + 3);
+    qToLittleEndian<quint64>(bits, frame + 5);
+    out.append(frame, kDeltaFrameSize);
+}
+
+inline double readDeltaValue(const char *frame)
+{
+    quint64 bits = qFromLittleEndian<quint64>(frame + 5);
+    double value;
+    std::memcpy(&value, &bits, sizeof(value));
+    return value;
+}
+
+} // namespace LiveFeed
+
+#endif // LIVEFEEDPROTOCOL_H
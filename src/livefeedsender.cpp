@@ -0,0 +1,136 @@
+// 实时数据推送的本地测试发送端
+// 读取一个 statistic 文件作为初始值，按指定速率随机扰动并推送统计增量
+// 用法: livefeedsender [statistic.txt] [--server 名称] [--rate 每秒更新数] [--duration 秒]
+
+#include <QCoreApplication>
+#include <QCommandLineParser>
+#include <QLocalSocket>
+#include <QFile>
+#include <QTextStream>
+#include <QTimer>
+#include <QElapsedTimer>
+#include <QRandomGenerator>
+#include <QVector>
+#include <QHash>
+#include "livefeedprotocol.h"
+
+struct SenderStat {
+    quint16 moduleId;
+    quint16 keyId;
+    double value;
+};
+
+int main(int argc, char *argv[])
+{
+    QCoreApplication app(argc, argv);
+
+    QCommandLineParser parser;
+    parser.setApplicationDescription("Live feed stand-in sender for HardwareVisualizer");
+    parser.addHelpOption();
+    parser.addPositionalArgument("statistic", "Statistic file providing modules, keys and initial values.");
+    QCommandLineOption serverOption("server", "Local server name.", "name", LiveFeed::defaultServerName());
+    QCommandLineOption rateOption("rate", "Updates per second.", "count", "10000");
+    QCommandLineOption durationOption("duration", "Seconds to run, 0 for unlimited.", "seconds", "0");
+    parser.addOption(serverOption);
+    parser.addOption(rateOption);
+    parser.addOption(durationOption);
+    parser.process(app);
+
+    QTextStream err(stderr);
+    QString statisticFile = parser.positionalArguments().value(0, "resources/statistic.txt");
+    QFile file(statisticFile);
+    if (!file.open(QIODevice::ReadOnly | QIODevice::Text)) {
+        err << "Cannot open statistics file: " << statisticFile << Qt::endl;
+        return 1;
+    }
+
+    QLocalSocket socket;
+    socket.connectToServer(parser.value(serverOption));
+    if (!socket.waitForConnected(3000)) {
+        err << "Cannot connect to " << parser.value(serverOption) << ": " << socket.errorString() << Qt::endl;
+        return 1;
+    }
+
+    // 解析统计文件，声明模块与统计项
+    QByteArray out;
+    QHash<QString, quint16> moduleIds;
+    QHash<QString, quint16> keyIds;
+    QVector<SenderStat> stats;
+    quint16 currentModule = 0;
+    bool hasModule = false;
+
+    QTextStream in(&file);
+    while (!in.atEnd()) {
+        QString line = in.readLine();
+        int commentPos = line.indexOf("//");
+        if (commentPos != -1) {
+            line = line.left(commentPos);
+        }
+        line = line.trimmed();
+        if (line.isEmpty()) continue;
+
+        if (line.contains("Latency:")) {
+            QString moduleName = line.split(" ").first();
+            if (!moduleIds.contains(moduleName)) {
+                quint16 id = quint16(moduleIds.size());
+                moduleIds.insert(moduleName, id);
+                LiveFeed::appendDefine(out, LiveFeed::DEFINE_MODULE, id, moduleName);
+            }
+            currentModule = moduleIds.value(moduleName);
+            hasModule = true;
+            continue;
+        }
+
+        QStringList parts = line.split(":");
+        if (parts.size() != 2 || !hasModule) continue;
+
+        QString key = parts[0].trimmed();
+        if (!keyIds.contains(key)) {
+            quint16 id = quint16(keyIds.size());
+            keyIds.insert(key, id);
+            LiveFeed::appendDefine(out, LiveFeed::DEFINE_KEY, id, key);
+        }
+        stats.append({currentModule, keyIds.value(key), parts[1].trimmed().toDouble()});
+    }
+    socket.write(out);
+
+    if (stats.isEmpty()) {
+        err << "No statistics found in " << statisticFile << Qt::endl;
+        return 1;
+    }
+
+    const int rate = qMax(1, parser.value(rateOption).toInt());
+    const int duration = parser.value(durationOption).toInt();
+    const int tickMs = 10;
+    quint64 sent = 0;
+    QElapsedTimer elapsed;
+    elapsed.start();
+
+    QTimer timer;
+    QObject::connect(&timer, &QTimer::timeout, [&]() {
+        if (duration > 0 && elapsed.elapsed() >= qint64(duration) * 1000) {
+            socket.flush();
+            socket.disconnectFromServer();
+            err << "Sent " << sent << " updates" << Qt::endl;
+            app.quit();
+            return;
+        }
+
+        // 按已用时间补足应发送的更新数
+        quint64 target = quint64(elapsed.elapsed()) * rate / 1000;
+        QByteArray batch;
+        auto *random = QRandomGenerator::global();
+        for (; sent < target; ++sent) {
+            SenderStat &stat = stats[random->bounded(int(stats.size()))];
+            stat.value = qMax(0.0, stat.value * (0.95 + 0.1 * random->generateDouble()) + random->bounded(2));
+            LiveFeed::appendDelta(batch, stat.moduleId, stat.keyId, stat.value);
+        }
+        if (!batch.isEmpty()) {
+            socket.write(batch);
+        }
+    });
+    QObject::connect(&socket, &QLocalSocket::disconnected, &app, &QCoreApplication::quit);
+    timer.start(tickMs);
+
+    return app.exec();
+}
@@ -0,0 +1,258 @@
+#include "livefeedserver.h"
+#include "livefeedprotocol.h"
+#include "statkeyregistry.h"
+#include <QtEndian>
+
+namespace {
+
+// 队列容量与每次刷新最多处理的增量数
+constexpr size_t kQueueCapacity = 1 << 18;
+constexpr int kMaxDeltasPerFrame = 1 << 17;
+// 每个连接缓冲区上限，超过后暂停读取，由套接字缓冲形成背压
+constexpr int kMaxBufferedBytes = 1 << 16;
+
+} // namespace
+
+LiveFeedWorker::LiveFeedWorker(SpscQueue<LiveStatDelta>* queue, const QStringList &moduleNames,
+                               quint32 generation)
+    : m_queue(queue)
+    , m_server(nullptr)
+    , m_generation(generation)
+{
+    setModuleNames(moduleNames, generation);
+}
+
+void LiveFeedWorker::start(const QString &serverName)
+{
+    m_server = new QLocalServer(this);
+    QLocalServer::removeServer(serverName);
+    if (!m_server->listen(serverName)) {
+        emit statusChanged(QString("实时数据服务启动失败: %1").arg(m_server->errorString()));
+        return;
+    }
+
+    connect(m_server, &QLocalServer::newConnection, this, &LiveFeedWorker::onNewConnection);
+    emit statusChanged(QString("实时数据服务已启动: %1").arg(m_server->fullServerName()));
+}
+
+void LiveFeedWorker::setModuleNames(const QStringList &moduleNames, quint32 generation)
+{
+    m_generation = generation;
+    m_moduleIndex.clear();
+    for (int i = 0; i < moduleNames.size(); ++i) {
+        m_moduleIndex.insert(moduleNames[i], i);
+    }
+
+    // 发送端只在连接时声明一次模块，按声明的模块名映射到新的模块序号，已删除的模块映射为 -1
+    for (auto &connection : m_connections) {
+        for (int id = 0; id < connection.moduleNames.size(); ++id) {
+            connection.modules[id] = m_moduleIndex.value(connection.moduleNames[id], -1);
+        }
+    }
+}
+
+void LiveFeedWorker::onNewConnection()
+{
+    while (QLocalSocket* socket = m_server->nextPendingConnection()) {
+        m_connections.insert(socket, Connection());
+        connect(socket, &QLocalSocket::readyRead, this, &LiveFeedWorker::onReadyRead);
+        connect(socket, &QLocalSocket::disconnected, this, &LiveFeedWorker::onDisconnected);
+        emit statusChanged(QString("实时数据连接数: %1").arg(m_connections.size()));
+    }
+}
+
+void LiveFeedWorker::onReadyRead()
+{
+    if (auto socket = qobject_cast<QLocalSocket*>(sender())) {
+        processSocket(socket);
+    }
+}
+
+void LiveFeedWorker::onDisconnected()
+{
+    auto socket = qobject_cast<QLocalSocket*>(sender());
+    if (!socket) return;
+
+    m_connections.remove(socket);
+    socket->deleteLater();
+    emit statusChanged(QString("实时数据连接数: %1").arg(m_connections.size()));
+}
+
+void LiveFeedWorker::processSocket(QLocalSocket* socket)
+{
+    auto connectionIt = m_connections.find(socket);
+    if (connectionIt == m_connections.end()) return;
+    Connection &connection = connectionIt.value();
+    connection.retryScheduled = false;
+
+    if (connection.buffer.size() < kMaxBufferedBytes) {
+        connection.buffer.append(socket->read(kMaxBufferedBytes));
+    }
+
+    const char* data = connection.buffer.constData();
+    const int size = connection.buffer.size();
+    int pos = 0;
+    bool queueFull = false;
+
+    while (pos < size) {
+        quint8 type = quint8(data[pos]);
+        if (type == LiveFeed::DELTA) {
+            if (size - pos < LiveFeed::kDeltaFrameSize) break;
+
+            quint16 moduleId = qFromLittleEndian<quint16>(data + pos + 1);
+            quint16 keyId = qFromLittleEndian<quint16>(data + pos + 3);
+            int moduleIndex = moduleId < connection.modules.size() ? connection.modules[moduleId] : -1;
+            int internedKey = keyId < connection.keys.size() ? connection.keys[keyId] : -1;
+
+            if (moduleIndex >= 0 && internedKey >= 0) {
+                LiveStatDelta delta{moduleIndex, internedKey, LiveFeed::readDeltaValue(data + pos), m_generation};
+                if (!m_queue->tryPush(delta)) {
+                    queueFull = true;
+                    break;
+                }
+            }
+            pos += LiveFeed::kDeltaFrameSize;
+        } else if (type == LiveFeed::DEFINE_KEY || type == LiveFeed::DEFINE_MODULE) {
+            if (size - pos < LiveFeed::kDefineHeaderSize) break;
+
+            quint16 id = qFromLittleEndian<quint16>(data + pos + 1);
+            quint16 length = qFromLittleEndian<quint16>(data + pos + 3);
+            if (size - pos < LiveFeed::kDefineHeaderSize + length) break;
+
+            QString name = QString::fromUtf8(data + pos + LiveFeed::kDefineHeaderSize, length);
+            if (type == LiveFeed::DEFINE_KEY) {
+                if (connection.keys.size() <= id) {
+                    connection.keys.resize(id + 1, -1);
+                }
+                connection.keys[id] = StatKeyRegistry::instance().intern(name);
+            } else {
+                if (connection.modules.size() <= id) {
+                    connection.modules.resize(id + 1, -1);
+                    connection.moduleNames.resize(id + 1);
+                }
+                connection.modules[id] = m_moduleIndex.value(name, -1);
+                connection.moduleNames[id] = name;
+            }
+            pos += LiveFeed::kDefineHeaderSize + length;
+        } else {
+            emit statusChanged(QString("实时数据帧类型错误: %1，已断开连接").arg(int(type)));
+            connection.buffer.clear();
+            socket->abort();
+            return;
+        }
+    }
+
+    connection.buffer.remove(0, pos);
+
+    // 队列已满或套接字中仍有数据时稍后继续处理
+    if ((queueFull || socket->bytesAvailable() > 0) && !connection.retryScheduled) {
+        connection.retryScheduled = true;
+        QTimer::singleShot(queueFull ? 1 : 0, socket, [this, socket]() {
+            processSocket(socket);
+        });
+    }
+}
+
+LiveFeedServer::LiveFeedServer(QObject *parent)
+    : QObject(parent)
+    , m_queue(kQueueCapacity)
+    , m_worker(nullptr)
+    , m_generation(0)
+    , m_appliedCount(0)
+{
+    m_applyTimer.setInterval(16);
+    connect(&m_applyTimer, &QTimer::timeout, this, &LiveFeedServer::applyPending);
+}
+
+LiveFeedServer::~LiveFeedServer()
+{
+    stop();
+}
+
+void LiveFeedServer::setModules(const QVector<HardwareModule*> &modules)
+{
+    // 接收线程收到新列表之前仍按旧序号解析，这些增量的版本号与新版本不同，由 applyPending 丢弃
+    LiveStatDelta delta;
+    while (m_queue.tryPop(delta)) {
+    }
+    m_modules = modules;
+    ++m_generation;
+
+    if (m_worker) {
+        QStringList names;
+        for (auto module : modules) {
+            names.append(module->name());
+        }
+        QMetaObject::invokeMethod(m_worker, "setModuleNames", Qt::QueuedConnection,
+                                  Q_ARG(QStringList, names), Q_ARG(quint32, m_generation));
+    }
+}
+
+void LiveFeedServer::start(const QString &serverName)
+{
+    if (m_worker) return;
+
+    QStringList names;
+    for (auto module : m_modules) {
+        names.append(module->name());
+    }
+
+    m_worker = new LiveFeedWorker(&m_queue, names, m_generation);
+    m_worker->moveToThread(&m_thread);
+    connect(&m_thread, &QThread::finished, m_worker, &QObject::deleteLater);
+    connect(m_worker, &LiveFeedWorker::statusChanged, this, &LiveFeedServer::statusChanged);
+    m_thread.start();
+
+    LiveFeedWorker* worker = m_worker;
+    QMetaObject::invokeMethod(worker, [worker, serverName]() {
+        worker->start(serverName);
+    }, Qt::QueuedConnection);
+
+    m_appliedCount = 0;
+    m_applyTimer.start();
+}
+
+void LiveFeedServer::stop()
+{
+    if (!m_worker) return;
+
+    m_applyTimer.stop();
+    m_thread.quit();
+    m_thread.wait();
+    m_worker = nullptr;
+
+    applyPending();
+    emit statusChanged(QString("实时数据服务已停止，共应用 %1 条更新").arg(m_appliedCount));
+}
+
+void LiveFeedServer::applyPending()
+{
+    // 同一模块同一统计项在一帧内只保留最新值
+    QHash<quint64, double> latest;
+    LiveStatDelta delta;
+    int count = 0;
+    int stale = 0;
+    while (count + stale < kMaxDeltasPerFrame && m_queue.tryPop(delta)) {
+        if (delta.generation != m_generation) {
+            ++stale;
+            continue;
+        }
+        latest.insert((quint64(quint32(delta.moduleIndex)) << 32) | quint32(delta.keyId), delta.value);
+        ++count;
+    }
+    if (latest.isEmpty()) return;
+
+    QHash<int, QVector<QPair<int, double>>> perModule;
+    for (auto it = latest.begin(); it != latest.end(); ++it) {
+        int moduleIndex = int(it.key() >> 32);
+        int keyId = int(it.key() & 0xffffffffu);
+        if (moduleIndex < m_modules.size()) {
+            perModule[moduleIndex].append({keyId, it.value()});
+        }
+    }
+
+    for (auto it = perModule.begin(); it != perModule.end(); ++it) {
+        m_modules[it.key()]->setStatistics(it.value());
+    }
+    m_appliedCount += count;
+}
@@ -0,0 +1,97 @@
+#ifndef LIVEFEEDSERVER_H
+#define LIVEFEEDSERVER_H
+
+#include <QObject>
+#include <QThread>
+#include <QTimer>
+#include <QHash>
+#include <QVector>
+#include <QStringList>
+#include <QLocalServer>
+#include <QLocalSocket>
+#include "hardwaremodule.h"
+#include "spscqueue.h"
+
+// 接收线程解析出的单个统计增量，moduleIndex 为模块在 setup 文件中的顺序，
+// generation 为解析时模块列表的版本，与GUI线程当前版本不同的增量被丢弃
+struct LiveStatDelta {
+    int moduleIndex;
+    int keyId;
+    double value;
+    quint32 generation;
+};
+
+// 运行在接收线程中的套接字处理对象，解析帧并写入无锁队列
+class LiveFeedWorker : public QObject
+{
+    Q_OBJECT
+
+public:
+    LiveFeedWorker(SpscQueue<LiveStatDelta>* queue, const QStringList &moduleNames, quint32 generation);
+
+public slots:
+    void start(const QString &serverName);
+    // 更换模块列表，已建立的连接按声明过的模块名重新映射
+    void setModuleNames(const QStringList &moduleNames, quint32 generation);
+
+signals:
+    void statusChanged(const QString &message);
+
+private slots:
+    void onNewConnection();
+    void onReadyRead();
+    void onDisconnected();
+
+private:
+    // 每个连接的发送端ID映射与未处理数据
+    struct Connection {
+        QVector<int> keys;     // 发送端 keyId -> 驻留ID
+        QVector<int> modules;  // 发送端 moduleId -> 模块序号
+        QStringList moduleNames;  // 发送端 moduleId -> 声明的模块名
+        QByteArray buffer;
+        bool retryScheduled = false;
+    };
+
+    void processSocket(QLocalSocket* socket);
+
+    SpscQueue<LiveStatDelta>* m_queue;
+    QLocalServer* m_server;
+    QHash<QLocalSocket*, Connection> m_connections;
+    QHash<QString, int> m_moduleIndex;
+    quint32 m_generation;
+};
+
+// 实时数据接收端：在独立线程中监听本地套接字，
+// 在GUI线程中按显示刷新率批量合并并应用统计更新
+class LiveFeedServer : public QObject
+{
+    Q_OBJECT
+
+public:
+    explicit LiveFeedServer(QObject *parent = nullptr);
+    ~LiveFeedServer();
+
+    // 设置按 setup 顺序排列的模块列表
+    void setModules(const QVector<HardwareModule*> &modules);
+
+    void start(const QString &serverName);
+    void stop();
+    bool isRunning() const { return m_worker != nullptr; }
+
+signals:
+    void statusChanged(const QString &message);
+
+private slots:
+    void applyPending();
+
+private:
+    SpscQueue<LiveStatDelta> m_queue;
+    QThread m_thread;
+    LiveFeedWorker* m_worker;
+    QTimer m_applyTimer;
+    QVector<HardwareModule*> m_modules;
+    quint32 m_generation;  // 每次 setModules 递增
+    quint64 m_appliedCount;
+};
+
+#endif // LIVEFEEDSERVER_H
@@ -6,23 +6,73 @@
 #include <QApplication>
 #include <QFile>
 #include <QTextStream>
-#include <QRegularExpression>
 #include <QDebug>
 #include <QToolBar>
 #include <QFileDialog>
+#include <QStatusBar>
+#include <QScrollArea>
+#include <QFileInfo>
+#include <QInputDialog>
+#include <QProgressDialog>
+#include <QtMath>
+#include <QHash>
+#include <QMenu>
+#include <QToolButton>
+#include <QDialog>
+#include "statkeyregistry.h"
+#include "latencybreakdownchart.h"
+#include "setupparser.h"
+#include "statisticparser.h"
+#include "statisticexporter.h"
+#include "configdiff.h"
 
 MainWindow::MainWindow(QWidget *parent)
     : QMainWindow(parent)
     , m_visualizer(new HardwareVisualizer(this))
     , m_toolBar(new QToolBar(this))
+    , m_searchIndex(new ModuleSearchIndex(this))
+    , m_bottleneckAnalyzer(new BottleneckAnalyzer(this))
+    , m_bottleneckPanel(nullptr)
+    , m_liveFeed(new LiveFeedServer(this))
+    , m_cacheEventModel(new CacheEventModel(this))
+    , m_latencyDock(nullptr)
+    , m_rooflineAnalyzer(new RooflineAnalyzer(this))
+    , m_rooflinePanel(nullptr)
+    , m_nucaAnalyzer(new NucaBalanceAnalyzer(&m_visualizer->topology(), this))
+    , m_nucaPanel(nullptr)
+    , m_latencyModel(new LatencyModel(this))
+    , m_whatIfPanel(nullptr)
+    , m_statisticHistory(new StatisticHistory(this))
+    , m_historyPanel(nullptr)
+    , m_sweepDashboard(nullptr)
+    , m_replayPanel(nullptr)
+    , m_posterExporter(nullptr)
+    , m_memoryPanel(nullptr)
+    , m_searchEdit(nullptr)
+    , m_searchDock(nullptr)
+    , m_searchResults(nullptr)
     , m_darkTheme(true)
 {
     setWindowTitle("硬件可视化器");
     resize(1024, 768);
 
     createActions();
+    createBottleneckPanel();
+    createLatencyPanel();
+    createRooflinePanel();
+    createNucaPanel();
+    createWhatIfPanel();
+    createHistoryPanel();
+    createReplayPanel();
+    createMemoryPanel();
     createToolBar();
+    createSearchDock();
     setupInitialLayout();
+
+    connect(m_visualizer, &HardwareVisualizer::moduleMoved, this, [this]() {
+        m_layoutCache.store(m_modules);
+    });
+
     loadConfiguration();
 }
 
@@ -36,12 +86,228 @@ void MainWindow::createActions()
     m_resetAction = new QAction("重置布局", this);
     m_resetAction->setIcon(style()->standardIcon(QStyle::SP_BrowserReload));
     connect(m_resetAction, &QAction::triggered, this, &MainWindow::resetToInitial);
+
+    m_liveFeedAction = new QAction("实时数据", this);
+    m_liveFeedAction->setIcon(style()->standardIcon(QStyle::SP_MediaPlay));
+    m_liveFeedAction->setCheckable(true);
+    m_liveFeedAction->setToolTip(QString("在本地套接字 %1 上接收模拟器推送的统计数据").arg(LiveFeed::defaultServerName()));
+    connect(m_liveFeedAction, &QAction::toggled, this, &MainWindow::toggleLiveFeed);
+    m_sweepAction = new QAction("参数扫描", this);
+    m_sweepAction->setIcon(style()->standardIcon(QStyle::SP_DirOpenIcon));
+    m_sweepAction->setToolTip("加载一个目录下的多次运行，按配置参数对比统计项");
+    connect(m_sweepAction, &QAction::triggered, this, &MainWindow::showSweepDashboard);
+    m_exportAction = new QAction("导出统计", this);
+    m_exportAction->setIcon(style()->standardIcon(QStyle::SP_DialogSaveButton));
+    m_exportAction->setToolTip("将所有模块的配置与统计数据导出为 CSV 或 Arrow IPC 文件");
+    connect(m_exportAction, &QAction::triggered, this, &MainWindow::exportStatistics);
+    m_posterAction = new QAction("导出海报", this);
+    m_posterAction->setIcon(style()->standardIcon(QStyle::SP_DriveFDIcon));
+    m_posterAction->setToolTip("以任意分辨率将整个场景导出为分块 TIFF 或 Deep Zoom 瓦片金字塔");
+    connect(m_posterAction, &QAction::triggered, this, &MainWindow::exportPoster);
+    m_semanticZoomAction = new QAction("语义缩放", this);
+    m_semanticZoomAction->setIcon(style()->standardIcon(QStyle::SP_FileDialogListView));
+    m_semanticZoomAction->setCheckable(true);
+    m_semanticZoomAction->setChecked(m_visualizer->isSemanticZoomEnabled());
+    m_semanticZoomAction->setToolTip("缩小视图时将核心折叠为簇、插槽或芯片");
+    connect(m_semanticZoomAction, &QAction::toggled, m_visualizer, &HardwareVisualizer::setSemanticZoomEnabled);
+    m_flowAction = new QAction("流量动画", this);
+    m_flowAction->setIcon(style()->standardIcon(QStyle::SP_MediaSeekForward));
+    m_flowAction->setCheckable(true);
+    m_flowAction->setToolTip("在有流量的连接上显示沿主要流向移动的虚线");
+    connect(m_flowAction, &QAction::toggled, m_visualizer, &HardwareVisualizer::setFlowAnimationEnabled);
+    m_sparklineAction = new QAction("走势图", this);
+    m_sparklineAction->setIcon(style()->standardIcon(QStyle::SP_FileDialogDetailedView));
+    m_sparklineAction->setCheckable(true);
+    m_sparklineAction->setToolTip("在模块中显示所选统计项最近的变化，点击箭头为各类模块选择统计项");
+    m_visualizer->setStatisticHistory(m_statisticHistory);
+    connect(m_sparklineAction, &QAction::toggled, m_visualizer, &HardwareVisualizer::setSparklinesEnabled);
+    QMenu* sparklineMenu = new QMenu(this);
+    const QVector<QPair<HardwareModule::ModuleType, QString>> sparklineTypes = {
+        {HardwareModule::CPU_CORE, "CPU 核心"},
+        {HardwareModule::CACHE_L2, "L2 缓存"},
+        {HardwareModule::CACHE_L3, "L3 缓存"},
+        {HardwareModule::BUS, "总线"},
+        {HardwareModule::MEMORY_CTRL, "内存控制器"},
+        {HardwareModule::DMA, "DMA"}
+    };
+    for (const auto &entry : sparklineTypes) {
+        connect(sparklineMenu->addAction(entry.second + "…"), &QAction::triggered, this, [this, entry]() {
+            chooseSparklineMetric(entry.first, entry.second);
+        });
+    }
+    m_sparklineAction->setMenu(sparklineMenu);
+
+    connect(m_liveFeed, &LiveFeedServer::statusChanged, this, [this](const QString &message) {
+        statusBar()->showMessage(message, 5000);
+    });
 }
 
 void MainWindow::createToolBar()
 {
     addToolBar(m_toolBar);
     m_toolBar->addAction(m_resetAction);
+    m_toolBar->addAction(m_bottleneckAction);
+    m_toolBar->addAction(m_latencyAction);
+    m_toolBar->addAction(m_rooflineAction);
+    m_toolBar->addAction(m_nucaAction);
+    m_toolBar->addAction(m_whatIfAction);
+    m_toolBar->addAction(m_historyAction);
+    m_toolBar->addAction(m_replayAction);
+    m_toolBar->addAction(m_memoryAction);
+    m_toolBar->addAction(m_sweepAction);
+    m_toolBar->addAction(m_exportAction);
+    m_toolBar->addAction(m_posterAction);
+    m_toolBar->addAction(m_liveFeedAction);
+    m_toolBar->addAction(m_semanticZoomAction);
+    m_toolBar->addAction(m_flowAction);
+    m_toolBar->addAction(m_sparklineAction);
+    if (auto button = qobject_cast<QToolButton*>(m_toolBar->widgetForAction(m_sparklineAction))) {
+        button->setPopupMode(QToolButton::MenuButtonPopup);
+    }
+    m_toolBar->addSeparator();
+
+    m_searchEdit = new QLineEdit(this);
+    m_searchEdit->setPlaceholderText("搜索模块，或 top 10 edge_*_busy_rate / l2_miss_count > 500");
+    m_searchEdit->setClearButtonEnabled(true);
+    m_searchEdit->setMinimumWidth(320);
+    connect(m_searchEdit, &QLineEdit::returnPressed, this, &MainWindow::runSearch);
+    m_toolBar->addWidget(m_searchEdit);
+}
+
+void MainWindow::createBottleneckPanel()
+{
+    m_bottleneckPanel = new BottleneckPanel(m_bottleneckAnalyzer, m_visualizer, this);
+    addDockWidget(Qt::RightDockWidgetArea, m_bottleneckPanel);
+    m_bottleneckPanel->hide();
+
+    m_bottleneckAction = m_bottleneckPanel->toggleViewAction();
+    m_bottleneckAction->setText("瓶颈分析");
+    m_bottleneckAction->setIcon(style()->standardIcon(QStyle::SP_MessageBoxWarning));
+}
+
+void MainWindow::createLatencyPanel()
+{
+    m_latencyDock = new QDockWidget("缺失延迟分解", this);
+    QScrollArea* scrollArea = new QScrollArea(m_latencyDock);
+    scrollArea->setWidgetResizable(true);
+    scrollArea->setWidget(new LatencyBreakdownChart(m_cacheEventModel, scrollArea));
+    m_latencyDock->setWidget(scrollArea);
+    addDockWidget(Qt::BottomDockWidgetArea, m_latencyDock);
+    m_latencyDock->hide();
+
+    m_latencyAction = m_latencyDock->toggleViewAction();
+    m_latencyAction->setText("延迟分解");
+    m_latencyAction->setIcon(style()->standardIcon(QStyle::SP_FileDialogDetailedView));
+}
+
+void MainWindow::createRooflinePanel()
+{
+    m_rooflinePanel = new RooflinePanel(m_rooflineAnalyzer, this);
+    addDockWidget(Qt::RightDockWidgetArea, m_rooflinePanel);
+    m_rooflinePanel->hide();
+
+    m_rooflineAction = m_rooflinePanel->toggleViewAction();
+    m_rooflineAction->setText("带宽分析");
+    m_rooflineAction->setIcon(style()->standardIcon(QStyle::SP_DriveHDIcon));
+}
+
+void MainWindow::createNucaPanel()
+{
+    m_nucaPanel = new NucaBalancePanel(m_nucaAnalyzer, m_visualizer, this);
+    addDockWidget(Qt::RightDockWidgetArea, m_nucaPanel);
+    m_nucaPanel->hide();
+
+    m_nucaAction = m_nucaPanel->toggleViewAction();
+    m_nucaAction->setText("NUCA 负载");
+    m_nucaAction->setIcon(style()->standardIcon(QStyle::SP_DriveNetIcon));
+    m_nucaAction->setToolTip("比较各 L3 分片的访问份额与理想份额，并用地址轨迹预测备选交织函数的负载");
+}
+
+void MainWindow::createWhatIfPanel()
+{
+    m_whatIfPanel = new WhatIfPanel(m_latencyModel, this);
+    addDockWidget(Qt::RightDockWidgetArea, m_whatIfPanel);
+    m_whatIfPanel->hide();
+    m_visualizer->setLatencyModel(m_latencyModel);
+
+    m_whatIfAction = m_whatIfPanel->toggleViewAction();
+    m_whatIfAction->setText("What-if 分析");
+    m_whatIfAction->setIcon(style()->standardIcon(QStyle::SP_FileDialogContentsView));
+}
+
+void MainWindow::createHistoryPanel()
+{
+    m_historyPanel = new HistoryPanel(m_statisticHistory, this);
+    addDockWidget(Qt::BottomDockWidgetArea, m_historyPanel);
+    m_historyPanel->hide();
+
+    m_historyAction = m_historyPanel->toggleViewAction();
+    m_historyAction->setText("统计历史");
+    m_historyAction->setIcon(style()->standardIcon(QStyle::SP_FileDialogInfoView));
+}
+
+void MainWindow::createReplayPanel()
+{
+    m_replayPanel = new PacketReplayPanel(m_visualizer, this);
+    addDockWidget(Qt::BottomDockWidgetArea, m_replayPanel);
+    m_replayPanel->hide();
+
+    m_replayAction = m_replayPanel->toggleViewAction();
+    m_replayAction->setText("数据包回放");
+    m_replayAction->setIcon(style()->standardIcon(QStyle::SP_MediaSkipForward));
+}
+
+void MainWindow::createMemoryPanel()
+{
+    m_memoryPanel = new MemoryPanel(this);
+    addDockWidget(Qt::RightDockWidgetArea, m_memoryPanel);
+    m_memoryPanel->hide();
+
+    m_memoryAction = m_memoryPanel->toggleViewAction();
+    m_memoryAction->setText("内存占用");
+    m_memoryAction->setIcon(style()->standardIcon(QStyle::SP_DriveHDIcon));
+    m_memoryAction->setToolTip("按类别估算统计数据、场景图形项、文本、像素图与对话框占用的内存");
+    // 遍历整个场景，只在打开面板或点击刷新时统计
+    connect(m_memoryPanel, &MemoryPanel::refreshRequested, this, &MainWindow::refreshMemoryReport);
+    connect(m_memoryPanel, &QDockWidget::visibilityChanged, this, [this](bool visible) {
+        if (visible) refreshMemoryReport();
+    });
+}
+
+void MainWindow::refreshMemoryReport()
+{
+    MemoryAccounting report;
+    for (auto module : m_modules) {
+        module->accountMemory(report);
+    }
+    StatKeyRegistry::instance().accountMemory(report);
+    m_statisticHistory->accountMemory(report);
+    m_visualizer->accountMemory(report);
+    for (QDialog* dialog : findChildren<QDialog*>()) {
+        report.addObjectTree(dialog->metaObject()->className(), dialog);
+    }
+    for (QDockWidget* dock : findChildren<QDockWidget*>()) {
+        report.addObjectTree(dock->metaObject()->className(), dock);
+    }
+    if (m_sweepDashboard) {
+        report.addObjectTree(m_sweepDashboard->metaObject()->className(), m_sweepDashboard);
+    }
+    report.sampleResidentBytes();
+    m_memoryPanel->setReport(report);
+}
+
+void MainWindow::createSearchDock()
+{
+    m_searchDock = new QDockWidget("搜索结果", this);
+    m_searchResults = new QListWidget(m_searchDock);
+    m_searchDock->setWidget(m_searchResults);
+    addDockWidget(Qt::RightDockWidgetArea, m_searchDock);
+    m_searchDock->hide();
+
+    connect(m_searchResults, &QListWidget::itemActivated,
+            this, &MainWindow::onSearchResultActivated);
+    connect(m_searchResults, &QListWidget::itemClicked,
+            this, &MainWindow::onSearchResultActivated);
 }
 
 void MainWindow::setupInitialLayout()
@@ -51,6 +317,20 @@ void MainWindow::setupInitialLayout()
 
 void MainWindow::resetToInitial()
 {
+    if (!m_modules.isEmpty()) {
+        reloadConfiguration();
+        return;
+    }
+
+    m_liveFeed->setModules({});
+    m_cacheEventModel->setModule(nullptr);
+    m_searchIndex->clear();
+    m_bottleneckAnalyzer->clear();
+    m_rooflineAnalyzer->clear();
+    m_nucaAnalyzer->clear();
+    m_latencyModel->clear();
+    m_statisticHistory->clear();
+    m_searchResults->clear();
     m_visualizer->clearModules();
     qDeleteAll(m_modules);
     m_modules.clear();
@@ -62,220 +342,382 @@ void MainWindow::resetToInitial()
 void MainWindow::loadConfiguration()
 {
     loadSetupFile("resources/setup.txt");
+    m_visualizer->refreshTopology();
     loadStatisticFile("resources/statistic.txt");
-    m_visualizer->autoLayout();
+
+    // 优先恢复缓存的布局，只对缓存中没有的模块计算布局；位置批量应用，连接线只重绘一次
+    const QHash<HardwareModule*, QPointF> cached = m_layoutCache.restore(m_modules);
+    if (cached.size() < m_modules.size()) {
+        m_visualizer->autoLayout(cached);
+        m_layoutCache.store(m_modules);
+    } else {
+        m_visualizer->setModulePositions(cached);
+    }
+    m_liveFeed->setModules(m_modules);
+
+    for (auto module : m_modules) {
+        if (module->type() == HardwareModule::CACHE_EVENT_TRACER) {
+            m_cacheEventModel->setModule(module);
+            break;
+        }
+    }
 }
 
-void MainWindow::loadSetupFile(const QString& filename)
+void MainWindow::reloadConfiguration()
 {
-    QFile file(filename);
-    if (!file.open(QIODevice::ReadOnly | QIODevice::Text)) {
-        QMessageBox::warning(this, "Error", "Cannot open setup file: " + filename);
+    QVector<ModuleSetup> setups;
+    QVector<ModuleStatistics> statistics;
+    QString error;
+    if (!SetupParser::parseFile("resources/setup.txt", setups, &error)
+        || !StatisticParser::parseFile("resources/statistic.txt", statistics, &error)) {
+        QMessageBox::warning(this, "Error", error);
         return;
     }
 
-    QTextStream in(&file);
-    QString line;
-    HardwareModule* currentBus = nullptr;
-    QVector<QPair<int, int>> busEdges;
-    QMap<int, int> portToNodeMap;
-    int portNumber = 0;
-    int currentPortId = -1;
-    
-    HardwareModule::CacheConfig l1i, l1d, l2, l3;
-    int nucaIndex = -1;
-    int nucaNum = -1;
-
-    HardwareModule* currentModule = nullptr;
-
-    while (!in.atEnd()) {
-        line = in.readLine();
-        
-        int commentPos = line.indexOf("//");
-        if (commentPos != -1) {
-            line = line.left(commentPos);
+    const ConfigDiff diff = ConfigDiff::compute(m_moduleMap, setups);
+    bool topologyChanged = !diff.removed.isEmpty() || !diff.added.isEmpty();
+    m_searchResults->clear();
+
+    // 重建的模块沿用旧位置
+    QHash<QString, QPointF> oldPositions;
+    for (auto module : diff.removed) {
+        oldPositions.insert(module->name(), module->position());
+        unregisterModule(module);
+        if (m_cacheEventModel->module() == module) {
+            m_cacheEventModel->setModule(nullptr);
         }
-        
-        line = line.trimmed();
-        if (line.isEmpty()) continue;
-
-        if (line.contains("@1tick")) {
-            QString moduleName = line.split("@").first().trimmed();
-            
-            HardwareModule::ModuleType type;
-            if (moduleName.startsWith("CPU")) {
-                type = HardwareModule::CPU_CORE;
-            } else if (moduleName.startsWith("L2Cache")) {
-                type = HardwareModule::CACHE_L2;
-            } else if (moduleName.startsWith("L3Cache")) {
-                type = HardwareModule::CACHE_L3;
-            } else if (moduleName.startsWith("Bus")) {
-                type = HardwareModule::BUS;
-            } else if (moduleName.startsWith("MemoryNode")) {
-                type = HardwareModule::MEMORY_CTRL;
-            } else if (moduleName.startsWith("DMA")) {
-                type = HardwareModule::DMA;
-            } else if (moduleName.startsWith("cache_event_trace")) {
-                type = HardwareModule::CACHE_EVENT_TRACER;
-            } else {
-                continue;
-            }
-            
-            auto module = new HardwareModule(type, moduleName, this);
-            currentPortId = -1;
+        m_moduleMap.remove(module->name());
+        m_modules.removeAll(module);
+        delete module;
+    }
+
+    int updated = 0;
+    for (const auto &match : diff.matched) {
+        HardwareModule* module = match.first;
+        const int result = SetupParser::applySetup(module, setups[match.second]);
+        if (result == SetupParser::UNCHANGED) continue;
+
+        ++updated;
+        // 分析器在加入模块时读取配置，需要重新登记
+        m_bottleneckAnalyzer->removeModule(module);
+        m_bottleneckAnalyzer->addModule(module);
+        m_rooflineAnalyzer->removeModule(module);
+        m_rooflineAnalyzer->addModule(module);
+        m_nucaAnalyzer->removeModule(module);
+        m_nucaAnalyzer->addModule(module);
+        m_latencyModel->removeModule(module);
+        m_latencyModel->addModule(module);
+        if (result & SetupParser::TOPOLOGY_CHANGED) {
+            topologyChanged = true;
+        }
+    }
+
+    QSet<HardwareModule*> placed;
+    for (int index : diff.added) {
+        auto module = SetupParser::createModule(setups[index], this);
+        auto it = oldPositions.constFind(module->name());
+        if (it != oldPositions.constEnd()) {
+            module->setPosition(*it);
+            placed.insert(module);
+        }
+        m_moduleMap[module->name()] = module;
+        registerModule(module);
+    }
+
+    // 保持配置文件中的模块顺序
+    m_modules.clear();
+    for (const auto &setup : setups) {
+        if (auto module = m_moduleMap.value(setup.name)) {
             m_modules.append(module);
-            m_moduleMap[moduleName] = module;
-            m_visualizer->addModule(module);
-            
-            currentModule = module;
-            
-            if (type == HardwareModule::BUS) {
-                currentBus = module;
-            }
-        } else if (line.startsWith("node_number:")) {
-            portNumber = line.split(":").last().trimmed().toInt();
-        } else if (line.startsWith("node_id_of_port_")) {
-            QRegularExpression re("node_id_of_port_(\\d+):\\s*(\\d+)");
-            auto match = re.match(line);
-            if (match.hasMatch()) {
-                int port = match.captured(1).toInt();
-                int node = match.captured(2).toInt();
-                portToNodeMap[port] = node;
-            }
-        } else if (line.startsWith("edge:")) {
-            QRegularExpression re("edge:\\s*(\\d+)\\s*to\\s*(\\d+)");
-            auto match = re.match(line);
-            if (match.hasMatch()) {
-                int from = match.captured(1).toInt();
-                int to = match.captured(2).toInt();
-                busEdges.append({from, to});
-            }
-        } else if (line.startsWith("port_id:")) {
-            currentPortId = line.split(":").last().trimmed().toInt();
-            if (currentModule) {
-                currentModule->setPortId(currentPortId);
-            }
-        } else if (currentModule) {
-            if (currentModule->type() == HardwareModule::CACHE_L3) {
-                if (line.startsWith("way_count:")) {
-                    l3.wayCount = line.split(":").last().trimmed().toInt();
-                } else if (line.startsWith("set_count:")) {
-                    l3.setCount = line.split(":").last().trimmed().toInt();
-                } else if (line.startsWith("mshr_count:")) {
-                    l3.mshrCount = line.split(":").last().trimmed().toInt();
-                } else if (line.startsWith("index_width:")) {
-                    l3.indexWidth = line.split(":").last().trimmed().toInt();
-                } else if (line.startsWith("index_latency:")) {
-                    l3.indexLatency = line.split(":").last().trimmed().toInt();
-                } else if (line.startsWith("nuca_index:")) {
-                    nucaIndex = line.split(":").last().trimmed().toInt();
-                } else if (line.startsWith("nuca_num:")) {
-                    nucaNum = line.split(":").last().trimmed().toInt();
-                    
-                    if (l3.wayCount > 0 && l3.setCount > 0 && nucaIndex >= 0 && nucaNum > 0) {
-                        currentModule->setL3CacheConfig(l3, nucaIndex, nucaNum);
-                        l3 = HardwareModule::CacheConfig();
-                        nucaIndex = -1;
-                        nucaNum = -1;
-                    }
-                }
-            } 
-            else if (currentModule->type() == HardwareModule::CACHE_L2) {
-                if (line.startsWith("l1i_way_count:")) {
-                    l1i.wayCount = line.split(":").last().trimmed().toInt();
-                } else if (line.startsWith("l1i_set_count:")) {
-                    l1i.setCount = line.split(":").last().trimmed().toInt();
-                } else if (line.startsWith("l1d_way_count:")) {
-                    l1d.wayCount = line.split(":").last().trimmed().toInt();
-                } else if (line.startsWith("l1d_set_count:")) {
-                    l1d.setCount = line.split(":").last().trimmed().toInt();
-                } else if (line.startsWith("l2_way_count:")) {
-                    l2.wayCount = line.split(":").last().trimmed().toInt();
-                } else if (line.startsWith("l2_set_count:")) {
-                    l2.setCount = line.split(":").last().trimmed().toInt();
-                } else if (line.startsWith("l2_mshr_count:")) {
-                    l2.mshrCount = line.split(":").last().trimmed().toInt();
-                } else if (line.startsWith("l2_index_width:")) {
-                    l2.indexWidth = line.split(":").last().trimmed().toInt();
-                } else if (line.startsWith("l2_index_latency:")) {
-                    l2.indexLatency = line.split(":").last().trimmed().toInt();
-                    
-                    if (l1i.wayCount > 0 && l1i.setCount > 0 && 
-                        l1d.wayCount > 0 && l1d.setCount > 0 && 
-                        l2.wayCount > 0 && l2.setCount > 0) {
-                        currentModule->setL2CacheConfig(l1i, l1d, l2);
-                        l1i = l1d = l2 = HardwareModule::CacheConfig();
-                    }
-                }
-            }
-            else if (currentModule->type() == HardwareModule::MEMORY_CTRL) {
-                if (line.startsWith("data_width:")) {
-                    int dataWidth = line.split(":").last().trimmed().toInt();
-                    currentModule->setMemoryConfig(dataWidth);
-                }
+        }
+    }
+
+    // 统计数据整体替换：新文件中缺少的统计项与分布从模块中删除，不在文件中的模块清空；
+    // 只对变化的统计项发出通知，未变化的模块不会触发重新分析
+    QHash<QString, const ModuleStatistics*> statsByModule;
+    for (const auto &moduleStats : statistics) {
+        statsByModule.insert(moduleStats.module, &moduleStats);
+    }
+    for (auto module : m_modules) {
+        const ModuleStatistics* moduleStats = statsByModule.value(module->name());
+        module->replaceStatistics(moduleStats ? moduleStats->values : QVector<QPair<int, double>>());
+        module->replaceHistograms(moduleStats ? moduleStats->histograms
+                                              : QVector<QPair<int, StatisticHistogram>>());
+    }
+
+    if (placed.size() < diff.added.size()) {
+        // 已有模块保持原位，只为没有旧位置的新模块计算布局
+        QSet<HardwareModule*> fixed;
+        for (auto module : m_modules) {
+            fixed.insert(module);
+        }
+        for (int index : diff.added) {
+            auto module = m_moduleMap.value(setups[index].name);
+            if (!placed.contains(module)) {
+                fixed.remove(module);
             }
         }
+        m_visualizer->refreshTopology();
+        m_visualizer->autoLayout(fixed);
+        m_layoutCache.store(m_modules);
+    } else if (topologyChanged) {
+        m_visualizer->refreshTopology();
+        m_visualizer->drawConnections();
     }
 
-    if (currentBus) {
-        currentBus->setBusConfig(portNumber, portToNodeMap, busEdges);
+    if (!diff.removed.isEmpty() || !diff.added.isEmpty()) {
+        m_liveFeed->setModules(m_modules);
+    }
+    if (!m_cacheEventModel->module()) {
+        for (auto module : m_modules) {
+            if (module->type() == HardwareModule::CACHE_EVENT_TRACER) {
+                m_cacheEventModel->setModule(module);
+                break;
+            }
+        }
     }
 
-    file.close();
+    statusBar()->showMessage(QString("重新加载：新增 %1，删除 %2，更新 %3 个模块")
+                                 .arg(diff.added.size()).arg(diff.removed.size()).arg(updated), 5000);
 }
 
-void MainWindow::loadStatisticFile(const QString& filename)
+void MainWindow::registerModule(HardwareModule* module)
 {
-    QFile file(filename);
-    if (!file.open(QIODevice::ReadOnly | QIODevice::Text)) {
-        QMessageBox::warning(this, "Error", "Cannot open statistics file: " + filename);
+    m_searchIndex->addModule(module);
+    m_bottleneckAnalyzer->addModule(module);
+    m_rooflineAnalyzer->addModule(module);
+    m_nucaAnalyzer->addModule(module);
+    m_latencyModel->addModule(module);
+    m_statisticHistory->addModule(module);
+    m_visualizer->addModule(module);
+}
+
+void MainWindow::unregisterModule(HardwareModule* module)
+{
+    m_visualizer->removeModule(module);
+    m_statisticHistory->removeModule(module);
+    m_latencyModel->removeModule(module);
+    m_nucaAnalyzer->removeModule(module);
+    m_rooflineAnalyzer->removeModule(module);
+    m_bottleneckAnalyzer->removeModule(module);
+    m_searchIndex->removeModule(module);
+}
+
+void MainWindow::loadSetupFile(const QString& filename)
+{
+    QVector<ModuleSetup> setups;
+    QString error;
+    if (!SetupParser::parseFile(filename, setups, &error)) {
+        QMessageBox::warning(this, "Error", error);
         return;
     }
 
-    QTextStream in(&file);
-    QString currentModule;
-    QMap<QString, double> currentStats;
+    for (const auto &setup : setups) {
+        auto module = SetupParser::createModule(setup, this);
+        m_modules.append(module);
+        m_moduleMap[setup.name] = module;
+        registerModule(module);
+    }
+}
 
-    while (!in.atEnd()) {
-        QString line = in.readLine();
-        
-        int commentPos = line.indexOf("//");
-        if (commentPos != -1) {
-            line = line.left(commentPos);
-        }
-        
-        line = line.trimmed();
-        if (line.isEmpty()) continue;
+void MainWindow::loadStatisticFile(const QString& filename)
+{
+    QVector<ModuleStatistics> statistics;
+    QString error;
+    if (!StatisticParser::parseFile(filename, statistics, &error)) {
+        QMessageBox::warning(this, "Error", error);
+        return;
+    }
 
-        if (line.contains("Latency:")) {
-            if (!currentModule.isEmpty() && !currentStats.isEmpty()) {
-                updateModuleStatistics(currentModule, currentStats);
+    for (const auto &moduleStats : statistics) {
+        updateModuleStatistics(moduleStats.module, moduleStats.values);
+        if (!moduleStats.histograms.isEmpty()) {
+            if (auto module = m_moduleMap.value(moduleStats.module)) {
+                module->setHistograms(moduleStats.histograms);
             }
-            currentModule = line.split(" ").first();
-            currentStats.clear();
-            continue;
         }
+    }
+}
 
-        QStringList parts = line.split(":");
-        if (parts.size() == 2) {
-            QString key = parts[0].trimmed();
-            double value = parts[1].trimmed().toDouble();
-            currentStats[key] = value;
+void MainWindow::updateModuleStatistics(const QString& moduleName, const QVector<QPair<int, double>>& stats)
+{
+    if (auto module = m_moduleMap.value(moduleName)) {
+        module->setStatistics(stats);
+    }
+}
+
+void MainWindow::chooseSparklineMetric(HardwareModule::ModuleType type, const QString &typeName)
+{
+    // 候选为该类模块出现过的统计项，也可输入其它名称
+    QSet<QString> keySet;
+    for (auto module : m_modules) {
+        if (module->type() != type) continue;
+        for (auto it = module->statistics().constBegin(); it != module->statistics().constEnd(); ++it) {
+            keySet.insert(it.key());
         }
     }
+    QStringList keys(keySet.begin(), keySet.end());
+    keys.sort();
+    const QString none = "（不显示）";
+    keys.prepend(none);
 
-    if (!currentModule.isEmpty() && !currentStats.isEmpty()) {
-        updateModuleStatistics(currentModule, currentStats);
+    QString current = m_visualizer->sparklineMetric(type);
+    const bool currentRate = current.endsWith("/s");
+    if (currentRate) current.chop(2);
+    bool ok = false;
+    const QString key = QInputDialog::getItem(this, "走势图统计项", typeName + " 显示的统计项：", keys,
+                                              qMax(0, keys.indexOf(current)), true, &ok).trimmed();
+    if (!ok) return;
+    if (key.isEmpty() || key == none) {
+        m_visualizer->setSparklineMetric(type, QString(), false);
+        return;
     }
 
-    file.close();
+    const QStringList modes = {"每秒变化量（计数器）", "当前值"};
+    const QString mode = QInputDialog::getItem(this, "走势图统计项", key + " 显示为：", modes,
+                                               currentRate || current.isEmpty() ? 0 : 1, false, &ok);
+    if (!ok) return;
+    m_visualizer->setSparklineMetric(type, key, mode == modes.first());
+    m_sparklineAction->setChecked(true);
 }
 
-void MainWindow::updateModuleStatistics(const QString& moduleName, const QMap<QString, double>& stats)
+void MainWindow::toggleLiveFeed(bool enabled)
 {
-    if (auto module = m_moduleMap.value(moduleName)) {
-        for (auto it = stats.begin(); it != stats.end(); ++it) {
-            module->setStatistic(it.key(), it.value());
+    if (enabled) {
+        m_liveFeed->start(LiveFeed::defaultServerName());
+    } else {
+        m_liveFeed->stop();
+    }
+}
+
+void MainWindow::showSweepDashboard()
+{
+    if (!m_sweepDashboard) {
+        m_sweepDashboard = new SweepDashboard(this);
+    }
+    m_sweepDashboard->show();
+    m_sweepDashboard->raise();
+    m_sweepDashboard->activateWindow();
+}
+
+void MainWindow::exportStatistics()
+{
+    const QString csvLong = "CSV 长表 (*.csv)";
+    const QString csvWide = "CSV 宽表 (*.csv)";
+    const QString arrowLong = "Arrow IPC 长表 (*.arrow)";
+    const QString arrowWide = "Arrow IPC 宽表 (*.arrow)";
+    QString selectedFilter = csvLong;
+    QString filename = QFileDialog::getSaveFileName(this, "导出统计数据", "statistics.csv",
+        QStringList({csvLong, csvWide, arrowLong, arrowWide}).join(";;"), &selectedFilter);
+    if (filename.isEmpty()) return;
+
+    auto format = selectedFilter.startsWith("Arrow") ? StatisticExporter::ARROW_IPC : StatisticExporter::CSV;
+    auto layout = (selectedFilter == csvWide || selectedFilter == arrowWide) ? StatisticExporter::WIDE : StatisticExporter::LONG;
+    if (format == StatisticExporter::ARROW_IPC && filename.endsWith(".csv")) {
+        filename.chop(4);
+        filename += ".arrow";
+    }
+
+    QString error;
+    if (!StatisticExporter::exportFile(m_modules, filename, format, layout, &error)) {
+        QMessageBox::warning(this, "导出失败", error);
+        return;
+    }
+    statusBar()->showMessage("已导出到 " + filename, 5000);
+}
+
+void MainWindow::exportPoster()
+{
+    if (m_posterExporter && m_posterExporter->isRunning()) return;
+
+    const QString tiff = "TIFF 图像 (*.tif *.tiff)";
+    const QString pyramid = "Deep Zoom 瓦片金字塔 (*.dzi)";
+    QString selectedFilter = tiff;
+    QString filename = QFileDialog::getSaveFileName(this, "导出海报", "poster.tif",
+        QStringList({tiff, pyramid}).join(";;"), &selectedFilter);
+    if (filename.isEmpty()) return;
+
+    auto format = selectedFilter == pyramid ? PosterExporter::TILE_PYRAMID : PosterExporter::TIFF;
+    if (format == PosterExporter::TILE_PYRAMID && !filename.endsWith(".dzi")) {
+        filename = QFileInfo(filename).path() + "/" + QFileInfo(filename).completeBaseName() + ".dzi";
+    }
+
+    QRectF source = m_visualizer->scene()->itemsBoundingRect().adjusted(-50, -50, 50, 50);
+    bool ok = false;
+    double scale = QInputDialog::getDouble(this, "导出海报",
+        QString("场景大小 %1 x %2，输出缩放倍数：").arg(qCeil(source.width())).arg(qCeil(source.height())),
+        4.0, 0.1, 256.0, 1, &ok);
+    if (!ok) return;
+
+    if (!m_posterExporter) {
+        m_posterExporter = new PosterExporter(this);
+    }
+    QString error;
+    if (!m_posterExporter->start(m_visualizer->scene(), source, m_visualizer->backgroundBrush(), scale,
+                                 filename, format, &error)) {
+        QMessageBox::warning(this, "导出失败", error);
+        return;
+    }
+
+    QSize size = PosterExporter::outputSize(source, scale);
+    QProgressDialog* progress = new QProgressDialog(QString("正在导出 %1 x %2 像素的海报").arg(size.width()).arg(size.height()),
+                                                    "取消", 0, 1, this);
+    progress->setAttribute(Qt::WA_DeleteOnClose);
+    progress->setWindowModality(Qt::WindowModal);
+    progress->setMinimumDuration(0);
+    connect(progress, &QProgressDialog::canceled, m_posterExporter, &PosterExporter::cancel);
+    connect(m_posterExporter, &PosterExporter::progress, progress, [progress](int done, int total) {
+        progress->setMaximum(total);
+        progress->setValue(done);
+    });
+    connect(m_posterExporter, &PosterExporter::finished, progress, [this, progress, filename](bool ok, const QString &error) {
+        progress->close();
+        if (ok) {
+            statusBar()->showMessage("已导出到 " + filename, 5000);
+        } else if (!error.isEmpty()) {
+            QMessageBox::warning(this, "导出失败", error);
         }
+    });
+}
+
+void MainWindow::runSearch()
+{
+    m_searchResults->clear();
+
+    QString text = m_searchEdit->text().trimmed();
+    if (text.isEmpty()) {
+        m_visualizer->highlightModules({});
+        m_searchDock->hide();
+        return;
     }
-}
\ No newline at end of file
+
+    const auto hits = m_searchIndex->query(text);
+    QList<HardwareModule*> matched;
+    for (const auto &hit : hits) {
+        QString label = hit.module->name();
+        if (hit.keyId >= 0) {
+            label += QString("  %1 = %2")
+                         .arg(StatKeyRegistry::instance().name(hit.keyId))
+                         .arg(hit.value, 0, 'g', 6);
+        }
+        auto item = new QListWidgetItem(label, m_searchResults);
+        item->setData(Qt::UserRole, QVariant::fromValue(hit.module));
+        if (!matched.contains(hit.module)) {
+            matched.append(hit.module);
+        }
+    }
+
+    m_visualizer->highlightModules(matched);
+    if (!matched.isEmpty()) {
+        m_visualizer->focusModule(matched.first());
+    }
+    m_searchDock->setWindowTitle(QString("搜索结果 (%1)").arg(hits.size()));
+    m_searchDock->show();
+}
+
+void MainWindow::onSearchResultActivated(QListWidgetItem *item)
+{
+    if (auto module = item->data(Qt::UserRole).value<HardwareModule*>()) {
+        m_visualizer->focusModule(module);
+    }
+}
@@ -6,8 +6,29 @@
 #include <QAction>
 #include <QVector>
 #include <QMap>
+#include <QLineEdit>
+#include <QDockWidget>
+#include <QListWidget>
 #include "hardwaremodule.h"
 #include "hardwarevisualizer.h"
+#include "modulesearchindex.h"
+#include "bottleneckanalyzer.h"
+#include "bottleneckpanel.h"
+#include "livefeedserver.h"
+#include "layoutcache.h"
+#include "cacheeventmodel.h"
+#include "rooflineanalyzer.h"
+#include "rooflinepanel.h"
+#include "latencymodel.h"
+#include "whatifpanel.h"
+#include "statistichistory.h"
+#include "historypanel.h"
+#include "sweepdashboard.h"
+#include "packetreplaypanel.h"
+#include "posterexporter.h"
+#include "memorypanel.h"
+#include "nucabalance.h"
+#include "nucabalancepanel.h"
 
 class MainWindow : public QMainWindow
 {
@@ -19,27 +40,97 @@ public:
 
 private slots:
     void resetToInitial();
+    // 执行搜索栏中的查询
+    void runSearch();
+    // 选中搜索结果时聚焦对应模块
+    void onSearchResultActivated(QListWidgetItem *item);
+    // 启动/停止实时数据接收
+    void toggleLiveFeed(bool enabled);
+    // 打开参数扫描面板
+    void showSweepDashboard();
+    // 导出所有模块的配置与统计数据
+    void exportStatistics();
+    // 将场景按指定分辨率导出为分块海报
+    void exportPoster();
+    // 统计模型、场景与界面的内存占用并显示在内存面板中
+    void refreshMemoryReport();
 
 private:
     void createToolBar();
     void createActions();
+    void createSearchDock();
+    void createBottleneckPanel();
+    void createLatencyPanel();
+    void createRooflinePanel();
+    void createNucaPanel();
+    void createWhatIfPanel();
+    void createHistoryPanel();
+    // 为一类模块选择走势图显示的统计项
+    void chooseSparklineMetric(HardwareModule::ModuleType type, const QString &typeName);
+    void createReplayPanel();
+    void createMemoryPanel();
     void setupInitialLayout();
     void loadConfiguration();
     
+    // 已加载模块时按新配置增量更新：只重建增删的模块，原地更新其余模块
+    void reloadConfiguration();
+    // 向搜索索引、分析器与场景注册或注销模块
+    void registerModule(HardwareModule* module);
+    void unregisterModule(HardwareModule* module);
+
     // 从配置文件加载硬件配置
     void loadSetupFile(const QString& filename);
     // 从统计文件加载性能数据
     void loadStatisticFile(const QString& filename);
     // 更新模块统计信息
-    void updateModuleStatistics(const QString& moduleName, const QMap<QString, double>& stats);
+    void updateModuleStatistics(const QString& moduleName, const QVector<QPair<int, double>>& stats);
 
     HardwareVisualizer *m_visualizer;
     QToolBar *m_toolBar;
     QVector<HardwareModule*> m_modules;
     QMap<QString, HardwareModule*> m_moduleMap; // 模块名到模块指针的映射
+    ModuleSearchIndex *m_searchIndex;             // 模块与统计项搜索索引
+    BottleneckAnalyzer *m_bottleneckAnalyzer;     // 瓶颈分析
+    BottleneckPanel *m_bottleneckPanel;
+    LiveFeedServer *m_liveFeed;                   // 实时数据接收
+    LayoutCache m_layoutCache;                    // 按拓扑保存的模块布局
+    CacheEventModel *m_cacheEventModel;           // 缓存事件延迟分解
+    QDockWidget *m_latencyDock;
+    RooflineAnalyzer *m_rooflineAnalyzer;         // 内存带宽与 Roofline 分析
+    RooflinePanel *m_rooflinePanel;
+    NucaBalanceAnalyzer *m_nucaAnalyzer;          // NUCA 分片负载均衡
+    NucaBalancePanel *m_nucaPanel;
+    LatencyModel *m_latencyModel;                 // What-if 解析延迟模型
+    WhatIfPanel *m_whatIfPanel;
+    StatisticHistory *m_statisticHistory;         // 统计项随时间的变化
+    HistoryPanel *m_historyPanel;
+    SweepDashboard *m_sweepDashboard;             // 参数扫描，首次打开时创建
+    PacketReplayPanel *m_replayPanel;             // 总线数据包回放
+    PosterExporter *m_posterExporter;             // 海报导出，首次使用时创建
+    MemoryPanel *m_memoryPanel;                   // 内存占用
+
+    // 搜索栏与结果列表
+    QLineEdit *m_searchEdit;
+    QDockWidget *m_searchDock;
+    QListWidget *m_searchResults;
 
     // 工具栏动作
     QAction *m_resetAction;
+    QAction *m_bottleneckAction;
+    QAction *m_latencyAction;
+    QAction *m_rooflineAction;
+    QAction *m_nucaAction;
+    QAction *m_whatIfAction;
+    QAction *m_historyAction;
+    QAction *m_sparklineAction;
+    QAction *m_replayAction;
+    QAction *m_memoryAction;
+    QAction *m_liveFeedAction;
+    QAction *m_sweepAction;
+    QAction *m_exportAction;
+    QAction *m_posterAction;
+    QAction *m_semanticZoomAction;
+    QAction *m_flowAction;
     QAction *m_drawLineAction;
     QAction *m_themeAction;
     
@@ -0,0 +1,170 @@
+#include "memoryaccounting.h"
+#include <QFile>
+#include <QSaveFile>
+#include <QJsonDocument>
+#include <QJsonObject>
+#include <QJsonArray>
+#include <QDateTime>
+#include <QObject>
+#ifdef Q_OS_LINUX
+#include <unistd.h>
+#endif
+
+QString MemoryAccounting::categoryId(Category category)
+{
+    switch (category) {
+        case MODULE_STATISTICS: return "module_statistics";
+        case MODULE_HISTOGRAMS: return "module_histograms";
+        case MODULE_CONFIG: return "module_config";
+        case STAT_KEYS: return "stat_keys";
+        case STATISTIC_HISTORY: return "statistic_history";
+        case GRAPHICS_ITEMS: return "graphics_items";
+        case TEXT_DOCUMENTS: return "text_documents";
+        case PIXMAPS: return "pixmaps";
+        case DIALOGS: return "dialogs";
+        default: return QString();
+    }
+}
+
+QString MemoryAccounting::categoryLabel(Category category)
+{
+    switch (category) {
+        case MODULE_STATISTICS: return "模块统计项";
+        case MODULE_HISTOGRAMS: return "模块分布统计";
+        case MODULE_CONFIG: return "总线与缓存配置";
+        case STAT_KEYS: return "统计项名称";
+        case STATISTIC_HISTORY: return "统计历史";
+        case GRAPHICS_ITEMS: return "图形项";
+        case TEXT_DOCUMENTS: return "文本文档";
+        case PIXMAPS: return "像素图";
+        case DIALOGS: return "对话框与面板";
+        default: return QString();
+    }
+}
+
+void MemoryAccounting::add(Category category, const QString &detail, qint64 count, qint64 bytes)
+{
+    CategoryData &data = m_categories[category];
+    auto it = data.index.constFind(detail);
+    if (it == data.index.constEnd()) {
+        it = data.index.insert(detail, data.entries.size());
+        data.entries.append(Entry{detail, 0, 0});
+    }
+    Entry &entry = data.entries[it.value()];
+    entry.count += count;
+    entry.bytes += bytes;
+}
+
+void MemoryAccounting::addPixmap(const QString &detail, qint64 cacheKey, int width, int height, int depth)
+{
+    if (width <= 0 || height <= 0 || m_pixmapKeys.contains(cacheKey)) return;
+    m_pixmapKeys.insert(cacheKey);
+    add(PIXMAPS, detail, 1, qint64(width) * height * depth / 8);
+}
+
+void MemoryAccounting::addObjectTree(const QString &detail, const QObject *root)
+{
+    if (!root) return;
+    qint64 widgets = root->isWidgetType() ? 1 : 0;
+    const QList<QObject*> children = root->findChildren<QObject*>();
+    for (const QObject *child : children) {
+        if (child->isWidgetType()) ++widgets;
+    }
+    const qint64 objects = children.size() + 1;
+    add(DIALOGS, detail, objects, widgets * kWidgetBytes + (objects - widgets) * kObjectBytes);
+}
+
+MemoryAccounting::Entry MemoryAccounting::total(Category category) const
+{
+    Entry result;
+    result.name = categoryLabel(category);
+    for (const Entry &entry : m_categories[category].entries) {
+        result.count += entry.count;
+        result.bytes += entry.bytes;
+    }
+    return result;
+}
+
+QVector<MemoryAccounting::Entry> MemoryAccounting::details(Category category) const
+{
+    return m_categories[category].entries;
+}
+
+qint64 MemoryAccounting::totalBytes() const
+{
+    qint64 bytes = 0;
+    for (int i = 0; i < CATEGORY_COUNT; ++i) {
+        bytes += total(Category(i)).bytes;
+    }
+    return bytes;
+}
+
+void MemoryAccounting::sampleResidentBytes()
+{
+    m_residentBytes = -1;
+#ifdef Q_OS_LINUX
+    // /proc/self/statm 的第二列为常驻页数
+    QFile file("/proc/self/statm");
+    if (file.open(QIODevice::ReadOnly)) {
+        const QList<QByteArray> fields = file.readAll().split(' ');
+        bool ok = false;
+        const qint64 pages = fields.size() > 1 ? fields[1].toLongLong(&ok) : 0;
+        if (ok) {
+            m_residentBytes = pages * sysconf(_SC_PAGESIZE);
+        }
+    }
+#endif
+}
+
+qint64 MemoryAccounting::stringBytes(const QString &string)
+{
+    return sizeof(string) + (string.capacity() > 0 ? kArrayHeaderBytes + (string.capacity() + 1) * qint64(sizeof(QChar)) : 0);
+}
+
+QByteArray MemoryAccounting::toJson() const
+{
+    QJsonArray categories;
+    for (int i = 0; i < CATEGORY_COUNT; ++i) {
+        const Category category = Category(i);
+        const Entry sum = total(category);
+        QJsonArray details;
+        for (const Entry &entry : m_categories[i].entries) {
+            details.append(QJsonObject{
+                {"name", entry.name},
+                {"count", entry.count},
+                {"bytes", entry.bytes}
+            });
+        }
+        categories.append(QJsonObject{
+            {"id", categoryId(category)},
+            {"count", sum.count},
+            {"bytes", sum.bytes},
+            {"details", details}
+        });
+    }
+
+    QJsonObject root;
+    root.insert("timestamp", QDateTime::currentDateTime().toString(Qt::ISODate));
+    root.insert("accounted_bytes", totalBytes());
+    if (m_residentBytes >= 0) {
+        root.insert("resident_bytes", m_residentBytes);
+        root.insert("unaccounted_bytes", m_residentBytes - totalBytes());
+    }
+    root.insert("categories", categories);
+    return QJsonDocument(root).toJson(QJsonDocument::Indented);
+}
+
+bool MemoryAccounting::writeJson(const QString &filename, QString *error) const
+{
+    QSaveFile file(filename);
+    if (!file.open(QIODevice::WriteOnly)) {
+        if (error) *error = "Cannot open export file: " + filename;
+        return false;
+    }
+    file.write(toJson());
+    if (!file.commit()) {
+        if (error) *error = file.errorString();
+        return false;
+    }
+    return true;
+}
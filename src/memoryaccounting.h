@@ -0,0 +1,98 @@
+#ifndef MEMORYACCOUNTING_H
+#define MEMORYACCOUNTING_H
+
+#include <QString>
+#include <QVector>
+#include <QHash>
+#include <QMap>
+#include <QSet>
+#include <QByteArray>
+
+class QObject;
+
+// 内存占用统计：各组件按类别上报对象数与估算字节数，汇总后显示或导出为 JSON
+// 字节数按容器容量与元素大小估算（含 Qt 容器头与节点开销），不替换分配器，
+// 与进程常驻内存的差值即为未归类部分（Qt 内部结构、字体缓存、分配器碎片等）
+class MemoryAccounting
+{
+public:
+    enum Category {
+        MODULE_STATISTICS,   // 模块标量统计项
+        MODULE_HISTOGRAMS,   // 模块分布型统计项
+        MODULE_CONFIG,       // 总线、缓存与端口配置
+        STAT_KEYS,           // 统计项名称驻留表
+        STATISTIC_HISTORY,   // 统计历史与金字塔
+        GRAPHICS_ITEMS,      // 场景图形项
+        TEXT_DOCUMENTS,      // 文字项的文本文档与排版
+        PIXMAPS,             // 图标与缓存像素图
+        DIALOGS,             // 对话框与停靠面板中的控件
+        CATEGORY_COUNT
+    };
+
+    struct Entry {
+        QString name;
+        qint64 count = 0;
+        qint64 bytes = 0;
+    };
+
+    // 类别在 JSON 中的标识与面板中显示的名称
+    static QString categoryId(Category category);
+    static QString categoryLabel(Category category);
+
+    // 向类别的某一明细累加，同名明细合并
+    void add(Category category, const QString &detail, qint64 count, qint64 bytes);
+    // 像素图按 cacheKey 去重，隐式共享的副本只计一次；只传尺寸与位深，本类不依赖 QtGui
+    void addPixmap(const QString &detail, qint64 cacheKey, int width, int height, int depth);
+    // 控件树按控件与其他对象的数目估算，计入 DIALOGS
+    void addObjectTree(const QString &detail, const QObject *root);
+
+    Entry total(Category category) const;
+    QVector<Entry> details(Category category) const;
+    qint64 totalBytes() const;
+
+    // 进程常驻内存（字节），平台不支持时为 -1
+    qint64 residentBytes() const { return m_residentBytes; }
+    void sampleResidentBytes();
+
+    QByteArray toJson() const;
+    bool writeJson(const QString &filename, QString *error = nullptr) const;
+
+    // 容器与字符串的估算大小（包括对象本身）
+    static qint64 stringBytes(const QString &string);
+    template <typename T>
+    static qint64 vectorBytes(const QVector<T> &vector)
+    {
+        return sizeof(vector) + (vector.capacity() > 0 ? kArrayHeaderBytes + vector.capacity() * qint64(sizeof(T)) : 0);
+    }
+    template <typename K, typename V>
+    static qint64 hashBytes(const QHash<K, V> &hash)
+    {
+        // Qt 6 的 QHash 按 128 个槽位一段分配，每个槽位一个偏移字节，节点连续存放
+        const qint64 slots = hash.capacity();
+        return sizeof(hash) + (slots > 0 ? kArrayHeaderBytes + slots + slots * qint64(sizeof(K) + sizeof(V)) : 0);
+    }
+    template <typename K, typename V>
+    static qint64 mapBytes(const QMap<K, V> &map)
+    {
+        // Qt 6 的 QMap 基于 std::map，每个节点另有红黑树指针与颜色
+        return sizeof(map) + (map.isEmpty() ? 0 : kArrayHeaderBytes + map.size() * (kTreeNodeBytes + qint64(sizeof(K) + sizeof(V))));
+    }
+
+    static constexpr qint64 kArrayHeaderBytes = 16;  // QArrayData 头
+    static constexpr qint64 kTreeNodeBytes = 32;     // std::map 节点头
+    static constexpr qint64 kHeapChunkBytes = 16;    // 每次堆分配的分配器开销
+    static constexpr qint64 kObjectBytes = 160;      // QObject 及其私有数据
+    static constexpr qint64 kWidgetBytes = 720;      // QWidget 及其私有数据与额外数据
+
+private:
+    struct CategoryData {
+        QVector<Entry> entries;
+        QHash<QString, int> index;
+    };
+
+    CategoryData m_categories[CATEGORY_COUNT];
+    QSet<qint64> m_pixmapKeys;
+    qint64 m_residentBytes = -1;
+};
+
+#endif // MEMORYACCOUNTING_H
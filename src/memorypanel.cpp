@@ -0,0 +1,111 @@
+#include "memorypanel.h"
+#include <QVBoxLayout>
+#include <QHBoxLayout>
+#include <QHeaderView>
+#include <QFileDialog>
+#include <QMessageBox>
+#include <algorithm>
+
+MemoryPanel::MemoryPanel(QWidget *parent)
+    : QDockWidget("内存占用", parent)
+{
+    QWidget* content = new QWidget(this);
+    QVBoxLayout* layout = new QVBoxLayout(content);
+    layout->setContentsMargins(4, 4, 4, 4);
+
+    QHBoxLayout* buttonLayout = new QHBoxLayout;
+    QPushButton* refreshButton = new QPushButton("刷新", content);
+    m_exportButton = new QPushButton("导出 JSON...", content);
+    m_exportButton->setEnabled(false);
+    buttonLayout->addWidget(refreshButton);
+    buttonLayout->addWidget(m_exportButton);
+    buttonLayout->addStretch();
+    layout->addLayout(buttonLayout);
+
+    m_summary = new QLabel(content);
+    m_summary->setWordWrap(true);
+    layout->addWidget(m_summary);
+
+    m_tree = new QTreeWidget(content);
+    m_tree->setColumnCount(4);
+    m_tree->setHeaderLabels({"Category", "Objects", "Bytes", "Share"});
+    m_tree->header()->setSectionResizeMode(0, QHeaderView::Stretch);
+    m_tree->setRootIsDecorated(true);
+    layout->addWidget(m_tree, 1);
+
+    setWidget(content);
+
+    connect(refreshButton, &QPushButton::clicked, this, &MemoryPanel::refreshRequested);
+    connect(m_exportButton, &QPushButton::clicked, this, &MemoryPanel::exportJson);
+}
+
+QString MemoryPanel::formatBytes(qint64 bytes)
+{
+    const double value = qAbs(double(bytes));
+    if (value >= 1024.0 * 1024.0 * 1024.0) return QString::number(bytes / (1024.0 * 1024.0 * 1024.0), 'f', 2) + " GB";
+    if (value >= 1024.0 * 1024.0) return QString::number(bytes / (1024.0 * 1024.0), 'f', 1) + " MB";
+    if (value >= 1024.0) return QString::number(bytes / 1024.0, 'f', 1) + " KB";
+    return QString::number(bytes) + " B";
+}
+
+void MemoryPanel::setReport(const MemoryAccounting &report)
+{
+    m_report = report;
+    m_exportButton->setEnabled(true);
+
+    const qint64 accounted = m_report.totalBytes();
+    QString summary = QString("已统计 %1").arg(formatBytes(accounted));
+    if (m_report.residentBytes() >= 0) {
+        summary += QString("，进程常驻 %1，未归类 %2")
+                       .arg(formatBytes(m_report.residentBytes()), formatBytes(m_report.residentBytes() - accounted));
+    }
+    m_summary->setText(summary);
+
+    auto makeItem = [accounted](QTreeWidgetItem* parent, const MemoryAccounting::Entry &entry) {
+        QTreeWidgetItem* item = parent ? new QTreeWidgetItem(parent) : new QTreeWidgetItem;
+        item->setText(0, entry.name);
+        item->setText(1, QString::number(entry.count));
+        item->setText(2, formatBytes(entry.bytes));
+        item->setText(3, accounted > 0 ? QString::number(100.0 * entry.bytes / accounted, 'f', 1) + "%" : QString());
+        item->setToolTip(2, QString("%1 bytes").arg(entry.bytes));
+        for (int column = 1; column < 4; ++column) {
+            item->setTextAlignment(column, Qt::AlignRight | Qt::AlignVCenter);
+        }
+        return item;
+    };
+    auto byBytes = [](const MemoryAccounting::Entry &a, const MemoryAccounting::Entry &b) {
+        return a.bytes > b.bytes;
+    };
+
+    // 类别与明细均按字节数从大到小排列
+    QVector<QPair<MemoryAccounting::Entry, MemoryAccounting::Category>> categories;
+    for (int i = 0; i < MemoryAccounting::CATEGORY_COUNT; ++i) {
+        const auto category = MemoryAccounting::Category(i);
+        categories.append(qMakePair(m_report.total(category), category));
+    }
+    std::stable_sort(categories.begin(), categories.end(), [&byBytes](const auto &a, const auto &b) {
+        return byBytes(a.first, b.first);
+    });
+
+    m_tree->clear();
+    for (const auto &category : categories) {
+        QTreeWidgetItem* item = makeItem(nullptr, category.first);
+        QVector<MemoryAccounting::Entry> details = m_report.details(category.second);
+        std::stable_sort(details.begin(), details.end(), byBytes);
+        for (const auto &entry : details) {
+            makeItem(item, entry);
+        }
+        m_tree->addTopLevelItem(item);
+    }
+}
+
+void MemoryPanel::exportJson()
+{
+    const QString filename = QFileDialog::getSaveFileName(this, "导出内存占用", "memory.json", "JSON (*.json)");
+    if (filename.isEmpty()) return;
+
+    QString error;
+    if (!m_report.writeJson(filename, &error)) {
+        QMessageBox::warning(this, "导出失败", error);
+    }
+}
@@ -0,0 +1,36 @@
+#ifndef MEMORYPANEL_H
+#define MEMORYPANEL_H
+
+#include <QDockWidget>
+#include <QTreeWidget>
+#include <QLabel>
+#include <QPushButton>
+#include "memoryaccounting.h"
+
+// 内存占用面板：按类别显示对象数与估算字节数，展开可见明细，可导出为 JSON
+class MemoryPanel : public QDockWidget
+{
+    Q_OBJECT
+
+public:
+    explicit MemoryPanel(QWidget *parent = nullptr);
+
+    void setReport(const MemoryAccounting &report);
+
+signals:
+    // 请求重新统计，收到后调用 setReport
+    void refreshRequested();
+
+private slots:
+    void exportJson();
+
+private:
+    static QString formatBytes(qint64 bytes);
+
+    QLabel* m_summary;
+    QTreeWidget* m_tree;
+    QPushButton* m_exportButton;
+    MemoryAccounting m_report;
+};
+
+#endif // MEMORYPANEL_H
@@ -0,0 +1,148 @@
+#include "modulecomparedialog.h"
+#include "statkeyregistry.h"
+#include <QVBoxLayout>
+#include <QHeaderView>
+#include <QSet>
+#include <QtNumeric>
+#include <algorithm>
+
+namespace {
+
+// 按 UserRole 中的数值排序的表格项
+class NumericItem : public QTableWidgetItem
+{
+public:
+    NumericItem(const QString &text, double value)
+        : QTableWidgetItem(text)
+    {
+        setData(Qt::UserRole, value);
+        setTextAlignment(Qt::AlignRight | Qt::AlignVCenter);
+    }
+
+    bool operator<(const QTableWidgetItem &other) const override
+    {
+        return data(Qt::UserRole).toDouble() < other.data(Qt::UserRole).toDouble();
+    }
+};
+
+QString formatValue(double value)
+{
+    return qAbs(value) >= 1e6 ? QString::number(value, 'g', 4)
+                              : QString::number(value, 'f', value == qRound64(value) ? 0 : 4);
+}
+
+} // namespace
+
+ModuleCompareDialog::ModuleCompareDialog(const QVector<HardwareModule*> &modules, QWidget* parent)
+    : QDialog(parent)
+    , m_modules(modules)
+{
+    setWindowTitle(QString("Compare %1 Modules").arg(modules.size()));
+    resize(720, 480);
+
+    QVBoxLayout* layout = new QVBoxLayout(this);
+    m_filterEdit = new QLineEdit(this);
+    m_filterEdit->setPlaceholderText("Filter metrics");
+    m_filterEdit->setClearButtonEnabled(true);
+    layout->addWidget(m_filterEdit);
+
+    m_table = new QTableWidget(this);
+    m_table->verticalHeader()->setVisible(false);
+    m_table->setEditTriggers(QAbstractItemView::NoEditTriggers);
+    layout->addWidget(m_table);
+
+    m_refreshTimer.setSingleShot(true);
+    m_refreshTimer.setInterval(200);
+    connect(&m_refreshTimer, &QTimer::timeout, this, &ModuleCompareDialog::refresh);
+    for (auto module : m_modules) {
+        connect(module, &HardwareModule::statisticsChanged, this, [this]() {
+            if (!m_refreshTimer.isActive()) {
+                m_refreshTimer.start();
+            }
+        });
+    }
+    connect(m_filterEdit, &QLineEdit::textChanged, this, &ModuleCompareDialog::applyFilter);
+
+    refresh();
+}
+
+void ModuleCompareDialog::refresh()
+{
+    auto &registry = StatKeyRegistry::instance();
+    QSet<int> keySet;
+    for (auto module : m_modules) {
+        for (auto it = module->statisticValues().constBegin(); it != module->statisticValues().constEnd(); ++it) {
+            keySet.insert(it.key());
+        }
+    }
+    QVector<QPair<QString, int>> keys;
+    keys.reserve(keySet.size());
+    for (int keyId : keySet) {
+        keys.append(qMakePair(registry.name(keyId), keyId));
+    }
+    std::sort(keys.begin(), keys.end());
+
+    QStringList headers = {"Metric"};
+    for (auto module : m_modules) {
+        headers.append(module->name());
+    }
+    headers << "Min" << "Max" << "Spread %";
+
+    m_table->setSortingEnabled(false);
+    m_table->clear();
+    m_table->setColumnCount(headers.size());
+    m_table->setHorizontalHeaderLabels(headers);
+    m_table->setRowCount(keys.size());
+
+    const int statsColumn = m_modules.size() + 1;
+    for (int row = 0; row < keys.size(); ++row) {
+        m_table->setItem(row, 0, new QTableWidgetItem(keys[row].first));
+
+        double low = qInf();
+        double high = -qInf();
+        double sum = 0.0;
+        int count = 0;
+        int maxColumn = -1;
+        for (int i = 0; i < m_modules.size(); ++i) {
+            HardwareModule* module = m_modules[i];
+            if (!module->hasStatistic(keys[row].second)) {
+                m_table->setItem(row, i + 1, new NumericItem("-", -qInf()));
+                continue;
+            }
+            const double value = module->statistic(keys[row].second);
+            m_table->setItem(row, i + 1, new NumericItem(formatValue(value), value));
+            if (value > high) {
+                maxColumn = i + 1;
+            }
+            low = qMin(low, value);
+            high = qMax(high, value);
+            sum += value;
+            ++count;
+        }
+
+        // 离散度：(最大值 - 最小值) / 平均值
+        const double mean = count > 0 ? sum / count : 0.0;
+        const double spread = qAbs(mean) > 1e-12 ? (high - low) / qAbs(mean) * 100.0 : 0.0;
+        m_table->setItem(row, statsColumn, new NumericItem(formatValue(low), low));
+        m_table->setItem(row, statsColumn + 1, new NumericItem(formatValue(high), high));
+        m_table->setItem(row, statsColumn + 2, new NumericItem(QString::number(spread, 'f', 1), spread));
+        if (count > 1 && high > low && maxColumn > 0) {
+            QFont font = m_table->item(row, maxColumn)->font();
+            font.setBold(true);
+            m_table->item(row, maxColumn)->setFont(font);
+        }
+    }
+
+    m_table->setSortingEnabled(true);
+    m_table->resizeColumnsToContents();
+    applyFilter();
+}
+
+void ModuleCompareDialog::applyFilter()
+{
+    const QString filter = m_filterEdit->text().trimmed();
+    for (int row = 0; row < m_table->rowCount(); ++row) {
+        const QTableWidgetItem* item = m_table->item(row, 0);
+        m_table->setRowHidden(row, !filter.isEmpty() && !item->text().contains(filter, Qt::CaseInsensitive));
+    }
+}
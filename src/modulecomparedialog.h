@@ -0,0 +1,33 @@
+#ifndef MODULECOMPAREDIALOG_H
+#define MODULECOMPAREDIALOG_H
+
+#include <QDialog>
+#include <QTableWidget>
+#include <QLineEdit>
+#include <QTimer>
+#include <QVector>
+#include "hardwaremodule.h"
+
+// 多个模块的统计项并排比较：每行一个统计项，列为各模块的值、最小值、最大值与离散度，
+// 每行的最大值加粗；成员统计变化时合并刷新
+class ModuleCompareDialog : public QDialog
+{
+    Q_OBJECT
+
+public:
+    explicit ModuleCompareDialog(const QVector<HardwareModule*> &modules, QWidget* parent = nullptr);
+
+    bool containsModule(HardwareModule* module) const { return m_modules.contains(module); }
+
+private slots:
+    void refresh();
+    void applyFilter();
+
+private:
+    QVector<HardwareModule*> m_modules;
+    QLineEdit* m_filterEdit;
+    QTableWidget* m_table;
+    QTimer m_refreshTimer;
+};
+
+#endif // MODULECOMPAREDIALOG_H
@@ -0,0 +1,161 @@
+#include "modulegroups.h"
+#include <QMultiMap>
+#include <QtMath>
+
+ModuleGroups::ModuleGroups(QObject *parent)
+    : QObject(parent)
+{
+}
+
+void ModuleGroups::rebuild(const QList<HardwareModule*> &modules, const BusTopology &topology)
+{
+    clear();
+
+    // 按所在总线（插槽）收集核心与 NUCA 分片数
+    QHash<HardwareModule*, QMultiMap<int, HardwareModule*>> coresByBus;
+    QHash<HardwareModule*, int> nucaNumByBus;
+    QHash<HardwareModule*, int> l3CountByBus;
+    for (auto module : modules) {
+        HardwareModule* bus = topology.busOf(module);
+        if (module->type() == HardwareModule::CPU_CORE) {
+            coresByBus[bus].insert(topology.hardwareIndex(module), module);
+        } else if (module->type() == HardwareModule::CACHE_L3) {
+            nucaNumByBus[bus] = qMax(nucaNumByBus.value(bus), module->nucaNum());
+            ++l3CountByBus[bus];
+        }
+    }
+
+    // 核心按编号排序后均分到各个 NUCA 分片，L2 跟随同编号的核心
+    for (auto it = coresByBus.begin(); it != coresByBus.end(); ++it) {
+        HardwareModule* bus = it.key();
+        QString socketName = bus ? bus->name() : QString("Socket");
+        const auto &cores = it.value();
+
+        int slices = nucaNumByBus.value(bus) > 0 ? nucaNumByBus.value(bus) : l3CountByBus.value(bus);
+        int clusterSize = slices > 0 ? qMax(1, int((cores.size() + slices - 1) / slices)) : kDefaultClusterSize;
+
+        int position = 0;
+        for (auto core : cores) {
+            QString clusterName = core->clusterName().isEmpty()
+                ? QString("%1/Cluster%2").arg(socketName).arg(position / clusterSize)
+                : core->clusterName();
+            ++position;
+
+            addToGroup(CLUSTER, clusterName, core);
+            if (auto l2 = topology.moduleByIndex(HardwareModule::CACHE_L2, topology.hardwareIndex(core))) {
+                addToGroup(CLUSTER, clusterName, l2);
+            }
+        }
+    }
+
+    for (auto module : modules) {
+        switch (module->type()) {
+            case HardwareModule::CACHE_EVENT_TRACER:
+                continue;
+            case HardwareModule::CPU_CORE:
+            case HardwareModule::CACHE_L2:
+            case HardwareModule::CACHE_L3: {
+                HardwareModule* bus = topology.busOf(module);
+                addToGroup(SOCKET, bus ? bus->name() : QString("Socket"), module);
+                break;
+            }
+            default:
+                break;
+        }
+        addToGroup(CHIP, "Chip", module);
+    }
+
+    // 以当前统计值初始化累加值，之后只按差值更新
+    for (auto it = m_memberGroups.begin(); it != m_memberGroups.end(); ++it) {
+        HardwareModule* module = it.key();
+        const auto &values = module->statisticValues();
+        for (int level = CLUSTER; level < LEVEL_COUNT; ++level) {
+            int index = it.value()[level];
+            if (index < 0) continue;
+
+            Group &group = m_groups[level][index];
+            for (auto valueIt = values.begin(); valueIt != values.end(); ++valueIt) {
+                group.sums[valueIt.key()] += valueIt.value();
+            }
+        }
+        connect(module, &HardwareModule::statisticChanged, this, &ModuleGroups::onStatisticChanged);
+    }
+}
+
+void ModuleGroups::clear()
+{
+    for (auto it = m_memberGroups.begin(); it != m_memberGroups.end(); ++it) {
+        disconnect(it.key(), nullptr, this, nullptr);
+    }
+    m_memberGroups.clear();
+    for (int level = 0; level < LEVEL_COUNT; ++level) {
+        m_groups[level].clear();
+        m_groupIndex[level].clear();
+    }
+}
+
+int ModuleGroups::groupOf(HardwareModule* module, Level level) const
+{
+    auto it = m_memberGroups.constFind(module);
+    return it != m_memberGroups.constEnd() ? it.value()[level] : -1;
+}
+
+QString ModuleGroups::levelName(Level level)
+{
+    switch (level) {
+        case CLUSTER:
+            return "Cluster";
+        case SOCKET:
+            return "Socket";
+        case CHIP:
+            return "Chip";
+        default:
+            return "Module";
+    }
+}
+
+void ModuleGroups::onStatisticChanged(int keyId, double oldValue, double newValue)
+{
+    auto it = m_memberGroups.constFind(qobject_cast<HardwareModule*>(sender()));
+    if (it == m_memberGroups.constEnd()) return;
+
+    double delta = (qIsNaN(newValue) ? 0.0 : newValue) - (qIsNaN(oldValue) ? 0.0 : oldValue);
+    for (int level = CLUSTER; level < LEVEL_COUNT; ++level) {
+        int index = it.value()[level];
+        if (index < 0) continue;
+
+        m_groups[level][index].sums[keyId] += delta;
+        emit groupChanged(level, index);
+    }
+}
+
+int ModuleGroups::addToGroup(Level level, const QString &name, HardwareModule* module)
+{
+    int index;
+    auto indexIt = m_groupIndex[level].constFind(name);
+    if (indexIt == m_groupIndex[level].constEnd()) {
+        Group group;
+        group.level = level;
+        group.name = name;
+        index = m_groups[level].size();
+        m_groups[level].append(group);
+        m_groupIndex[level].insert(name, index);
+    } else {
+        index = indexIt.value();
+    }
+
+    Group &group = m_groups[level][index];
+    group.members.append(module);
+    if (module->type() == HardwareModule::CPU_CORE) {
+        ++group.coreCount;
+    }
+
+    auto memberIt = m_memberGroups.find(module);
+    if (memberIt == m_memberGroups.end()) {
+        std::array<int, LEVEL_COUNT> none;
+        none.fill(-1);
+        memberIt = m_memberGroups.insert(module, none);
+    }
+    (*memberIt)[level] = index;
+    return index;
+}
@@ -0,0 +1,67 @@
+#ifndef MODULEGROUPS_H
+#define MODULEGROUPS_H
+
+#include <QObject>
+#include <QString>
+#include <QVector>
+#include <QHash>
+#include <QList>
+#include <array>
+#include "hardwaremodule.h"
+#include "bustopology.h"
+
+// 模块分层分组（簇、插槽、芯片），用于缩小视图时的语义缩放；
+// 每个分组维护成员统计数据的累加值，成员统计项变化时按差值增量更新
+class ModuleGroups : public QObject
+{
+    Q_OBJECT
+
+public:
+    enum Level {
+        MODULE = 0,  // 不分组，逐个显示模块
+        CLUSTER,     // 处理器核心及其 L2 缓存
+        SOCKET,      // 同一总线上的核心、L2 与 L3 缓存
+        CHIP,        // 除缓存事件追踪器外的全部模块
+        LEVEL_COUNT
+    };
+
+    struct Group {
+        Level level = MODULE;
+        QString name;
+        QVector<HardwareModule*> members;
+        int coreCount = 0;
+        QHash<int, double> sums;  // 统计项ID -> 成员累加值
+    };
+
+    // 未能按 NUCA 分片推断时每个簇的核心数
+    static constexpr int kDefaultClusterSize = 8;
+
+    explicit ModuleGroups(QObject *parent = nullptr);
+
+    // 按模块集合与总线拓扑重建分组：簇优先使用配置的 cluster 字段，
+    // 否则按核心编号与所在总线上 L3 的 NUCA 分片数均分
+    void rebuild(const QList<HardwareModule*> &modules, const BusTopology &topology);
+    void clear();
+
+    const QVector<Group>& groups(Level level) const { return m_groups[level]; }
+    // 模块在指定层级所属分组的下标，不属于任何分组时为-1
+    int groupOf(HardwareModule* module, Level level) const;
+
+    static QString levelName(Level level);
+
+signals:
+    // 分组的累加统计值发生变化
+    void groupChanged(int level, int index);
+
+private slots:
+    void onStatisticChanged(int keyId, double oldValue, double newValue);
+
+private:
+    int addToGroup(Level level, const QString &name, HardwareModule* module);
+
+    QVector<Group> m_groups[LEVEL_COUNT];
+    QHash<QString, int> m_groupIndex[LEVEL_COUNT];
+    QHash<HardwareModule*, std::array<int, LEVEL_COUNT>> m_memberGroups;
+};
+
+#endif // MODULEGROUPS_H
@@ -2,15 +2,65 @@
 #include <QVBoxLayout>
 #include <QFont>
 #include <QGraphicsItem>
+#include <QGroupBox>
+#include <QFormLayout>
+#include <QHBoxLayout>
+#include <QPushButton>
 #include <QRegularExpression>
+#include <QFileDialog>
+#include <QFileInfo>
+#include <QMessageBox>
+#include <QThread>
+#include <QtNumeric>
+#include <algorithm>
+#include "statkeyregistry.h"
+#include "addresstrace.h"
+#include "bottleneckanalyzer.h"
+#include "setheatmap.h"
+#include "workstealingpool.h"
 
-ModuleInfoDialog::ModuleInfoDialog(HardwareModule* module, const QMap<HardwareModule*, QGraphicsItem*>& moduleItems, QWidget* parent)
+ModuleInfoDialog::ModuleInfoDialog(HardwareModule* module, const BusTopology& topology,
+                                   const QVector<HardwareModule*>& peers, LatencyModel* latencyModel,
+                                   QWidget* parent)
     : QDialog(parent)
     , m_module(module)
-    , m_moduleItems(moduleItems)
+    , m_topology(topology)
+    , m_peers(peers)
+    , m_distributionCombo(nullptr)
+    , m_distributionChart(nullptr)
+    , m_latencyModel(latencyModel)
+    , m_edgeEdit(nullptr)
+    , m_predictionLabel(nullptr)
+    , m_lineSizeSpin(nullptr)
+    , m_traceButton(nullptr)
+    , m_levelCombo(nullptr)
+    , m_metricCombo(nullptr)
+    , m_traceLabel(nullptr)
+    , m_setHeatmap(nullptr)
+    , m_traceThread(nullptr)
+    , m_traced(0)
+    , m_cancel(false)
 {
     setupUI();
     updateModuleInfo();
+
+    // 重新加载配置时原地更新的模块刷新显示
+    connect(m_module, &HardwareModule::configChanged, this, &ModuleInfoDialog::updateModuleInfo);
+}
+
+ModuleInfoDialog::~ModuleInfoDialog()
+{
+    if (m_traceThread) {
+        m_cancel = true;
+        m_traceThread->wait();
+        delete m_traceThread;
+    }
+}
+
+bool ModuleInfoDialog::releaseModule(HardwareModule* module)
+{
+    m_peers.removeAll(module);
+    return module == m_module;
 }
 
 void ModuleInfoDialog::setupUI()
@@ -25,6 +75,333 @@ void ModuleInfoDialog::setupUI()
     m_textBrowser->setFont(QFont("Consolas", 10));
     
     layout->addWidget(m_textBrowser);
+
+    setupWhatIf(layout);
+    setupSetConflicts(layout);
+
+    if (m_module->histograms().isEmpty()) return;
+
+    // 分布图：按名称排序列出直方图统计项
+    QList<int> keys = m_module->histograms().keys();
+    std::sort(keys.begin(), keys.end(), [](int a, int b) {
+        return StatKeyRegistry::instance().name(a) < StatKeyRegistry::instance().name(b);
+    });
+    m_distributionCombo = new QComboBox(this);
+    for (int keyId : keys) {
+        m_distributionCombo->addItem(StatKeyRegistry::instance().name(keyId), keyId);
+    }
+    m_distributionChart = new HistogramChart(this);
+    layout->addWidget(m_distributionCombo);
+    layout->addWidget(m_distributionChart);
+    setMinimumSize(480, 560);
+
+    connect(m_distributionCombo, QOverload<int>::of(&QComboBox::currentIndexChanged), this, [this]() {
+        showDistribution(m_distributionCombo->currentData().toInt());
+    });
+    showDistribution(m_distributionCombo->currentData().toInt());
+}
+
+void ModuleInfoDialog::setupWhatIf(QVBoxLayout* layout)
+{
+    if (!m_latencyModel || m_latencyModel->nodesOf(m_module).isEmpty()) return;
+
+    QGroupBox* group = new QGroupBox("What-if Parameters", this);
+    QVBoxLayout* groupLayout = new QVBoxLayout(group);
+    QFormLayout* form = new QFormLayout;
+    groupLayout->addLayout(form);
+
+    auto addParameter = [&](LatencyModel::Parameter parameter, const QString &label, int minimum, int maximum) {
+        QSpinBox* edit = new QSpinBox(group);
+        edit->setRange(minimum, maximum);
+        edit->setValue(m_latencyModel->parameter(m_module, parameter));
+        form->addRow(label, edit);
+        m_parameterEdits.insert(parameter, edit);
+        connect(edit, QOverload<int>::of(&QSpinBox::valueChanged), this, [this, parameter](int value) {
+            m_latencyModel->setParameter(m_module, parameter, value);
+        });
+    };
+
+    if (m_module->type() == HardwareModule::CACHE_L2 || m_module->type() == HardwareModule::CACHE_L3) {
+        addParameter(LatencyModel::MSHR_COUNT, "MSHR Count:", 1, 1024);
+        addParameter(LatencyModel::INDEX_WIDTH, "Index Width:", 1, 64);
+        addParameter(LatencyModel::INDEX_LATENCY, "Index Latency (cycles):", 0, 1000);
+    } else if (m_module->type() == HardwareModule::MEMORY_CTRL) {
+        addParameter(LatencyModel::DATA_WIDTH, "Data Width (bits):", 1, 4096);
+    } else if (m_module->type() == HardwareModule::BUS) {
+        // 每行一条有向边，格式与 setup 文件相同：“源节点 to 目的节点”
+        m_edgeEdit = new QPlainTextEdit(group);
+        m_edgeEdit->setFont(QFont("Consolas", 10));
+        m_edgeEdit->setMaximumHeight(120);
+        QPushButton* applyButton = new QPushButton("Apply Edges", group);
+        form->addRow("Edges (a to b):", m_edgeEdit);
+        form->addRow(QString(), applyButton);
+        connect(applyButton, &QPushButton::clicked, this, &ModuleInfoDialog::applyBusEdges);
+    }
+
+    m_predictionLabel = new QLabel(group);
+    m_predictionLabel->setTextFormat(Qt::RichText);
+    m_predictionLabel->setWordWrap(true);
+    groupLayout->addWidget(m_predictionLabel);
+
+    // 处理器核心只显示预测值
+    if (!m_parameterEdits.isEmpty() || m_edgeEdit) {
+        QPushButton* resetButton = new QPushButton("Reset", group);
+        QHBoxLayout* buttonLayout = new QHBoxLayout;
+        buttonLayout->addStretch();
+        buttonLayout->addWidget(resetButton);
+        groupLayout->addLayout(buttonLayout);
+        connect(resetButton, &QPushButton::clicked, this, [this]() {
+            m_latencyModel->resetParameters(m_module);
+        });
+    }
+
+    layout->addWidget(group);
+    connect(m_latencyModel, &LatencyModel::changed, this, &ModuleInfoDialog::updateWhatIf);
+    updateWhatIf();
+}
+
+void ModuleInfoDialog::updateWhatIf()
+{
+    for (auto it = m_parameterEdits.constBegin(); it != m_parameterEdits.constEnd(); ++it) {
+        QSignalBlocker blocker(it.value());
+        it.value()->setValue(m_latencyModel->parameter(m_module, LatencyModel::Parameter(it.key())));
+    }
+    if (m_edgeEdit && !m_edgeEdit->hasFocus()) {
+        QStringList lines;
+        for (const auto &edge : m_latencyModel->busEdges(m_module)) {
+            lines.append(QString("%1 to %2").arg(edge.first).arg(edge.second));
+        }
+        m_edgeEdit->setPlainText(lines.join("\n"));
+    }
+
+    auto format = [](double value) {
+        return qIsFinite(value) ? QString::number(value, 'f', 2) : QString("saturated");
+    };
+    QString text = "<table border='0' cellspacing='3'>"
+                   "<tr><th align='left'>Metric</th><th>Baseline</th><th>Predicted</th></tr>";
+    QVector<int> indices = m_latencyModel->nodesOf(m_module);
+    if (m_latencyModel->systemNode() >= 0) {
+        indices.append(m_latencyModel->systemNode());
+    }
+    for (int index : indices) {
+        const LatencyModel::Node &node = m_latencyModel->nodes()[index];
+        const bool changed = node.predicted != node.baseline;
+        text += QString("<tr><td><b>%1</b></td><td>%2</td><td>%3%4%5</td></tr>")
+                    .arg(LatencyModel::kindName(node.kind))
+                    .arg(format(node.baseline))
+                    .arg(changed ? "<b>" : "")
+                    .arg(format(node.predicted))
+                    .arg(changed ? "</b>" : "");
+    }
+    text += "</table>";
+    m_predictionLabel->setText(text);
+}
+
+void ModuleInfoDialog::applyBusEdges()
+{
+    static const QRegularExpression edgePattern("^\\s*(\\d+)\\s+to\\s+(\\d+)\\s*$");
+
+    QVector<QPair<int, int>> edges;
+    const QStringList lines = m_edgeEdit->toPlainText().split('\n');
+    for (int i = 0; i < lines.size(); ++i) {
+        if (lines[i].trimmed().isEmpty()) continue;
+        QRegularExpressionMatch match = edgePattern.match(lines[i]);
+        if (!match.hasMatch()) {
+            m_predictionLabel->setText(QString("<span style='color:red'>Line %1: expected \"a to b\"</span>").arg(i + 1));
+            return;
+        }
+        edges.append(qMakePair(match.captured(1).toInt(), match.captured(2).toInt()));
+    }
+    m_edgeEdit->clearFocus();
+    m_latencyModel->setBusEdges(m_module, edges);
+    updateWhatIf();
+}
+
+void ModuleInfoDialog::setupSetConflicts(QVBoxLayout* layout)
+{
+    if (m_module->type() != HardwareModule::CACHE_L2 && m_module->type() != HardwareModule::CACHE_L3) return;
+
+    QGroupBox* group = new QGroupBox("Set Conflicts", this);
+    QVBoxLayout* groupLayout = new QVBoxLayout(group);
+    QHBoxLayout* controls = new QHBoxLayout;
+    groupLayout->addLayout(controls);
+
+    m_lineSizeSpin = new QSpinBox(group);
+    m_lineSizeSpin->setRange(16, 4096);
+    m_lineSizeSpin->setSuffix(" B");
+    m_lineSizeSpin->setValue(BottleneckAnalyzer::kCacheLineBytes);
+    m_levelCombo = new QComboBox(group);
+    m_metricCombo = new QComboBox(group);
+    m_metricCombo->addItem("Conflicts", SetHeatmap::CONFLICTS);
+    m_metricCombo->addItem("Misses", SetHeatmap::MISSES);
+    m_metricCombo->addItem("Accesses", SetHeatmap::ACCESSES);
+    m_traceButton = new QPushButton("Load Address Trace...", group);
+    controls->addWidget(new QLabel("Line Size:", group));
+    controls->addWidget(m_lineSizeSpin);
+    controls->addWidget(m_levelCombo);
+    controls->addWidget(m_metricCombo);
+    controls->addStretch();
+    controls->addWidget(m_traceButton);
+
+    m_traceLabel = new QLabel(group);
+    m_traceLabel->setWordWrap(true);
+    m_setHeatmap = new SetHeatmap(group);
+    groupLayout->addWidget(m_traceLabel);
+    groupLayout->addWidget(m_setHeatmap);
+    layout->addWidget(group);
+
+    m_progressTimer.setInterval(200);
+    connect(&m_progressTimer, &QTimer::timeout, this, [this]() {
+        m_traceLabel->setText(QString("Replaying %1: %2 accesses")
+                                  .arg(QFileInfo(m_traceFile).fileName())
+                                  .arg(m_traced.load()));
+    });
+    connect(m_traceButton, &QPushButton::clicked, this, &ModuleInfoDialog::loadAddressTrace);
+    connect(m_levelCombo, QOverload<int>::of(&QComboBox::currentIndexChanged), this, &ModuleInfoDialog::showSetConflicts);
+    connect(m_metricCombo, QOverload<int>::of(&QComboBox::currentIndexChanged), this, [this]() {
+        m_setHeatmap->setMetric(SetHeatmap::Metric(m_metricCombo->currentData().toInt()));
+    });
+}
+
+QVector<SetConflictProfiler::Level> ModuleInfoDialog::setConflictLevels() const
+{
+    auto makeLevel = [](const QString &name, const HardwareModule::CacheConfig &config) {
+        SetConflictProfiler::Level level;
+        level.name = name;
+        level.setCount = config.setCount;
+        level.wayCount = config.wayCount;
+        return level;
+    };
+
+    QVector<SetConflictProfiler::Level> levels;
+    if (m_module->type() == HardwareModule::CACHE_L2) {
+        // 取指进入 L1I，读写进入 L1D，两者的未命中合并进入 L2
+        SetConflictProfiler::Level l1i = makeLevel("L1I", m_module->l1iConfig());
+        l1i.kinds = quint8(1 << AddressTrace::FETCH);
+        SetConflictProfiler::Level l1d = makeLevel("L1D", m_module->l1dConfig());
+        l1d.kinds = quint8((1 << AddressTrace::READ) | (1 << AddressTrace::WRITE));
+        SetConflictProfiler::Level l2 = makeLevel("L2", m_module->l2Config());
+        l2.sources = {0, 1};
+        levels = {l1i, l1d, l2};
+    } else {
+        levels.append(makeLevel("L3", m_module->l3Config()));
+    }
+    return levels;
+}
+
+void ModuleInfoDialog::loadAddressTrace()
+{
+    if (m_traceThread) return;
+
+    const QVector<SetConflictProfiler::Level> levels = setConflictLevels();
+    bool hasGeometry = false;
+    for (const auto &level : levels) {
+        hasGeometry = hasGeometry || (level.setCount > 0 && level.wayCount > 0);
+    }
+    if (!hasGeometry) {
+        QMessageBox::warning(this, "Error", "The cache configuration has no set or way count.");
+        return;
+    }
+
+    const QString filename = QFileDialog::getOpenFileName(this, "Open Address Trace", QString(),
+                                                          "Address Traces (*.txt *.trace *.bin);;All Files (*)");
+    if (filename.isEmpty()) return;
+
+    // 整个轨迹在工作线程中流式回放，组下标提取与各组的 LRU 模拟再分到回放专用的线程池
+    m_traceFile = filename;
+    m_traceError.clear();
+    m_traced = 0;
+    m_cancel = false;
+    m_traceButton->setEnabled(false);
+    m_lineSizeSpin->setEnabled(false);
+
+    if (!m_pool) {
+        m_pool = std::make_unique<WorkStealingPool>();
+    }
+    const int lineBytes = m_lineSizeSpin->value();
+    m_traceThread = QThread::create([this, filename, levels, lineBytes]() {
+        AddressTrace trace;
+        if (!trace.open(filename, &m_traceError)) return;
+        SetConflictProfiler profiler(levels, lineBytes);
+        if (profiler.run(trace, *m_pool, &m_traced, &m_cancel, &m_traceError)) {
+            m_setResults = profiler.results();
+        }
+    });
+    connect(m_traceThread, &QThread::finished, this, &ModuleInfoDialog::onTraceFinished);
+    m_traceThread->start();
+    m_progressTimer.start();
+}
+
+void ModuleInfoDialog::onTraceFinished()
+{
+    m_progressTimer.stop();
+    m_traceThread->wait();
+    delete m_traceThread;
+    m_traceThread = nullptr;
+    m_traceButton->setEnabled(true);
+    m_lineSizeSpin->setEnabled(true);
+
+    if (!m_traceError.isEmpty()) {
+        m_traceLabel->clear();
+        QMessageBox::warning(this, "Error", m_traceError);
+        return;
+    }
+
+    // 只列出有几何配置的级别，默认选中最后一级（本模块自身的缓存）
+    QSignalBlocker blocker(m_levelCombo);
+    m_levelCombo->clear();
+    for (int i = 0; i < m_setResults.size(); ++i) {
+        if (m_setResults[i].setCount > 0) {
+            m_levelCombo->addItem(m_setResults[i].name, i);
+        }
+    }
+    m_levelCombo->setCurrentIndex(m_levelCombo->count() - 1);
+    showSetConflicts();
+}
+
+void ModuleInfoDialog::showSetConflicts()
+{
+    const int index = m_levelCombo->currentData().toInt();
+    if (m_levelCombo->currentIndex() < 0 || index >= m_setResults.size()) {
+        m_setHeatmap->setResult(SetConflictProfiler::Result());
+        return;
+    }
+
+    const SetConflictProfiler::Result &result = m_setResults[index];
+    auto percent = [](quint64 part, quint64 total) {
+        return total > 0 ? 100.0 * double(part) / double(total) : 0.0;
+    };
+    m_traceLabel->setText(QString("%1: %2 accesses, %3 B lines; %4: %5 accesses, "
+                                  "miss rate %6%, %7 conflicts (%8% of misses)")
+                              .arg(QFileInfo(m_traceFile).fileName())
+                              .arg(m_traced.load())
+                              .arg(m_lineSizeSpin->value())
+                              .arg(result.name)
+                              .arg(result.totalAccesses)
+                              .arg(percent(result.totalMisses, result.totalAccesses), 0, 'f', 2)
+                              .arg(result.totalConflicts)
+                              .arg(percent(result.totalConflicts, result.totalMisses), 0, 'f', 1));
+    m_setHeatmap->setResult(result);
+}
+
+void ModuleInfoDialog::showDistribution(int keyId)
+{
+    const StatisticHistogram* histogram = m_module->histogram(keyId);
+    if (!histogram) return;
+
+    StatisticHistogram reference;
+    int peerCount = 0;
+    for (HardwareModule* peer : m_peers) {
+        if (peer == m_module) continue;
+        if (const StatisticHistogram* other = peer->histogram(keyId)) {
+            reference.merge(*other);
+            ++peerCount;
+        }
+    }
+
+    m_distributionChart->setHistogram(*histogram, m_module->name());
+    m_distributionChart->setReference(reference, QString("%1 other %2").arg(peerCount)
+                                                      .arg(getModuleTypeName(m_module->type())));
 }
 
 void ModuleInfoDialog::updateModuleInfo()
@@ -113,6 +490,8 @@ void ModuleInfoDialog::updateModuleInfo()
         info += "</ul>";
     }
     
+    info += getDistributionInfo();
+
     info += "<h3>Connection Information</h3>";
     info += getConnectionInfo();
     
@@ -130,6 +509,34 @@ QString ModuleInfoDialog::formatStatistic(const QString& key, double value) cons
     }
 }
 
+QString ModuleInfoDialog::getDistributionInfo() const
+{
+    const auto& histograms = m_module->histograms();
+    if (histograms.isEmpty()) return QString();
+
+    QList<int> keys = histograms.keys();
+    std::sort(keys.begin(), keys.end(), [](int a, int b) {
+        return StatKeyRegistry::instance().name(a) < StatKeyRegistry::instance().name(b);
+    });
+
+    QString info = "<h3>Distributions</h3>";
+    info += "<table border='0' cellspacing='3'>";
+    info += "<tr><th align='left'>Statistic</th><th>Count</th><th>Mean</th><th>p50</th><th>p99</th><th>p999</th><th>Max</th></tr>";
+    for (int keyId : keys) {
+        const StatisticHistogram& histogram = histograms.value(keyId);
+        info += QString("<tr><td><b>%1</b></td><td>%2</td><td>%3</td><td>%4</td><td>%5</td><td>%6</td><td>%7</td></tr>")
+                    .arg(StatKeyRegistry::instance().name(keyId))
+                    .arg(histogram.count())
+                    .arg(histogram.mean(), 0, 'f', 2)
+                    .arg(histogram.percentile(50), 0, 'f', 1)
+                    .arg(histogram.percentile(99), 0, 'f', 1)
+                    .arg(histogram.percentile(99.9), 0, 'f', 1)
+                    .arg(histogram.max(), 0, 'f', 1);
+    }
+    info += "</table>";
+    return info;
+}
+
 QString ModuleInfoDialog::getModuleTypeName(HardwareModule::ModuleType type) const
 {
     switch (type) {
@@ -155,23 +562,35 @@ QString ModuleInfoDialog::getModuleTypeName(HardwareModule::ModuleType type) con
 QString ModuleInfoDialog::getConnectionInfo() const
 {
     QString info;
-    bool hasConnections = false;
 
-    HardwareModule* busModule = nullptr;
-    for (auto it = m_moduleItems.begin(); it != m_moduleItems.end(); ++it) {
-        if (it.key()->type() == HardwareModule::BUS) {
-            busModule = it.key();
-            break;
-        }
+    if (m_topology.buses().isEmpty()) {
+        return "<p>No bus module found in the system</p>";
     }
 
-    if (!busModule) {
-        return "<p>No bus module found in the system</p>";
+    if (m_module->type() == HardwareModule::BUS) {
+        QVector<HardwareModule*> attached = m_topology.modulesOnBus(m_module);
+        if (attached.isEmpty()) {
+            return "<p>No modules attached to this bus</p>";
+        }
+        info += "<p><b>Attached Modules:</b></p><ul>";
+        for (auto module : attached) {
+            if (module->portId() >= 0) {
+                info += QString("<li>Port %1: %2</li>").arg(module->portId()).arg(module->name());
+            } else {
+                info += QString("<li>%1</li>").arg(module->name());
+            }
+        }
+        info += "</ul>";
+        return info;
     }
 
+    HardwareModule* busModule = m_topology.busOf(m_module);
     int currentModulePort = m_module->portId();
 
     info += QString("<p><b>Module Port ID:</b> %1</p>").arg(currentModulePort);
+    if (busModule) {
+        info += QString("<p><b>Bus:</b> %1</p>").arg(busModule->name());
+    }
 
     if (currentModulePort == -1) {
         if (m_module->type() == HardwareModule::CPU_CORE || m_module->type() == HardwareModule::CACHE_EVENT_TRACER || m_module->type() == HardwareModule::DMA) {
@@ -181,48 +600,30 @@ QString ModuleInfoDialog::getConnectionInfo() const
         }
     }
 
-    const auto& stats = busModule->statistics();
-    
-    for (auto it = stats.begin(); it != stats.end(); ++it) {
-        QString key = it.key();
-        
-        if (key.startsWith("transmit_package_number_from_")) {
-            QRegularExpression txRe("transmit_package_number_from_(\\d+)_to_(\\d+)");
-            QRegularExpressionMatch txMatch = txRe.match(key);
-            
-            if (txMatch.hasMatch()) {
-                int fromPort = txMatch.captured(1).toInt();
-                int toPort = txMatch.captured(2).toInt();
-                int packages = it.value();
-                
-                if (fromPort == currentModulePort || toPort == currentModulePort) {
-                    hasConnections = true;
-                    
-                    bool isOutgoing = (fromPort == currentModulePort);
-                    int otherPort = isOutgoing ? toPort : fromPort;
-                    QString direction = isOutgoing ? "to" : "from";
-                    
-                    QString otherModuleName = "Unknown";
-                    for (auto moduleIt = m_moduleItems.begin(); moduleIt != m_moduleItems.end(); ++moduleIt) {
-                        HardwareModule* module = moduleIt.key();
-                        if(module->portId() == otherPort){
-                            otherModuleName = module->name();
-                            break;
-                        }
-                    }
-                    
-                    info += QString("<p>Connection %1 <b>%2</b> (Packages: %3)</p>")
-                        .arg(direction)
-                        .arg(otherModuleName)
-                        .arg(packages);
-                }
-            }
-        }
+    if (!busModule) {
+        return info + "<p>This module is not attached to any bus</p>";
     }
 
-    if (!hasConnections) {
+    auto appendConnections = [&](const BusTopology::PortTraffic &traffic, const QString &direction) {
+        const QHash<int, double> peers = traffic.value(currentModulePort);
+        QList<int> ports = peers.keys();
+        std::sort(ports.begin(), ports.end());
+        for (int otherPort : ports) {
+            HardwareModule* other = m_topology.moduleAtPort(busModule, otherPort);
+            info += QString("<p>Connection %1 <b>%2</b> (Packages: %3)</p>")
+                .arg(direction)
+                .arg(other ? other->name() : QString("Unknown"))
+                .arg(qint64(peers.value(otherPort)));
+        }
+        return !ports.isEmpty();
+    };
+
+    bool hasOutgoing = appendConnections(m_topology.outgoingTraffic(busModule), "to");
+    bool hasIncoming = appendConnections(m_topology.incomingTraffic(busModule), "from");
+
+    if (!hasOutgoing && !hasIncoming) {
         info += "<p>No direct connections found</p>";
     }
 
     return info;
-} 
\ No newline at end of file
+}
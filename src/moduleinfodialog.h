@@ -6,14 +6,37 @@
 #include <QVBoxLayout>
 #include <QTextBrowser>
 #include <QGraphicsItem>
+#include <QComboBox>
+#include <QHash>
+#include <QSpinBox>
+#include <QPlainTextEdit>
+#include <QPushButton>
+#include <QTimer>
+#include <atomic>
+#include <memory>
 #include "hardwaremodule.h"
+#include "bustopology.h"
+#include "histogramchart.h"
+#include "latencymodel.h"
+#include "setconflictprofiler.h"
+
+class QThread;
+class SetHeatmap;
+class WorkStealingPool;
 
 class ModuleInfoDialog : public QDialog
 {
     Q_OBJECT
 
 public:
-    explicit ModuleInfoDialog(HardwareModule* module, const QMap<HardwareModule*, QGraphicsItem*>& moduleItems, QWidget* parent = nullptr);
+    // peers 为同类模块（如其它 L3 分片），用于合并出参照分布；latencyModel 非空时可编辑 What-if 参数
+    explicit ModuleInfoDialog(HardwareModule* module, const BusTopology& topology,
+                              const QVector<HardwareModule*>& peers = {}, LatencyModel* latencyModel = nullptr,
+                              QWidget* parent = nullptr);
+    ~ModuleInfoDialog();
+
+    // 模块即将被删除：从参照模块中移除，是本对话框的模块时返回 true
+    bool releaseModule(HardwareModule* module);
 
 private:
     void setupUI();
@@ -21,10 +44,46 @@ private:
     QString formatStatistic(const QString& key, double value) const;
     QString getModuleTypeName(HardwareModule::ModuleType type) const;
     QString getConnectionInfo() const;
+    QString getDistributionInfo() const;
+    // 显示选中的直方图统计项，并叠加其它同类模块合并后的分布
+    void showDistribution(int keyId);
+    // What-if 参数编辑区（缓存、内存节点与总线）
+    void setupWhatIf(QVBoxLayout* layout);
+    // 按延迟模型的当前参数刷新编辑控件与本模块的预测指标
+    void updateWhatIf();
+    void applyBusEdges();
+    // 组冲突热力图（L2 模块含 L1I/L1D/L2，L3 模块为 L3），地址轨迹在工作线程中回放
+    void setupSetConflicts(QVBoxLayout* layout);
+    QVector<SetConflictProfiler::Level> setConflictLevels() const;
+    void loadAddressTrace();
+    void onTraceFinished();
+    void showSetConflicts();
 
     HardwareModule* m_module;
-    const QMap<HardwareModule*, QGraphicsItem*>& m_moduleItems;
+    const BusTopology& m_topology;
+    QVector<HardwareModule*> m_peers;
     QTextBrowser* m_textBrowser;
+    QComboBox* m_distributionCombo;
+    HistogramChart* m_distributionChart;
+    LatencyModel* m_latencyModel;
+    QHash<int, QSpinBox*> m_parameterEdits;  // LatencyModel::Parameter -> 编辑框
+    QPlainTextEdit* m_edgeEdit;
+    QLabel* m_predictionLabel;
+
+    QSpinBox* m_lineSizeSpin;
+    QPushButton* m_traceButton;
+    QComboBox* m_levelCombo;
+    QComboBox* m_metricCombo;
+    QLabel* m_traceLabel;
+    SetHeatmap* m_setHeatmap;
+    QThread* m_traceThread;
+    QTimer m_progressTimer;
+    std::atomic<qint64> m_traced;
+    std::atomic<bool> m_cancel;
+    QString m_traceFile;
+    QString m_traceError;
+    QVector<SetConflictProfiler::Result> m_setResults;
+    std::unique_ptr<WorkStealingPool> m_pool;  // 轨迹回放专用，不占用界面共用的线程池
 };
 
 #endif // MODULEINFODIALOG_H 
\ No newline at end of file
@@ -0,0 +1,291 @@
+#include "modulesearchindex.h"
+#include "statkeyregistry.h"
+#include <QRegularExpression>
+#include <QtNumeric>
+#include <algorithm>
+#include <queue>
+#include <vector>
+
+namespace {
+
+template <typename Iter>
+struct Cursor {
+    Iter it;
+    Iter end;
+    int keyId;
+};
+
+// 多路归并多个有序统计索引，只取前 k 个元素
+template <typename Iter, typename Before>
+QVector<ModuleSearchIndex::Hit> mergeCursors(const QVector<Cursor<Iter>> &cursors, int k, Before before)
+{
+    auto lowerPriority = [&before](const Cursor<Iter> &a, const Cursor<Iter> &b) {
+        return before(b.it->value, a.it->value);
+    };
+    std::priority_queue<Cursor<Iter>, std::vector<Cursor<Iter>>, decltype(lowerPriority)> heap(lowerPriority);
+    for (const auto &cursor : cursors) {
+        if (cursor.it != cursor.end) {
+            heap.push(cursor);
+        }
+    }
+
+    QVector<ModuleSearchIndex::Hit> hits;
+    while (!heap.empty() && hits.size() < k) {
+        Cursor<Iter> cursor = heap.top();
+        heap.pop();
+        hits.append({cursor.it->module, cursor.keyId, cursor.it->value});
+        if (++cursor.it != cursor.end) {
+            heap.push(cursor);
+        }
+    }
+    return hits;
+}
+
+// 子序列模糊匹配，返回字符间隔总和（越小越好），不匹配时返回-1
+int fuzzyScore(const QString &name, const QString &pattern)
+{
+    int score = 0;
+    int pos = 0;
+    for (QChar c : pattern) {
+        int found = name.indexOf(c, pos);
+        if (found < 0) {
+            return -1;
+        }
+        score += found - pos;
+        pos = found + 1;
+    }
+    return score;
+}
+
+QString stripQuotes(QString text)
+{
+    return text.remove('`').trimmed();
+}
+
+} // namespace
+
+ModuleSearchIndex::ModuleSearchIndex(QObject *parent)
+    : QObject(parent)
+{
+}
+
+void ModuleSearchIndex::addModule(HardwareModule* module)
+{
+    if (!module) return;
+
+    QPair<QString, HardwareModule*> nameEntry(module->name().toLower(), module);
+    auto pos = std::lower_bound(m_sortedNames.begin(), m_sortedNames.end(), nameEntry);
+    if (pos != m_sortedNames.end() && pos->second == module) return;
+    m_sortedNames.insert(pos, nameEntry);
+
+    const auto &values = module->statisticValues();
+    for (auto it = values.begin(); it != values.end(); ++it) {
+        insertEntry(it.key(), module, it.value());
+    }
+
+    connect(module, &HardwareModule::statisticChanged,
+            this, &ModuleSearchIndex::onStatisticChanged);
+}
+
+void ModuleSearchIndex::removeModule(HardwareModule* module)
+{
+    if (!module) return;
+
+    disconnect(module, nullptr, this, nullptr);
+
+    QPair<QString, HardwareModule*> nameEntry(module->name().toLower(), module);
+    auto pos = std::lower_bound(m_sortedNames.begin(), m_sortedNames.end(), nameEntry);
+    if (pos != m_sortedNames.end() && pos->second == module) {
+        m_sortedNames.erase(pos);
+    }
+
+    const auto &values = module->statisticValues();
+    for (auto it = values.begin(); it != values.end(); ++it) {
+        eraseEntry(it.key(), module, it.value());
+    }
+}
+
+void ModuleSearchIndex::clear()
+{
+    for (const auto &entry : m_sortedNames) {
+        disconnect(entry.second, nullptr, this, nullptr);
+    }
+    m_sortedNames.clear();
+    m_keyIndex.clear();
+}
+
+QVector<ModuleSearchIndex::Hit> ModuleSearchIndex::query(const QString &text, int limit) const
+{
+    static const QRegularExpression topRe(
+        "^\\s*(top|bottom)\\s+(\\d+)\\s+(.+)$",
+        QRegularExpression::CaseInsensitiveOption);
+    static const QRegularExpression compareRe(
+        "^\\s*(?:modules\\s+where\\s+)?(.+?)\\s*(>=|<=|==|>|<|=)\\s*([-+]?[0-9]*\\.?[0-9]+(?:[eE][-+]?[0-9]+)?)\\s*$",
+        QRegularExpression::CaseInsensitiveOption);
+
+    auto topMatch = topRe.match(text);
+    if (topMatch.hasMatch()) {
+        bool largest = topMatch.captured(1).compare("top", Qt::CaseInsensitive) == 0;
+        // 查询中显式给出的 N 优先于默认条数
+        return topK(stripQuotes(topMatch.captured(3)), topMatch.captured(2).toInt(), largest);
+    }
+
+    auto compareMatch = compareRe.match(text);
+    if (compareMatch.hasMatch()) {
+        QString op = compareMatch.captured(2);
+        Compare compare = Equal;
+        if (op == ">") compare = Greater;
+        else if (op == ">=") compare = GreaterEqual;
+        else if (op == "<") compare = Less;
+        else if (op == "<=") compare = LessEqual;
+        return filter(stripQuotes(compareMatch.captured(1)), compare,
+                      compareMatch.captured(3).toDouble(), limit);
+    }
+
+    return matchNames(text.trimmed(), limit);
+}
+
+QVector<ModuleSearchIndex::Hit> ModuleSearchIndex::matchNames(const QString &text, int limit) const
+{
+    QVector<Hit> hits;
+    QString pattern = text.toLower();
+    if (pattern.isEmpty()) return hits;
+
+    auto it = std::lower_bound(m_sortedNames.begin(), m_sortedNames.end(), pattern,
+                               [](const QPair<QString, HardwareModule*> &entry, const QString &value) {
+                                   return entry.first < value;
+                               });
+    for (; it != m_sortedNames.end() && hits.size() < limit; ++it) {
+        if (!it->first.startsWith(pattern)) break;
+        hits.append({it->second, -1, 0.0});
+    }
+
+    if (hits.size() >= limit) return hits;
+
+    QVector<QPair<int, HardwareModule*>> fuzzy;
+    for (const auto &entry : m_sortedNames) {
+        if (entry.first.startsWith(pattern)) continue;
+        int score = fuzzyScore(entry.first, pattern);
+        if (score >= 0) {
+            fuzzy.append({score, entry.second});
+        }
+    }
+    std::stable_sort(fuzzy.begin(), fuzzy.end(),
+                     [](const QPair<int, HardwareModule*> &a, const QPair<int, HardwareModule*> &b) {
+                         return a.first < b.first;
+                     });
+    for (const auto &entry : fuzzy) {
+        if (hits.size() >= limit) break;
+        hits.append({entry.second, -1, double(entry.first)});
+    }
+    return hits;
+}
+
+QVector<ModuleSearchIndex::Hit> ModuleSearchIndex::topK(const QString &keyPattern, int k, bool largest) const
+{
+    const QVector<int> keyIds = StatKeyRegistry::instance().match(keyPattern);
+
+    if (largest) {
+        QVector<Cursor<KeyIndex::const_reverse_iterator>> cursors;
+        for (int keyId : keyIds) {
+            auto it = m_keyIndex.constFind(keyId);
+            if (it != m_keyIndex.constEnd()) {
+                cursors.append({it->rbegin(), it->rend(), keyId});
+            }
+        }
+        return mergeCursors(cursors, k, [](double a, double b) { return a > b; });
+    }
+
+    QVector<Cursor<KeyIndex::const_iterator>> cursors;
+    for (int keyId : keyIds) {
+        auto it = m_keyIndex.constFind(keyId);
+        if (it != m_keyIndex.constEnd()) {
+            cursors.append({it->begin(), it->end(), keyId});
+        }
+    }
+    return mergeCursors(cursors, k, [](double a, double b) { return a < b; });
+}
+
+QVector<ModuleSearchIndex::Hit> ModuleSearchIndex::filter(const QString &keyPattern, Compare op,
+                                                          double threshold, int limit) const
+{
+    QVector<Hit> hits;
+    bool descending = (op == Greater || op == GreaterEqual);
+
+    for (int keyId : StatKeyRegistry::instance().match(keyPattern)) {
+        auto indexIt = m_keyIndex.constFind(keyId);
+        if (indexIt == m_keyIndex.constEnd()) continue;
+        const KeyIndex &index = indexIt.value();
+
+        KeyIndex::const_iterator first = index.begin();
+        KeyIndex::const_iterator last = index.end();
+        switch (op) {
+            case Greater:
+                first = index.upper_bound(threshold);
+                break;
+            case GreaterEqual:
+                first = index.lower_bound(threshold);
+                break;
+            case Less:
+                last = index.lower_bound(threshold);
+                break;
+            case LessEqual:
+                last = index.upper_bound(threshold);
+                break;
+            case Equal:
+                first = index.lower_bound(threshold);
+                last = index.upper_bound(threshold);
+                break;
+        }
+
+        // 每个统计项最多取 limit 个，从最靠近结果排序首部的一端开始
+        int taken = 0;
+        if (descending) {
+            for (auto it = KeyIndex::const_reverse_iterator(last);
+                 it != KeyIndex::const_reverse_iterator(first) && taken < limit; ++it, ++taken) {
+                hits.append({it->module, keyId, it->value});
+            }
+        } else {
+            for (auto it = first; it != last && taken < limit; ++it, ++taken) {
+                hits.append({it->module, keyId, it->value});
+            }
+        }
+    }
+
+    std::sort(hits.begin(), hits.end(), [descending](const Hit &a, const Hit &b) {
+        return descending ? a.value > b.value : a.value < b.value;
+    });
+    if (hits.size() > limit) {
+        hits.resize(limit);
+    }
+    return hits;
+}
+
+void ModuleSearchIndex::onStatisticChanged(int keyId, double oldValue, double newValue)
+{
+    auto module = qobject_cast<HardwareModule*>(sender());
+    if (!module) return;
+
+    if (!qIsNaN(oldValue)) {
+        eraseEntry(keyId, module, oldValue);
+    }
+    if (!qIsNaN(newValue)) {
+        insertEntry(keyId, module, newValue);
+    }
+}
+
+void ModuleSearchIndex::insertEntry(int keyId, HardwareModule* module, double value)
+{
+    m_keyIndex[keyId].insert(Entry{value, module});
+}
+
+void ModuleSearchIndex::eraseEntry(int keyId, HardwareModule* module, double value)
+{
+    auto it = m_keyIndex.find(keyId);
+    if (it == m_keyIndex.end()) return;
+
+    it->erase(Entry{value, module});
+    if (it->empty()) {
+        m_keyIndex.erase(it);
+    }
+}
@@ -0,0 +1,82 @@
+#ifndef MODULESEARCHINDEX_H
+#define MODULESEARCHINDEX_H
+
+#include <QObject>
+#include <QString>
+#include <QVector>
+#include <QHash>
+#include <set>
+#include <functional>
+#include "hardwaremodule.h"
+
+// 模块与统计项搜索索引
+// 模块名保存在有序数组中支持前缀/模糊匹配，
+// 每个驻留统计项维护一个按值排序的集合，用于 top-K 与阈值查询
+class ModuleSearchIndex : public QObject
+{
+    Q_OBJECT
+
+public:
+    // 查询结果：keyId 为 -1 表示按名称匹配
+    struct Hit {
+        HardwareModule* module;
+        int keyId;
+        double value;
+    };
+
+    enum Compare {
+        Greater,
+        GreaterEqual,
+        Less,
+        LessEqual,
+        Equal
+    };
+
+    explicit ModuleSearchIndex(QObject *parent = nullptr);
+
+    // 添加/移除模块，添加时会索引模块已有的统计数据
+    void addModule(HardwareModule* module);
+    void removeModule(HardwareModule* module);
+    void clear();
+
+    // 解析并执行查询文本，支持：
+    //   top N <pattern> / bottom N <pattern>
+    //   <pattern> >|>=|<|<=|= <value>
+    //   其它文本按模块名前缀/模糊匹配
+    // limit 限制阈值与名称匹配的条数，top/bottom 按查询中的 N 返回
+    QVector<Hit> query(const QString &text, int limit = 50) const;
+
+    // 模块名匹配：先取前缀匹配，不足时补充子序列模糊匹配
+    QVector<Hit> matchNames(const QString &text, int limit) const;
+    // 取匹配模式的统计项中最大（或最小）的 k 个值
+    QVector<Hit> topK(const QString &keyPattern, int k, bool largest = true) const;
+    // 取匹配模式的统计项中满足阈值条件的值
+    QVector<Hit> filter(const QString &keyPattern, Compare op, double threshold, int limit) const;
+
+private slots:
+    void onStatisticChanged(int keyId, double oldValue, double newValue);
+
+private:
+    struct Entry {
+        double value;
+        HardwareModule* module;
+        bool operator<(const Entry &other) const {
+            if (value != other.value) return value < other.value;
+            return module < other.module;
+        }
+        // 支持直接按数值做 lower_bound/upper_bound
+        friend bool operator<(const Entry &entry, double value) { return entry.value < value; }
+        friend bool operator<(double value, const Entry &entry) { return value < entry.value; }
+    };
+    using KeyIndex = std::set<Entry, std::less<>>;
+
+    void insertEntry(int keyId, HardwareModule* module, double value);
+    void eraseEntry(int keyId, HardwareModule* module, double value);
+
+    // 按名称小写形式排序的模块列表
+    QVector<QPair<QString, HardwareModule*>> m_sortedNames;
+    // 按驻留ID组织的统计值有序索引
+    QHash<int, KeyIndex> m_keyIndex;
+};
+
+#endif // MODULESEARCHINDEX_H
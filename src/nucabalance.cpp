@@ -0,0 +1,334 @@
+#include "nucabalance.h"
+#include "statkeyregistry.h"
+#include "addresstrace.h"
+#include "workstealingpool.h"
+#include <QtMath>
+#include <QtAlgorithms>
+#include <algorithm>
+#include <cmath>
+
+namespace {
+
+const int kHashGrain = 1 << 16;   // 每个并行分段的地址数
+const int kPageBits = 12;
+const int kMaxSliceBits = 16;
+
+int ceilLog2(int value)
+{
+    int bits = 0;
+    while ((1 << bits) < value) ++bits;
+    return bits;
+}
+
+// H3 奇偶校验哈希的固定掩码：splitmix64 生成，只取缓存行偏移以上、第 40 位以下的地址位
+void h3Masks(int lineBits, quint64 *masks, int count)
+{
+    quint64 state = 0;
+    const quint64 range = ((quint64(1) << 40) - 1) & ~((quint64(1) << lineBits) - 1);
+    for (int i = 0; i < count; ++i) {
+        quint64 z = (state += 0x9E3779B97F4A7C15ull);
+        z = (z ^ (z >> 30)) * 0xBF58476D1CE4E5B9ull;
+        z = (z ^ (z >> 27)) * 0x94D049BB133111EBull;
+        masks[i] = (z ^ (z >> 31)) & range;
+    }
+}
+
+// 原始哈希值映射到分片：分片数为 2 的幂时取低位，否则取模
+void reduce(quint32 *slices, int count, int sliceCount)
+{
+    if ((sliceCount & (sliceCount - 1)) == 0) {
+        const quint32 mask = quint32(sliceCount - 1);
+        for (int i = 0; i < count; ++i) {
+            slices[i] &= mask;
+        }
+    } else {
+        const quint32 divisor = quint32(sliceCount);
+        for (int i = 0; i < count; ++i) {
+            slices[i] %= divisor;
+        }
+    }
+}
+
+} // namespace
+
+NucaBalanceAnalyzer::NucaBalanceAnalyzer(const BusTopology* topology, QObject *parent)
+    : QObject(parent)
+    , m_topology(topology)
+    , m_threshold(0.2)
+{
+    auto &registry = StatKeyRegistry::instance();
+    m_hitKey = registry.intern("llc_hit_count");
+    m_missKey = registry.intern("llc_miss_count");
+
+    m_timer.setSingleShot(true);
+    m_timer.setInterval(50);
+    connect(&m_timer, &QTimer::timeout, this, &NucaBalanceAnalyzer::recompute);
+    connect(m_topology, &BusTopology::trafficChanged, this, [this]() {
+        if (!m_timer.isActive()) {
+            m_timer.start();
+        }
+    });
+}
+
+void NucaBalanceAnalyzer::addModule(HardwareModule* module)
+{
+    if (!module || module->type() != HardwareModule::CACHE_L3 || m_slices.contains(module)) return;
+
+    m_slices.append(module);
+    connect(module, &HardwareModule::statisticChanged,
+            this, &NucaBalanceAnalyzer::onStatisticChanged);
+    m_timer.start();
+}
+
+void NucaBalanceAnalyzer::removeModule(HardwareModule* module)
+{
+    if (!m_slices.removeOne(module)) return;
+
+    disconnect(module, nullptr, this, nullptr);
+    m_timer.start();
+}
+
+void NucaBalanceAnalyzer::clear()
+{
+    for (auto module : m_slices) {
+        disconnect(module, nullptr, this, nullptr);
+    }
+    m_slices.clear();
+    m_timer.stop();
+    recompute();
+}
+
+void NucaBalanceAnalyzer::setThreshold(double threshold)
+{
+    if (qFuzzyCompare(m_threshold, threshold)) return;
+    m_threshold = threshold;
+    recompute();
+}
+
+void NucaBalanceAnalyzer::onStatisticChanged(int keyId, double oldValue, double newValue)
+{
+    Q_UNUSED(oldValue);
+    Q_UNUSED(newValue);
+
+    if ((keyId == m_hitKey || keyId == m_missKey) && !m_timer.isActive()) {
+        m_timer.start();
+    }
+}
+
+void NucaBalanceAnalyzer::balance(const QVector<double> &values, double *maxOverMean, double *cv)
+{
+    double sum = 0.0;
+    double high = 0.0;
+    for (double value : values) {
+        sum += value;
+        high = qMax(high, value);
+    }
+    const double mean = values.isEmpty() ? 0.0 : sum / values.size();
+    double variance = 0.0;
+    for (double value : values) {
+        variance += (value - mean) * (value - mean);
+    }
+    variance = values.isEmpty() ? 0.0 : variance / values.size();
+    if (maxOverMean) *maxOverMean = mean > 0 ? high / mean : 0.0;
+    if (cv) *cv = mean > 0 ? std::sqrt(variance) / mean : 0.0;
+}
+
+void NucaBalanceAnalyzer::recompute()
+{
+    // 按所在总线分组，同一插槽内按 nuca_index 排列
+    QVector<HardwareModule*> buses;
+    QHash<HardwareModule*, QVector<HardwareModule*>> slicesByBus;
+    for (auto module : m_slices) {
+        HardwareModule* bus = m_topology->busOf(module);
+        if (!slicesByBus.contains(bus)) {
+            buses.append(bus);
+        }
+        slicesByBus[bus].append(module);
+    }
+
+    m_domains.clear();
+    for (auto bus : buses) {
+        QVector<HardwareModule*> modules = slicesByBus.value(bus);
+        std::sort(modules.begin(), modules.end(), [](HardwareModule* a, HardwareModule* b) {
+            return a->nucaIndex() != b->nucaIndex() ? a->nucaIndex() < b->nucaIndex() : a->name() < b->name();
+        });
+
+        Domain domain;
+        domain.bus = bus;
+        domain.name = bus ? bus->name() : QString("Socket");
+        domain.nucaNum = 0;
+        for (auto module : modules) {
+            domain.nucaNum = qMax(domain.nucaNum, module->nucaNum());
+        }
+        // 配置缺少 nuca_num 时按实际分片数计算理想份额
+        if (domain.nucaNum <= 0) {
+            domain.nucaNum = modules.size();
+        }
+        domain.idealShare = 1.0 / domain.nucaNum;
+
+        const BusTopology::PortTraffic &incoming = m_topology->incomingTraffic(bus);
+        double total = 0.0;
+        QVector<double> accesses;
+        for (auto module : modules) {
+            Slice slice;
+            slice.module = module;
+            slice.nucaIndex = module->nucaIndex();
+            slice.hits = module->statistic(m_hitKey);
+            slice.misses = module->statistic(m_missKey);
+            slice.accesses = slice.hits + slice.misses;
+            slice.busPackets = -1.0;
+            if (!incoming.isEmpty() && module->portId() >= 0) {
+                slice.busPackets = 0.0;
+                for (double packets : incoming.value(module->portId())) {
+                    slice.busPackets += packets;
+                }
+            }
+            total += slice.accesses;
+            accesses.append(slice.accesses);
+            domain.slices.append(slice);
+        }
+        // 配置中存在但没有加载的分片按零访问计入
+        for (int i = modules.size(); i < domain.nucaNum; ++i) {
+            accesses.append(0.0);
+        }
+        balance(accesses, &domain.maxOverMean, &domain.cv);
+
+        domain.imbalancedSlices = 0;
+        for (auto &slice : domain.slices) {
+            slice.share = total > 0 ? slice.accesses / total : 0.0;
+            slice.deviation = total > 0 ? slice.share / domain.idealShare - 1.0 : 0.0;
+            slice.imbalanced = total > 0 && qAbs(slice.deviation) > m_threshold;
+            if (slice.imbalanced) {
+                ++domain.imbalancedSlices;
+            }
+        }
+        m_domains.append(domain);
+    }
+    emit changed();
+}
+
+QString NucaBalanceAnalyzer::hashName(HashFunction function)
+{
+    switch (function) {
+        case BIT_SELECT_LINE: return "Bit-select (line)";
+        case BIT_SELECT_PAGE: return "Bit-select (4KB page)";
+        case XOR_FOLD: return "XOR fold";
+        case H3_PARITY: return "H3 parity";
+        default: return QString();
+    }
+}
+
+void NucaBalanceAnalyzer::hashSlices(HashFunction function, const quint64 *addresses, int count,
+                                     int sliceCount, int lineBits, quint32 *slices)
+{
+    const int sliceBits = qMin(ceilLog2(sliceCount), kMaxSliceBits);
+    switch (function) {
+        case BIT_SELECT_LINE:
+        case BIT_SELECT_PAGE: {
+            const int shift = function == BIT_SELECT_PAGE ? qMax(lineBits, kPageBits) : lineBits;
+            for (int i = 0; i < count; ++i) {
+                slices[i] = quint32(addresses[i] >> shift);
+            }
+            break;
+        }
+        case XOR_FOLD: {
+            // 分片数不是 2 的幂时先折叠为 16 位再取模
+            const int width = (sliceCount & (sliceCount - 1)) == 0 ? qMax(1, sliceBits) : kMaxSliceBits;
+            const quint64 fieldMask = (quint64(1) << width) - 1;
+            const int fields = (48 - lineBits + width - 1) / width;
+            for (int i = 0; i < count; ++i) {
+                const quint64 line = addresses[i] >> lineBits;
+                quint64 value = 0;
+                for (int f = 0; f < fields; ++f) {
+                    value ^= (line >> (f * width)) & fieldMask;
+                }
+                slices[i] = quint32(value);
+            }
+            break;
+        }
+        case H3_PARITY: {
+            const int bits = (sliceCount & (sliceCount - 1)) == 0 ? sliceBits : kMaxSliceBits;
+            quint64 masks[kMaxSliceBits];
+            h3Masks(lineBits, masks, bits);
+            for (int i = 0; i < count; ++i) {
+                slices[i] = 0;
+            }
+            for (int b = 0; b < bits; ++b) {
+                const quint64 mask = masks[b];
+                for (int i = 0; i < count; ++i) {
+                    slices[i] |= quint32(qPopulationCount(addresses[i] & mask) & 1) << b;
+                }
+            }
+            break;
+        }
+        default:
+            break;
+    }
+    reduce(slices, count, sliceCount);
+}
+
+QVector<NucaBalanceAnalyzer::HashPrediction> NucaBalanceAnalyzer::replayTrace(AddressTrace &trace, WorkStealingPool &pool,
+                                                                              int sliceCount, int lineBits,
+                                                                              std::atomic<qint64> *processed,
+                                                                              const std::atomic<bool> *cancel, QString *error)
+{
+    QVector<HashPrediction> predictions;
+    if (sliceCount <= 0) {
+        if (error) *error = "No NUCA slices to replay against";
+        return predictions;
+    }
+
+    const int functionCount = HASH_FUNCTION_COUNT;
+    QVector<quint64> totals(functionCount * sliceCount, 0);
+    QVector<quint64> addresses;
+    QVector<quint8> kinds;
+    while (!(cancel && cancel->load())) {
+        if (!trace.readBlock(addresses, kinds)) {
+            if (error) *error = trace.errorString();
+            return predictions;
+        }
+        if (addresses.isEmpty()) break;
+
+        // 每个分段独立计数，结束后按分段顺序合并，不需要加锁
+        const int count = addresses.size();
+        const int segments = (count + kHashGrain - 1) / kHashGrain;
+        QVector<quint64> segmentCounts(segments * functionCount * sliceCount, 0);
+        const quint64 *data = addresses.constData();
+        pool.parallelFor(count, kHashGrain, [&](int begin, int end) {
+            QVector<quint32> slices(end - begin);
+            quint64 *counts = segmentCounts.data() + (begin / kHashGrain) * functionCount * sliceCount;
+            for (int f = 0; f < functionCount; ++f) {
+                hashSlices(HashFunction(f), data + begin, end - begin, sliceCount, lineBits, slices.data());
+                quint64 *functionCounts = counts + f * sliceCount;
+                for (quint32 slice : slices) {
+                    ++functionCounts[slice];
+                }
+            }
+        });
+        for (int s = 0; s < segments; ++s) {
+            const quint64 *counts = segmentCounts.constData() + s * functionCount * sliceCount;
+            for (int i = 0; i < totals.size(); ++i) {
+                totals[i] += counts[i];
+            }
+        }
+        if (processed) {
+            processed->fetch_add(count);
+        }
+    }
+    if (cancel && cancel->load()) {
+        return predictions;
+    }
+
+    for (int f = 0; f < functionCount; ++f) {
+        HashPrediction prediction;
+        prediction.function = HashFunction(f);
+        QVector<double> values;
+        for (int s = 0; s < sliceCount; ++s) {
+            prediction.counts.append(totals[f * sliceCount + s]);
+            values.append(double(totals[f * sliceCount + s]));
+        }
+        balance(values, &prediction.maxOverMean, &prediction.cv);
+        predictions.append(prediction);
+    }
+    return predictions;
+}
@@ -0,0 +1,105 @@
+#ifndef NUCABALANCE_H
+#define NUCABALANCE_H
+
+#include <QObject>
+#include <QVector>
+#include <QTimer>
+#include <QSet>
+#include <atomic>
+#include "hardwaremodule.h"
+#include "bustopology.h"
+
+class AddressTrace;
+class WorkStealingPool;
+
+// NUCA 分片负载均衡分析：每条总线（插槽）上的 L3 分片按 nuca_index 排列，
+// 用 llc_hit_count + llc_miss_count 计算各分片的访问份额并与理想的 1/nuca_num 比较，
+// 同时给出发往分片端口的总线数据包数；偏离理想份额超过阈值的分片标记为失衡
+class NucaBalanceAnalyzer : public QObject
+{
+    Q_OBJECT
+
+public:
+    struct Slice {
+        HardwareModule* module;
+        int nucaIndex;
+        double hits;
+        double misses;
+        double accesses;
+        double share;        // 占本插槽分片访问总数的比例
+        double deviation;    // share / 理想份额 - 1
+        double busPackets;   // 发往分片端口的数据包数，没有流量统计时为-1
+        bool imbalanced;
+    };
+
+    struct Domain {
+        HardwareModule* bus;
+        QString name;
+        int nucaNum;
+        double idealShare;
+        double maxOverMean;  // 访问最多的分片与平均值之比
+        double cv;           // 各分片访问数的变异系数
+        int imbalancedSlices;
+        QVector<Slice> slices;
+    };
+
+    // 备选的分片交织函数
+    enum HashFunction {
+        BIT_SELECT_LINE,   // 缓存行地址的低位
+        BIT_SELECT_PAGE,   // 4KB 页地址的低位
+        XOR_FOLD,          // 缓存行地址按分片位宽分段异或
+        H3_PARITY,         // 每个输出位为地址与固定随机掩码按位与后的奇偶校验
+        HASH_FUNCTION_COUNT
+    };
+
+    // 按交织函数回放地址轨迹得到的各分片访问数
+    struct HashPrediction {
+        HashFunction function;
+        QVector<quint64> counts;
+        double maxOverMean;
+        double cv;
+    };
+
+    explicit NucaBalanceAnalyzer(const BusTopology* topology, QObject *parent = nullptr);
+
+    void addModule(HardwareModule* module);
+    void removeModule(HardwareModule* module);
+    void clear();
+
+    // 失衡阈值：访问份额相对理想份额的偏离比例
+    void setThreshold(double threshold);
+    double threshold() const { return m_threshold; }
+
+    const QVector<Domain>& domains() const { return m_domains; }
+
+    static QString hashName(HashFunction function);
+    // 计算 count 个地址所在的分片：各函数均为逐元素无分支运算，便于编译器向量化
+    static void hashSlices(HashFunction function, const quint64 *addresses, int count,
+                           int sliceCount, int lineBits, quint32 *slices);
+    // 流式回放整个轨迹，每块按地址分段在 pool 中并行计算所有交织函数（不与界面共用线程池）；
+    // 可在工作线程中调用，processed 为已处理的访问数，cancel 置位时提前返回；出错时返回空并设置 error
+    static QVector<HashPrediction> replayTrace(AddressTrace &trace, WorkStealingPool &pool, int sliceCount,
+                                               int lineBits, std::atomic<qint64> *processed,
+                                               const std::atomic<bool> *cancel, QString *error);
+    // 最大值与平均值之比、变异系数
+    static void balance(const QVector<double> &values, double *maxOverMean, double *cv);
+
+signals:
+    void changed();
+
+private slots:
+    void onStatisticChanged(int keyId, double oldValue, double newValue);
+    void recompute();
+
+private:
+    const BusTopology* m_topology;
+    QVector<HardwareModule*> m_slices;
+    QTimer m_timer;
+    double m_threshold;
+    QVector<Domain> m_domains;
+
+    int m_hitKey;
+    int m_missKey;
+};
+
+#endif // NUCABALANCE_H
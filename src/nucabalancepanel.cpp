@@ -0,0 +1,302 @@
+#include "nucabalancepanel.h"
+#include "addresstrace.h"
+#include "bottleneckanalyzer.h"
+#include "workstealingpool.h"
+#include <QVBoxLayout>
+#include <QHBoxLayout>
+#include <QHeaderView>
+#include <QFileDialog>
+#include <QFileInfo>
+#include <QMessageBox>
+#include <QSignalBlocker>
+#include <QThread>
+
+namespace {
+
+// 按 UserRole 中的数值排序的表格项
+class NumericItem : public QTableWidgetItem
+{
+public:
+    NumericItem(const QString &text, double value)
+        : QTableWidgetItem(text)
+    {
+        setData(Qt::UserRole, value);
+        setTextAlignment(Qt::AlignRight | Qt::AlignVCenter);
+    }
+
+    bool operator<(const QTableWidgetItem &other) const override
+    {
+        return data(Qt::UserRole).toDouble() < other.data(Qt::UserRole).toDouble();
+    }
+};
+
+QString percent(double value)
+{
+    return QString("%1%").arg(value * 100.0, 0, 'f', 1);
+}
+
+} // namespace
+
+NucaBalancePanel::NucaBalancePanel(NucaBalanceAnalyzer* analyzer, HardwareVisualizer* visualizer, QWidget *parent)
+    : QDockWidget("NUCA 负载", parent)
+    , m_analyzer(analyzer)
+    , m_visualizer(visualizer)
+    , m_replayThread(nullptr)
+    , m_replayed(0)
+    , m_cancel(false)
+    , m_replaySlices(0)
+{
+    QWidget* content = new QWidget(this);
+    QVBoxLayout* layout = new QVBoxLayout(content);
+    layout->setContentsMargins(4, 4, 4, 4);
+
+    QHBoxLayout* optionLayout = new QHBoxLayout;
+    m_domainCombo = new QComboBox(content);
+    m_thresholdSpin = new QDoubleSpinBox(content);
+    m_thresholdSpin->setRange(1.0, 200.0);
+    m_thresholdSpin->setSuffix("%");
+    m_thresholdSpin->setDecimals(0);
+    m_thresholdSpin->setValue(m_analyzer->threshold() * 100.0);
+    m_thresholdSpin->setToolTip("访问份额偏离理想份额 1/nuca_num 超过该比例的分片标记为失衡");
+    optionLayout->addWidget(new QLabel("插槽", content));
+    optionLayout->addWidget(m_domainCombo, 1);
+    optionLayout->addWidget(new QLabel("失衡阈值", content));
+    optionLayout->addWidget(m_thresholdSpin);
+    layout->addLayout(optionLayout);
+
+    m_summaryLabel = new QLabel(content);
+    m_summaryLabel->setWordWrap(true);
+    layout->addWidget(m_summaryLabel);
+
+    m_sliceTable = new QTableWidget(0, 7, content);
+    m_sliceTable->setHorizontalHeaderLabels({"Slice", "NUCA Index", "Hits", "Misses", "Share", "Deviation", "Bus Packets"});
+    m_sliceTable->horizontalHeader()->setSectionResizeMode(0, QHeaderView::Stretch);
+    m_sliceTable->verticalHeader()->setVisible(false);
+    m_sliceTable->setEditTriggers(QAbstractItemView::NoEditTriggers);
+    m_sliceTable->setSelectionBehavior(QAbstractItemView::SelectRows);
+    m_sliceTable->setSortingEnabled(true);
+    layout->addWidget(m_sliceTable, 1);
+
+    QHBoxLayout* replayLayout = new QHBoxLayout;
+    m_lineSizeSpin = new QSpinBox(content);
+    m_lineSizeSpin->setRange(16, 4096);
+    m_lineSizeSpin->setSingleStep(16);
+    m_lineSizeSpin->setValue(BottleneckAnalyzer::kCacheLineBytes);
+    m_lineSizeSpin->setSuffix(" B");
+    m_replayButton = new QPushButton("回放地址轨迹...", content);
+    m_replayButton->setToolTip("按位选择、异或折叠与 H3 哈希计算轨迹中每个地址所在的分片，预测各交织函数的负载");
+    replayLayout->addWidget(new QLabel("缓存行", content));
+    replayLayout->addWidget(m_lineSizeSpin);
+    replayLayout->addWidget(m_replayButton);
+    replayLayout->addStretch();
+    layout->addLayout(replayLayout);
+
+    m_replayLabel = new QLabel(content);
+    layout->addWidget(m_replayLabel);
+
+    m_predictionTable = new QTableWidget(0, 5, content);
+    m_predictionTable->setHorizontalHeaderLabels({"Interleaving", "Max / Mean", "CV", "Min Share", "Max Share"});
+    m_predictionTable->horizontalHeader()->setSectionResizeMode(0, QHeaderView::Stretch);
+    m_predictionTable->verticalHeader()->setVisible(false);
+    m_predictionTable->setEditTriggers(QAbstractItemView::NoEditTriggers);
+    m_predictionTable->setSortingEnabled(true);
+    layout->addWidget(m_predictionTable, 1);
+
+    setWidget(content);
+
+    m_progressTimer.setInterval(200);
+    connect(&m_progressTimer, &QTimer::timeout, this, &NucaBalancePanel::updateReplayProgress);
+    connect(m_analyzer, &NucaBalanceAnalyzer::changed, this, &NucaBalancePanel::refreshDomains);
+    connect(m_domainCombo, QOverload<int>::of(&QComboBox::currentIndexChanged), this, &NucaBalancePanel::refresh);
+    connect(m_thresholdSpin, QOverload<double>::of(&QDoubleSpinBox::valueChanged), this, [this](double value) {
+        m_analyzer->setThreshold(value / 100.0);
+    });
+    connect(m_sliceTable, &QTableWidget::cellClicked, this, &NucaBalancePanel::onCellClicked);
+    connect(m_replayButton, &QPushButton::clicked, this, &NucaBalancePanel::replayTrace);
+    refreshDomains();
+}
+
+NucaBalancePanel::~NucaBalancePanel()
+{
+    if (m_replayThread) {
+        m_cancel = true;
+        m_replayThread->wait();
+        delete m_replayThread;
+    }
+}
+
+const NucaBalanceAnalyzer::Domain* NucaBalancePanel::currentDomain() const
+{
+    const int index = m_domainCombo->currentIndex();
+    const auto &domains = m_analyzer->domains();
+    return index >= 0 && index < domains.size() ? &domains[index] : nullptr;
+}
+
+void NucaBalancePanel::refreshDomains()
+{
+    const QString current = m_domainCombo->currentText();
+    {
+        QSignalBlocker blocker(m_domainCombo);
+        m_domainCombo->clear();
+        for (const auto &domain : m_analyzer->domains()) {
+            m_domainCombo->addItem(domain.name);
+        }
+        const int index = m_domainCombo->findText(current);
+        m_domainCombo->setCurrentIndex(index >= 0 ? index : 0);
+    }
+    refresh();
+}
+
+void NucaBalancePanel::refresh()
+{
+    const NucaBalanceAnalyzer::Domain* domain = currentDomain();
+    m_replayButton->setEnabled(domain && !m_replayThread);
+    if (!domain) {
+        m_summaryLabel->setText("没有 L3 分片");
+        m_sliceTable->setRowCount(0);
+        return;
+    }
+
+    m_summaryLabel->setText(QString("%1 个分片，理想份额 %2，最大/平均 %3，变异系数 %4，%5 个分片失衡")
+                                .arg(domain->nucaNum)
+                                .arg(percent(domain->idealShare))
+                                .arg(domain->maxOverMean, 0, 'f', 2)
+                                .arg(domain->cv, 0, 'f', 3)
+                                .arg(domain->imbalancedSlices));
+
+    // 填充期间关闭排序，结束后按当前排序列重新排序
+    m_sliceTable->setSortingEnabled(false);
+    m_sliceTable->setRowCount(domain->slices.size());
+    for (int row = 0; row < domain->slices.size(); ++row) {
+        const auto &slice = domain->slices[row];
+
+        auto nameItem = new QTableWidgetItem(slice.module->name());
+        nameItem->setData(Qt::UserRole, QVariant::fromValue(slice.module));
+        m_sliceTable->setItem(row, 0, nameItem);
+        m_sliceTable->setItem(row, 1, new NumericItem(QString::number(slice.nucaIndex), slice.nucaIndex));
+        m_sliceTable->setItem(row, 2, new NumericItem(QString::number(slice.hits, 'g', 10), slice.hits));
+        m_sliceTable->setItem(row, 3, new NumericItem(QString::number(slice.misses, 'g', 10), slice.misses));
+        m_sliceTable->setItem(row, 4, new NumericItem(percent(slice.share), slice.share));
+        m_sliceTable->setItem(row, 5, new NumericItem(QString("%1%2").arg(slice.deviation >= 0 ? "+" : "")
+                                                          .arg(percent(slice.deviation)), slice.deviation));
+        m_sliceTable->setItem(row, 6, slice.busPackets >= 0
+                                  ? new NumericItem(QString::number(slice.busPackets, 'g', 10), slice.busPackets)
+                                  : new NumericItem("-", -1.0));
+
+        if (slice.imbalanced) {
+            for (int column = 4; column <= 5; ++column) {
+                m_sliceTable->item(row, column)->setBackground(QColor(230, 120, 110));
+                m_sliceTable->item(row, column)->setForeground(Qt::black);
+            }
+        }
+    }
+    m_sliceTable->setSortingEnabled(true);
+}
+
+void NucaBalancePanel::onCellClicked(int row, int column)
+{
+    Q_UNUSED(column);
+
+    if (auto item = m_sliceTable->item(row, 0)) {
+        if (auto module = item->data(Qt::UserRole).value<HardwareModule*>()) {
+            m_visualizer->focusModule(module);
+        }
+    }
+}
+
+void NucaBalancePanel::replayTrace()
+{
+    const NucaBalanceAnalyzer::Domain* domain = currentDomain();
+    if (m_replayThread || !domain) return;
+
+    const QString filename = QFileDialog::getOpenFileName(this, "打开地址轨迹", QString(),
+                                                          "Address Traces (*.txt *.trace *.bin);;All Files (*)");
+    if (filename.isEmpty()) return;
+
+    int lineBits = 0;
+    while ((1 << (lineBits + 1)) <= m_lineSizeSpin->value()) ++lineBits;
+
+    // 回放需要读完整个轨迹，在工作线程中完成，哈希计算再分到回放专用的线程池
+    m_replayFile = filename;
+    m_replayError.clear();
+    m_replaySlices = domain->nucaNum;
+    m_replayed = 0;
+    m_cancel = false;
+    m_replayButton->setEnabled(false);
+    m_replayLabel->setText("正在回放: " + QFileInfo(filename).fileName());
+
+    if (!m_pool) {
+        m_pool = std::make_unique<WorkStealingPool>();
+    }
+    const int slices = m_replaySlices;
+    m_replayThread = QThread::create([this, filename, slices, lineBits]() {
+        AddressTrace trace;
+        if (!trace.open(filename, &m_replayError)) return;
+        m_predictions = NucaBalanceAnalyzer::replayTrace(trace, *m_pool, slices, lineBits, &m_replayed, &m_cancel,
+                                                         &m_replayError);
+    });
+    connect(m_replayThread, &QThread::finished, this, &NucaBalancePanel::onReplayFinished);
+    m_replayThread->start();
+    m_progressTimer.start();
+}
+
+void NucaBalancePanel::updateReplayProgress()
+{
+    m_replayLabel->setText(QString("正在回放: %1，已处理 %2 个访问")
+                               .arg(QFileInfo(m_replayFile).fileName())
+                               .arg(m_replayed.load()));
+}
+
+void NucaBalancePanel::onReplayFinished()
+{
+    m_progressTimer.stop();
+    m_replayThread->wait();
+    delete m_replayThread;
+    m_replayThread = nullptr;
+    m_replayButton->setEnabled(currentDomain() != nullptr);
+
+    if (!m_replayError.isEmpty()) {
+        m_replayLabel->clear();
+        QMessageBox::warning(this, "Error", m_replayError);
+        return;
+    }
+    m_replayLabel->setText(QString("%1：%2 个访问，%3 个分片")
+                               .arg(QFileInfo(m_replayFile).fileName())
+                               .arg(m_replayed.load())
+                               .arg(m_replaySlices));
+    showPredictions();
+}
+
+void NucaBalancePanel::showPredictions()
+{
+    m_predictionTable->setSortingEnabled(false);
+    m_predictionTable->setRowCount(m_predictions.size());
+    for (int row = 0; row < m_predictions.size(); ++row) {
+        const auto &prediction = m_predictions[row];
+
+        quint64 total = 0;
+        quint64 low = prediction.counts.isEmpty() ? 0 : prediction.counts.first();
+        quint64 high = 0;
+        QStringList shares;
+        for (quint64 count : prediction.counts) {
+            total += count;
+            low = qMin(low, count);
+            high = qMax(high, count);
+        }
+        for (int slice = 0; slice < prediction.counts.size(); ++slice) {
+            shares.append(QString("%1: %2").arg(slice).arg(percent(total > 0 ? double(prediction.counts[slice]) / total : 0.0)));
+        }
+        const double lowShare = total > 0 ? double(low) / total : 0.0;
+        const double highShare = total > 0 ? double(high) / total : 0.0;
+
+        auto nameItem = new QTableWidgetItem(NucaBalanceAnalyzer::hashName(prediction.function));
+        nameItem->setToolTip(shares.join("\n"));
+        m_predictionTable->setItem(row, 0, nameItem);
+        m_predictionTable->setItem(row, 1, new NumericItem(QString::number(prediction.maxOverMean, 'f', 3), prediction.maxOverMean));
+        m_predictionTable->setItem(row, 2, new NumericItem(QString::number(prediction.cv, 'f', 4), prediction.cv));
+        m_predictionTable->setItem(row, 3, new NumericItem(percent(lowShare), lowShare));
+        m_predictionTable->setItem(row, 4, new NumericItem(percent(highShare), highShare));
+    }
+    m_predictionTable->setSortingEnabled(true);
+    m_predictionTable->sortByColumn(1, Qt::AscendingOrder);
+}
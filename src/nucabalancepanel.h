@@ -0,0 +1,67 @@
+#ifndef NUCABALANCEPANEL_H
+#define NUCABALANCEPANEL_H
+
+#include <QDockWidget>
+#include <QTableWidget>
+#include <QComboBox>
+#include <QDoubleSpinBox>
+#include <QSpinBox>
+#include <QLabel>
+#include <QPushButton>
+#include <QTimer>
+#include <atomic>
+#include <memory>
+#include "nucabalance.h"
+#include "hardwarevisualizer.h"
+
+class QThread;
+class WorkStealingPool;
+
+// NUCA 负载面板：按插槽列出各 L3 分片的访问份额与理想份额的偏离，失衡的分片标红；
+// 可在工作线程中回放地址轨迹，比较各备选交织函数预测的分片负载
+class NucaBalancePanel : public QDockWidget
+{
+    Q_OBJECT
+
+public:
+    explicit NucaBalancePanel(NucaBalanceAnalyzer* analyzer, HardwareVisualizer* visualizer,
+                              QWidget *parent = nullptr);
+    ~NucaBalancePanel();
+
+private slots:
+    void refreshDomains();
+    void refresh();
+    void onCellClicked(int row, int column);
+    void replayTrace();
+    void onReplayFinished();
+    void updateReplayProgress();
+
+private:
+    const NucaBalanceAnalyzer::Domain* currentDomain() const;
+    void showPredictions();
+
+    NucaBalanceAnalyzer* m_analyzer;
+    HardwareVisualizer* m_visualizer;
+    QComboBox* m_domainCombo;
+    QDoubleSpinBox* m_thresholdSpin;
+    QLabel* m_summaryLabel;
+    QTableWidget* m_sliceTable;
+
+    QSpinBox* m_lineSizeSpin;
+    QPushButton* m_replayButton;
+    QLabel* m_replayLabel;
+    QTableWidget* m_predictionTable;
+
+    // 回放轨迹的工作线程与结果
+    QThread* m_replayThread;
+    QTimer m_progressTimer;
+    std::atomic<qint64> m_replayed;
+    std::atomic<bool> m_cancel;
+    QString m_replayFile;
+    QString m_replayError;
+    int m_replaySlices;
+    QVector<NucaBalanceAnalyzer::HashPrediction> m_predictions;
+    std::unique_ptr<WorkStealingPool> m_pool;  // 回放专用，不占用界面共用的线程池
+};
+
+#endif // NUCABALANCEPANEL_H
@@ -0,0 +1,331 @@
+#include "packetreplay.h"
+#include <QPainter>
+#include <QPen>
+#include <QSet>
+#include <QQueue>
+#include <QtMath>
+#include <algorithm>
+
+namespace {
+
+const int kFrameInterval = 33;
+// 一帧内需要跳过的块数超过该值时直接按索引定位，不逐块读入
+const int kSeekAheadChunks = 4;
+const double kNodeRadius = 80.0;   // 没有端口模块的节点在总线周围的分布半径
+
+} // namespace
+
+PacketReplay::PacketReplay(QObject *parent)
+    : QObject(parent)
+    , m_bus(nullptr)
+    , m_speed(1000)
+    , m_position(0)
+    , m_tick(0)
+    , m_pendingIndex(0)
+    , m_nextChunk(0)
+{
+    m_timer.setInterval(kFrameInterval);
+    connect(&m_timer, &QTimer::timeout, this, &PacketReplay::onFrame);
+}
+
+PacketReplay::~PacketReplay() = default;
+
+void PacketReplay::setTrace(std::unique_ptr<BusTrace> trace)
+{
+    pause();
+    m_trace = std::move(trace);
+    m_inFlight.clear();
+    m_pending.clear();
+    m_pendingIndex = 0;
+    m_nextChunk = 0;
+    if (m_trace) {
+        seek(m_trace->firstTick());
+    }
+    emit stateChanged();
+}
+
+void PacketReplay::setBus(HardwareModule* bus)
+{
+    if (m_bus == bus) return;
+
+    m_bus = bus;
+    emit busChanged();
+}
+
+void PacketReplay::play()
+{
+    if (!m_trace || m_trace->chunkCount() == 0 || isPlaying()) return;
+
+    if (m_tick >= m_trace->lastTick()) {
+        seek(m_trace->firstTick());
+    }
+    m_clock.start();
+    m_timer.start();
+    emit stateChanged();
+}
+
+void PacketReplay::pause()
+{
+    if (!isPlaying()) return;
+
+    m_timer.stop();
+    emit stateChanged();
+}
+
+void PacketReplay::setSpeed(double ticksPerSecond)
+{
+    m_speed = qMax(1.0, ticksPerSecond);
+}
+
+void PacketReplay::onFrame()
+{
+    m_position += m_clock.restart() / 1000.0 * m_speed;
+    qint64 target = qMin(qint64(m_position), m_trace->lastTick());
+    if (target > m_tick) {
+        advanceTo(target);
+    }
+    if (m_tick >= m_trace->lastTick()) {
+        pause();
+    }
+}
+
+void PacketReplay::seek(qint64 tick)
+{
+    if (!m_trace) return;
+
+    tick = qBound(m_trace->firstTick(), tick, m_trace->lastTick());
+    m_inFlight.clear();
+    m_pending.clear();
+    m_pendingIndex = 0;
+
+    // last 之后的块尚未注入，之前的块只读入仍有在途数据包的块
+    const int last = m_trace->lastChunkInjectedBy(tick);
+    QVector<BusTrace::Packet> packets;
+    for (int index : m_trace->chunksInFlight(tick, last)) {
+        if (!m_trace->readChunk(index, packets)) {
+            fail();
+            return;
+        }
+        for (const auto &packet : packets) {
+            if (packet.inject > tick) {
+                m_pending.append(packet);
+            } else if (packet.arrive > tick) {
+                m_inFlight.append(packet);
+            }
+        }
+    }
+    m_nextChunk = last + 1;
+
+    m_tick = tick;
+    m_position = tick;
+    emit tickChanged(m_tick);
+}
+
+void PacketReplay::advanceTo(qint64 tick)
+{
+    if (m_trace->lastChunkInjectedBy(tick) - m_nextChunk > kSeekAheadChunks) {
+        seek(tick);
+        return;
+    }
+
+    m_inFlight.erase(std::remove_if(m_inFlight.begin(), m_inFlight.end(),
+                                    [tick](const BusTrace::Packet &packet) { return packet.arrive <= tick; }),
+                     m_inFlight.end());
+
+    while (true) {
+        while (m_pendingIndex < m_pending.size() && m_pending[m_pendingIndex].inject <= tick) {
+            const BusTrace::Packet &packet = m_pending[m_pendingIndex++];
+            if (packet.arrive > tick) {
+                m_inFlight.append(packet);
+            }
+        }
+        if (m_pendingIndex < m_pending.size()) break;
+        if (m_nextChunk >= m_trace->chunkCount() || m_trace->chunk(m_nextChunk).firstInject > tick) break;
+        if (!loadChunk(m_nextChunk++)) {
+            fail();
+            return;
+        }
+    }
+
+    m_tick = tick;
+    emit tickChanged(m_tick);
+}
+
+bool PacketReplay::loadChunk(int index)
+{
+    m_pendingIndex = 0;
+    return m_trace->readChunk(index, m_pending);
+}
+
+void PacketReplay::fail()
+{
+    pause();
+    m_inFlight.clear();
+    m_pending.clear();
+    m_pendingIndex = 0;
+    emit errorOccurred(m_trace->errorString());
+}
+
+PacketFlowLayer::PacketFlowLayer(PacketReplay *replay)
+    : m_replay(replay)
+{
+    setZValue(1);
+    setAcceptedMouseButtons(Qt::NoButton);
+}
+
+void PacketFlowLayer::setRoutes(HardwareModule* bus, const QPointF &busCenter, const QHash<int, QPointF> &portPositions)
+{
+    prepareGeometryChange();
+    m_portPositions = portPositions;
+    m_portNodes.clear();
+    m_nodePositions.clear();
+    m_adjacency.clear();
+    m_routes.clear();
+    m_skeleton = QPainterPath();
+    m_bounds = QRectF();
+    if (!bus) return;
+
+    // 节点位置取所连端口模块的平均位置
+    QSet<int> nodes;
+    QHash<int, QPair<QPointF, int>> sums;
+    const QMap<int, int> &portToNode = bus->busPortToNodeMap();
+    for (auto it = portToNode.begin(); it != portToNode.end(); ++it) {
+        m_portNodes.insert(it.key(), it.value());
+        nodes.insert(it.value());
+        auto position = portPositions.constFind(it.key());
+        if (position != portPositions.constEnd()) {
+            sums[it.value()].first += position.value();
+            sums[it.value()].second += 1;
+        }
+    }
+    for (const auto &edge : bus->busEdges()) {
+        m_adjacency[edge.first].append(edge.second);
+        nodes.insert(edge.first);
+        nodes.insert(edge.second);
+    }
+
+    QList<int> nodeList = nodes.values();
+    std::sort(nodeList.begin(), nodeList.end());
+    for (int i = 0; i < nodeList.size(); ++i) {
+        const int node = nodeList[i];
+        auto sum = sums.constFind(node);
+        if (sum != sums.constEnd()) {
+            m_nodePositions.insert(node, sum->first / sum->second);
+        } else {
+            double angle = 2 * M_PI * i / nodeList.size();
+            m_nodePositions.insert(node, busCenter + QPointF(qCos(angle), qSin(angle)) * kNodeRadius);
+        }
+    }
+
+    for (const auto &edge : bus->busEdges()) {
+        m_skeleton.moveTo(m_nodePositions.value(edge.first));
+        m_skeleton.lineTo(m_nodePositions.value(edge.second));
+    }
+
+    for (const QPointF &position : portPositions) {
+        m_bounds |= QRectF(position, QSizeF(1, 1));
+    }
+    for (const QPointF &position : m_nodePositions) {
+        m_bounds |= QRectF(position, QSizeF(1, 1));
+    }
+    m_bounds.adjust(-10, -10, 10, 10);
+    update();
+}
+
+QVector<int> PacketFlowLayer::nodePath(int from, int to) const
+{
+    if (from == to) return {from};
+
+    // 按有向 edge 广度优先搜索最短路由
+    QHash<int, int> parent;
+    QQueue<int> queue;
+    parent.insert(from, from);
+    queue.enqueue(from);
+    while (!queue.isEmpty() && !parent.contains(to)) {
+        int node = queue.dequeue();
+        for (int next : m_adjacency.value(node)) {
+            if (!parent.contains(next)) {
+                parent.insert(next, node);
+                queue.enqueue(next);
+            }
+        }
+    }
+    if (!parent.contains(to)) return {from, to};
+
+    QVector<int> path;
+    for (int node = to; node != from; node = parent.value(node)) {
+        path.prepend(node);
+    }
+    path.prepend(from);
+    return path;
+}
+
+const PacketFlowLayer::Route& PacketFlowLayer::route(int source, int destination)
+{
+    const quint64 key = (quint64(quint32(source)) << 32) | quint32(destination);
+    auto it = m_routes.constFind(key);
+    if (it != m_routes.constEnd()) return it.value();
+
+    Route route;
+    auto sourcePosition = m_portPositions.constFind(source);
+    auto destinationPosition = m_portPositions.constFind(destination);
+    if (sourcePosition != m_portPositions.constEnd() && destinationPosition != m_portPositions.constEnd()) {
+        route.points.append(sourcePosition.value());
+        if (m_portNodes.contains(source) && m_portNodes.contains(destination)) {
+            for (int node : nodePath(m_portNodes.value(source), m_portNodes.value(destination))) {
+                route.points.append(m_nodePositions.value(node));
+            }
+        }
+        route.points.append(destinationPosition.value());
+
+        route.lengths.append(0.0);
+        for (int i = 1; i < route.points.size(); ++i) {
+            route.lengths.append(route.lengths.last() + QLineF(route.points[i - 1], route.points[i]).length());
+        }
+    }
+    return m_routes.insert(key, route).value();
+}
+
+QRectF PacketFlowLayer::boundingRect() const
+{
+    return m_bounds;
+}
+
+QPainterPath PacketFlowLayer::shape() const
+{
+    return QPainterPath();
+}
+
+void PacketFlowLayer::paint(QPainter *painter, const QStyleOptionGraphicsItem *option, QWidget *widget)
+{
+    Q_UNUSED(option);
+    Q_UNUSED(widget);
+
+    if (!m_replay->trace() || m_bounds.isEmpty()) return;
+
+    painter->setBrush(Qt::NoBrush);
+    painter->setPen(QPen(QColor(255, 215, 0, 60), 1.0));
+    painter->drawPath(m_skeleton);
+
+    // 每个数据包按在途时间的比例沿路由的长度插值
+    const qint64 tick = m_replay->currentTick();
+    const auto &packets = m_replay->inFlight();
+    QVector<QPointF> points;
+    points.reserve(packets.size());
+    for (const auto &packet : packets) {
+        const Route &path = route(packet.source, packet.destination);
+        if (path.points.size() < 2) continue;
+
+        double progress = packet.arrive > packet.inject
+            ? double(tick - packet.inject) / double(packet.arrive - packet.inject) : 1.0;
+        double distance = qBound(0.0, progress, 1.0) * path.lengths.last();
+        int segment = int(std::upper_bound(path.lengths.begin(), path.lengths.end(), distance) - path.lengths.begin());
+        segment = qBound(1, segment, path.points.size() - 1);
+        double segmentLength = path.lengths[segment] - path.lengths[segment - 1];
+        double t = segmentLength > 0 ? (distance - path.lengths[segment - 1]) / segmentLength : 1.0;
+        points.append(path.points[segment - 1] + (path.points[segment] - path.points[segment - 1]) * t);
+    }
+
+    painter->setPen(QPen(QColor(255, 215, 0, 220), 7.0, Qt::SolidLine, Qt::RoundCap));
+    painter->drawPoints(points.constData(), points.size());
+}
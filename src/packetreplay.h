@@ -0,0 +1,110 @@
+#ifndef PACKETREPLAY_H
+#define PACKETREPLAY_H
+
+#include <QObject>
+#include <QGraphicsItem>
+#include <QElapsedTimer>
+#include <QTimer>
+#include <QHash>
+#include <QVector>
+#include <QPointF>
+#include <QPainterPath>
+#include <memory>
+#include "bustrace.h"
+#include "hardwaremodule.h"
+
+// 数据包回放：按时间线从轨迹文件中流式读取数据包，只在内存中保留当前在途的数据包
+// （以及最后读入的一块中尚未注入的数据包），跳转时通过分块索引定位
+class PacketReplay : public QObject
+{
+    Q_OBJECT
+
+public:
+    explicit PacketReplay(QObject *parent = nullptr);
+    ~PacketReplay();
+
+    // 接管已建立索引的轨迹并跳转到起点
+    void setTrace(std::unique_ptr<BusTrace> trace);
+    BusTrace* trace() const { return m_trace.get(); }
+
+    // 轨迹中的端口所属的总线
+    void setBus(HardwareModule* bus);
+    HardwareModule* bus() const { return m_bus; }
+
+    void play();
+    void pause();
+    bool isPlaying() const { return m_timer.isActive(); }
+    // 回放速度：每秒前进的周期数
+    void setSpeed(double ticksPerSecond);
+    double speed() const { return m_speed; }
+
+    void seek(qint64 tick);
+    qint64 currentTick() const { return m_tick; }
+    const QVector<BusTrace::Packet>& inFlight() const { return m_inFlight; }
+
+signals:
+    void tickChanged(qint64 tick);
+    void stateChanged();
+    void busChanged();
+    void errorOccurred(const QString &message);
+
+private slots:
+    void onFrame();
+
+private:
+    // 向前推进到 tick：移除已到达的数据包，按需读入后续的块
+    void advanceTo(qint64 tick);
+    bool loadChunk(int index);
+    void fail();
+
+    std::unique_ptr<BusTrace> m_trace;
+    HardwareModule* m_bus;
+    QTimer m_timer;
+    QElapsedTimer m_clock;
+    double m_speed;
+    double m_position;    // 带小数的当前周期，累积每帧的推进量
+    qint64 m_tick;
+    QVector<BusTrace::Packet> m_inFlight;
+    QVector<BusTrace::Packet> m_pending;   // 最后读入的块中尚未处理的数据包
+    int m_pendingIndex;
+    int m_nextChunk;                       // 下一个要读入的块
+};
+
+// 在场景中绘制在途数据包的图形项：数据包从源端口模块出发，
+// 沿总线 edge 连接的最短路由经过各节点到达目的端口模块，位置按注入与到达周期插值
+class PacketFlowLayer : public QGraphicsItem
+{
+public:
+    enum { Type = UserType + 2 };
+
+    explicit PacketFlowLayer(PacketReplay *replay);
+
+    // 设置总线的节点连接与各端口模块的位置，模块移动后需重新设置
+    void setRoutes(HardwareModule* bus, const QPointF &busCenter, const QHash<int, QPointF> &portPositions);
+
+    int type() const override { return Type; }
+    QRectF boundingRect() const override;
+    QPainterPath shape() const override;
+    void paint(QPainter *painter, const QStyleOptionGraphicsItem *option, QWidget *widget) override;
+
+private:
+    // 端口到端口的折线路由与累计长度
+    struct Route {
+        QVector<QPointF> points;
+        QVector<double> lengths;
+    };
+
+    const Route& route(int source, int destination);
+    QVector<int> nodePath(int from, int to) const;
+
+    PacketReplay *m_replay;
+    QHash<int, QPointF> m_portPositions;
+    QHash<int, int> m_portNodes;              // 端口 -> 节点
+    QHash<int, QPointF> m_nodePositions;      // 节点 -> 位置（所连端口模块的平均位置）
+    QHash<int, QVector<int>> m_adjacency;     // 节点 -> 有向 edge 的下一跳节点
+    QHash<quint64, Route> m_routes;           // (源端口, 目的端口) -> 路由缓存
+    QPainterPath m_skeleton;                  // 节点间 edge 的连线
+    QRectF m_bounds;
+};
+
+#endif // PACKETREPLAY_H
@@ -0,0 +1,191 @@
+#include "packetreplaypanel.h"
+#include <QVBoxLayout>
+#include <QHBoxLayout>
+#include <QFileDialog>
+#include <QFileInfo>
+#include <QMessageBox>
+#include <QSignalBlocker>
+#include <QStyle>
+#include <QThread>
+
+namespace {
+
+const int kTimelineSteps = 10000;
+
+} // namespace
+
+PacketReplayPanel::PacketReplayPanel(HardwareVisualizer* visualizer, QWidget *parent)
+    : QDockWidget("数据包回放", parent)
+    , m_visualizer(visualizer)
+    , m_replay(new PacketReplay(this))
+    , m_indexThread(nullptr)
+    , m_indexedTrace(nullptr)
+    , m_indexOk(false)
+{
+    QWidget* content = new QWidget(this);
+    QVBoxLayout* layout = new QVBoxLayout(content);
+    layout->setContentsMargins(4, 4, 4, 4);
+
+    QHBoxLayout* fileLayout = new QHBoxLayout;
+    m_openButton = new QPushButton("打开轨迹", content);
+    m_busCombo = new QComboBox(content);
+    m_busCombo->setToolTip("轨迹中的端口所属的总线");
+    m_fileLabel = new QLabel("未加载轨迹", content);
+    fileLayout->addWidget(m_openButton);
+    fileLayout->addWidget(new QLabel("总线", content));
+    fileLayout->addWidget(m_busCombo);
+    fileLayout->addWidget(m_fileLabel, 1);
+    layout->addLayout(fileLayout);
+
+    QHBoxLayout* playLayout = new QHBoxLayout;
+    m_playButton = new QToolButton(content);
+    m_speedCombo = new QComboBox(content);
+    for (double speed : {100.0, 1e3, 1e4, 1e5, 1e6, 1e7}) {
+        m_speedCombo->addItem(QString("%L1 周期/秒").arg(speed, 0, 'f', 0), speed);
+    }
+    m_speedCombo->setCurrentIndex(1);
+    m_timeline = new QSlider(Qt::Horizontal, content);
+    m_timeline->setRange(0, kTimelineSteps);
+    playLayout->addWidget(m_playButton);
+    playLayout->addWidget(m_speedCombo);
+    playLayout->addWidget(m_timeline, 1);
+    layout->addLayout(playLayout);
+
+    m_statusLabel = new QLabel(content);
+    layout->addWidget(m_statusLabel);
+    layout->addStretch();
+
+    setWidget(content);
+
+    m_visualizer->setPacketReplay(m_replay);
+    m_replay->setSpeed(m_speedCombo->currentData().toDouble());
+
+    connect(m_openButton, &QPushButton::clicked, this, &PacketReplayPanel::openTrace);
+    connect(m_playButton, &QToolButton::clicked, this, [this]() {
+        if (m_replay->isPlaying()) {
+            m_replay->pause();
+        } else {
+            m_replay->play();
+        }
+    });
+    connect(m_speedCombo, QOverload<int>::of(&QComboBox::currentIndexChanged), this, [this]() {
+        m_replay->setSpeed(m_speedCombo->currentData().toDouble());
+    });
+    connect(m_timeline, &QSlider::valueChanged, this, [this](int value) {
+        if (BusTrace* trace = m_replay->trace()) {
+            qint64 span = trace->lastTick() - trace->firstTick();
+            m_replay->seek(trace->firstTick() + qint64(double(span) * value / kTimelineSteps));
+        }
+    });
+    connect(m_busCombo, QOverload<int>::of(&QComboBox::currentIndexChanged), this, [this]() {
+        m_replay->setBus(m_busCombo->currentData().value<HardwareModule*>());
+    });
+
+    connect(m_visualizer, &HardwareVisualizer::topologyChanged, this, &PacketReplayPanel::refreshBuses);
+    connect(m_replay, &PacketReplay::tickChanged, this, &PacketReplayPanel::updateTimeline);
+    connect(m_replay, &PacketReplay::stateChanged, this, &PacketReplayPanel::updateControls);
+    connect(m_replay, &PacketReplay::errorOccurred, this, [this](const QString &message) {
+        QMessageBox::warning(this, "Error", message);
+    });
+
+    refreshBuses();
+    updateControls();
+}
+
+PacketReplayPanel::~PacketReplayPanel()
+{
+    if (m_indexThread) {
+        m_indexThread->wait();
+        delete m_indexThread;
+        delete m_indexedTrace;
+    }
+}
+
+void PacketReplayPanel::openTrace()
+{
+    if (m_indexThread) return;
+
+    QString filename = QFileDialog::getOpenFileName(this, "打开数据包轨迹", QString(),
+                                                    "Trace Files (*.txt *.csv *.trace);;All Files (*)");
+    if (filename.isEmpty()) return;
+
+    // 索引需要扫描整个文件，在工作线程中完成，界面线程不会阻塞
+    m_replay->pause();
+    m_indexedTrace = new BusTrace;
+    m_indexOk = false;
+    m_indexError.clear();
+    m_openButton->setEnabled(false);
+    m_statusLabel->setText("正在建立索引: " + QFileInfo(filename).fileName());
+
+    BusTrace* trace = m_indexedTrace;
+    m_indexThread = QThread::create([this, trace, filename]() {
+        m_indexOk = trace->open(filename, &m_indexError);
+    });
+    connect(m_indexThread, &QThread::finished, this, &PacketReplayPanel::onIndexed);
+    m_indexThread->start();
+}
+
+void PacketReplayPanel::onIndexed()
+{
+    m_indexThread->wait();
+    delete m_indexThread;
+    m_indexThread = nullptr;
+    m_openButton->setEnabled(true);
+
+    std::unique_ptr<BusTrace> trace(m_indexedTrace);
+    m_indexedTrace = nullptr;
+    if (!m_indexOk) {
+        QMessageBox::warning(this, "Error", m_indexError);
+        updateControls();
+        return;
+    }
+
+    m_fileLabel->setText(QFileInfo(trace->fileName()).fileName());
+    m_replay->setTrace(std::move(trace));
+}
+
+void PacketReplayPanel::refreshBuses()
+{
+    QString current = m_busCombo->currentText();
+    {
+        QSignalBlocker blocker(m_busCombo);
+        m_busCombo->clear();
+        for (HardwareModule* bus : m_visualizer->topology().buses()) {
+            m_busCombo->addItem(bus->name(), QVariant::fromValue(bus));
+        }
+        int index = m_busCombo->findText(current);
+        m_busCombo->setCurrentIndex(index >= 0 ? index : 0);
+    }
+    m_replay->setBus(m_busCombo->currentData().value<HardwareModule*>());
+}
+
+void PacketReplayPanel::updateControls()
+{
+    const bool hasTrace = m_replay->trace() && m_replay->trace()->chunkCount() > 0;
+    m_playButton->setEnabled(hasTrace);
+    m_timeline->setEnabled(hasTrace);
+    m_playButton->setIcon(style()->standardIcon(m_replay->isPlaying() ? QStyle::SP_MediaPause : QStyle::SP_MediaPlay));
+    m_playButton->setToolTip(m_replay->isPlaying() ? "暂停" : "播放");
+    updateTimeline();
+}
+
+void PacketReplayPanel::updateTimeline()
+{
+    BusTrace* trace = m_replay->trace();
+    if (!trace) {
+        m_statusLabel->setText("轨迹格式：每行 源端口 目的端口 注入周期 到达周期，按注入周期排序");
+        return;
+    }
+
+    qint64 span = trace->lastTick() - trace->firstTick();
+    int value = span > 0 ? int(double(m_replay->currentTick() - trace->firstTick()) / span * kTimelineSteps) : 0;
+    {
+        QSignalBlocker blocker(m_timeline);
+        m_timeline->setValue(value);
+    }
+    m_statusLabel->setText(QString("周期 %L1 / %L2，在途 %L3 个数据包（共 %L4 个）")
+                               .arg(m_replay->currentTick())
+                               .arg(trace->lastTick())
+                               .arg(m_replay->inFlight().size())
+                               .arg(trace->packetCount()));
+}
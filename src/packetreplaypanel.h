@@ -0,0 +1,49 @@
+#ifndef PACKETREPLAYPANEL_H
+#define PACKETREPLAYPANEL_H
+
+#include <QDockWidget>
+#include <QComboBox>
+#include <QLabel>
+#include <QPushButton>
+#include <QSlider>
+#include <QToolButton>
+#include "packetreplay.h"
+#include "hardwarevisualizer.h"
+
+class QThread;
+
+// 数据包回放面板：打开总线轨迹文件（在工作线程中建立索引），选择总线，播放、暂停、调速与拖动时间线
+class PacketReplayPanel : public QDockWidget
+{
+    Q_OBJECT
+
+public:
+    explicit PacketReplayPanel(HardwareVisualizer* visualizer, QWidget *parent = nullptr);
+    ~PacketReplayPanel();
+
+private slots:
+    void openTrace();
+    void onIndexed();
+    void refreshBuses();
+    void updateControls();
+    void updateTimeline();
+
+private:
+    HardwareVisualizer* m_visualizer;
+    PacketReplay* m_replay;
+    QPushButton* m_openButton;
+    QComboBox* m_busCombo;
+    QLabel* m_fileLabel;
+    QToolButton* m_playButton;
+    QComboBox* m_speedCombo;
+    QSlider* m_timeline;
+    QLabel* m_statusLabel;
+
+    // 建立索引的工作线程与结果
+    QThread* m_indexThread;
+    BusTrace* m_indexedTrace;
+    bool m_indexOk;
+    QString m_indexError;
+};
+
+#endif // PACKETREPLAYPANEL_H
@@ -0,0 +1,118 @@
+// 性能回归检查：按规则文件比较基准与候选 statistic，有违规时返回非零，供 CI 使用
+// 用法: perfgate --rules 规则文件 --setup setup.txt 基准.statistic.txt 候选.statistic.txt
+//       perfgate --rules 规则文件 基准目录 候选目录 [--threads 线程数] [--verbose]
+// 目录按参数扫描的约定查找运行（子目录或成对的 <运行名>.setup.txt / <运行名>.statistic.txt），按运行名配对
+// 返回值: 0 全部通过，1 有违规，2 参数、规则或输入文件错误
+
+#include <QCoreApplication>
+#include <QCommandLineParser>
+#include <QFileInfo>
+#include <QTextStream>
+#include <QMap>
+#include <QVector>
+#include "regressiongate.h"
+#include "sweeploader.h"
+#include "workstealingpool.h"
+
+struct RunPair {
+    QString name;
+    QString setupFile;
+    QString baselineFile;
+    QString candidateFile;
+};
+
+int main(int argc, char *argv[])
+{
+    QCoreApplication app(argc, argv);
+
+    QCommandLineParser parser;
+    parser.setApplicationDescription("Performance regression gate for HardwareVisualizer statistics");
+    parser.addHelpOption();
+    parser.addPositionalArgument("baseline", "Baseline statistic file, or directory of baseline runs.");
+    parser.addPositionalArgument("candidate", "Candidate statistic file, or directory of candidate runs.");
+    QCommandLineOption rulesOption("rules", "Rules file.", "file");
+    QCommandLineOption setupOption("setup", "Setup file shared by both statistic files.", "file");
+    QCommandLineOption threadsOption("threads", "Worker threads, 0 for hardware concurrency.", "count", "0");
+    QCommandLineOption verboseOption("verbose", "Also list metrics that changed within their thresholds.");
+    parser.addOption(rulesOption);
+    parser.addOption(setupOption);
+    parser.addOption(threadsOption);
+    parser.addOption(verboseOption);
+    parser.process(app);
+
+    QTextStream out(stdout);
+    QTextStream err(stderr);
+    const QStringList positional = parser.positionalArguments();
+    if (positional.size() != 2 || !parser.isSet(rulesOption)) {
+        err << parser.helpText();
+        return 2;
+    }
+
+    RegressionRules rules;
+    QString error;
+    if (!rules.parseFile(parser.value(rulesOption), &error)) {
+        err << error << Qt::endl;
+        return 2;
+    }
+
+    // 两个文件共用 --setup；两个目录按运行名配对，各运行使用基准一侧的 setup
+    QVector<RunPair> pairs;
+    bool unmatched = false;
+    if (QFileInfo(positional[0]).isDir() && QFileInfo(positional[1]).isDir()) {
+        QMap<QString, SweepRun> candidates;
+        for (const SweepRun &run : SweepLoader::discoverRuns(positional[1])) {
+            candidates.insert(run.name, run);
+        }
+        for (const SweepRun &run : SweepLoader::discoverRuns(positional[0])) {
+            auto it = candidates.find(run.name);
+            if (it == candidates.end()) {
+                err << "No candidate run for baseline run " << run.name << Qt::endl;
+                unmatched = true;
+                continue;
+            }
+            pairs.append({run.name, run.setupFile, run.statisticFile, it->statisticFile});
+            candidates.erase(it);
+        }
+        for (const SweepRun &run : candidates) {
+            err << "No baseline run for candidate run " << run.name << Qt::endl;
+            unmatched = true;
+        }
+        if (pairs.isEmpty()) {
+            err << "No runs found in " << positional[0] << Qt::endl;
+            return 2;
+        }
+    } else {
+        if (!parser.isSet(setupOption)) {
+            err << "--setup is required when comparing two statistic files" << Qt::endl;
+            return 2;
+        }
+        pairs.append({QFileInfo(positional[1]).fileName(), parser.value(setupOption), positional[0], positional[1]});
+    }
+
+    // 每对运行独立解析与比较，结果按输入顺序输出
+    RegressionGate gate(rules);
+    QVector<RegressionReport> reports(pairs.size());
+    WorkStealingPool pool(parser.value(threadsOption).toInt());
+    pool.parallelFor(pairs.size(), 1, [&](int begin, int end) {
+        for (int i = begin; i < end; ++i) {
+            const RunPair &pair = pairs[i];
+            reports[i] = gate.compareFiles(pair.name, pair.setupFile, pair.baselineFile, pair.candidateFile);
+        }
+    });
+
+    const bool verbose = parser.isSet(verboseOption);
+    int failedRuns = 0;
+    int brokenRuns = 0;
+    for (const RegressionReport &report : reports) {
+        out << gate.format(report, verbose);
+        if (!report.error.isEmpty()) {
+            ++brokenRuns;
+        } else if (report.violations() > 0) {
+            ++failedRuns;
+        }
+    }
+    out << reports.size() << " runs, " << failedRuns << " failed, " << brokenRuns << " errors" << Qt::endl;
+
+    if (brokenRuns > 0 || unmatched) return 2;
+    return failedRuns > 0 ? 1 : 0;
+}
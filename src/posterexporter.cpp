@@ -0,0 +1,444 @@
+#include "posterexporter.h"
+#include "workstealingpool.h"
+#include <QGraphicsScene>
+#include <QPainter>
+#include <QSaveFile>
+#include <QFileInfo>
+#include <QDir>
+#include <QMutex>
+#include <QThread>
+#include <QtEndian>
+#include <QtMath>
+#include <algorithm>
+
+namespace {
+
+// 当前导出的编号，工作线程据此判断本线程缓存的场景记录是否过期
+std::atomic<int> g_exportGeneration(0);
+
+// 分块 TIFF 写入器：分块数据按完成顺序追加，IFD 与偏移表在最后写出并回填文件头
+class TiledTiffWriter
+{
+public:
+    TiledTiffWriter(QIODevice *device, bool bigTiff, int tileCount)
+        : m_device(device)
+        , m_bigTiff(bigTiff)
+        , m_position(0)
+        , m_offsets(tileCount)
+        , m_byteCounts(tileCount)
+    {
+    }
+
+    bool begin()
+    {
+        QByteArray header("II");
+        if (m_bigTiff) {
+            appendLittle<quint16>(header, 43);
+            appendLittle<quint16>(header, 8);
+            appendLittle<quint16>(header, 0);
+            appendLittle<quint64>(header, 0);
+        } else {
+            appendLittle<quint16>(header, 42);
+            appendLittle<quint32>(header, 0);
+        }
+        return write(header);
+    }
+
+    bool writeTile(int index, const QByteArray &data)
+    {
+        m_offsets[index] = m_position;
+        m_byteCounts[index] = data.size();
+        return write(data);
+    }
+
+    bool finish(quint32 width, quint32 height, quint32 tileSize)
+    {
+        enum { SHORT = 3, LONG = 4, LONG8 = 16 };
+        const quint16 arrayType = m_bigTiff ? quint16(LONG8) : quint16(LONG);
+
+        QByteArray offsets, byteCounts, bits;
+        for (int i = 0; i < m_offsets.size(); ++i) {
+            appendOffset(offsets, m_offsets[i]);
+            appendOffset(byteCounts, m_byteCounts[i]);
+        }
+        for (int i = 0; i < 3; ++i) {
+            appendLittle<quint16>(bits, 8);
+        }
+
+        // 标签按编号升序；放不进条目的值写在 IFD 之前
+        struct Entry {
+            quint16 tag;
+            quint16 type;
+            quint64 count;
+            QByteArray value;
+        };
+        const QVector<Entry> entries = {
+            {256, LONG, 1, little<quint32>(width)},         // ImageWidth
+            {257, LONG, 1, little<quint32>(height)},        // ImageLength
+            {258, SHORT, 3, bits},                          // BitsPerSample
+            {259, SHORT, 1, little<quint16>(8)},            // Compression: Deflate
+            {262, SHORT, 1, little<quint16>(2)},            // PhotometricInterpretation: RGB
+            {277, SHORT, 1, little<quint16>(3)},            // SamplesPerPixel
+            {284, SHORT, 1, little<quint16>(1)},            // PlanarConfiguration: 交错
+            {322, LONG, 1, little<quint32>(tileSize)},      // TileWidth
+            {323, LONG, 1, little<quint32>(tileSize)},      // TileLength
+            {324, arrayType, quint64(m_offsets.size()), offsets},      // TileOffsets
+            {325, arrayType, quint64(m_byteCounts.size()), byteCounts}, // TileByteCounts
+        };
+
+        const int inlineSize = m_bigTiff ? 8 : 4;
+        QByteArray trailer;
+        QVector<quint64> valueOffsets(entries.size());
+        for (int i = 0; i < entries.size(); ++i) {
+            if (entries[i].value.size() <= inlineSize) continue;
+            if ((m_position + trailer.size()) % 2) trailer.append('\0');
+            valueOffsets[i] = m_position + trailer.size();
+            trailer.append(entries[i].value);
+        }
+        if ((m_position + trailer.size()) % 2) trailer.append('\0');
+        const quint64 ifdOffset = m_position + trailer.size();
+
+        if (m_bigTiff) {
+            appendLittle<quint64>(trailer, entries.size());
+        } else {
+            appendLittle<quint16>(trailer, entries.size());
+        }
+        for (int i = 0; i < entries.size(); ++i) {
+            const Entry &entry = entries[i];
+            appendLittle<quint16>(trailer, entry.tag);
+            appendLittle<quint16>(trailer, entry.type);
+            if (entry.value.size() <= inlineSize) {
+                appendCount(trailer, entry.count);
+                trailer.append(entry.value);
+                trailer.append(QByteArray(inlineSize - entry.value.size(), '\0'));
+            } else {
+                appendCount(trailer, entry.count);
+                appendOffset(trailer, valueOffsets[i]);
+            }
+        }
+        appendOffset(trailer, 0);  // 没有下一个 IFD
+
+        if (!write(trailer)) return false;
+
+        // 回填文件头中的 IFD 偏移
+        QByteArray pointer;
+        appendOffset(pointer, ifdOffset);
+        return m_device->seek(m_bigTiff ? 8 : 4) && m_device->write(pointer) == pointer.size();
+    }
+
+private:
+    template <typename T>
+    static void appendLittle(QByteArray &data, T value)
+    {
+        T little = qToLittleEndian(value);
+        data.append(reinterpret_cast<const char*>(&little), sizeof(T));
+    }
+
+    template <typename T>
+    static QByteArray little(T value)
+    {
+        QByteArray data;
+        appendLittle<T>(data, value);
+        return data;
+    }
+
+    void appendOffset(QByteArray &data, quint64 value) const
+    {
+        if (m_bigTiff) {
+            appendLittle<quint64>(data, value);
+        } else {
+            appendLittle<quint32>(data, quint32(value));
+        }
+    }
+
+    void appendCount(QByteArray &data, quint64 value) const
+    {
+        appendOffset(data, value);
+    }
+
+    bool write(const QByteArray &data)
+    {
+        if (m_device->write(data) != data.size()) return false;
+        m_position += data.size();
+        return true;
+    }
+
+    QIODevice *m_device;
+    bool m_bigTiff;
+    quint64 m_position;
+    QVector<quint64> m_offsets;
+    QVector<quint64> m_byteCounts;
+};
+
+int ceilDiv(qint64 value, qint64 divisor)
+{
+    return int((value + divisor - 1) / divisor);
+}
+
+} // namespace
+
+PosterExporter::PosterExporter(QObject *parent)
+    : QObject(parent)
+    , m_scale(1.0)
+    , m_format(TIFF)
+    , m_thread(nullptr)
+    , m_cancelled(false)
+    , m_running(false)
+    , m_done(0)
+{
+}
+
+PosterExporter::~PosterExporter()
+{
+    cancel();
+    if (m_thread) {
+        m_thread->wait();
+        delete m_thread;
+    }
+}
+
+QSize PosterExporter::outputSize(const QRectF &sourceRect, double scale)
+{
+    return QSize(qCeil(sourceRect.width() * scale), qCeil(sourceRect.height() * scale));
+}
+
+bool PosterExporter::start(QGraphicsScene *scene, const QRectF &sourceRect, const QBrush &background, double scale,
+                           const QString &filename, Format format, QString *error)
+{
+    if (m_running) {
+        if (error) *error = "An export is already running";
+        return false;
+    }
+    const QSize size = outputSize(sourceRect, scale);
+    if (size.isEmpty() || size.width() > kMaxDimension || size.height() > kMaxDimension) {
+        if (error) *error = QString("Output size %1 x %2 is out of range").arg(size.width()).arg(size.height());
+        return false;
+    }
+    if (m_thread) {
+        m_thread->wait();
+        delete m_thread;
+        m_thread = nullptr;
+    }
+
+    // 场景只能在界面线程中访问，先记录为与分辨率无关的绘制指令
+    m_picture = QPicture();
+    QPainter painter(&m_picture);
+    painter.setRenderHints(QPainter::Antialiasing | QPainter::TextAntialiasing | QPainter::SmoothPixmapTransform);
+    painter.translate(-sourceRect.topLeft());
+    painter.fillRect(sourceRect, background);
+    painter.resetTransform();
+    scene->render(&painter, QRectF(QPointF(0, 0), sourceRect.size()), sourceRect);
+    painter.end();
+
+    m_sourceRect = sourceRect;
+    m_scale = scale;
+    m_size = size;
+    m_filename = filename;
+    m_format = format;
+    ++g_exportGeneration;
+
+    if (!m_pool) {
+        m_pool = std::make_unique<WorkStealingPool>();
+    }
+    m_cancelled = false;
+    m_running = true;
+    m_done = 0;
+
+    m_thread = QThread::create([this]() { run(); });
+    m_thread->start();
+    return true;
+}
+
+void PosterExporter::cancel()
+{
+    m_cancelled = true;
+}
+
+void PosterExporter::run()
+{
+    QString error;
+    bool ok = m_format == TILE_PYRAMID ? writePyramid(&error) : writeTiff(&error);
+    if (!ok && m_cancelled) {
+        error.clear();
+    }
+    m_running = false;
+    emit finished(ok, error);
+}
+
+QImage PosterExporter::renderTile(const QRect &pixelRect, double scale) const
+{
+    // QPicture 回放时会移动内部读取位置，每个线程使用自己的深拷贝
+    thread_local QPicture picture;
+    thread_local int generation = -1;
+    if (generation != g_exportGeneration) {
+        picture = m_picture;
+        picture.detach();
+        generation = g_exportGeneration;
+    }
+
+    QImage image(kTileSize, kTileSize, QImage::Format_ARGB32_Premultiplied);
+    image.fill(Qt::transparent);
+    QPainter painter(&image);
+    painter.setRenderHints(QPainter::Antialiasing | QPainter::TextAntialiasing | QPainter::SmoothPixmapTransform);
+    painter.setClipRect(QRect(0, 0, kTileSize, kTileSize));
+    painter.translate(-pixelRect.topLeft());
+    painter.scale(scale, scale);
+    picture.play(&painter);
+    painter.end();
+    return image;
+}
+
+void PosterExporter::reportTile(int total)
+{
+    int done = ++m_done;
+    if (done % 16 == 0 || done == total) {
+        emit progress(done, total);
+    }
+}
+
+bool PosterExporter::writeTiff(QString *error)
+{
+    const int across = ceilDiv(m_size.width(), kTileSize);
+    const int down = ceilDiv(m_size.height(), kTileSize);
+    const int total = across * down;
+    const qint64 tileBytes = qint64(kTileSize) * kTileSize * 3;
+    // Deflate 对不可压缩数据只有很小的膨胀，按未压缩大小判断是否需要 64 位偏移
+    const bool bigTiff = tileBytes * total > 0xF0000000LL;
+
+    QSaveFile file(m_filename);
+    if (!file.open(QIODevice::WriteOnly)) {
+        if (error) *error = "Cannot open export file: " + m_filename;
+        return false;
+    }
+    TiledTiffWriter writer(&file, bigTiff, total);
+    if (!writer.begin()) {
+        if (error) *error = file.errorString();
+        file.cancelWriting();
+        return false;
+    }
+
+    // 每批的分块并发渲染与压缩，压缩结果按顺序写出后再处理下一批
+    const int batchSize = (m_pool->threadCount() + 1) * 4;
+    QVector<QByteArray> results(batchSize);
+    for (int begin = 0; begin < total; begin += batchSize) {
+        if (m_cancelled) {
+            file.cancelWriting();
+            return false;
+        }
+
+        const int count = qMin(batchSize, total - begin);
+        m_pool->parallelFor(count, 1, [this, begin, across, total, &results](int first, int last) {
+            for (int i = first; i < last; ++i) {
+                const int index = begin + i;
+                QRect rect((index % across) * kTileSize, (index / across) * kTileSize, kTileSize, kTileSize);
+                QImage tile = renderTile(rect, m_scale).convertToFormat(QImage::Format_RGB888);
+                // qCompress 的结果为 4 字节长度前缀加 zlib 数据流，即 TIFF 的 Deflate 压缩
+                results[i] = qCompress(tile.constBits(), int(tile.sizeInBytes()), 6).mid(4);
+                reportTile(total);
+            }
+        });
+
+        for (int i = 0; i < count; ++i) {
+            if (!writer.writeTile(begin + i, results[i])) {
+                if (error) *error = file.errorString();
+                file.cancelWriting();
+                return false;
+            }
+            results[i].clear();
+        }
+    }
+
+    if (!writer.finish(m_size.width(), m_size.height(), kTileSize) || !file.commit()) {
+        if (error) *error = file.errorString();
+        return false;
+    }
+    return true;
+}
+
+bool PosterExporter::writePyramid(QString *error)
+{
+    QFileInfo info(m_filename);
+    const QString base = info.path() + "/" + info.completeBaseName();
+    const QString filesDir = base + "_files";
+
+    // 第 maxLevel 层为原始尺寸，每低一层缩小一半，直到 1 x 1
+    const int maxLevel = int(std::ceil(std::log2(double(qMax(m_size.width(), m_size.height())))));
+    struct Level {
+        int width;
+        int height;
+        int across;
+        int firstTile;
+    };
+    QVector<Level> levels;
+    int total = 0;
+    for (int level = 0; level <= maxLevel; ++level) {
+        qint64 divisor = qint64(1) << (maxLevel - level);
+        Level info;
+        info.width = ceilDiv(m_size.width(), divisor);
+        info.height = ceilDiv(m_size.height(), divisor);
+        info.across = ceilDiv(info.width, kTileSize);
+        info.firstTile = total;
+        total += info.across * ceilDiv(info.height, kTileSize);
+        levels.append(info);
+
+        if (!QDir().mkpath(QString("%1/%2").arg(filesDir).arg(level))) {
+            if (error) *error = "Cannot create directory: " + filesDir;
+            return false;
+        }
+    }
+
+    // 分块按下标在各层之间定位，不为每个分块保存任务描述
+    QMutex failureMutex;
+    QString failure;
+    const int batchSize = (m_pool->threadCount() + 1) * 16;
+    for (int begin = 0; begin < total && failure.isEmpty(); begin += batchSize) {
+        if (m_cancelled) return false;
+
+        const int count = qMin(batchSize, total - begin);
+        m_pool->parallelFor(count, 1, [&, begin](int first, int last) {
+            for (int i = first; i < last; ++i) {
+                const int index = begin + i;
+                auto levelIt = std::upper_bound(levels.begin(), levels.end(), index,
+                                                [](int value, const Level &level) { return value < level.firstTile; });
+                const int level = int(levelIt - levels.begin()) - 1;
+                const Level &info = levels[level];
+                const int column = (index - info.firstTile) % info.across;
+                const int row = (index - info.firstTile) / info.across;
+
+                QRect rect(column * kTileSize, row * kTileSize,
+                           qMin(kTileSize, info.width - column * kTileSize),
+                           qMin(kTileSize, info.height - row * kTileSize));
+                double scale = m_scale / double(qint64(1) << (maxLevel - level));
+                QImage tile = renderTile(rect, scale).copy(0, 0, rect.width(), rect.height());
+
+                QString path = QString("%1/%2/%3_%4.png").arg(filesDir).arg(level).arg(column).arg(row);
+                if (!tile.save(path, "PNG")) {
+                    QMutexLocker locker(&failureMutex);
+                    failure = "Cannot write tile: " + path;
+                }
+                reportTile(total);
+            }
+        });
+    }
+    if (!failure.isEmpty()) {
+        if (error) *error = failure;
+        return false;
+    }
+
+    QSaveFile descriptor(m_filename);
+    if (!descriptor.open(QIODevice::WriteOnly)) {
+        if (error) *error = "Cannot open export file: " + m_filename;
+        return false;
+    }
+    descriptor.write(QString("<?xml version=\"1.0\" encoding=\"UTF-8\"?>\n"
+                             "<Image xmlns=\"http://schemas.microsoft.com/deepzoom/2008\" Format=\"png\" "
+                             "Overlap=\"0\" TileSize=\"%1\">\n"
+                             "  <Size Width=\"%2\" Height=\"%3\"/>\n"
+                             "</Image>\n")
+                         .arg(kTileSize).arg(m_size.width()).arg(m_size.height()).toUtf8());
+    if (!descriptor.commit()) {
+        if (error) *error = descriptor.errorString();
+        return false;
+    }
+    return true;
+}
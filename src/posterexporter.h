@@ -0,0 +1,71 @@
+#ifndef POSTEREXPORTER_H
+#define POSTEREXPORTER_H
+
+#include <QObject>
+#include <QString>
+#include <QRectF>
+#include <QSize>
+#include <QBrush>
+#include <QPicture>
+#include <QImage>
+#include <atomic>
+#include <memory>
+
+class QGraphicsScene;
+class QThread;
+class WorkStealingPool;
+
+// 场景海报导出：在界面线程中将场景记录为绘制指令，随后在工作线程池中并发回放到各个分块，
+// 按批写出为分块 TIFF 或 Deep Zoom（.dzi）瓦片金字塔，内存占用只与分块大小和线程数有关
+class PosterExporter : public QObject
+{
+    Q_OBJECT
+
+public:
+    enum Format {
+        TIFF,           // 单个分块 TIFF，Deflate 压缩，超过 4GB 时使用 BigTIFF
+        TILE_PYRAMID    // <名称>.dzi 与 <名称>_files/<层级>/<列>_<行>.png
+    };
+
+    static const int kTileSize = 512;
+    static const int kMaxDimension = 1 << 20;
+
+    explicit PosterExporter(QObject *parent = nullptr);
+    ~PosterExporter();
+
+    // 记录场景 sourceRect 区域（先以 background 填充）并开始导出，输出尺寸为 sourceRect 乘以 scale
+    bool start(QGraphicsScene *scene, const QRectF &sourceRect, const QBrush &background, double scale,
+               const QString &filename, Format format, QString *error = nullptr);
+    void cancel();
+    bool isRunning() const { return m_running; }
+
+    static QSize outputSize(const QRectF &sourceRect, double scale);
+
+signals:
+    // 以下信号从协调线程或工作线程发出，跨线程连接时自动排队
+    void progress(int done, int total);
+    void finished(bool ok, const QString &error);   // 取消时 ok 为 false 且 error 为空
+
+private:
+    void run();
+    bool writeTiff(QString *error);
+    bool writePyramid(QString *error);
+    // 以 scale 回放场景记录，返回输出图像中 pixelRect 区域（kTileSize 大小的画布）
+    QImage renderTile(const QRect &pixelRect, double scale) const;
+    void reportTile(int total);
+
+    QPicture m_picture;      // 以 sourceRect 左上角为原点的场景绘制记录
+    QRectF m_sourceRect;
+    double m_scale;
+    QSize m_size;
+    QString m_filename;
+    Format m_format;
+
+    std::unique_ptr<WorkStealingPool> m_pool;
+    QThread *m_thread;       // 分批提交任务并写出结果的协调线程
+    std::atomic<bool> m_cancelled;
+    std::atomic<bool> m_running;
+    std::atomic<int> m_done;
+};
+
+#endif // POSTEREXPORTER_H
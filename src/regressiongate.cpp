@@ -0,0 +1,556 @@
+#include "regressiongate.h"
+#include "statkeyregistry.h"
+#include <QFile>
+#include <QMap>
+#include <QSet>
+#include <QVarLengthArray>
+#include <QtNumeric>
+#include <algorithm>
+
+// 递归下降解析器：expr := term (('+'|'-') term)*，term := unary (('*'|'/') unary)*，
+// unary := '-' unary | number | name | '(' expr ')'
+class ExpressionParser
+{
+public:
+    ExpressionParser(const QString &text, const QHash<QString, MetricExpression> &definitions,
+                     QVector<MetricExpression::Token> &program)
+        : m_text(text)
+        , m_pos(0)
+        , m_definitions(definitions)
+        , m_program(program)
+    {
+    }
+
+    bool parse(QString *error)
+    {
+        if (!parseExpression()) {
+            if (error) *error = m_error;
+            return false;
+        }
+        skipSpaces();
+        if (m_pos < m_text.size()) {
+            if (error) *error = QString("Unexpected '%1' at column %2").arg(m_text[m_pos]).arg(m_pos + 1);
+            return false;
+        }
+        return true;
+    }
+
+private:
+    using Token = MetricExpression::Token;
+
+    void skipSpaces()
+    {
+        while (m_pos < m_text.size() && m_text[m_pos].isSpace()) ++m_pos;
+    }
+
+    bool accept(QChar c)
+    {
+        skipSpaces();
+        if (m_pos < m_text.size() && m_text[m_pos] == c) {
+            ++m_pos;
+            return true;
+        }
+        return false;
+    }
+
+    bool fail(const QString &message)
+    {
+        m_error = QString("%1 at column %2").arg(message).arg(m_pos + 1);
+        return false;
+    }
+
+    bool parseExpression()
+    {
+        if (!parseTerm()) return false;
+        while (true) {
+            if (accept('+')) {
+                if (!parseTerm()) return false;
+                m_program.append({Token::ADD, 0.0, -1});
+            } else if (accept('-')) {
+                if (!parseTerm()) return false;
+                m_program.append({Token::SUB, 0.0, -1});
+            } else {
+                return true;
+            }
+        }
+    }
+
+    bool parseTerm()
+    {
+        if (!parseUnary()) return false;
+        while (true) {
+            if (accept('*')) {
+                if (!parseUnary()) return false;
+                m_program.append({Token::MUL, 0.0, -1});
+            } else if (accept('/')) {
+                if (!parseUnary()) return false;
+                m_program.append({Token::DIV, 0.0, -1});
+            } else {
+                return true;
+            }
+        }
+    }
+
+    bool parseUnary()
+    {
+        if (accept('-')) {
+            if (!parseUnary()) return false;
+            m_program.append({Token::NEG, 0.0, -1});
+            return true;
+        }
+        if (accept('(')) {
+            if (!parseExpression()) return false;
+            return accept(')') ? true : fail("Expected ')'");
+        }
+
+        skipSpaces();
+        const int start = m_pos;
+        if (m_pos < m_text.size() && (m_text[m_pos].isDigit() || m_text[m_pos] == '.')) {
+            while (m_pos < m_text.size() && (m_text[m_pos].isDigit() || m_text[m_pos] == '.' ||
+                   m_text[m_pos] == 'e' || m_text[m_pos] == 'E' ||
+                   ((m_text[m_pos] == '+' || m_text[m_pos] == '-') && m_pos > start &&
+                    (m_text[m_pos - 1] == 'e' || m_text[m_pos - 1] == 'E')))) {
+                ++m_pos;
+            }
+            bool ok = false;
+            const double value = m_text.mid(start, m_pos - start).toDouble(&ok);
+            if (!ok) return fail("Invalid number");
+            m_program.append({Token::NUMBER, value, -1});
+            return true;
+        }
+        if (m_pos < m_text.size() && (m_text[m_pos].isLetter() || m_text[m_pos] == '_')) {
+            while (m_pos < m_text.size() && (m_text[m_pos].isLetterOrNumber() || m_text[m_pos] == '_')) ++m_pos;
+            const QString name = m_text.mid(start, m_pos - start);
+            auto it = m_definitions.constFind(name);
+            if (it != m_definitions.constEnd()) {
+                m_program += it->m_program;
+            } else {
+                m_program.append({Token::KEY, 0.0, StatKeyRegistry::instance().intern(name)});
+            }
+            return true;
+        }
+        return fail(m_pos < m_text.size() ? "Unexpected character" : "Unexpected end of expression");
+    }
+
+    const QString &m_text;
+    int m_pos;
+    const QHash<QString, MetricExpression> &m_definitions;
+    QVector<MetricExpression::Token> &m_program;
+    QString m_error;
+};
+
+namespace {
+
+bool isIdentifier(const QString &name)
+{
+    static const QRegularExpression pattern("^[A-Za-z_][A-Za-z0-9_]*$");
+    return pattern.match(name).hasMatch();
+}
+
+// 模块的统计项与配置参数，统计项优先
+struct ModuleValues {
+    QString name;
+    QString typeName;
+    QHash<int, double> baseline;
+    QHash<int, double> candidate;
+};
+
+QString formatValue(double value)
+{
+    return qIsNaN(value) ? QString("-") : QString::number(value, 'g', 6);
+}
+
+QString formatChange(const RegressionRule &rule, double baseline, double candidate)
+{
+    if (qIsNaN(baseline) || qIsNaN(candidate)) {
+        return qIsNaN(candidate) ? QString("missing") : QString("new");
+    }
+    if (!rule.relative) {
+        const double delta = candidate - baseline;
+        return QString("%1%2").arg(delta >= 0 ? "+" : "").arg(QString::number(delta, 'g', 4));
+    }
+    if (baseline == 0.0) {
+        return candidate == 0.0 ? QString("+0.00%") : QString(candidate > 0 ? "+inf%" : "-inf%");
+    }
+    const double change = (candidate - baseline) / qAbs(baseline) * 100.0;
+    return QString("%1%2%").arg(change >= 0 ? "+" : "").arg(change, 0, 'f', 2);
+}
+
+} // namespace
+
+bool MetricExpression::parse(const QString &text, const QHash<QString, MetricExpression> &definitions,
+                             MetricExpression &expression, QString *error)
+{
+    expression.m_program.clear();
+    ExpressionParser parser(text, definitions, expression.m_program);
+    return parser.parse(error);
+}
+
+double MetricExpression::evaluate(const QHash<int, double> &values) const
+{
+    QVarLengthArray<double, 16> stack;
+    for (const Token &token : m_program) {
+        if (token.op == Token::NUMBER) {
+            stack.append(token.value);
+            continue;
+        }
+        if (token.op == Token::KEY) {
+            auto it = values.constFind(token.keyId);
+            if (it == values.constEnd()) return qQNaN();
+            stack.append(it.value());
+            continue;
+        }
+        if (token.op == Token::NEG) {
+            stack.last() = -stack.last();
+            continue;
+        }
+
+        const double right = stack.last();
+        stack.removeLast();
+        double &left = stack.last();
+        switch (token.op) {
+            case Token::ADD:
+                left += right;
+                break;
+            case Token::SUB:
+                left -= right;
+                break;
+            case Token::MUL:
+                left *= right;
+                break;
+            case Token::DIV:
+                if (right == 0.0) return qQNaN();
+                left /= right;
+                break;
+            default:
+                break;
+        }
+    }
+    return stack.isEmpty() ? qQNaN() : stack.last();
+}
+
+bool RegressionRules::parseFile(const QString &filename, QString *error)
+{
+    QFile file(filename);
+    if (!file.open(QIODevice::ReadOnly | QIODevice::Text)) {
+        if (error) {
+            *error = "Cannot open rules file: " + filename;
+        }
+        return false;
+    }
+
+    QTextStream in(&file);
+    if (!parse(in, error)) {
+        if (error) {
+            *error = filename + ":" + *error;
+        }
+        return false;
+    }
+    return true;
+}
+
+bool RegressionRules::parse(QTextStream &in, QString *error)
+{
+    m_rules.clear();
+    m_metrics.clear();
+
+    int lineNumber = 0;
+    auto fail = [&](const QString &message) {
+        if (error) {
+            *error = QString("%1: %2").arg(lineNumber).arg(message);
+        }
+        return false;
+    };
+
+    while (!in.atEnd()) {
+        QString line = in.readLine();
+        ++lineNumber;
+
+        int commentPos = line.indexOf("//");
+        if (commentPos != -1) {
+            line = line.left(commentPos);
+        }
+        line = line.trimmed();
+        if (line.isEmpty()) continue;
+
+        // define <名称> = <表达式>
+        if (line.startsWith("define ")) {
+            const int equals = line.indexOf('=');
+            if (equals < 0) return fail("Expected 'define <name> = <expression>'");
+            const QString name = line.mid(7, equals - 7).trimmed();
+            if (!isIdentifier(name)) return fail(QString("Invalid metric name '%1'").arg(name));
+
+            MetricExpression expression;
+            QString expressionError;
+            if (!MetricExpression::parse(line.mid(equals + 1), m_metrics, expression, &expressionError)) {
+                return fail(expressionError);
+            }
+            m_metrics.insert(name, expression);
+            continue;
+        }
+
+        // <指标> [per|total <范围>] rise|fall|within <阈值>[%]
+        const QStringList fields = line.split(QRegularExpression("\\s+"), Qt::SkipEmptyParts);
+        RegressionRule rule;
+        rule.metric = fields[0];
+        rule.line = lineNumber;
+        rule.text = fields.mid(1).join(' ');
+
+        int index = 1;
+        if (index < fields.size() && (fields[index] == "per" || fields[index] == "total")) {
+            if (index + 1 >= fields.size()) return fail("Expected module scope after '" + fields[index] + "'");
+            rule.total = fields[index] == "total";
+            rule.scope = fields[index + 1];
+            index += 2;
+        }
+        if (index + 2 != fields.size()) {
+            return fail("Expected '<metric> [per|total <scope>] rise|fall|within <threshold>[%]'");
+        }
+
+        const QString &check = fields[index];
+        if (check == "rise") {
+            rule.check = RegressionRule::RISE;
+        } else if (check == "fall") {
+            rule.check = RegressionRule::FALL;
+        } else if (check == "within") {
+            rule.check = RegressionRule::WITHIN;
+        } else {
+            return fail(QString("Unknown check '%1'").arg(check));
+        }
+
+        QString threshold = fields[index + 1];
+        rule.relative = threshold.endsWith('%');
+        if (rule.relative) threshold.chop(1);
+        bool ok = false;
+        rule.threshold = threshold.toDouble(&ok);
+        if (!ok || rule.threshold < 0) return fail(QString("Invalid threshold '%1'").arg(fields[index + 1]));
+        if (rule.relative) rule.threshold /= 100.0;
+
+        m_rules.append(rule);
+    }
+    return true;
+}
+
+int RegressionReport::violations() const
+{
+    return int(std::count_if(checks.begin(), checks.end(), [](const RegressionCheck &check) {
+        return check.violated;
+    }));
+}
+
+RegressionGate::RegressionGate(const RegressionRules &rules)
+    : m_rules(rules)
+{
+    for (const RegressionRule &rule : m_rules.rules()) {
+        CompiledRule compiled;
+        auto it = m_rules.metrics().constFind(rule.metric);
+        compiled.expression = it != m_rules.metrics().constEnd() ? &it.value() : nullptr;
+        const bool wildcard = rule.metric.contains('*') || rule.metric.contains('?');
+        compiled.keyId = !compiled.expression && !wildcard ? StatKeyRegistry::instance().intern(rule.metric) : -1;
+        if (!compiled.expression && wildcard) {
+            compiled.metricPattern.setPattern(QRegularExpression::wildcardToRegularExpression(rule.metric));
+            // 预先编译，工作线程中只做匹配
+            compiled.metricPattern.optimize();
+        }
+        if (!rule.scope.isEmpty()) {
+            compiled.scopePattern.setPattern(QRegularExpression::wildcardToRegularExpression(rule.scope));
+            compiled.scopePattern.optimize();
+        }
+        m_compiled.append(compiled);
+    }
+}
+
+bool RegressionGate::violates(const RegressionRule &rule, double baseline, double candidate) const
+{
+    // 基准中有、候选中缺失视为违规；候选中新出现的指标没有可比较的基准
+    if (qIsNaN(candidate)) return !qIsNaN(baseline);
+    if (qIsNaN(baseline)) return false;
+
+    double change = candidate - baseline;
+    if (rule.relative) {
+        if (baseline == 0.0) {
+            change = candidate == 0.0 ? 0.0 : (candidate > 0 ? qInf() : -qInf());
+        } else {
+            change /= qAbs(baseline);
+        }
+    }
+
+    switch (rule.check) {
+        case RegressionRule::RISE:
+            return change > rule.threshold;
+        case RegressionRule::FALL:
+            return change < -rule.threshold;
+        case RegressionRule::WITHIN:
+            return qAbs(change) > rule.threshold;
+        default:
+            return false;
+    }
+}
+
+RegressionReport RegressionGate::compare(const QString &run, const QVector<ModuleSetup> &setups,
+                                         const QVector<ModuleStatistics> &baseline,
+                                         const QVector<ModuleStatistics> &candidate) const
+{
+    RegressionReport report;
+    report.run = run;
+
+    // 按模块合并两次运行的统计项，配置参数只在统计项中没有同名项时补充
+    StatKeyRegistry &registry = StatKeyRegistry::instance();
+    QMap<QString, ModuleValues> modules;
+    auto collect = [&](const QVector<ModuleStatistics> &statistics, bool isBaseline) {
+        for (const ModuleStatistics &stats : statistics) {
+            ModuleValues &values = modules[stats.module];
+            QHash<int, double> &target = isBaseline ? values.baseline : values.candidate;
+            for (const auto &entry : stats.values) {
+                target.insert(entry.first, entry.second);
+            }
+        }
+    };
+    collect(baseline, true);
+    collect(candidate, false);
+
+    for (const ModuleSetup &setup : setups) {
+        auto it = modules.find(setup.name);
+        if (it == modules.end()) continue;
+        it->typeName = SetupParser::typeName(setup.type);
+        for (const auto &param : SetupParser::parameters(setup)) {
+            const int keyId = registry.intern(param.first);
+            if (!it->baseline.isEmpty() && !it->baseline.contains(keyId)) it->baseline.insert(keyId, param.second);
+            if (!it->candidate.isEmpty() && !it->candidate.contains(keyId)) it->candidate.insert(keyId, param.second);
+        }
+    }
+    for (auto it = modules.begin(); it != modules.end(); ++it) {
+        it->name = it.key();
+        HardwareModule::ModuleType type;
+        if (it->typeName.isEmpty() && SetupParser::moduleType(it->name, type)) {
+            it->typeName = SetupParser::typeName(type);
+        }
+    }
+
+    for (int ruleIndex = 0; ruleIndex < m_compiled.size(); ++ruleIndex) {
+        const RegressionRule &rule = m_rules.rules()[ruleIndex];
+        const CompiledRule &compiled = m_compiled[ruleIndex];
+
+        // 指标名 -> (基准和, 候选和)，只用于求和规则
+        QMap<QString, QPair<double, double>> totals;
+        auto accumulate = [](double &sum, double value) {
+            if (qIsNaN(value)) return;
+            sum = qIsNaN(sum) ? value : sum + value;
+        };
+        auto emitCheck = [&](const QString &module, const QString &metric, double base, double cand) {
+            if (rule.total) {
+                auto it = totals.find(metric);
+                if (it == totals.end()) it = totals.insert(metric, qMakePair(qQNaN(), qQNaN()));
+                accumulate(it->first, base);
+                accumulate(it->second, cand);
+                return;
+            }
+            report.checks.append({ruleIndex, module, metric, base, cand, violates(rule, base, cand)});
+        };
+
+        for (const ModuleValues &module : modules) {
+            if (!rule.scope.isEmpty() && !compiled.scopePattern.match(module.name).hasMatch() &&
+                !compiled.scopePattern.match(module.typeName).hasMatch()) {
+                continue;
+            }
+
+            if (compiled.expression) {
+                const double base = module.baseline.isEmpty() ? qQNaN() : compiled.expression->evaluate(module.baseline);
+                const double cand = module.candidate.isEmpty() ? qQNaN() : compiled.expression->evaluate(module.candidate);
+                if (!qIsNaN(base) || !qIsNaN(cand)) {
+                    emitCheck(module.name, rule.metric, base, cand);
+                }
+                continue;
+            }
+
+            if (compiled.keyId >= 0) {
+                const double base = module.baseline.value(compiled.keyId, qQNaN());
+                const double cand = module.candidate.value(compiled.keyId, qQNaN());
+                if (!qIsNaN(base) || !qIsNaN(cand)) {
+                    emitCheck(module.name, rule.metric, base, cand);
+                }
+                continue;
+            }
+
+            // 通配符按名称排序展开
+            QSet<int> keys;
+            for (auto it = module.baseline.constBegin(); it != module.baseline.constEnd(); ++it) keys.insert(it.key());
+            for (auto it = module.candidate.constBegin(); it != module.candidate.constEnd(); ++it) keys.insert(it.key());
+            QMap<QString, int> matched;
+            for (int keyId : keys) {
+                const QString name = registry.name(keyId);
+                if (compiled.metricPattern.match(name).hasMatch()) {
+                    matched.insert(name, keyId);
+                }
+            }
+            for (auto it = matched.constBegin(); it != matched.constEnd(); ++it) {
+                emitCheck(module.name, it.key(), module.baseline.value(it.value(), qQNaN()),
+                          module.candidate.value(it.value(), qQNaN()));
+            }
+        }
+
+        for (auto it = totals.constBegin(); it != totals.constEnd(); ++it) {
+            report.checks.append({ruleIndex, "total " + rule.scope, it.key(), it->first, it->second,
+                                  violates(rule, it->first, it->second)});
+        }
+    }
+
+    return report;
+}
+
+RegressionReport RegressionGate::compareFiles(const QString &run, const QString &setupFile,
+                                              const QString &baselineFile, const QString &candidateFile) const
+{
+    QVector<ModuleSetup> setups;
+    QVector<ModuleStatistics> baseline;
+    QVector<ModuleStatistics> candidate;
+    QString error;
+    if (!SetupParser::parseFile(setupFile, setups, &error) ||
+        !StatisticParser::parseFile(baselineFile, baseline, &error) ||
+        !StatisticParser::parseFile(candidateFile, candidate, &error)) {
+        RegressionReport report;
+        report.run = run;
+        report.error = error;
+        return report;
+    }
+    return compare(run, setups, baseline, candidate);
+}
+
+QString RegressionGate::format(const RegressionReport &report, bool verbose) const
+{
+    if (!report.error.isEmpty()) {
+        return QString("ERROR %1: %2\n").arg(report.run, report.error);
+    }
+
+    QVector<const RegressionCheck*> shown;
+    for (const RegressionCheck &check : report.checks) {
+        if (check.violated || (verbose && !(check.baseline == check.candidate))) {
+            shown.append(&check);
+        }
+    }
+
+    QString text;
+    QTextStream out(&text);
+    const int violations = report.violations();
+    out << (violations > 0 ? "FAIL " : "PASS ") << report.run << ": " << report.checks.size() << " checks, "
+        << violations << " violations\n";
+
+    int moduleWidth = 0;
+    int metricWidth = 0;
+    int valueWidth = 0;
+    for (const RegressionCheck *check : shown) {
+        moduleWidth = qMax(moduleWidth, int(check->module.size()));
+        metricWidth = qMax(metricWidth, int(check->metric.size()));
+        valueWidth = qMax(valueWidth, int(formatValue(check->baseline).size() + formatValue(check->candidate).size() + 4));
+    }
+    for (const RegressionCheck *check : shown) {
+        const RegressionRule &rule = m_rules.rules()[check->rule];
+        out << "  " << (check->violated ? "! " : "  ")
+            << check->module.leftJustified(moduleWidth) << "  "
+            << check->metric.leftJustified(metricWidth) << "  "
+            << (formatValue(check->baseline) + " -> " + formatValue(check->candidate)).leftJustified(valueWidth) << "  "
+            << formatChange(rule, check->baseline, check->candidate).rightJustified(9) << "  "
+            << "(line " << rule.line << ": " << rule.text << ")\n";
+    }
+    return text;
+}
@@ -0,0 +1,116 @@
+#ifndef REGRESSIONGATE_H
+#define REGRESSIONGATE_H
+
+#include <QString>
+#include <QStringList>
+#include <QVector>
+#include <QHash>
+#include <QTextStream>
+#include <QRegularExpression>
+#include "setupparser.h"
+#include "statisticparser.h"
+
+// 派生指标表达式：模块统计项与配置参数的四则运算，如 l2_miss_count / (l2_hit_count + l2_miss_count)
+// 解析时编译为后缀表达式，名称在解析时驻留为ID
+class MetricExpression
+{
+public:
+    // definitions 中的已定义指标可在表达式中引用，解析时展开
+    static bool parse(const QString &text, const QHash<QString, MetricExpression> &definitions,
+                      MetricExpression &expression, QString *error = nullptr);
+
+    // 任一操作数缺失或除以零时返回 NaN
+    double evaluate(const QHash<int, double> &values) const;
+
+private:
+    struct Token {
+        enum Op { NUMBER, KEY, ADD, SUB, MUL, DIV, NEG };
+        Op op;
+        double value;
+        int keyId;
+    };
+
+    QVector<Token> m_program;  // 后缀表达式
+
+    friend class ExpressionParser;
+};
+
+// 一条回归规则：<指标> [per|total <范围>] rise|fall|within <阈值>[%]
+struct RegressionRule {
+    enum Check { RISE, FALL, WITHIN };
+
+    QString metric;       // 统计项名（可含通配符）或派生指标名
+    QString scope;        // 模块类型前缀（如 L3Cache）或模块名通配符，空表示全部模块
+    bool total = false;   // 对范围内的模块求和后比较
+    Check check = WITHIN;
+    double threshold = 0.0;
+    bool relative = false;  // 阈值为百分比
+    int line = 0;
+    QString text;         // 规则原文，用于报告
+};
+
+// 回归规则文件：define 行定义派生指标，其余每行一条规则，// 之后为注释
+class RegressionRules
+{
+public:
+    bool parseFile(const QString &filename, QString *error = nullptr);
+    bool parse(QTextStream &in, QString *error = nullptr);
+
+    const QVector<RegressionRule>& rules() const { return m_rules; }
+    const QHash<QString, MetricExpression>& metrics() const { return m_metrics; }
+
+private:
+    QVector<RegressionRule> m_rules;
+    QHash<QString, MetricExpression> m_metrics;
+};
+
+// 一个指标在基准与候选运行中的比较结果
+struct RegressionCheck {
+    int rule;          // 规则下标
+    QString module;    // 求和规则为范围名
+    QString metric;
+    double baseline;   // 缺失时为 NaN
+    double candidate;
+    bool violated;
+};
+
+struct RegressionReport {
+    QString run;
+    QVector<RegressionCheck> checks;
+    QString error;     // 无法解析输入时非空
+
+    int violations() const;
+};
+
+// 回归检查：用同一个 setup 解释基准与候选 statistic，按规则逐条比较
+// 基准中存在而候选中缺失的指标视为违规，只在候选中出现的指标不检查
+class RegressionGate
+{
+public:
+    explicit RegressionGate(const RegressionRules &rules);
+
+    RegressionReport compare(const QString &run, const QVector<ModuleSetup> &setups,
+                             const QVector<ModuleStatistics> &baseline,
+                             const QVector<ModuleStatistics> &candidate) const;
+    // 解析文件后比较，可在工作线程中调用
+    RegressionReport compareFiles(const QString &run, const QString &setupFile,
+                                  const QString &baselineFile, const QString &candidateFile) const;
+
+    // 紧凑的差异文本：每条违规一行，verbose 时也列出数值变化但未违规的指标
+    QString format(const RegressionReport &report, bool verbose) const;
+
+private:
+    struct CompiledRule {
+        int keyId;                         // 不含通配符的统计项名，否则为 -1
+        QRegularExpression metricPattern;  // 统计项名通配符
+        const MetricExpression *expression;
+        QRegularExpression scopePattern;
+    };
+
+    bool violates(const RegressionRule &rule, double baseline, double candidate) const;
+
+    const RegressionRules &m_rules;
+    QVector<CompiledRule> m_compiled;
+};
+
+#endif // REGRESSIONGATE_H
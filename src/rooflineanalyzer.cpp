@@ -0,0 +1,162 @@
+#include "rooflineanalyzer.h"
+#include "statkeyregistry.h"
+#include "bottleneckanalyzer.h"
+#include "bustopology.h"
+
+RooflineAnalyzer::RooflineAnalyzer(QObject *parent)
+    : QObject(parent)
+    , m_tracer(nullptr)
+    , m_ticks(0.0)
+    , m_memoryFraction(1.0)
+{
+    auto &registry = StatKeyRegistry::instance();
+    m_totalTickKey = registry.intern("total_tick_processed");
+    m_instKey = registry.intern("finished_inst_count");
+    m_ldInstKey = registry.intern("ld_inst_cnt");
+    m_stInstKey = registry.intern("st_inst_cnt");
+    m_ldMemTickKey = registry.intern("ld_mem_tick_sum");
+    m_ldMissKey = registry.intern("ld_cache_miss_count");
+    m_stMissKey = registry.intern("st_cache_miss_count");
+    m_l2MissKey = registry.intern("l2_miss_count");
+    m_messageKey = registry.intern("message_precossed");
+    for (const char *eventClass : {"l1miss_l2miss_l3hit", "l1miss_l2miss_l3forward", "l1miss_l2miss_l3miss"}) {
+        m_l2MissCountKeys.append(registry.intern(QString("%1_cnt").arg(eventClass)));
+    }
+    m_l3MissCountKey = registry.intern("l1miss_l2miss_l3miss_cnt");
+
+    m_relevantKeys = {m_totalTickKey, m_instKey, m_ldInstKey, m_stInstKey, m_ldMemTickKey,
+                      m_ldMissKey, m_stMissKey, m_l2MissKey, m_messageKey};
+    for (int key : m_l2MissCountKeys) {
+        m_relevantKeys.insert(key);
+    }
+
+    m_timer.setSingleShot(true);
+    m_timer.setInterval(50);
+    connect(&m_timer, &QTimer::timeout, this, &RooflineAnalyzer::recompute);
+}
+
+void RooflineAnalyzer::addModule(HardwareModule* module)
+{
+    if (!module || m_modules.contains(module)) return;
+
+    m_modules.append(module);
+    if (module->type() == HardwareModule::CACHE_EVENT_TRACER) {
+        m_tracer = module;
+    } else if (module->type() == HardwareModule::CACHE_L2) {
+        m_l2ByIndex.insert(BusTopology::parseHardwareIndex(module->name()), module);
+    }
+
+    connect(module, &HardwareModule::statisticChanged,
+            this, &RooflineAnalyzer::onStatisticChanged);
+    m_timer.start();
+}
+
+void RooflineAnalyzer::removeModule(HardwareModule* module)
+{
+    if (!m_modules.removeOne(module)) return;
+
+    disconnect(module, nullptr, this, nullptr);
+    if (module == m_tracer) {
+        m_tracer = nullptr;
+    }
+    for (auto it = m_l2ByIndex.begin(); it != m_l2ByIndex.end(); ++it) {
+        if (it.value() == module) {
+            m_l2ByIndex.erase(it);
+            break;
+        }
+    }
+    m_timer.start();
+}
+
+void RooflineAnalyzer::clear()
+{
+    for (auto module : m_modules) {
+        disconnect(module, nullptr, this, nullptr);
+    }
+    m_modules.clear();
+    m_l2ByIndex.clear();
+    m_tracer = nullptr;
+    m_timer.stop();
+    recompute();
+}
+
+double RooflineAnalyzer::peakBandwidth() const
+{
+    double peak = 0.0;
+    for (const auto &node : m_memoryNodes) {
+        peak += node.peak;
+    }
+    return peak;
+}
+
+void RooflineAnalyzer::onStatisticChanged(int keyId, double oldValue, double newValue)
+{
+    Q_UNUSED(oldValue);
+    Q_UNUSED(newValue);
+
+    if (m_relevantKeys.contains(keyId) && !m_timer.isActive()) {
+        m_timer.start();
+    }
+}
+
+void RooflineAnalyzer::recompute()
+{
+    const int lineBytes = BottleneckAnalyzer::kCacheLineBytes;
+
+    m_ticks = 0.0;
+    for (auto module : m_modules) {
+        if (module->type() == HardwareModule::CPU_CORE) {
+            m_ticks = qMax(m_ticks, module->statistic(m_totalTickKey));
+        }
+    }
+
+    m_memoryFraction = 1.0;
+    if (m_tracer) {
+        double l2Misses = 0.0;
+        for (int key : m_l2MissCountKeys) {
+            l2Misses += m_tracer->statistic(key);
+        }
+        if (l2Misses > 0) {
+            m_memoryFraction = m_tracer->statistic(m_l3MissCountKey) / l2Misses;
+        }
+    }
+
+    m_memoryNodes.clear();
+    m_cores.clear();
+    for (auto module : m_modules) {
+        if (module->type() == HardwareModule::MEMORY_CTRL) {
+            MemoryNode node;
+            node.module = module;
+            node.dataWidth = module->memoryDataWidth();
+            node.messages = module->statistic(m_messageKey);
+            node.bytes = node.messages * lineBytes;
+            node.achieved = m_ticks > 0 ? node.bytes / m_ticks : 0.0;
+            node.peak = node.dataWidth / 8.0;
+            node.utilization = node.peak > 0 ? node.achieved / node.peak : 0.0;
+            m_memoryNodes.append(node);
+        } else if (module->type() == HardwareModule::CPU_CORE) {
+            CorePoint core;
+            core.module = module;
+            core.instructions = module->statistic(m_instKey);
+            core.memoryInstructions = module->statistic(m_ldInstKey) + module->statistic(m_stInstKey);
+            core.ticks = module->statistic(m_totalTickKey);
+
+            // 内存流量：同编号 L2 的未命中中访问内存的部分；没有 L2 统计时退化为 L1 未命中
+            HardwareModule* l2 = m_l2ByIndex.value(BusTopology::parseHardwareIndex(module->name()));
+            if (l2 && l2->hasStatistic(m_l2MissKey)) {
+                core.dramBytes = l2->statistic(m_l2MissKey) * m_memoryFraction * lineBytes;
+            } else {
+                core.dramBytes = (module->statistic(m_ldMissKey) + module->statistic(m_stMissKey)) * lineBytes;
+            }
+
+            core.ipc = core.ticks > 0 ? core.instructions / core.ticks : 0.0;
+            core.intensity = core.dramBytes > 0 ? core.instructions / core.dramBytes : 0.0;
+            core.memoryIntensity = core.instructions > 0 ? core.memoryInstructions / core.instructions : 0.0;
+            double loads = module->statistic(m_ldInstKey);
+            core.loadLatency = loads > 0 ? module->statistic(m_ldMemTickKey) / loads : 0.0;
+            m_cores.append(core);
+        }
+    }
+
+    emit changed();
+}
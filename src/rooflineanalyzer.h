@@ -0,0 +1,89 @@
+#ifndef ROOFLINEANALYZER_H
+#define ROOFLINEANALYZER_H
+
+#include <QObject>
+#include <QVector>
+#include <QHash>
+#include <QSet>
+#include <QTimer>
+#include "hardwaremodule.h"
+
+// 内存带宽与 Roofline 分析：
+// 内存节点按 data_width 计算峰值带宽、按 message_precossed 计算实际带宽（字节/周期），
+// 每个核心按指令数与访问内存的字节数计算访存强度与算术强度
+class RooflineAnalyzer : public QObject
+{
+    Q_OBJECT
+
+public:
+    struct MemoryNode {
+        HardwareModule* module;
+        int dataWidth;       // 位宽（bit）
+        double messages;     // 处理的访问次数
+        double bytes;        // 传输字节数（访问次数 × 缓存行大小）
+        double achieved;     // 实际带宽（字节/周期）
+        double peak;         // 峰值带宽（字节/周期）
+        double utilization;  // achieved / peak
+    };
+
+    struct CorePoint {
+        HardwareModule* module;
+        double instructions;        // 完成的指令数
+        double memoryInstructions;  // LOAD + STORE 指令数
+        double dramBytes;           // 估算的内存访问字节数
+        double ticks;               // 运行周期数
+        double ipc;                 // 每周期指令数
+        double intensity;           // 算术强度：指令数 / 内存访问字节数
+        double memoryIntensity;     // 访存强度：访存指令数 / 指令数
+        double loadLatency;         // LOAD 指令平均消耗周期
+    };
+
+    explicit RooflineAnalyzer(QObject *parent = nullptr);
+
+    void addModule(HardwareModule* module);
+    void removeModule(HardwareModule* module);
+    void clear();
+
+    const QVector<MemoryNode>& memoryNodes() const { return m_memoryNodes; }
+    const QVector<CorePoint>& cores() const { return m_cores; }
+    // 仿真总周期数（各处理器 total_tick_processed 的最大值）
+    double simulationTicks() const { return m_ticks; }
+    // 所有内存节点峰值带宽之和（字节/周期）
+    double peakBandwidth() const;
+    // L2 未命中中最终访问内存的比例（来自 cache_event_trace，缺省为1）
+    double memoryFraction() const { return m_memoryFraction; }
+
+signals:
+    void changed();
+
+private slots:
+    void onStatisticChanged(int keyId, double oldValue, double newValue);
+    void recompute();
+
+private:
+    QVector<HardwareModule*> m_modules;
+    QHash<int, HardwareModule*> m_l2ByIndex;  // 编号 -> L2 缓存，用于估算核心的内存流量
+    HardwareModule* m_tracer;
+    QTimer m_timer;
+
+    QVector<MemoryNode> m_memoryNodes;
+    QVector<CorePoint> m_cores;
+    double m_ticks;
+    double m_memoryFraction;
+
+    // 参与计算的统计项驻留ID
+    QSet<int> m_relevantKeys;
+    int m_totalTickKey;
+    int m_instKey;
+    int m_ldInstKey;
+    int m_stInstKey;
+    int m_ldMemTickKey;
+    int m_ldMissKey;
+    int m_stMissKey;
+    int m_l2MissKey;
+    int m_messageKey;
+    QVector<int> m_l2MissCountKeys;
+    int m_l3MissCountKey;
+};
+
+#endif // ROOFLINEANALYZER_H
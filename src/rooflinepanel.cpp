@@ -0,0 +1,306 @@
+#include "rooflinepanel.h"
+#include <QVBoxLayout>
+#include <QHBoxLayout>
+#include <QHeaderView>
+#include <QPainter>
+#include <QPainterPath>
+#include <QHelpEvent>
+#include <QToolTip>
+#include <QtMath>
+
+namespace {
+
+// 按 UserRole 中的数值排序的表格项
+class NumericItem : public QTableWidgetItem
+{
+public:
+    NumericItem(const QString &text, double value)
+        : QTableWidgetItem(text)
+    {
+        setData(Qt::UserRole, value);
+        setTextAlignment(Qt::AlignRight | Qt::AlignVCenter);
+    }
+
+    bool operator<(const QTableWidgetItem &other) const override
+    {
+        return data(Qt::UserRole).toDouble() < other.data(Qt::UserRole).toDouble();
+    }
+};
+
+// 取包含 [lo, hi] 的整十倍区间
+QPair<double, double> decadeRange(double lo, double hi)
+{
+    double low = qFloor(std::log10(lo));
+    double high = qCeil(std::log10(hi));
+    if (high <= low) {
+        high = low + 1;
+    }
+    return qMakePair(qPow(10.0, low), qPow(10.0, high));
+}
+
+// 核心在平均分到的带宽下是否受带宽限制
+bool isBandwidthBound(const RooflineAnalyzer::CorePoint &core, double bandwidthPerCore, double peakIpc)
+{
+    return bandwidthPerCore > 0 && core.intensity * bandwidthPerCore < peakIpc;
+}
+
+} // namespace
+
+RooflinePlot::RooflinePlot(QWidget *parent)
+    : QWidget(parent)
+    , m_peakBandwidth(0.0)
+    , m_peakIpc(1.0)
+{
+    setMinimumHeight(220);
+}
+
+void RooflinePlot::setData(const QVector<RooflineAnalyzer::CorePoint> &cores, double peakBandwidth, double peakIpc)
+{
+    m_cores = cores;
+    m_peakBandwidth = peakBandwidth;
+    m_peakIpc = peakIpc;
+    update();
+}
+
+void RooflinePlot::paintEvent(QPaintEvent *event)
+{
+    Q_UNUSED(event);
+
+    QPainter painter(this);
+    painter.setRenderHint(QPainter::Antialiasing);
+    painter.fillRect(rect(), palette().color(QPalette::Base));
+    m_hitRects.clear();
+
+    const int coreCount = m_cores.size();
+    const double perCoreBandwidth = coreCount > 0 ? m_peakBandwidth / coreCount : m_peakBandwidth;
+
+    double xLo = 0.0, xHi = 0.0, yLo = 0.0, yHi = m_peakIpc;
+    auto extendX = [&xLo, &xHi](double x) {
+        if (x <= 0) return;
+        xLo = xLo > 0 ? qMin(xLo, x) : x;
+        xHi = qMax(xHi, x);
+    };
+    for (const auto &core : m_cores) {
+        extendX(core.intensity);
+        if (core.ipc > 0) {
+            yLo = yLo > 0 ? qMin(yLo, core.ipc) : core.ipc;
+            yHi = qMax(yHi, core.ipc);
+        }
+    }
+    if (m_peakBandwidth > 0) {
+        extendX(m_peakIpc / m_peakBandwidth);
+        extendX(m_peakIpc / perCoreBandwidth);
+    }
+
+    if (xLo <= 0 || yLo <= 0 || m_peakBandwidth <= 0) {
+        painter.setPen(palette().color(QPalette::Text));
+        painter.drawText(rect(), Qt::AlignCenter, "没有足够的内存或处理器统计数据");
+        return;
+    }
+
+    auto xRange = decadeRange(xLo, xHi);
+    auto yRange = decadeRange(yLo, yHi * 1.05);
+    const QRectF area = QRectF(rect()).adjusted(56, 12, -16, -40);
+    auto mapX = [&](double x) {
+        return area.left() + (std::log10(x) - std::log10(xRange.first))
+            / (std::log10(xRange.second) - std::log10(xRange.first)) * area.width();
+    };
+    auto mapY = [&](double y) {
+        y = qBound(yRange.first, y, yRange.second);
+        return area.bottom() - (std::log10(y) - std::log10(yRange.first))
+            / (std::log10(yRange.second) - std::log10(yRange.first)) * area.height();
+    };
+
+    // 十倍刻度网格
+    QPen gridPen(palette().color(QPalette::Mid), 1, Qt::DotLine);
+    painter.setFont(font());
+    for (double x = xRange.first; x <= xRange.second * 1.001; x *= 10) {
+        painter.setPen(gridPen);
+        painter.drawLine(QPointF(mapX(x), area.top()), QPointF(mapX(x), area.bottom()));
+        painter.setPen(palette().color(QPalette::Text));
+        painter.drawText(QRectF(mapX(x) - 30, area.bottom() + 2, 60, 16), Qt::AlignCenter, QString::number(x, 'g', 3));
+    }
+    for (double y = yRange.first; y <= yRange.second * 1.001; y *= 10) {
+        painter.setPen(gridPen);
+        painter.drawLine(QPointF(area.left(), mapY(y)), QPointF(area.right(), mapY(y)));
+        painter.setPen(palette().color(QPalette::Text));
+        painter.drawText(QRectF(0, mapY(y) - 8, area.left() - 4, 16), Qt::AlignRight | Qt::AlignVCenter, QString::number(y, 'g', 3));
+    }
+    painter.drawRect(area);
+    painter.drawText(QRectF(area.left(), area.bottom() + 18, area.width(), 18), Qt::AlignCenter, "算术强度（指令/字节）");
+    painter.save();
+    painter.translate(12, area.center().y());
+    painter.rotate(-90);
+    painter.drawText(QRectF(-area.height() / 2, -10, area.height(), 20), Qt::AlignCenter, "IPC");
+    painter.restore();
+
+    // 屋顶：min(峰值IPC, 带宽 × 强度)，斜线段在双对数坐标中为直线
+    auto drawRoof = [&](double bandwidth, const QPen &pen, const QString &label) {
+        double ridge = m_peakIpc / bandwidth;
+        QPainterPath path;
+        path.moveTo(mapX(xRange.first), mapY(bandwidth * xRange.first));
+        if (ridge > xRange.first && ridge < xRange.second) {
+            path.lineTo(mapX(ridge), mapY(m_peakIpc));
+        }
+        path.lineTo(mapX(xRange.second), mapY(qMin(m_peakIpc, bandwidth * xRange.second)));
+        painter.setPen(pen);
+        painter.drawPath(path);
+        if (ridge > xRange.first && ridge < xRange.second) {
+            painter.drawText(QPointF(mapX(ridge) + 4, mapY(m_peakIpc) + 14), label);
+        }
+    };
+    drawRoof(m_peakBandwidth, QPen(QColor(255, 140, 0), 2), "DRAM 峰值");
+    if (coreCount > 1) {
+        drawRoof(perCoreBandwidth, QPen(QColor(255, 140, 0), 1.5, Qt::DashLine), "每核心带宽");
+    }
+
+    for (const auto &core : m_cores) {
+        if (core.intensity <= 0 || core.ipc <= 0) continue;
+
+        QPointF point(mapX(core.intensity), mapY(core.ipc));
+        bool bandwidthBound = isBandwidthBound(core, perCoreBandwidth, m_peakIpc);
+        QColor color = bandwidthBound ? QColor(220, 20, 60) : QColor(60, 179, 113);
+        painter.setPen(QPen(color.darker(130), 1));
+        painter.setBrush(color);
+        painter.drawEllipse(point, 4.5, 4.5);
+        painter.setPen(palette().color(QPalette::Text));
+        painter.drawText(point + QPointF(6, -4), core.module->name());
+
+        m_hitRects.append(qMakePair(QRectF(point - QPointF(6, 6), QSizeF(12, 12)),
+            QString("%1\nIPC: %2\n强度: %3 指令/字节\n%4")
+                .arg(core.module->name()).arg(core.ipc, 0, 'f', 3).arg(core.intensity, 0, 'f', 3)
+                .arg(bandwidthBound ? "受带宽限制" : "受计算限制")));
+    }
+    painter.setBrush(Qt::NoBrush);
+}
+
+bool RooflinePlot::event(QEvent *event)
+{
+    if (event->type() == QEvent::ToolTip) {
+        auto helpEvent = static_cast<QHelpEvent*>(event);
+        for (const auto &hit : m_hitRects) {
+            if (hit.first.contains(helpEvent->pos())) {
+                QToolTip::showText(helpEvent->globalPos(), hit.second, this);
+                return true;
+            }
+        }
+        QToolTip::hideText();
+        event->ignore();
+        return true;
+    }
+    return QWidget::event(event);
+}
+
+RooflinePanel::RooflinePanel(RooflineAnalyzer* analyzer, QWidget *parent)
+    : QDockWidget("带宽与Roofline", parent)
+    , m_analyzer(analyzer)
+{
+    QWidget* content = new QWidget(this);
+    QVBoxLayout* layout = new QVBoxLayout(content);
+    layout->setContentsMargins(4, 4, 4, 4);
+
+    QHBoxLayout* optionLayout = new QHBoxLayout;
+    m_peakIpc = new QDoubleSpinBox(content);
+    m_peakIpc->setRange(0.1, 16.0);
+    m_peakIpc->setSingleStep(0.5);
+    m_peakIpc->setValue(1.0);
+    m_clockGhz = new QDoubleSpinBox(content);
+    m_clockGhz->setRange(0.1, 10.0);
+    m_clockGhz->setSingleStep(0.1);
+    m_clockGhz->setValue(1.0);
+    optionLayout->addWidget(new QLabel("峰值 IPC", content));
+    optionLayout->addWidget(m_peakIpc);
+    optionLayout->addWidget(new QLabel("主频 (GHz)", content));
+    optionLayout->addWidget(m_clockGhz);
+    optionLayout->addStretch();
+    layout->addLayout(optionLayout);
+
+    m_summary = new QLabel(content);
+    m_summary->setWordWrap(true);
+    layout->addWidget(m_summary);
+
+    m_memoryTable = new QTableWidget(0, 7, content);
+    m_memoryTable->setHorizontalHeaderLabels({"Memory Node", "Width (bit)", "Messages", "Achieved (B/cyc)",
+                                              "Achieved (GB/s)", "Peak (GB/s)", "Utilization"});
+    m_memoryTable->horizontalHeader()->setSectionResizeMode(0, QHeaderView::Stretch);
+    m_memoryTable->verticalHeader()->setVisible(false);
+    m_memoryTable->setEditTriggers(QAbstractItemView::NoEditTriggers);
+    m_memoryTable->setSortingEnabled(true);
+    m_memoryTable->setMaximumHeight(140);
+    layout->addWidget(m_memoryTable);
+
+    m_plot = new RooflinePlot(content);
+    layout->addWidget(m_plot, 1);
+
+    m_coreTable = new QTableWidget(0, 7, content);
+    m_coreTable->setHorizontalHeaderLabels({"Core", "IPC", "Inst/Byte", "Mem Inst %", "DRAM Bytes",
+                                            "Load Latency", "Bound"});
+    m_coreTable->horizontalHeader()->setSectionResizeMode(0, QHeaderView::Stretch);
+    m_coreTable->verticalHeader()->setVisible(false);
+    m_coreTable->setEditTriggers(QAbstractItemView::NoEditTriggers);
+    m_coreTable->setSortingEnabled(true);
+    layout->addWidget(m_coreTable);
+
+    setWidget(content);
+
+    connect(m_analyzer, &RooflineAnalyzer::changed, this, &RooflinePanel::refresh);
+    connect(m_peakIpc, QOverload<double>::of(&QDoubleSpinBox::valueChanged), this, &RooflinePanel::refresh);
+    connect(m_clockGhz, QOverload<double>::of(&QDoubleSpinBox::valueChanged), this, &RooflinePanel::refresh);
+    refresh();
+}
+
+void RooflinePanel::refresh()
+{
+    const double clockGhz = m_clockGhz->value();
+    const double peakIpc = m_peakIpc->value();
+    const double peakBandwidth = m_analyzer->peakBandwidth();
+    const auto &nodes = m_analyzer->memoryNodes();
+    const auto &cores = m_analyzer->cores();
+
+    m_memoryTable->setSortingEnabled(false);
+    m_memoryTable->setRowCount(nodes.size());
+    double achievedTotal = 0.0;
+    for (int row = 0; row < nodes.size(); ++row) {
+        const auto &node = nodes[row];
+        achievedTotal += node.achieved;
+        m_memoryTable->setItem(row, 0, new QTableWidgetItem(node.module->name()));
+        m_memoryTable->setItem(row, 1, new NumericItem(QString::number(node.dataWidth), node.dataWidth));
+        m_memoryTable->setItem(row, 2, new NumericItem(QString::number(qint64(node.messages)), node.messages));
+        m_memoryTable->setItem(row, 3, new NumericItem(QString::number(node.achieved, 'f', 3), node.achieved));
+        m_memoryTable->setItem(row, 4, new NumericItem(QString::number(node.achieved * clockGhz, 'f', 2), node.achieved));
+        m_memoryTable->setItem(row, 5, new NumericItem(QString::number(node.peak * clockGhz, 'f', 2), node.peak));
+        m_memoryTable->setItem(row, 6, new NumericItem(QString("%1%").arg(node.utilization * 100, 0, 'f', 1), node.utilization));
+    }
+    m_memoryTable->setSortingEnabled(true);
+
+    const double perCoreBandwidth = cores.isEmpty() ? peakBandwidth : peakBandwidth / cores.size();
+    int boundCount = 0;
+    m_coreTable->setSortingEnabled(false);
+    m_coreTable->setRowCount(cores.size());
+    for (int row = 0; row < cores.size(); ++row) {
+        const auto &core = cores[row];
+        bool bandwidthBound = isBandwidthBound(core, perCoreBandwidth, peakIpc);
+        if (bandwidthBound) ++boundCount;
+        m_coreTable->setItem(row, 0, new QTableWidgetItem(core.module->name()));
+        m_coreTable->setItem(row, 1, new NumericItem(QString::number(core.ipc, 'f', 3), core.ipc));
+        m_coreTable->setItem(row, 2, new NumericItem(QString::number(core.intensity, 'f', 3), core.intensity));
+        m_coreTable->setItem(row, 3, new NumericItem(QString("%1%").arg(core.memoryIntensity * 100, 0, 'f', 1), core.memoryIntensity));
+        m_coreTable->setItem(row, 4, new NumericItem(QString::number(qint64(core.dramBytes)), core.dramBytes));
+        m_coreTable->setItem(row, 5, new NumericItem(QString::number(core.loadLatency, 'f', 2), core.loadLatency));
+        m_coreTable->setItem(row, 6, new QTableWidgetItem(bandwidthBound ? "Bandwidth" : "Compute"));
+    }
+    m_coreTable->setSortingEnabled(true);
+
+    if (peakBandwidth > 0) {
+        m_summary->setText(QString("DRAM 峰值带宽 %1 GB/s，实际 %2 GB/s（%3%）；%4 个核心中 %5 个受带宽限制")
+            .arg(peakBandwidth * clockGhz, 0, 'f', 2)
+            .arg(achievedTotal * clockGhz, 0, 'f', 2)
+            .arg(achievedTotal / peakBandwidth * 100, 0, 'f', 1)
+            .arg(cores.size())
+            .arg(boundCount));
+    } else {
+        m_summary->setText("没有配置 data_width 的内存节点");
+    }
+
+    m_plot->setData(cores, peakBandwidth, peakIpc);
+}
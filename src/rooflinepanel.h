@@ -0,0 +1,57 @@
+#ifndef ROOFLINEPANEL_H
+#define ROOFLINEPANEL_H
+
+#include <QDockWidget>
+#include <QWidget>
+#include <QTableWidget>
+#include <QDoubleSpinBox>
+#include <QLabel>
+#include <QVector>
+#include <QPair>
+#include <QRectF>
+#include "rooflineanalyzer.h"
+
+// Roofline 图（双对数坐标）：横轴为算术强度（指令/字节），纵轴为 IPC，
+// 屋顶由峰值 IPC 与内存峰值带宽（整芯片及平均到每个核心）组成，每个核心一个点
+class RooflinePlot : public QWidget
+{
+public:
+    explicit RooflinePlot(QWidget *parent = nullptr);
+
+    void setData(const QVector<RooflineAnalyzer::CorePoint> &cores, double peakBandwidth, double peakIpc);
+
+    QSize sizeHint() const override { return QSize(420, 300); }
+
+protected:
+    void paintEvent(QPaintEvent *event) override;
+    bool event(QEvent *event) override;
+
+private:
+    QVector<RooflineAnalyzer::CorePoint> m_cores;
+    double m_peakBandwidth;
+    double m_peakIpc;
+    QVector<QPair<QRectF, QString>> m_hitRects;
+};
+
+// 带宽与 Roofline 面板：内存节点带宽表、Roofline 图与核心强度表
+class RooflinePanel : public QDockWidget
+{
+    Q_OBJECT
+
+public:
+    explicit RooflinePanel(RooflineAnalyzer* analyzer, QWidget *parent = nullptr);
+
+private slots:
+    void refresh();
+
+private:
+    RooflineAnalyzer* m_analyzer;
+    QDoubleSpinBox* m_peakIpc;
+    QDoubleSpinBox* m_clockGhz;
+    QTableWidget* m_memoryTable;
+    QTableWidget* m_coreTable;
+    RooflinePlot* m_plot;
+    QLabel* m_summary;
+};
+
+#endif // ROOFLINEPANEL_H
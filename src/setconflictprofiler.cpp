@@ -0,0 +1,198 @@
+#include "setconflictprofiler.h"
+#include "addresstrace.h"
+#include "workstealingpool.h"
+#include <algorithm>
+
+namespace {
+
+const int kIndexGrain = 1 << 16;  // 并行提取组下标时每段的访问数
+
+} // namespace
+
+SetConflictProfiler::SetConflictProfiler(const QVector<Level> &levels, int lineBytes)
+    : m_lineBits(0)
+{
+    while ((1 << (m_lineBits + 1)) <= lineBytes) ++m_lineBits;
+
+    for (const Level &level : levels) {
+        Cache cache;
+        cache.level = level;
+        Result result;
+        result.name = level.name;
+        if (level.setCount > 0 && level.wayCount > 0) {
+            cache.tags.fill(0, level.setCount * level.wayCount);
+            result.setCount = level.setCount;
+            result.wayCount = level.wayCount;
+            result.accesses.fill(0, level.setCount);
+            result.misses.fill(0, level.setCount);
+            result.conflicts.fill(0, level.setCount);
+        }
+        m_caches.append(cache);
+        m_results.append(result);
+    }
+}
+
+bool SetConflictProfiler::run(AddressTrace &trace, WorkStealingPool &pool, std::atomic<qint64> *processed,
+                              const std::atomic<bool> *cancel, QString *error)
+{
+    QVector<quint64> addresses;
+    QVector<quint8> kinds;
+    while (true) {
+        if (cancel && cancel->load()) {
+            if (error) *error = "Cancelled";
+            return false;
+        }
+        if (!trace.readBlock(addresses, kinds)) {
+            if (error) *error = trace.errorString();
+            return false;
+        }
+        if (addresses.isEmpty()) break;
+
+        for (int i = 0; i < m_caches.size(); ++i) {
+            processBlock(pool, m_caches[i], m_results[i], addresses, kinds);
+        }
+        if (processed) {
+            processed->fetch_add(addresses.size());
+        }
+    }
+
+    for (Result &result : m_results) {
+        result.totalAccesses = 0;
+        result.totalMisses = 0;
+        result.totalConflicts = 0;
+        for (int set = 0; set < result.setCount; ++set) {
+            result.totalAccesses += result.accesses[set];
+            result.totalMisses += result.misses[set];
+            result.totalConflicts += result.conflicts[set];
+        }
+    }
+    return true;
+}
+
+void SetConflictProfiler::processBlock(WorkStealingPool &pool, Cache &cache, Result &result,
+                                       const QVector<quint64> &addresses, const QVector<quint8> &kinds)
+{
+    const int count = addresses.size();
+    const Level &level = cache.level;
+    cache.input.resize(count);
+    cache.missed.resize(count);
+    quint8 *input = cache.input.data();
+    quint8 *missed = cache.missed.data();
+
+    // 输入：按类型筛选轨迹访问，或合并上一级的未命中
+    if (level.sources.isEmpty()) {
+        const quint8 *kind = kinds.constData();
+        for (int i = 0; i < count; ++i) {
+            input[i] = (level.kinds >> (kind[i] & 7)) & 1;
+        }
+    } else {
+        std::fill(input, input + count, quint8(0));
+        for (int source : level.sources) {
+            const quint8 *sourceMissed = m_caches[source].missed.constData();
+            for (int i = 0; i < count; ++i) {
+                input[i] |= sourceMissed[i];
+            }
+        }
+    }
+
+    // 没有几何配置的级别直接透传，下一级看到的是它的全部输入
+    if (result.setCount <= 0) {
+        std::copy(input, input + count, missed);
+        return;
+    }
+
+    // 组下标提取为逐元素无分支运算，便于编译器向量化
+    cache.sets.resize(count);
+    quint32 *sets = cache.sets.data();
+    const quint64 *address = addresses.constData();
+    const int lineBits = m_lineBits;
+    const quint32 setCount = quint32(level.setCount);
+    const bool powerOfTwo = (setCount & (setCount - 1)) == 0;
+
+    // 组按连续区间分给各线程，组 s 属于区间 s * partitions / setCount；
+    // 提取下标时顺便统计每段中各区间的访问数，之后按段顺序分桶，桶内保持轨迹顺序
+    const int partitions = std::min(int(setCount), pool.threadCount() + 1);
+    const int segments = (count + kIndexGrain - 1) / kIndexGrain;
+    QVector<int> offsets(segments * partitions, 0);
+    int *segmentOffsets = offsets.data();
+    auto partitionOf = [setCount, partitions](quint32 set) {
+        return int(quint64(set) * quint64(partitions) / setCount);
+    };
+    pool.parallelFor(count, kIndexGrain, [=](int begin, int end) {
+        if (powerOfTwo) {
+            const quint64 mask = setCount - 1;
+            for (int i = begin; i < end; ++i) {
+                sets[i] = quint32((address[i] >> lineBits) & mask);
+            }
+        } else {
+            for (int i = begin; i < end; ++i) {
+                sets[i] = quint32((address[i] >> lineBits) % setCount);
+            }
+        }
+        int *counts = segmentOffsets + (begin / kIndexGrain) * partitions;
+        for (int i = begin; i < end; ++i) {
+            if (input[i]) ++counts[partitionOf(sets[i])];
+        }
+    });
+
+    // 各段在每个桶中的起始位置：桶按区间排列，桶内按段顺序
+    QVector<int> bucketBegin(partitions + 1, 0);
+    int position = 0;
+    for (int p = 0; p < partitions; ++p) {
+        bucketBegin[p] = position;
+        for (int segment = 0; segment < segments; ++segment) {
+            const int segmentCount = segmentOffsets[segment * partitions + p];
+            segmentOffsets[segment * partitions + p] = position;
+            position += segmentCount;
+        }
+    }
+    bucketBegin[partitions] = position;
+
+    cache.order.resize(position);
+    int *order = cache.order.data();
+    pool.parallelFor(count, kIndexGrain, [=](int begin, int end) {
+        int *next = segmentOffsets + (begin / kIndexGrain) * partitions;
+        for (int i = begin; i < end; ++i) {
+            if (input[i]) order[next[partitionOf(sets[i])]++] = i;
+        }
+    });
+
+    // 每个线程只处理自己桶中的访问，组之间互不影响，总工作量与访问数成正比
+    const int ways = level.wayCount;
+    const int *bucket = bucketBegin.constData();
+    quint64 *tags = cache.tags.data();
+    quint64 *accesses = result.accesses.data();
+    quint64 *misses = result.misses.data();
+    quint64 *conflicts = result.conflicts.data();
+    pool.parallelFor(partitions, 1, [=](int first, int last) {
+        for (int k = bucket[first]; k < bucket[last]; ++k) {
+            const int i = order[k];
+            const quint32 set = sets[i];
+
+            // 标签为缓存行地址加一，0 表示无效行
+            const quint64 tag = (address[i] >> lineBits) + 1;
+            quint64 *line = tags + qint64(set) * ways;
+            ++accesses[set];
+            int way = 0;
+            while (way < ways && line[way] != tag) ++way;
+            if (way == ways) {
+                ++misses[set];
+                if (line[ways - 1] != 0) {
+                    ++conflicts[set];
+                }
+                way = ways - 1;
+                missed[i] = 1;
+            } else {
+                missed[i] = 0;
+            }
+            // 移到最近使用的位置
+            std::move_backward(line, line + way, line + way + 1);
+            line[0] = tag;
+        }
+    });
+
+    // 没有进入本级的访问不算未命中
+    for (int i = 0; i < count; ++i) {
+        missed[i] &= input[i];
+    }
+}
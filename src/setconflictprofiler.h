@@ -0,0 +1,67 @@
+#ifndef SETCONFLICTPROFILER_H
+#define SETCONFLICTPROFILER_H
+
+#include <QString>
+#include <QVector>
+#include <atomic>
+
+class AddressTrace;
+class WorkStealingPool;
+
+// 缓存组冲突分析：流式读取地址轨迹，按各级缓存的组数、路数与缓存行大小模拟 LRU 替换，
+// 统计每个组的访问、未命中与冲突（未命中时组已满而驱逐有效行）次数。
+// 下一级缓存的输入为上一级的未命中；每块轨迹先并行提取组下标并按组区间分桶，
+// 再由多个线程各自模拟一个区间，同一组的访问保持轨迹中的顺序。
+// 内存占用为各级缓存的标签阵列加一块轨迹，与轨迹长度无关
+class SetConflictProfiler
+{
+public:
+    struct Level {
+        QString name;
+        int setCount = 0;
+        int wayCount = 0;
+        quint8 kinds = 0xFF;    // 直接接收轨迹访问时接受的类型（按 AddressTrace::Kind 的位掩码）
+        QVector<int> sources;   // 非空时以这些级别的未命中为输入（下标须小于本级）
+    };
+
+    struct Result {
+        QString name;
+        int setCount = 0;
+        int wayCount = 0;
+        QVector<quint64> accesses;
+        QVector<quint64> misses;
+        QVector<quint64> conflicts;
+        quint64 totalAccesses = 0;
+        quint64 totalMisses = 0;
+        quint64 totalConflicts = 0;
+    };
+
+    // 组数或路数不大于 0 的级别不做模拟，其输入原样作为未命中传给下一级
+    SetConflictProfiler(const QVector<Level> &levels, int lineBytes);
+
+    // 可在工作线程中调用，并行部分在 pool 中执行（不能是调用线程所在的池）；
+    // processed 为已处理的访问数，cancel 置位时提前返回 false
+    bool run(AddressTrace &trace, WorkStealingPool &pool, std::atomic<qint64> *processed,
+             const std::atomic<bool> *cancel, QString *error);
+
+    const QVector<Result>& results() const { return m_results; }
+
+private:
+    struct Cache {
+        Level level;
+        QVector<quint64> tags;   // 每组 wayCount 个标签，按最近使用排列（0 为最近），0 表示无效
+        QVector<quint32> sets;   // 当前块中每个访问的组下标
+        QVector<int> order;      // 进入本级的访问下标，按组区间分桶，桶内保持轨迹顺序
+        QVector<quint8> input;   // 当前块中每个访问是否进入本级
+        QVector<quint8> missed;  // 当前块中每个访问在本级是否未命中
+    };
+
+    void processBlock(WorkStealingPool &pool, Cache &cache, Result &result, const QVector<quint64> &addresses,
+                      const QVector<quint8> &kinds);
+
+    int m_lineBits;
+    QVector<Cache> m_caches;
+    QVector<Result> m_results;
+};
+
+#endif // SETCONFLICTPROFILER_H
@@ -0,0 +1,160 @@
+#include "setheatmap.h"
+#include <QPainter>
+#include <QHelpEvent>
+#include <QToolTip>
+#include <cmath>
+
+namespace {
+
+const int kMargin = 8;
+const int kLegendHeight = 18;
+const int kScaleHeight = 10;
+
+// 0 为冷色（蓝），1 为热色（红）
+QColor heatColor(double level)
+{
+    return QColor::fromHsvF(float((1.0 - qBound(0.0, level, 1.0)) * 240.0 / 360.0), 0.85f, 0.95f);
+}
+
+} // namespace
+
+SetHeatmap::SetHeatmap(QWidget *parent)
+    : QWidget(parent)
+    , m_metric(CONFLICTS)
+    , m_maxValue(0)
+{
+    setMinimumHeight(160);
+}
+
+void SetHeatmap::setResult(const SetConflictProfiler::Result &result)
+{
+    m_result = result;
+    rebuildImage();
+}
+
+void SetHeatmap::setMetric(Metric metric)
+{
+    if (m_metric == metric) return;
+    m_metric = metric;
+    rebuildImage();
+}
+
+QSize SetHeatmap::sizeHint() const
+{
+    return QSize(420, 240);
+}
+
+const QVector<quint64>& SetHeatmap::values() const
+{
+    switch (m_metric) {
+    case MISSES:
+        return m_result.misses;
+    case ACCESSES:
+        return m_result.accesses;
+    case CONFLICTS:
+    default:
+        return m_result.conflicts;
+    }
+}
+
+void SetHeatmap::rebuildImage()
+{
+    const QVector<quint64> &data = values();
+    m_maxValue = 0;
+    for (quint64 value : data) {
+        m_maxValue = qMax(m_maxValue, value);
+    }
+
+    if (m_result.setCount <= 0) {
+        m_image = QImage();
+        update();
+        return;
+    }
+
+    // 对数刻度：log(1 + v) / log(1 + max)，为 0 的组用底色
+    const int rows = (m_result.setCount + kColumns - 1) / kColumns;
+    m_image = QImage(kColumns, rows, QImage::Format_RGB32);
+    m_image.fill(palette().color(QPalette::AlternateBase));
+    const double logMax = std::log1p(double(m_maxValue));
+    for (int set = 0; set < data.size(); ++set) {
+        if (data[set] == 0) continue;
+        const double level = logMax > 0 ? std::log1p(double(data[set])) / logMax : 0.0;
+        m_image.setPixelColor(set % kColumns, set / kColumns, heatColor(level));
+    }
+    update();
+}
+
+int SetHeatmap::setAt(const QPointF &pos) const
+{
+    if (m_image.isNull() || !m_plotRect.contains(pos)) return -1;
+    const int column = int((pos.x() - m_plotRect.left()) / m_plotRect.width() * m_image.width());
+    const int row = int((pos.y() - m_plotRect.top()) / m_plotRect.height() * m_image.height());
+    const int set = qBound(0, row, m_image.height() - 1) * kColumns + qBound(0, column, kColumns - 1);
+    return set < m_result.setCount ? set : -1;
+}
+
+void SetHeatmap::paintEvent(QPaintEvent *event)
+{
+    Q_UNUSED(event);
+
+    QPainter painter(this);
+    painter.fillRect(rect(), palette().color(QPalette::Base));
+    painter.setPen(palette().color(QPalette::Text));
+
+    if (m_image.isNull()) {
+        m_plotRect = QRectF();
+        painter.drawText(rect(), Qt::AlignCenter, "No set data");
+        return;
+    }
+
+    static const char *const kMetricNames[] = {"conflicts", "misses", "accesses"};
+    const QString legend = QString("%1: %2 sets x %3 ways, max %4 %5 per set")
+                               .arg(m_result.name)
+                               .arg(m_result.setCount)
+                               .arg(m_result.wayCount)
+                               .arg(m_maxValue)
+                               .arg(kMetricNames[m_metric]);
+    painter.drawText(QRectF(kMargin, kMargin, width() - kMargin * 2, kLegendHeight), Qt::AlignLeft | Qt::AlignVCenter,
+                     fontMetrics().elidedText(legend, Qt::ElideRight, width() - kMargin * 2));
+
+    // 组多于可用像素时平滑缩小，避免热点行被最近邻采样丢掉
+    const QRectF area(kMargin, kMargin + kLegendHeight,
+                      qMax(10, width() - kMargin * 2),
+                      qMax(10, height() - kMargin * 3 - kLegendHeight - kScaleHeight));
+    const double cell = qMin(area.width() / m_image.width(), area.height() / m_image.height());
+    m_plotRect = QRectF(area.left(), area.top(), cell * m_image.width(), cell * m_image.height());
+    painter.setRenderHint(QPainter::SmoothPixmapTransform, cell < 1.0);
+    painter.drawImage(m_plotRect, m_image);
+    painter.setPen(palette().color(QPalette::Mid));
+    painter.drawRect(m_plotRect);
+
+    // 色标：左端为 0，右端为最大值
+    const QRectF scale(kMargin, m_plotRect.bottom() + kMargin, m_plotRect.width(), kScaleHeight);
+    QLinearGradient gradient(scale.topLeft(), scale.topRight());
+    for (int i = 0; i <= 4; ++i) {
+        gradient.setColorAt(i / 4.0, heatColor(i / 4.0));
+    }
+    painter.fillRect(scale, gradient);
+}
+
+bool SetHeatmap::event(QEvent *event)
+{
+    if (event->type() == QEvent::ToolTip) {
+        auto helpEvent = static_cast<QHelpEvent*>(event);
+        const int set = setAt(helpEvent->pos());
+        if (set >= 0) {
+            QToolTip::showText(helpEvent->globalPos(),
+                               QString("Set %1\nAccesses: %2\nMisses: %3\nConflicts: %4")
+                                   .arg(set)
+                                   .arg(m_result.accesses[set])
+                                   .arg(m_result.misses[set])
+                                   .arg(m_result.conflicts[set]),
+                               this);
+            return true;
+        }
+        QToolTip::hideText();
+        event->ignore();
+        return true;
+    }
+    return QWidget::event(event);
+}
@@ -0,0 +1,49 @@
+#ifndef SETHEATMAP_H
+#define SETHEATMAP_H
+
+#include <QWidget>
+#include <QImage>
+#include <QRectF>
+#include "setconflictprofiler.h"
+
+// 缓存组热力图：每个组一个格子，每行 kColumns 个组，颜色按所选指标的对数刻度由蓝到红；
+// 悬停显示组下标及其访问、未命中与冲突次数
+class SetHeatmap : public QWidget
+{
+    Q_OBJECT
+
+public:
+    enum Metric {
+        CONFLICTS,
+        MISSES,
+        ACCESSES
+    };
+
+    static const int kColumns = 64;
+
+    explicit SetHeatmap(QWidget *parent = nullptr);
+
+    // 组数为 0 的结果显示为空
+    void setResult(const SetConflictProfiler::Result &result);
+    void setMetric(Metric metric);
+
+    QSize sizeHint() const override;
+
+protected:
+    void paintEvent(QPaintEvent *event) override;
+    bool event(QEvent *event) override;
+
+private:
+    const QVector<quint64>& values() const;
+    void rebuildImage();
+    // 热力图区域中的点对应的组下标，不在任何组上时返回 -1
+    int setAt(const QPointF &pos) const;
+
+    SetConflictProfiler::Result m_result;
+    Metric m_metric;
+    quint64 m_maxValue;
+    QImage m_image;     // 每个组一个像素，绘制时缩放到热力图区域
+    QRectF m_plotRect;  // 上次绘制时热力图所在区域
+};
+
+#endif // SETHEATMAP_H
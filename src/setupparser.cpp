@@ -0,0 +1,502 @@
+#include "setupparser.h"
+#include <QFile>
+#include <algorithm>
+#include <string_view>
+
+namespace {
+
+using std::string_view;
+using CacheConfig = HardwareModule::CacheConfig;
+
+// 一行 "键: 值" 中的值
+struct FieldValue {
+    string_view text;  // 已去除首尾空白
+    int index;         // 带编号的键（如 node_id_of_port_3）中的编号
+};
+
+using FieldSetter = void (*)(ModuleSetup &setup, const FieldValue &value);
+
+// setup 文件字段的声明：键、适用的模块类型与写入位置
+// 整数字段直接写入成员，其它字段使用自定义的写入函数
+struct FieldSpec {
+    string_view key;
+    unsigned types;                             // 适用的模块类型位掩码
+    bool indexed;                               // 键为前缀加编号
+    int ModuleSetup::*member;
+    CacheConfig ModuleSetup::*cache;
+    int CacheConfig::*cacheMember;
+    FieldSetter apply;
+};
+
+constexpr unsigned typeBit(HardwareModule::ModuleType type)
+{
+    return 1u << type;
+}
+
+constexpr unsigned kAnyType = ~0u;
+constexpr unsigned kBus = typeBit(HardwareModule::BUS);
+constexpr unsigned kL2 = typeBit(HardwareModule::CACHE_L2);
+constexpr unsigned kL3 = typeBit(HardwareModule::CACHE_L3);
+constexpr unsigned kMemory = typeBit(HardwareModule::MEMORY_CTRL);
+
+constexpr FieldSpec intField(string_view key, unsigned types, int ModuleSetup::*member)
+{
+    return {key, types, false, member, nullptr, nullptr, nullptr};
+}
+
+constexpr FieldSpec cacheField(string_view key, unsigned types, CacheConfig ModuleSetup::*cache, int CacheConfig::*member)
+{
+    return {key, types, false, nullptr, cache, member, nullptr};
+}
+
+constexpr FieldSpec customField(string_view key, unsigned types, bool indexed, FieldSetter apply)
+{
+    return {key, types, indexed, nullptr, nullptr, nullptr, apply};
+}
+
+constexpr bool isSpace(char c)
+{
+    return c == ' ' || c == '\t' || c == '\r' || c == '\n' || c == '\v' || c == '\f';
+}
+
+constexpr bool isDigit(char c)
+{
+    return c >= '0' && c <= '9';
+}
+
+string_view trimmed(string_view text)
+{
+    while (!text.empty() && isSpace(text.front())) text.remove_prefix(1);
+    while (!text.empty() && isSpace(text.back())) text.remove_suffix(1);
+    return text;
+}
+
+// 从 text 头部读取一个整数并消耗对应字符
+bool consumeInt(string_view &text, int &value)
+{
+    size_t pos = 0;
+    bool negative = false;
+    if (pos < text.size() && (text[pos] == '-' || text[pos] == '+')) {
+        negative = text[pos] == '-';
+        ++pos;
+    }
+    if (pos >= text.size() || !isDigit(text[pos])) return false;
+
+    long long result = 0;
+    while (pos < text.size() && isDigit(text[pos])) {
+        result = result * 10 + (text[pos] - '0');
+        if (result > 0x7fffffffLL) return false;
+        ++pos;
+    }
+    value = int(negative ? -result : result);
+    text.remove_prefix(pos);
+    return true;
+}
+
+// 与 QString::toInt 一致：整个值不是整数时返回 0
+int toInt(string_view text)
+{
+    int value = 0;
+    return consumeInt(text, value) && text.empty() ? value : 0;
+}
+
+QString toQString(string_view text)
+{
+    return QString::fromUtf8(text.data(), int(text.size()));
+}
+
+// 字段注册表：新增模拟器参数只需在此声明
+constexpr FieldSpec kFields[] = {
+    // 所有模块
+    intField("port_id", kAnyType, &ModuleSetup::portId),
+    customField("bus", kAnyType, false, [](ModuleSetup &setup, const FieldValue &value) {
+        setup.busName = toQString(value.text);
+    }),
+    customField("cluster", kAnyType, false, [](ModuleSetup &setup, const FieldValue &value) {
+        setup.clusterName = toQString(value.text);
+    }),
+
+    // 总线
+    intField("node_number", kBus, &ModuleSetup::busPortNumber),
+    customField("node_id_of_port_", kBus, true, [](ModuleSetup &setup, const FieldValue &value) {
+        string_view text = value.text;
+        int node = 0;
+        if (consumeInt(text, node) && text.empty()) {
+            setup.busPortToNodeMap[value.index] = node;
+        }
+    }),
+    customField("edge", kBus, false, [](ModuleSetup &setup, const FieldValue &value) {
+        // 格式为 "a to b"
+        string_view text = value.text;
+        int from = 0, to = 0;
+        if (!consumeInt(text, from)) return;
+        text = trimmed(text);
+        if (text.substr(0, 2) != "to") return;
+        text = trimmed(text.substr(2));
+        if (consumeInt(text, to)) {
+            setup.busEdges.append({from, to});
+        }
+    }),
+
+    // L3 缓存
+    cacheField("way_count", kL3, &ModuleSetup::l3, &CacheConfig::wayCount),
+    cacheField("set_count", kL3, &ModuleSetup::l3, &CacheConfig::setCount),
+    cacheField("mshr_count", kL3, &ModuleSetup::l3, &CacheConfig::mshrCount),
+    cacheField("index_width", kL3, &ModuleSetup::l3, &CacheConfig::indexWidth),
+    cacheField("index_latency", kL3, &ModuleSetup::l3, &CacheConfig::indexLatency),
+    intField("nuca_index", kL3, &ModuleSetup::nucaIndex),
+    intField("nuca_num", kL3, &ModuleSetup::nucaNum),
+
+    // L2 缓存（含私有 L1I/L1D）
+    cacheField("l1i_way_count", kL2, &ModuleSetup::l1i, &CacheConfig::wayCount),
+    cacheField("l1i_set_count", kL2, &ModuleSetup::l1i, &CacheConfig::setCount),
+    cacheField("l1d_way_count", kL2, &ModuleSetup::l1d, &CacheConfig::wayCount),
+    cacheField("l1d_set_count", kL2, &ModuleSetup::l1d, &CacheConfig::setCount),
+    cacheField("l2_way_count", kL2, &ModuleSetup::l2, &CacheConfig::wayCount),
+    cacheField("l2_set_count", kL2, &ModuleSetup::l2, &CacheConfig::setCount),
+    cacheField("l2_mshr_count", kL2, &ModuleSetup::l2, &CacheConfig::mshrCount),
+    cacheField("l2_index_width", kL2, &ModuleSetup::l2, &CacheConfig::indexWidth),
+    cacheField("l2_index_latency", kL2, &ModuleSetup::l2, &CacheConfig::indexLatency),
+
+    // 内存控制器
+    intField("data_width", kMemory, &ModuleSetup::memoryDataWidth),
+};
+
+constexpr int kFieldCount = int(sizeof(kFields) / sizeof(kFields[0]));
+constexpr int kSlotCount = 64;  // 2 的幂，且不小于字段数的两倍
+static_assert(kSlotCount >= 2 * kFieldCount, "enlarge kSlotCount for the field registry");
+
+// 带种子的 FNV-1a，末尾混合使低位分布均匀
+constexpr quint32 hashKey(string_view key, quint32 seed)
+{
+    quint32 hash = 2166136261u ^ seed;
+    for (char c : key) {
+        hash ^= quint8(c);
+        hash *= 16777619u;
+    }
+    hash ^= hash >> 16;
+    hash *= 0x45d9f3bu;
+    hash ^= hash >> 16;
+    return hash;
+}
+
+// 编译期完美哈希：搜索一个使所有键落在不同槽位的种子
+struct PerfectHash {
+    quint32 seed;
+    int slots[kSlotCount];
+};
+
+constexpr PerfectHash buildPerfectHash()
+{
+    for (quint32 seed = 0; seed < 4096; ++seed) {
+        PerfectHash table{seed, {}};
+        for (int &slot : table.slots) {
+            slot = -1;
+        }
+
+        bool collision = false;
+        for (int i = 0; i < kFieldCount && !collision; ++i) {
+            int &slot = table.slots[hashKey(kFields[i].key, seed) % kSlotCount];
+            collision = slot >= 0;
+            slot = i;
+        }
+        if (!collision) return table;
+    }
+    return PerfectHash{0, {}};
+}
+
+constexpr PerfectHash kFieldHash = buildPerfectHash();
+
+constexpr bool isPerfect()
+{
+    for (int i = 0; i < kFieldCount; ++i) {
+        if (kFieldHash.slots[hashKey(kFields[i].key, kFieldHash.seed) % kSlotCount] != i) return false;
+    }
+    return true;
+}
+static_assert(isPerfect(), "no collision-free seed for the field registry");
+
+const FieldSpec* findField(string_view key)
+{
+    int index = kFieldHash.slots[hashKey(key, kFieldHash.seed) % kSlotCount];
+    return index >= 0 && kFields[index].key == key ? &kFields[index] : nullptr;
+}
+
+// 模块名前缀到类型的映射
+struct ModuleTypeSpec {
+    string_view prefix;
+    HardwareModule::ModuleType type;
+};
+
+constexpr ModuleTypeSpec kModuleTypes[] = {
+    {"CPU", HardwareModule::CPU_CORE},
+    {"L2Cache", HardwareModule::CACHE_L2},
+    {"L3Cache", HardwareModule::CACHE_L3},
+    {"Bus", HardwareModule::BUS},
+    {"MemoryNode", HardwareModule::MEMORY_CTRL},
+    {"DMA", HardwareModule::DMA},
+    {"cache_event_trace", HardwareModule::CACHE_EVENT_TRACER},
+};
+
+bool moduleTypeOf(string_view name, HardwareModule::ModuleType &type)
+{
+    for (const auto &spec : kModuleTypes) {
+        if (name.substr(0, spec.prefix.size()) == spec.prefix) {
+            type = spec.type;
+            return true;
+        }
+    }
+    return false;
+}
+
+// 按声明写入一个字段，键不存在或不适用于当前模块时忽略
+void applyField(ModuleSetup &setup, string_view key, string_view text)
+{
+    FieldValue value{text, -1};
+    const FieldSpec *spec = findField(key);
+    if (!spec && !key.empty() && isDigit(key.back())) {
+        // 带编号的键：去掉末尾数字后按前缀查找
+        size_t prefixLength = key.size();
+        while (prefixLength > 0 && isDigit(key[prefixLength - 1])) --prefixLength;
+        string_view digits = key.substr(prefixLength);
+        spec = findField(key.substr(0, prefixLength));
+        if (spec && (!spec->indexed || !consumeInt(digits, value.index))) {
+            spec = nullptr;
+        }
+    }
+    if (!spec || !(spec->types & typeBit(setup.type))) return;
+
+    if (spec->member) {
+        setup.*(spec->member) = toInt(text);
+    } else if (spec->cache) {
+        (setup.*(spec->cache)).*(spec->cacheMember) = toInt(text);
+    } else {
+        spec->apply(setup, value);
+    }
+}
+
+} // namespace
+
+bool SetupParser::parseFile(const QString &filename, QVector<ModuleSetup> &modules, QString *error)
+{
+    QFile file(filename);
+    if (!file.open(QIODevice::ReadOnly)) {
+        if (error) {
+            *error = "Cannot open setup file: " + filename;
+        }
+        return false;
+    }
+
+    modules = parse(file.readAll());
+    return true;
+}
+
+bool SetupParser::moduleType(const QString &name, HardwareModule::ModuleType &type)
+{
+    QByteArray utf8 = name.toUtf8();
+    return moduleTypeOf(string_view(utf8.constData(), size_t(utf8.size())), type);
+}
+
+QString SetupParser::typeName(HardwareModule::ModuleType type)
+{
+    for (const auto &spec : kModuleTypes) {
+        if (spec.type == type) {
+            return toQString(spec.prefix);
+        }
+    }
+    return QString();
+}
+
+QVector<ModuleSetup> SetupParser::parse(const QByteArray &data)
+{
+    QVector<ModuleSetup> modules;
+    ModuleSetup *current = nullptr;
+    string_view rest(data.constData(), size_t(data.size()));
+    // 跳过 UTF-8 BOM，否则第一个模块名无法识别
+    if (rest.substr(0, 3) == string_view("\xEF\xBB\xBF", 3)) {
+        rest.remove_prefix(3);
+    }
+
+    // 单遍扫描，每行只在原始数据上移动视图
+    while (!rest.empty()) {
+        size_t end = rest.find('\n');
+        string_view line = rest.substr(0, end);
+        rest.remove_prefix(end == string_view::npos ? rest.size() : end + 1);
+
+        size_t commentPos = line.find("//");
+        if (commentPos != string_view::npos) {
+            line = line.substr(0, commentPos);
+        }
+        line = trimmed(line);
+        if (line.empty()) continue;
+
+        size_t tickPos = line.find("@1tick");
+        if (tickPos != string_view::npos) {
+            string_view name = trimmed(line.substr(0, line.find('@')));
+            HardwareModule::ModuleType type;
+            if (!moduleTypeOf(name, type)) {
+                continue;
+            }
+
+            ModuleSetup setup;
+            setup.name = toQString(name);
+            setup.type = type;
+            modules.append(setup);
+            current = &modules.last();
+            continue;
+        }
+
+        if (!current) continue;
+
+        size_t colon = line.find(':');
+        if (colon == string_view::npos) continue;
+        applyField(*current, trimmed(line.substr(0, colon)), trimmed(line.substr(colon + 1)));
+    }
+
+    return modules;
+}
+
+HardwareModule* SetupParser::createModule(const ModuleSetup &setup, QObject *parent)
+{
+    auto module = new HardwareModule(setup.type, setup.name, parent);
+    applySetup(module, setup);
+    return module;
+}
+
+int SetupParser::applySetup(HardwareModule *module, const ModuleSetup &setup)
+{
+    int result = UNCHANGED;
+    if (module->portId() != setup.portId || module->busName() != setup.busName ||
+        module->clusterName() != setup.clusterName) {
+        module->setPortId(setup.portId);
+        module->setBusName(setup.busName);
+        module->setClusterName(setup.clusterName);
+        result |= TOPOLOGY_CHANGED;
+    }
+
+    switch (setup.type) {
+        case HardwareModule::CACHE_L2: {
+            // 只有 L1I/L1D/L2 的组相连参数都完整时才应用缓存配置，否则保持默认值
+            const bool complete = setup.l1i.wayCount > 0 && setup.l1i.setCount > 0 &&
+                                  setup.l1d.wayCount > 0 && setup.l1d.setCount > 0 &&
+                                  setup.l2.wayCount > 0 && setup.l2.setCount > 0;
+            const HardwareModule::CacheConfig l1i = complete ? setup.l1i : HardwareModule::CacheConfig();
+            const HardwareModule::CacheConfig l1d = complete ? setup.l1d : HardwareModule::CacheConfig();
+            const HardwareModule::CacheConfig l2 = complete ? setup.l2 : HardwareModule::CacheConfig();
+            if (module->l1iConfig() != l1i || module->l1dConfig() != l1d || module->l2Config() != l2) {
+                module->setL2CacheConfig(l1i, l1d, l2);
+                result |= CONFIG_CHANGED;
+            }
+            break;
+        }
+        case HardwareModule::CACHE_L3: {
+            const bool complete = setup.l3.wayCount > 0 && setup.l3.setCount > 0 &&
+                                  setup.nucaIndex >= 0 && setup.nucaNum > 0;
+            const HardwareModule::CacheConfig l3 = complete ? setup.l3 : HardwareModule::CacheConfig();
+            const int nucaIndex = complete ? setup.nucaIndex : 0;
+            const int nucaNum = complete ? setup.nucaNum : 0;
+            if (module->l3Config() != l3 || module->nucaIndex() != nucaIndex || module->nucaNum() != nucaNum) {
+                // NUCA 分片数参与簇的推断
+                result |= (module->nucaIndex() != nucaIndex || module->nucaNum() != nucaNum)
+                          ? TOPOLOGY_CHANGED | CONFIG_CHANGED : CONFIG_CHANGED;
+                module->setL3CacheConfig(l3, nucaIndex, nucaNum);
+            }
+            break;
+        }
+        case HardwareModule::MEMORY_CTRL:
+            if (module->memoryDataWidth() != setup.memoryDataWidth) {
+                module->setMemoryConfig(setup.memoryDataWidth);
+                result |= CONFIG_CHANGED;
+            }
+            break;
+        case HardwareModule::BUS:
+            if (module->busPortNumber() != setup.busPortNumber ||
+                module->busPortToNodeMap() != setup.busPortToNodeMap ||
+                module->busEdges() != setup.busEdges) {
+                module->setBusConfig(setup.busPortNumber, setup.busPortToNodeMap, setup.busEdges);
+                result |= TOPOLOGY_CHANGED;
+            }
+            break;
+        default:
+            break;
+    }
+
+    if (result != UNCHANGED) {
+        emit module->configChanged();
+    }
+    return result;
+}
+
+ModuleSetup SetupParser::setupOf(const HardwareModule *module)
+{
+    ModuleSetup setup;
+    setup.name = module->name();
+    setup.type = module->type();
+    setup.portId = module->portId();
+    setup.busName = module->busName();
+    setup.clusterName = module->clusterName();
+    setup.l1i = module->l1iConfig();
+    setup.l1d = module->l1dConfig();
+    setup.l2 = module->l2Config();
+    setup.l3 = module->l3Config();
+    setup.nucaIndex = module->nucaIndex();
+    setup.nucaNum = module->nucaNum();
+    setup.memoryDataWidth = module->memoryDataWidth();
+    setup.busPortNumber = module->busPortNumber();
+    setup.busPortToNodeMap = module->busPortToNodeMap();
+    setup.busEdges = module->busEdges();
+    return setup;
+}
+
+QVector<QPair<QString, double>> SetupParser::parameters(const ModuleSetup &setup)
+{
+    QVector<QPair<QString, double>> params;
+    if (setup.portId >= 0) {
+        params.append({"port_id", double(setup.portId)});
+    }
+
+    auto appendCache = [&params](const QString &prefix, const HardwareModule::CacheConfig &config, bool full) {
+        params.append({prefix + "way_count", double(config.wayCount)});
+        params.append({prefix + "set_count", double(config.setCount)});
+        if (full) {
+            params.append({prefix + "mshr_count", double(config.mshrCount)});
+            params.append({prefix + "index_width", double(config.indexWidth)});
+            params.append({prefix + "index_latency", double(config.indexLatency)});
+        }
+    };
+
+    switch (setup.type) {
+        case HardwareModule::CACHE_L2:
+            appendCache("l1i_", setup.l1i, false);
+            appendCache("l1d_", setup.l1d, false);
+            appendCache("l2_", setup.l2, true);
+            break;
+        case HardwareModule::CACHE_L3:
+            appendCache("", setup.l3, true);
+            params.append({"nuca_index", double(setup.nucaIndex)});
+            params.append({"nuca_num", double(setup.nucaNum)});
+            break;
+        case HardwareModule::MEMORY_CTRL:
+            params.append({"data_width", double(setup.memoryDataWidth)});
+            break;
+        case HardwareModule::BUS:
+            params.append({"node_number", double(setup.busPortNumber)});
+            params.append({"edge_count", double(setup.busEdges.size())});
+            break;
+        default:
+            break;
+    }
+    return params;
+}
+
+QString SetupParser::edgeSetText(const ModuleSetup &setup)
+{
+    QVector<QPair<int, int>> edges = setup.busEdges;
+    std::sort(edges.begin(), edges.end());
+
+    QStringList parts;
+    for (const auto &edge : edges) {
+        parts.append(QString("%1>%2").arg(edge.first).arg(edge.second));
+    }
+    return parts.join(',');
+}
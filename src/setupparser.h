@@ -0,0 +1,71 @@
+#ifndef SETUPPARSER_H
+#define SETUPPARSER_H
+
+#include <QString>
+#include <QStringList>
+#include <QVector>
+#include <QMap>
+#include <QPair>
+#include <QByteArray>
+#include "hardwaremodule.h"
+
+// setup 文件中一个模块的配置（与界面无关，可在工作线程中解析）
+struct ModuleSetup {
+    QString name;
+    HardwareModule::ModuleType type = HardwareModule::CPU_CORE;
+    int portId = -1;
+    QString busName;
+    QString clusterName;
+
+    // 缓存配置
+    HardwareModule::CacheConfig l1i;
+    HardwareModule::CacheConfig l1d;
+    HardwareModule::CacheConfig l2;
+    HardwareModule::CacheConfig l3;
+    int nucaIndex = -1;
+    int nucaNum = -1;
+
+    // 内存控制器配置
+    int memoryDataWidth = 0;
+
+    // 总线配置
+    int busPortNumber = 0;
+    QMap<int, int> busPortToNodeMap;
+    QVector<QPair<int, int>> busEdges;
+};
+
+// setup 文件解析器：主窗口、参数扫描与命令行工具共用
+class SetupParser
+{
+public:
+    // 解析 setup 文件，无法打开时返回 false 并设置 error
+    static bool parseFile(const QString &filename, QVector<ModuleSetup> &modules, QString *error = nullptr);
+    // 单遍解析 setup 文件内容，字段按 setupparser.cpp 中的注册表分派
+    static QVector<ModuleSetup> parse(const QByteArray &data);
+
+    // 按模块名前缀确定模块类型，不支持的模块返回 false
+    static bool moduleType(const QString &name, HardwareModule::ModuleType &type);
+    // 模块类型对应的名称前缀（如 "L2Cache"）
+    static QString typeName(HardwareModule::ModuleType type);
+
+    // 按配置创建模块
+    static HardwareModule* createModule(const ModuleSetup &setup, QObject *parent = nullptr);
+
+    // applySetup 的返回值（按位组合）
+    enum ApplyResult {
+        UNCHANGED = 0,
+        CONFIG_CHANGED = 1,    // 缓存或内存参数变化
+        TOPOLOGY_CHANGED = 2   // 端口、总线、簇、NUCA 或总线连接变化，需要重建拓扑与连接
+    };
+    // 将配置原地应用到同名同类型的模块，只写入变化的部分，有变化时发出 configChanged
+    static int applySetup(HardwareModule *module, const ModuleSetup &setup);
+    // 从已加载的模块还原配置，用于导出等只持有模块的场景
+    static ModuleSetup setupOf(const HardwareModule *module);
+
+    // 模块的数值配置参数（名称, 值），参数名与 setup 文件中的字段名一致
+    static QVector<QPair<QString, double>> parameters(const ModuleSetup &setup);
+    // 总线连接集合的规范文本（如 "0>1,1>0"），用于按连接集合分组
+    static QString edgeSetText(const ModuleSetup &setup);
+};
+
+#endif // SETUPPARSER_H
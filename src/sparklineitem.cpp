@@ -0,0 +1,164 @@
+#include "sparklineitem.h"
+#include "memoryaccounting.h"
+#include <QPainter>
+#include <QStyleOptionGraphicsItem>
+#include <QtNumeric>
+
+namespace {
+
+const QColor kBackground(20, 20, 22, 170);
+
+QString formatValue(double value)
+{
+    return qAbs(value) >= 1e4 ? QString::number(value, 'g', 3) : QString::number(value, 'f', qAbs(value) < 10 ? 2 : 0);
+}
+
+} // namespace
+
+SparklineItem::SparklineItem(const QString &label, const QColor &color, QGraphicsItem *parent)
+    : QGraphicsItem(parent)
+    , m_label(label)
+    , m_color(color)
+    , m_values(kColumns, 0.0)
+    , m_head(0)
+    , m_count(0)
+    , m_pending(0)
+    , m_sinceRedraw(0)
+    , m_low(0.0)
+    , m_high(0.0)
+    , m_pixmapValid(false)
+{
+    setAcceptedMouseButtons(Qt::NoButton);
+}
+
+void SparklineItem::addSample(double value)
+{
+    if (!qIsFinite(value)) return;
+
+    m_values[m_head] = value;
+    m_head = (m_head + 1) % kColumns;
+    m_count = qMin(m_count + 1, kColumns);
+    ++m_pending;
+    // 超出当前纵轴范围时需要整体重画
+    if (value < m_low || value > m_high) {
+        m_pixmapValid = false;
+    }
+    update();
+}
+
+void SparklineItem::clear()
+{
+    m_head = 0;
+    m_count = 0;
+    m_pending = 0;
+    m_pixmapValid = false;
+    update();
+}
+
+QRectF SparklineItem::boundingRect() const
+{
+    return QRectF(0, 0, kColumns, kHeight);
+}
+
+double SparklineItem::valueAt(int column) const
+{
+    const int oldest = (m_head - m_count + kColumns) % kColumns;
+    return m_values[(oldest + column) % kColumns];
+}
+
+double SparklineItem::mapY(double value) const
+{
+    return kHeight - 1 - (value - m_low) / (m_high - m_low) * (kHeight - 2);
+}
+
+void SparklineItem::paint(QPainter *painter, const QStyleOptionGraphicsItem *option, QWidget *widget)
+{
+    Q_UNUSED(option);
+    Q_UNUSED(widget);
+
+    // 缩小到看不清时跳过，待绘制的样本保留到下次
+    if (QStyleOptionGraphicsItem::levelOfDetailFromTransform(painter->worldTransform()) < kMinLevelOfDetail) {
+        return;
+    }
+
+    if (!m_pixmapValid || m_pending >= kColumns || m_sinceRedraw + m_pending >= kColumns) {
+        redraw();
+    } else if (m_pending > 0) {
+        appendColumns(m_pending);
+    }
+    m_pending = 0;
+    painter->drawPixmap(0, 0, m_pixmap);
+
+    QFont font = painter->font();
+    font.setPointSize(6);
+    painter->setFont(font);
+    painter->setPen(QColor(255, 255, 255, 200));
+    const QString text = m_count > 0 ? QString("%1  %2").arg(m_label, formatValue(valueAt(m_count - 1))) : m_label;
+    painter->drawText(QRectF(2, 0, kColumns - 4, 10), Qt::AlignLeft | Qt::AlignTop, text);
+}
+
+void SparklineItem::redraw()
+{
+    if (m_pixmap.isNull()) {
+        m_pixmap = QPixmap(kColumns, kHeight);
+    }
+
+    m_low = 0.0;
+    m_high = 1.0;
+    if (m_count > 0) {
+        m_low = m_high = valueAt(0);
+        for (int i = 1; i < m_count; ++i) {
+            m_low = qMin(m_low, valueAt(i));
+            m_high = qMax(m_high, valueAt(i));
+        }
+        // 顶部留出余量，缓慢增长的序列不必每个样本都重画
+        const double span = m_high - m_low;
+        m_high += span > 1e-12 ? span * 0.2 : qMax(1.0, qAbs(m_high) * 0.1);
+        if (span <= 1e-12) {
+            m_low -= qMax(1.0, qAbs(m_low) * 0.1);
+        }
+    }
+
+    m_pixmap.fill(kBackground);
+    QPainter painter(&m_pixmap);
+    drawColumns(painter, m_count);
+    m_pixmapValid = true;
+    m_sinceRedraw = 0;
+}
+
+void SparklineItem::appendColumns(int count)
+{
+    m_pixmap.scroll(-count, 0, m_pixmap.rect());
+    QPainter painter(&m_pixmap);
+    painter.setCompositionMode(QPainter::CompositionMode_Source);
+    painter.fillRect(kColumns - count, 0, count, kHeight, kBackground);
+    painter.setCompositionMode(QPainter::CompositionMode_SourceOver);
+    drawColumns(painter, count);
+    m_sinceRedraw += count;
+}
+
+void SparklineItem::drawColumns(QPainter &painter, int count)
+{
+    QColor fill = m_color;
+    fill.setAlpha(70);
+    painter.setRenderHint(QPainter::Antialiasing);
+    for (int i = 0; i < count; ++i) {
+        const int column = m_count - count + i;
+        const double x = kColumns - count + i + 0.5;
+        const double y = mapY(valueAt(column));
+        painter.setPen(QPen(fill, 1.0));
+        painter.drawLine(QPointF(x, kHeight), QPointF(x, y));
+        if (column > 0) {
+            painter.setPen(QPen(m_color, 1.2));
+            painter.drawLine(QPointF(x - 1.0, mapY(valueAt(column - 1))), QPointF(x, y));
+        }
+    }
+}
+
+void SparklineItem::accountMemory(MemoryAccounting &accounting) const
+{
+    accounting.add(MemoryAccounting::GRAPHICS_ITEMS, "sparkline samples", m_count,
+                   MemoryAccounting::vectorBytes(m_values) - qint64(sizeof(m_values)));
+    accounting.addPixmap("sparkline cache", m_pixmap.cacheKey(), m_pixmap.width(), m_pixmap.height(), m_pixmap.depth());
+}
+
@@ -0,0 +1,57 @@
+#ifndef SPARKLINEITEM_H
+#define SPARKLINEITEM_H
+
+#include <QGraphicsItem>
+#include <QPixmap>
+#include <QVector>
+#include <QColor>
+
+class MemoryAccounting;
+
+// 模块图形项内的迷你走势图：最近 kColumns 个样本，每个样本一个像素列
+// 绘制到缓存的像素图，新样本在绘制时把像素图左移并只画新增的列；
+// 缩放比例过小或所在模块被折叠时不绘制，样本在下次绘制时一并补上
+class SparklineItem : public QGraphicsItem
+{
+public:
+    enum { Type = UserType + 3 };
+
+    static constexpr int kColumns = 128;
+    static constexpr int kHeight = 24;
+    // 低于该细节级别（视图缩放比例）时不绘制
+    static constexpr double kMinLevelOfDetail = 0.5;
+
+    SparklineItem(const QString &label, const QColor &color, QGraphicsItem *parent = nullptr);
+
+    void addSample(double value);
+    void clear();
+    // 上报样本缓冲区与缓存像素图占用的内存
+    void accountMemory(MemoryAccounting &accounting) const;
+
+    int type() const override { return Type; }
+    QRectF boundingRect() const override;
+    void paint(QPainter *painter, const QStyleOptionGraphicsItem *option, QWidget *widget) override;
+
+private:
+    double valueAt(int column) const;  // 0 为最旧的样本
+    // 按环形缓冲区中的样本重新确定纵轴范围并重画整个像素图
+    void redraw();
+    // 像素图左移 count 列，在右侧画出最近 count 个样本
+    void appendColumns(int count);
+    void drawColumns(QPainter &painter, int count);
+    double mapY(double value) const;
+
+    QString m_label;
+    QColor m_color;
+    QVector<double> m_values;  // 环形缓冲区
+    int m_head;                // 下一个写入位置
+    int m_count;
+    int m_pending;             // 尚未画入像素图的样本数
+    int m_sinceRedraw;         // 上次完整重画后追加的列数，满一屏时重画以收紧纵轴
+    double m_low;
+    double m_high;
+    QPixmap m_pixmap;
+    bool m_pixmapValid;
+};
+
+#endif // SPARKLINEITEM_H
@@ -0,0 +1,364 @@
+#include "statisticexporter.h"
+#include "arrowipcwriter.h"
+#include "setupparser.h"
+#include "statkeyregistry.h"
+#include <QIODevice>
+#include <QSaveFile>
+#include <QHash>
+#include <QtMath>
+#include <algorithm>
+#include <charconv>
+
+namespace {
+
+const int kFlushSize = 1 << 16;
+
+// 导出前的一次性准备：只建立名称字典与统计项ID到列的映射，名称只编码一次；
+// 参数与统计值在写出时逐模块读取，不保存数据的副本
+struct ExportPlan {
+    QVector<QByteArray> moduleNames;
+    QVector<int> moduleTypes;            // 各模块的类型字典下标
+    QVector<QByteArray> typeNames;
+    QVector<QByteArray> parameterNames;
+    QHash<QString, int> parameterIndex;
+    QVector<QByteArray> statisticNames;  // 按名称排序
+    QVector<int> statisticColumn;        // 统计项ID -> 统计列下标
+
+    int columnCount() const { return 2 + parameterNames.size() + statisticNames.size(); }
+};
+
+ExportPlan buildPlan(const QVector<HardwareModule*> &modules)
+{
+    ExportPlan plan;
+    QHash<int, int> typeIndex;
+
+    // 收集所有模块用到的统计项，按名称排序后分配列
+    QVector<bool> usedKeys;
+    for (const HardwareModule *module : modules) {
+        for (auto it = module->statisticValues().begin(); it != module->statisticValues().end(); ++it) {
+            if (it.key() >= usedKeys.size()) {
+                usedKeys.resize(it.key() + 1);
+            }
+            usedKeys[it.key()] = true;
+        }
+    }
+    const StatKeyRegistry &registry = StatKeyRegistry::instance();
+    QVector<QPair<QString, int>> keys;
+    for (int id = 0; id < usedKeys.size(); ++id) {
+        if (usedKeys[id]) {
+            keys.append({registry.name(id), id});
+        }
+    }
+    std::sort(keys.begin(), keys.end());
+    plan.statisticColumn.fill(-1, usedKeys.size());
+    for (int i = 0; i < keys.size(); ++i) {
+        plan.statisticColumn[keys[i].second] = i;
+        plan.statisticNames.append(keys[i].first.toUtf8());
+    }
+
+    plan.moduleTypes.reserve(modules.size());
+    for (const HardwareModule *module : modules) {
+        plan.moduleNames.append(module->name().toUtf8());
+
+        auto type = typeIndex.constFind(module->type());
+        if (type == typeIndex.constEnd()) {
+            type = typeIndex.insert(module->type(), plan.typeNames.size());
+            plan.typeNames.append(SetupParser::typeName(module->type()).toUtf8());
+        }
+        plan.moduleTypes.append(type.value());
+
+        for (const auto &param : SetupParser::parameters(SetupParser::setupOf(module))) {
+            if (!plan.parameterIndex.contains(param.first)) {
+                plan.parameterIndex.insert(param.first, plan.parameterNames.size());
+                plan.parameterNames.append(param.first.toUtf8());
+            }
+        }
+    }
+    return plan;
+}
+
+// 读取一个模块的参数与统计值到复用的缓冲中：(列下标, 值)，统计值按列排序
+void readRow(const ExportPlan &plan, const HardwareModule *module,
+             QVector<QPair<int, double>> &parameters, QVector<QPair<int, double>> &statistics)
+{
+    parameters.resize(0);
+    for (const auto &param : SetupParser::parameters(SetupParser::setupOf(module))) {
+        parameters.append({plan.parameterIndex.value(param.first), param.second});
+    }
+
+    statistics.resize(0);
+    for (auto it = module->statisticValues().begin(); it != module->statisticValues().end(); ++it) {
+        statistics.append({plan.statisticColumn[it.key()], it.value()});
+    }
+    std::sort(statistics.begin(), statistics.end());
+}
+
+// 含逗号、引号或换行的字段加引号
+QByteArray csvEscape(const QByteArray &text)
+{
+    if (!text.contains(',') && !text.contains('"') && !text.contains('\n') && !text.contains('\r')) {
+        return text;
+    }
+    QByteArray escaped = text;
+    escaped.replace("\"", "\"\"");
+    return '"' + escaped + '"';
+}
+
+QVector<QByteArray> csvEscape(const QVector<QByteArray> &texts)
+{
+    QVector<QByteArray> escaped;
+    escaped.reserve(texts.size());
+    for (const QByteArray &text : texts) {
+        escaped.append(csvEscape(text));
+    }
+    return escaped;
+}
+
+// 带缓冲的 CSV 写出：数值直接格式化到缓冲区，与区域设置无关
+class CsvWriter
+{
+public:
+    explicit CsvWriter(QIODevice *device)
+        : m_device(device)
+        , m_firstField(true)
+    {
+        m_buffer.reserve(kFlushSize + 4096);
+    }
+
+    void text(const QByteArray &escaped)
+    {
+        separator();
+        m_buffer.append(escaped);
+    }
+
+    // NaN 写为空字段
+    void number(double value)
+    {
+        separator();
+        if (qIsNaN(value)) return;
+
+        char digits[32];
+        auto result = std::to_chars(digits, digits + sizeof(digits), value);
+        m_buffer.append(digits, int(result.ptr - digits));
+    }
+
+    bool endRow()
+    {
+        m_buffer.append('\n');
+        m_firstField = true;
+        return m_buffer.size() < kFlushSize || flush();
+    }
+
+    bool flush()
+    {
+        if (m_device->write(m_buffer) != m_buffer.size()) {
+            return false;
+        }
+        m_buffer.truncate(0);
+        return true;
+    }
+
+private:
+    void separator()
+    {
+        if (!m_firstField) {
+            m_buffer.append(',');
+        }
+        m_firstField = false;
+    }
+
+    QIODevice *m_device;
+    QByteArray m_buffer;
+    bool m_firstField;
+};
+
+bool writeCsv(const QVector<HardwareModule*> &modules, const ExportPlan &plan, QIODevice *device,
+              StatisticExporter::Layout layout)
+{
+    CsvWriter writer(device);
+    const QVector<QByteArray> moduleNames = csvEscape(plan.moduleNames);
+    const QVector<QByteArray> typeNames = csvEscape(plan.typeNames);
+    const QVector<QByteArray> parameterNames = csvEscape(plan.parameterNames);
+    const QVector<QByteArray> statisticNames = csvEscape(plan.statisticNames);
+    QVector<QPair<int, double>> parameters, statistics;
+
+    if (layout == StatisticExporter::LONG) {
+        for (const char *header : {"module", "type", "kind", "key", "value"}) {
+            writer.text(header);
+        }
+        if (!writer.endRow()) return false;
+
+        for (int m = 0; m < modules.size(); ++m) {
+            readRow(plan, modules[m], parameters, statistics);
+            const QByteArray &moduleName = moduleNames[m];
+            const QByteArray &typeName = typeNames[plan.moduleTypes[m]];
+            for (const auto &param : parameters) {
+                writer.text(moduleName);
+                writer.text(typeName);
+                writer.text("config");
+                writer.text(parameterNames[param.first]);
+                writer.number(param.second);
+                if (!writer.endRow()) return false;
+            }
+            for (const auto &stat : statistics) {
+                writer.text(moduleName);
+                writer.text(typeName);
+                writer.text("stat");
+                writer.text(statisticNames[stat.first]);
+                writer.number(stat.second);
+                if (!writer.endRow()) return false;
+            }
+        }
+        return writer.flush();
+    }
+
+    writer.text("module");
+    writer.text("type");
+    for (const QByteArray &name : parameterNames) writer.text(name);
+    for (const QByteArray &name : statisticNames) writer.text(name);
+    if (!writer.endRow()) return false;
+
+    // 稀疏的参数与统计值展开到复用的整行缓冲中
+    const int parameterCount = plan.parameterNames.size();
+    QVector<double> cells(parameterCount + plan.statisticNames.size(), qQNaN());
+    for (int m = 0; m < modules.size(); ++m) {
+        readRow(plan, modules[m], parameters, statistics);
+        std::fill(cells.begin(), cells.end(), qQNaN());
+        for (const auto &param : parameters) cells[param.first] = param.second;
+        for (const auto &stat : statistics) cells[parameterCount + stat.first] = stat.second;
+
+        writer.text(moduleNames[m]);
+        writer.text(typeNames[plan.moduleTypes[m]]);
+        for (double value : cells) writer.number(value);
+        if (!writer.endRow()) return false;
+    }
+    return writer.flush();
+}
+
+bool writeArrow(const QVector<HardwareModule*> &modules, const ExportPlan &plan, QIODevice *device,
+                StatisticExporter::Layout layout, QString *error)
+{
+    ArrowIpcWriter writer(device);
+    QVector<QPair<int, double>> parameters, statistics;
+    auto fail = [&writer, error]() {
+        if (error) *error = writer.errorString();
+        return false;
+    };
+
+    writer.addDictionaryColumn("module", plan.moduleNames);
+    writer.addDictionaryColumn("type", plan.typeNames);
+
+    if (layout == StatisticExporter::LONG) {
+        // key 列的字典为参数名之后接统计项名
+        writer.addDictionaryColumn("kind", {"config", "stat"});
+        writer.addDictionaryColumn("key", plan.parameterNames + plan.statisticNames);
+        writer.addFloat64Column("value");
+        if (!writer.begin()) return fail();
+
+        const int batchRows = StatisticExporter::kBatchCells / 5;
+        const int statisticBase = plan.parameterNames.size();
+        QVector<qint32> moduleColumn, typeColumn, kinds, keys;
+        QVector<double> values;
+        for (auto *column : {&moduleColumn, &typeColumn, &kinds, &keys}) column->reserve(batchRows);
+        values.reserve(batchRows);
+
+        auto flush = [&]() {
+            bool ok = writer.writeBatch(values.size(), {moduleColumn.constData(), typeColumn.constData(),
+                                                        kinds.constData(), keys.constData(), values.constData()});
+            for (auto *column : {&moduleColumn, &typeColumn, &kinds, &keys}) column->resize(0);
+            values.resize(0);
+            return ok;
+        };
+        auto append = [&](int module, qint32 kind, qint32 key, double value) {
+            moduleColumn.append(module);
+            typeColumn.append(plan.moduleTypes[module]);
+            kinds.append(kind);
+            keys.append(key);
+            values.append(value);
+            return values.size() < batchRows || flush();
+        };
+
+        for (int m = 0; m < modules.size(); ++m) {
+            readRow(plan, modules[m], parameters, statistics);
+            for (const auto &param : parameters) {
+                if (!append(m, 0, param.first, param.second)) return fail();
+            }
+            for (const auto &stat : statistics) {
+                if (!append(m, 1, statisticBase + stat.first, stat.second)) return fail();
+            }
+        }
+        if (!values.isEmpty() && !flush()) return fail();
+        return writer.finish() || fail();
+    }
+
+    for (const QByteArray &name : plan.parameterNames) writer.addFloat64Column(QString::fromUtf8(name));
+    for (const QByteArray &name : plan.statisticNames) writer.addFloat64Column(QString::fromUtf8(name));
+    if (!writer.begin()) return fail();
+
+    // 每批次按列存放，批次行数随列数缩放以限制内存
+    const int valueColumns = plan.columnCount() - 2;
+    const int parameterCount = plan.parameterNames.size();
+    const int batchRows = qMax(1, StatisticExporter::kBatchCells / qMax(1, valueColumns));
+    QVector<qint32> moduleColumn(batchRows), typeColumn(batchRows);
+    QVector<double> cells(valueColumns * batchRows);
+    QVector<const void*> columns(plan.columnCount());
+    columns[0] = moduleColumn.constData();
+    columns[1] = typeColumn.constData();
+
+    for (int begin = 0; begin < modules.size(); begin += batchRows) {
+        const int count = qMin(batchRows, modules.size() - begin);
+        std::fill(cells.begin(), cells.end(), qQNaN());
+        for (int r = 0; r < count; ++r) {
+            const int m = begin + r;
+            readRow(plan, modules[m], parameters, statistics);
+            moduleColumn[r] = m;
+            typeColumn[r] = plan.moduleTypes[m];
+            for (const auto &param : parameters) {
+                cells[param.first * batchRows + r] = param.second;
+            }
+            for (const auto &stat : statistics) {
+                cells[(parameterCount + stat.first) * batchRows + r] = stat.second;
+            }
+        }
+        for (int c = 0; c < valueColumns; ++c) {
+            columns[2 + c] = cells.constData() + c * batchRows;
+        }
+        if (!writer.writeBatch(count, columns)) return fail();
+    }
+    return writer.finish() || fail();
+}
+
+} // namespace
+
+bool StatisticExporter::exportModules(const QVector<HardwareModule*> &modules, QIODevice *device,
+                                      Format format, Layout layout, QString *error)
+{
+    const ExportPlan plan = buildPlan(modules);
+    if (format == ARROW_IPC) {
+        return writeArrow(modules, plan, device, layout, error);
+    }
+    if (!writeCsv(modules, plan, device, layout)) {
+        if (error) *error = device->errorString();
+        return false;
+    }
+    return true;
+}
+
+bool StatisticExporter::exportFile(const QVector<HardwareModule*> &modules, const QString &filename,
+                                   Format format, Layout layout, QString *error)
+{
+    QSaveFile file(filename);
+    if (!file.open(QIODevice::WriteOnly)) {
+        if (error) *error = "Cannot open export file: " + filename;
+        return false;
+    }
+    if (!exportModules(modules, &file, format, layout, error)) {
+        file.cancelWriting();
+        return false;
+    }
+    if (!file.commit()) {
+        if (error) *error = file.errorString();
+        return false;
+    }
+    return true;
+}
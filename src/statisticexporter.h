@@ -0,0 +1,35 @@
+#ifndef STATISTICEXPORTER_H
+#define STATISTICEXPORTER_H
+
+#include <QString>
+#include <QVector>
+#include "hardwaremodule.h"
+
+class QIODevice;
+
+// 将所有模块的配置参数与统计数据导出为 CSV 或 Arrow IPC 文件
+// 按批次流式写出，统计项按驻留ID直接取值，不为每个数值构造字符串对象
+class StatisticExporter
+{
+public:
+    enum Format {
+        CSV,
+        ARROW_IPC
+    };
+
+    enum Layout {
+        LONG,   // 每个(模块, 参数或统计项)一行：module, type, kind, key, value
+        WIDE    // 每个模块一行，每个参数或统计项一列
+    };
+
+    // 每个记录批次的最大单元格数，限制导出时的内存占用
+    static constexpr int kBatchCells = 1 << 20;
+
+    static bool exportModules(const QVector<HardwareModule*> &modules, QIODevice *device,
+                              Format format, Layout layout, QString *error = nullptr);
+    // 写入文件，失败时不会留下不完整的文件
+    static bool exportFile(const QVector<HardwareModule*> &modules, const QString &filename,
+                           Format format, Layout layout, QString *error = nullptr);
+};
+
+#endif // STATISTICEXPORTER_H
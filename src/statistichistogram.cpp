@@ -0,0 +1,162 @@
+#include "statistichistogram.h"
+#include <QStringList>
+#include <cmath>
+#include <limits>
+
+namespace {
+
+bool isSeparator(QChar c)
+{
+    return c.isSpace() || c == QLatin1Char(',');
+}
+
+} // namespace
+
+StatisticHistogram::StatisticHistogram()
+    : m_total(0)
+    , m_sum(0.0)
+    , m_min(std::numeric_limits<double>::infinity())
+    , m_max(0.0)
+{
+}
+
+int StatisticHistogram::bucketIndex(double value)
+{
+    if (!(value > 0)) return 0;
+    if (value < kSubBuckets) return int(value);
+
+    // value = m * 2^exponent，m 在 [0.5, 1)；所在 2 的幂区间为 [2^(exponent-1), 2^exponent)
+    int exponent;
+    std::frexp(value, &exponent);
+    const int magnitude = exponent - 1;
+    const int sub = int(std::ldexp(value, kSubBucketBits - magnitude)) - kSubBuckets;
+    const int index = (magnitude - kSubBucketBits + 1) * kSubBuckets + sub;
+    return qMin(index, kMaxBuckets - 1);
+}
+
+double StatisticHistogram::bucketLowerBound(int index)
+{
+    if (index < kSubBuckets) return index;
+
+    const int magnitude = index / kSubBuckets + kSubBucketBits - 1;
+    const int sub = index % kSubBuckets;
+    return std::ldexp(double(kSubBuckets + sub), magnitude - kSubBucketBits);
+}
+
+void StatisticHistogram::record(double value, quint64 count)
+{
+    if (count == 0) return;
+    if (!(value > 0)) value = 0.0;
+
+    const int index = bucketIndex(value);
+    if (index >= m_counts.size()) {
+        m_counts.resize(index + 1);
+    }
+    m_counts[index] += count;
+    m_total += count;
+    m_sum += value * double(count);
+    m_min = qMin(m_min, value);
+    m_max = qMax(m_max, value);
+}
+
+void StatisticHistogram::merge(const StatisticHistogram &other)
+{
+    if (other.isEmpty()) return;
+
+    if (other.m_counts.size() > m_counts.size()) {
+        m_counts.resize(other.m_counts.size());
+    }
+    quint64 *counts = m_counts.data();
+    const quint64 *otherCounts = other.m_counts.constData();
+    for (int i = 0; i < other.m_counts.size(); ++i) {
+        counts[i] += otherCounts[i];
+    }
+    m_total += other.m_total;
+    m_sum += other.m_sum;
+    m_min = qMin(m_min, other.m_min);
+    m_max = qMax(m_max, other.m_max);
+}
+
+void StatisticHistogram::clear()
+{
+    *this = StatisticHistogram();
+}
+
+double StatisticHistogram::percentile(double percent) const
+{
+    if (m_total == 0) return 0.0;
+
+    const double clamped = qBound(0.0, percent, 100.0);
+    const quint64 rank = qMax<quint64>(1, quint64(std::ceil(clamped / 100.0 * double(m_total))));
+    quint64 cumulative = 0;
+    for (int i = 0; i < m_counts.size(); ++i) {
+        cumulative += m_counts[i];
+        if (cumulative >= rank) {
+            // 线性区的桶宽为 1，直接取下界；对数区取桶中点
+            double value = i < kSubBuckets ? bucketLowerBound(i)
+                                           : (bucketLowerBound(i) + bucketUpperBound(i)) / 2;
+            return qBound(m_min, value, m_max);
+        }
+    }
+    return m_max;
+}
+
+bool StatisticHistogram::operator==(const StatisticHistogram &other) const
+{
+    return m_total == other.m_total && m_sum == other.m_sum && m_counts == other.m_counts
+        && min() == other.min() && max() == other.max();
+}
+
+bool StatisticHistogram::parse(QStringView text, StatisticHistogram &histogram)
+{
+    histogram.clear();
+    text = text.trimmed();
+    if (text.size() < 2 || text.front() != QLatin1Char('{') || text.back() != QLatin1Char('}')) {
+        return false;
+    }
+    text = text.mid(1, text.size() - 2);
+
+    const qsizetype size = text.size();
+    qsizetype pos = 0;
+    while (true) {
+        while (pos < size && isSeparator(text[pos])) ++pos;
+        if (pos >= size) break;
+
+        qsizetype colon = pos;
+        while (colon < size && text[colon] != QLatin1Char(':')) ++colon;
+        if (colon >= size) return false;
+        qsizetype end = colon + 1;
+        while (end < size && !isSeparator(text[end])) ++end;
+
+        bool valueOk = false;
+        bool countOk = false;
+        const double value = text.mid(pos, colon - pos).trimmed().toDouble(&valueOk);
+        const quint64 count = text.mid(colon + 1, end - colon - 1).trimmed().toULongLong(&countOk);
+        if (!valueOk || !countOk) return false;
+
+        histogram.record(value, count);
+        pos = end;
+    }
+    return true;
+}
+
+QString StatisticHistogram::toString() const
+{
+    QStringList entries;
+    for (int i = 0; i < m_counts.size(); ++i) {
+        if (m_counts[i] > 0) {
+            entries.append(QString("%1:%2").arg(bucketLowerBound(i)).arg(m_counts[i]));
+        }
+    }
+    return "{" + entries.join(" ") + "}";
+}
+
+const QVector<QPair<QString, double>>& StatisticHistogram::percentileSuffixes()
+{
+    static const QVector<QPair<QString, double>> suffixes = {
+        {"_p50", 50.0},
+        {"_p99", 99.0},
+        {"_p999", 99.9},
+    };
+    return suffixes;
+}
@@ -0,0 +1,61 @@
+#ifndef STATISTICHISTOGRAM_H
+#define STATISTICHISTOGRAM_H
+
+#include <QVector>
+#include <QPair>
+#include <QString>
+#include <QStringView>
+
+// 分布型统计项：对数-线性分桶直方图（HdrHistogram 编码）
+// [0, 32) 内每个整数一个桶，之后每个 2 的幂区间再分为 32 个桶，相对误差不超过 1/64
+// 桶数组只保存到最大的非空桶，合并为逐桶相加
+class StatisticHistogram
+{
+public:
+    static const int kSubBucketBits = 5;
+    static const int kSubBuckets = 1 << kSubBucketBits;
+    static const int kMaxBuckets = 64 * kSubBuckets;
+
+    StatisticHistogram();
+
+    // 记录 count 个值为 value 的样本，负值与 NaN 计入 0
+    void record(double value, quint64 count = 1);
+    void merge(const StatisticHistogram &other);
+    void clear();
+
+    bool isEmpty() const { return m_total == 0; }
+    quint64 count() const { return m_total; }
+    double mean() const { return m_total > 0 ? m_sum / double(m_total) : 0.0; }
+    double min() const { return m_total > 0 ? m_min : 0.0; }
+    double max() const { return m_total > 0 ? m_max : 0.0; }
+    // 百分位数（percent 为 0-100），结果限制在已记录的最小值与最大值之间
+    double percentile(double percent) const;
+
+    // 桶访问：下标 [0, bucketCount())，区间为 [lowerBound, upperBound)
+    int bucketCount() const { return m_counts.size(); }
+    quint64 bucketSamples(int index) const { return m_counts[index]; }
+    static int bucketIndex(double value);
+    static double bucketLowerBound(int index);
+    static double bucketUpperBound(int index) { return bucketLowerBound(index + 1); }
+
+    bool operator==(const StatisticHistogram &other) const;
+    bool operator!=(const StatisticHistogram &other) const { return !(*this == other); }
+
+    // 解析 statistic 文件中的直方图值 "{值:样本数 值:样本数 ...}"（分隔符可为空白或逗号）
+    // 逐个扫描数值，不为每个桶分配字符串；格式错误时返回 false
+    static bool parse(QStringView text, StatisticHistogram &histogram);
+    // 格式化为可被 parse 读回的文本，每个非空桶输出其下界
+    QString toString() const;
+
+    // 直方图统计项附带的百分位标量统计项后缀
+    static const QVector<QPair<QString, double>>& percentileSuffixes();
+
+private:
+    QVector<quint64> m_counts;
+    quint64 m_total;
+    double m_sum;
+    double m_min;
+    double m_max;
+};
+
+#endif // STATISTICHISTOGRAM_H
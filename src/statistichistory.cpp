@@ -0,0 +1,103 @@
+#include "statistichistory.h"
+#include "memoryaccounting.h"
+#include <QtNumeric>
+
+StatisticHistory::StatisticHistory(QObject *parent)
+    : QObject(parent)
+{
+    m_clock.start();
+}
+
+StatisticHistory::~StatisticHistory()
+{
+    for (auto &series : m_series) {
+        qDeleteAll(series);
+    }
+}
+
+void StatisticHistory::addModule(HardwareModule* module)
+{
+    if (!module || m_modules.contains(module)) return;
+
+    m_modules.append(module);
+    // 已有的统计值作为第一个样本
+    QHash<int, TimeSeries*> &series = m_series[module];
+    const double time = now();
+    const QHash<int, double> &values = module->statisticValues();
+    for (auto it = values.constBegin(); it != values.constEnd(); ++it) {
+        TimeSeries* s = new TimeSeries;
+        s->append(time, it.value());
+        series.insert(it.key(), s);
+    }
+
+    connect(module, &HardwareModule::statisticChanged,
+            this, &StatisticHistory::onStatisticChanged);
+    emit modulesChanged();
+}
+
+void StatisticHistory::removeModule(HardwareModule* module)
+{
+    if (!m_modules.removeOne(module)) return;
+
+    disconnect(module, nullptr, this, nullptr);
+    emit seriesRemoved(module);
+    qDeleteAll(m_series.take(module));
+    emit modulesChanged();
+}
+
+void StatisticHistory::clear()
+{
+    for (auto module : m_modules) {
+        disconnect(module, nullptr, this, nullptr);
+    }
+    emit seriesRemoved(nullptr);
+    for (auto &series : m_series) {
+        qDeleteAll(series);
+    }
+    m_series.clear();
+    m_modules.clear();
+    emit modulesChanged();
+}
+
+QVector<int> StatisticHistory::keys(HardwareModule* module) const
+{
+    return m_series.value(module).keys();
+}
+
+const TimeSeries* StatisticHistory::series(HardwareModule* module, int keyId) const
+{
+    auto it = m_series.constFind(module);
+    return it == m_series.constEnd() ? nullptr : it->value(keyId, nullptr);
+}
+
+void StatisticHistory::onStatisticChanged(int keyId, double oldValue, double newValue)
+{
+    Q_UNUSED(oldValue);
+    // 统计项被删除时保留已有的历史
+    if (qIsNaN(newValue)) return;
+
+    auto module = qobject_cast<HardwareModule*>(sender());
+    auto it = m_series.find(module);
+    if (it == m_series.end()) return;
+
+    TimeSeries* &series = (*it)[keyId];
+    if (!series) {
+        series = new TimeSeries;
+    }
+    series->append(now(), newValue);
+    emit sampleAdded(module, keyId);
+}
+
+void StatisticHistory::accountMemory(MemoryAccounting &accounting) const
+{
+    qint64 indexBytes = MemoryAccounting::hashBytes(m_series);
+    qint64 seriesCount = 0;
+    for (const auto &series : m_series) {
+        indexBytes += MemoryAccounting::hashBytes(series) - qint64(sizeof(series));
+        seriesCount += series.size();
+        for (const TimeSeries *s : series) {
+            s->accountMemory(accounting);
+        }
+    }
+    accounting.add(MemoryAccounting::STATISTIC_HISTORY, "series index", seriesCount, indexBytes);
+}
@@ -0,0 +1,49 @@
+#ifndef STATISTICHISTORY_H
+#define STATISTICHISTORY_H
+
+#include <QObject>
+#include <QHash>
+#include <QVector>
+#include <QElapsedTimer>
+#include "hardwaremodule.h"
+#include "timeseries.h"
+
+// 统计历史：记录各模块统计项每次变化的值，时间为自创建起的秒数
+// 实时数据与重新加载都经由 statisticChanged 写入，每个序列各自维护多分辨率金字塔
+class StatisticHistory : public QObject
+{
+    Q_OBJECT
+
+public:
+    explicit StatisticHistory(QObject *parent = nullptr);
+    ~StatisticHistory();
+
+    void addModule(HardwareModule* module);
+    void removeModule(HardwareModule* module);
+    void clear();
+
+    QVector<HardwareModule*> modules() const { return m_modules; }
+    // 已有历史的统计项驻留ID
+    QVector<int> keys(HardwareModule* module) const;
+    // 序列在模块移除或 clear 之前保持有效
+    const TimeSeries* series(HardwareModule* module, int keyId) const;
+    double now() const { return m_clock.elapsed() / 1000.0; }
+    // 上报所有序列占用的内存
+    void accountMemory(MemoryAccounting &accounting) const;
+
+signals:
+    void sampleAdded(HardwareModule* module, int keyId);
+    // 模块被移除，module 为空表示全部清除
+    void seriesRemoved(HardwareModule* module);
+    void modulesChanged();
+
+private slots:
+    void onStatisticChanged(int keyId, double oldValue, double newValue);
+
+private:
+    QElapsedTimer m_clock;
+    QVector<HardwareModule*> m_modules;
+    QHash<HardwareModule*, QHash<int, TimeSeries*>> m_series;
+};
+
+#endif // STATISTICHISTORY_H
@@ -0,0 +1,97 @@
+#include "statisticparser.h"
+#include "statkeyregistry.h"
+#include <QFile>
+#include <QHash>
+
+bool StatisticParser::parseFile(const QString &filename, QVector<ModuleStatistics> &modules, QString *error)
+{
+    QFile file(filename);
+    if (!file.open(QIODevice::ReadOnly | QIODevice::Text)) {
+        if (error) {
+            *error = "Cannot open statistics file: " + filename;
+        }
+        return false;
+    }
+
+    QTextStream in(&file);
+    modules = parse(in);
+    return true;
+}
+
+QVector<ModuleStatistics> StatisticParser::parse(QTextStream &in)
+{
+    QVector<ModuleStatistics> modules;
+    ModuleStatistics current;
+    // 同一模块内重复出现的标量统计项以最后一次为准；
+    // 重复出现的直方图统计项视为不同阶段（epoch）的分布，合并为一个
+    QHash<int, int> positions;
+    QHash<int, int> histogramPositions;
+
+    StatKeyRegistry &registry = StatKeyRegistry::instance();
+    auto setValue = [&](int keyId, double value) {
+        auto it = positions.constFind(keyId);
+        if (it != positions.constEnd()) {
+            current.values[it.value()].second = value;
+        } else {
+            positions.insert(keyId, current.values.size());
+            current.values.append({keyId, value});
+        }
+    };
+
+    auto flush = [&]() {
+        for (const auto &entry : current.histograms) {
+            const QString name = registry.name(entry.first);
+            for (const auto &suffix : StatisticHistogram::percentileSuffixes()) {
+                setValue(registry.intern(name + suffix.first), entry.second.percentile(suffix.second));
+            }
+        }
+        if (!current.module.isEmpty() && !current.values.isEmpty()) {
+            modules.append(current);
+        }
+        current = ModuleStatistics();
+        positions.clear();
+        histogramPositions.clear();
+    };
+
+    while (!in.atEnd()) {
+        QString line = in.readLine();
+
+        int commentPos = line.indexOf("//");
+        if (commentPos != -1) {
+            line = line.left(commentPos);
+        }
+
+        line = line.trimmed();
+        if (line.isEmpty()) continue;
+
+        if (line.contains("Latency:")) {
+            flush();
+            current.module = line.split(" ").first();
+            continue;
+        }
+
+        int colon = line.indexOf(':');
+        if (colon > 0 && line.indexOf('{', colon) != -1) {
+            StatisticHistogram histogram;
+            if (!StatisticHistogram::parse(QStringView(line).mid(colon + 1), histogram)) continue;
+
+            int keyId = registry.intern(line.left(colon).trimmed());
+            auto it = histogramPositions.constFind(keyId);
+            if (it != histogramPositions.constEnd()) {
+                current.histograms[it.value()].second.merge(histogram);
+            } else {
+                histogramPositions.insert(keyId, current.histograms.size());
+                current.histograms.append({keyId, histogram});
+            }
+            continue;
+        }
+
+        QStringList parts = line.split(":");
+        if (parts.size() == 2) {
+            setValue(registry.intern(parts[0].trimmed()), parts[1].trimmed().toDouble());
+        }
+    }
+    flush();
+
+    return modules;
+}
@@ -0,0 +1,28 @@
+#ifndef STATISTICPARSER_H
+#define STATISTICPARSER_H
+
+#include <QString>
+#include <QVector>
+#include <QPair>
+#include <QTextStream>
+#include "statistichistogram.h"
+
+// statistic 文件中一个模块的统计数据，统计项以驻留ID表示
+// 直方图统计项（"key: {值:样本数 ...}"）另存于 histograms，
+// 并在 values 中附带 key_p50、key_p99、key_p999 百分位标量
+struct ModuleStatistics {
+    QString module;
+    QVector<QPair<int, double>> values;
+    QVector<QPair<int, StatisticHistogram>> histograms;
+};
+
+// statistic 文件解析器：主窗口、参数扫描与命令行工具共用，可在工作线程中使用
+class StatisticParser
+{
+public:
+    // 解析 statistic 文件，无法打开时返回 false 并设置 error
+    static bool parseFile(const QString &filename, QVector<ModuleStatistics> &modules, QString *error = nullptr);
+    static QVector<ModuleStatistics> parse(QTextStream &in);
+};
+
+#endif // STATISTICPARSER_H
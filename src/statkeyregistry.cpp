@@ -0,0 +1,85 @@
+#include "statkeyregistry.h"
+#include "memoryaccounting.h"
+#include <QRegularExpression>
+
+StatKeyRegistry& StatKeyRegistry::instance()
+{
+    static StatKeyRegistry registry;
+    return registry;
+}
+
+int StatKeyRegistry::intern(const QString &key)
+{
+    {
+        QReadLocker locker(&m_lock);
+        auto it = m_ids.constFind(key);
+        if (it != m_ids.constEnd()) {
+            return it.value();
+        }
+    }
+
+    QWriteLocker locker(&m_lock);
+    auto it = m_ids.constFind(key);
+    if (it != m_ids.constEnd()) {
+        return it.value();
+    }
+
+    int id = m_names.size();
+    m_names.append(key);
+    m_ids.insert(key, id);
+    return id;
+}
+
+int StatKeyRegistry::find(const QString &key) const
+{
+    QReadLocker locker(&m_lock);
+    return m_ids.value(key, -1);
+}
+
+int StatKeyRegistry::count() const
+{
+    QReadLocker locker(&m_lock);
+    return m_names.size();
+}
+
+QString StatKeyRegistry::name(int id) const
+{
+    QReadLocker locker(&m_lock);
+    return (id >= 0 && id < m_names.size()) ? m_names[id] : QString();
+}
+
+QVector<int> StatKeyRegistry::match(const QString &pattern) const
+{
+    QVector<int> ids;
+
+    if (!pattern.contains('*') && !pattern.contains('?')) {
+        int id = find(pattern);
+        if (id >= 0) {
+            ids.append(id);
+        }
+        return ids;
+    }
+
+    QRegularExpression re(QRegularExpression::wildcardToRegularExpression(pattern));
+    QReadLocker locker(&m_lock);
+    for (int id = 0; id < m_names.size(); ++id) {
+        if (re.match(m_names[id]).hasMatch()) {
+            ids.append(id);
+        }
+    }
+    return ids;
+}
+
+void StatKeyRegistry::accountMemory(MemoryAccounting &accounting) const
+{
+    QReadLocker locker(&m_lock);
+    // 哈希表的键与名称数组共享字符串数据，字符只计一次
+    qint64 characterBytes = 0;
+    for (const QString &name : m_names) {
+        characterBytes += MemoryAccounting::stringBytes(name) - qint64(sizeof(QString));
+    }
+    accounting.add(MemoryAccounting::STAT_KEYS, "names", m_names.size(),
+                   MemoryAccounting::vectorBytes(m_names) + characterBytes);
+    accounting.add(MemoryAccounting::STAT_KEYS, "QHash<QString, int>", m_ids.size(),
+                   MemoryAccounting::hashBytes(m_ids));
+}
@@ -0,0 +1,41 @@
+#ifndef STATKEYREGISTRY_H
+#define STATKEYREGISTRY_H
+
+#include <QString>
+#include <QHash>
+#include <QVector>
+#include <QReadWriteLock>
+
+class MemoryAccounting;
+
+// 统计项名称驻留表：把统计项名称映射为稠密的整数ID，
+// 供索引、分析等模块用整数而非字符串访问统计数据
+// 可在多个线程中同时使用（如实时数据接收线程）
+class StatKeyRegistry
+{
+public:
+    static StatKeyRegistry& instance();
+
+    // 获取名称对应的ID，不存在时分配新ID
+    int intern(const QString &key);
+    // 查找名称对应的ID，不存在时返回-1
+    int find(const QString &key) const;
+    // 获取ID对应的名称
+    QString name(int id) const;
+    // 已驻留的名称数量
+    int count() const;
+    // 获取匹配通配符模式（如 edge_*_busy_rate）的所有ID
+    QVector<int> match(const QString &pattern) const;
+    // 上报名称表占用的内存
+    void accountMemory(MemoryAccounting &accounting) const;
+
+private:
+    StatKeyRegistry() = default;
+    Q_DISABLE_COPY(StatKeyRegistry)
+
+    mutable QReadWriteLock m_lock;
+    QHash<QString, int> m_ids;
+    QVector<QString> m_names;
+};
+
+#endif // STATKEYREGISTRY_H
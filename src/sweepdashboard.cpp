@@ -0,0 +1,491 @@
+#include "sweepdashboard.h"
+#include "sweeploader.h"
+#include <QVBoxLayout>
+#include <QHBoxLayout>
+#include <QFormLayout>
+#include <QComboBox>
+#include <QLineEdit>
+#include <QLabel>
+#include <QProgressBar>
+#include <QPushButton>
+#include <QFileDialog>
+#include <QPainter>
+#include <QHelpEvent>
+#include <QToolTip>
+#include <QRegularExpression>
+#include <QMap>
+#include <QtMath>
+#include <algorithm>
+
+namespace {
+
+const int kBinSize = 3;          // 散点分箱的像素边长
+const int kMaxTrendPoints = 256; // x 取值过多时不绘制均值折线
+
+// 取覆盖 [lo, hi] 的整齐刻度步长
+double niceStep(double range, int ticks)
+{
+    double raw = range / qMax(1, ticks);
+    double magnitude = qPow(10.0, qFloor(std::log10(raw)));
+    double residual = raw / magnitude;
+    if (residual > 5) return 10 * magnitude;
+    if (residual > 2) return 5 * magnitude;
+    if (residual > 1) return 2 * magnitude;
+    return magnitude;
+}
+
+// 按通配符筛选字典项；模式为空时返回空掩码，表示不过滤
+QVector<bool> dictionaryMask(const SweepTable &table, int column, const QString &pattern)
+{
+    QVector<bool> mask;
+    if (column < 0 || pattern.trimmed().isEmpty()) return mask;
+
+    QRegularExpression re(QRegularExpression::wildcardToRegularExpression(pattern.trimmed()),
+                          QRegularExpression::CaseInsensitiveOption);
+    const QStringList &dictionary = table.column(column).dictionary;
+    mask.resize(dictionary.size());
+    for (int i = 0; i < dictionary.size(); ++i) {
+        mask[i] = re.match(dictionary[i]).hasMatch();
+    }
+    return mask;
+}
+
+bool passes(const QVector<bool> &mask, const SweepTable::Column *column, int row)
+{
+    if (mask.isEmpty()) return true;
+    double value = column->values[row];
+    if (qIsNaN(value)) return false;
+    return mask[int(value)];
+}
+
+} // namespace
+
+SweepPlot::SweepPlot(QWidget *parent)
+    : QWidget(parent)
+    , m_binColumns(0)
+    , m_imageDirty(true)
+{
+    setMinimumSize(400, 300);
+}
+
+void SweepPlot::setData(const QVector<QPointF> &points, const QString &xLabel, const QString &yLabel)
+{
+    m_points = points;
+    m_xLabel = xLabel;
+    m_yLabel = yLabel;
+    m_trend.clear();
+    m_bounds = QRectF();
+
+    if (!m_points.isEmpty()) {
+        double xMin = m_points[0].x(), xMax = xMin, yMin = m_points[0].y(), yMax = yMin;
+        QMap<double, QPair<double, int>> byX;
+        for (const QPointF &point : m_points) {
+            xMin = qMin(xMin, point.x());
+            xMax = qMax(xMax, point.x());
+            yMin = qMin(yMin, point.y());
+            yMax = qMax(yMax, point.y());
+            if (byX.size() <= kMaxTrendPoints) {
+                auto &entry = byX[point.x()];
+                entry.first += point.y();
+                ++entry.second;
+            }
+        }
+        if (byX.size() > 1 && byX.size() <= kMaxTrendPoints) {
+            for (auto it = byX.begin(); it != byX.end(); ++it) {
+                m_trend.append(QPointF(it.key(), it.value().first / it.value().second));
+            }
+        }
+
+        // 退化区间向两侧扩展，避免除零
+        if (xMax <= xMin) { xMin -= 0.5; xMax += 0.5; }
+        if (yMax <= yMin) { yMin -= 0.5; yMax += 0.5; }
+        double xPad = (xMax - xMin) * 0.04, yPad = (yMax - yMin) * 0.04;
+        m_bounds = QRectF(QPointF(xMin - xPad, yMin - yPad), QPointF(xMax + xPad, yMax + yPad));
+    }
+
+    m_imageDirty = true;
+    update();
+}
+
+QRectF SweepPlot::plotArea() const
+{
+    return QRectF(rect()).adjusted(64, 12, -16, -40);
+}
+
+QPointF SweepPlot::toData(const QPointF &pos) const
+{
+    const QRectF area = plotArea();
+    return QPointF(m_bounds.left() + (pos.x() - area.left()) / area.width() * m_bounds.width(),
+                   m_bounds.top() + (area.bottom() - pos.y()) / area.height() * m_bounds.height());
+}
+
+void SweepPlot::resizeEvent(QResizeEvent *event)
+{
+    QWidget::resizeEvent(event);
+    m_imageDirty = true;
+}
+
+void SweepPlot::renderImage()
+{
+    m_imageDirty = false;
+    const QRectF area = plotArea();
+    m_binColumns = qMax(1, qCeil(area.width() / kBinSize));
+    const int binRows = qMax(1, qCeil(area.height() / kBinSize));
+    m_bins.fill(0, m_binColumns * binRows);
+    m_image = QImage(m_binColumns * kBinSize, binRows * kBinSize, QImage::Format_ARGB32_Premultiplied);
+    m_image.fill(Qt::transparent);
+    if (m_points.isEmpty()) return;
+
+    // 先计数再按密度上色，绘制开销与点数无关
+    int maxCount = 0;
+    for (const QPointF &point : m_points) {
+        int column = int((point.x() - m_bounds.left()) / m_bounds.width() * area.width()) / kBinSize;
+        int row = int((m_bounds.bottom() - point.y()) / m_bounds.height() * area.height()) / kBinSize;
+        column = qBound(0, column, m_binColumns - 1);
+        row = qBound(0, row, binRows - 1);
+        maxCount = qMax(maxCount, ++m_bins[row * m_binColumns + column]);
+    }
+
+    QPainter painter(&m_image);
+    const double logMax = std::log1p(double(maxCount));
+    for (int row = 0; row < binRows; ++row) {
+        for (int column = 0; column < m_binColumns; ++column) {
+            int count = m_bins[row * m_binColumns + column];
+            if (count == 0) continue;
+
+            double density = logMax > 0 ? std::log1p(double(count)) / logMax : 1.0;
+            QColor color = QColor::fromHsvF(0.6 - 0.6 * density, 0.85, 0.9);
+            painter.fillRect(column * kBinSize, row * kBinSize, kBinSize, kBinSize, color);
+        }
+    }
+}
+
+void SweepPlot::paintEvent(QPaintEvent *event)
+{
+    Q_UNUSED(event);
+
+    QPainter painter(this);
+    painter.fillRect(rect(), palette().color(QPalette::Base));
+    if (m_points.isEmpty()) {
+        painter.setPen(palette().color(QPalette::Text));
+        painter.drawText(rect(), Qt::AlignCenter, "没有符合条件的数据");
+        return;
+    }
+    if (m_imageDirty) {
+        renderImage();
+    }
+
+    const QRectF area = plotArea();
+    auto mapX = [&](double x) { return area.left() + (x - m_bounds.left()) / m_bounds.width() * area.width(); };
+    auto mapY = [&](double y) { return area.bottom() - (y - m_bounds.top()) / m_bounds.height() * area.height(); };
+
+    QPen gridPen(palette().color(QPalette::Mid), 1, Qt::DotLine);
+    double xStep = niceStep(m_bounds.width(), 8);
+    for (double x = qCeil(m_bounds.left() / xStep) * xStep; x <= m_bounds.right(); x += xStep) {
+        painter.setPen(gridPen);
+        painter.drawLine(QPointF(mapX(x), area.top()), QPointF(mapX(x), area.bottom()));
+        painter.setPen(palette().color(QPalette::Text));
+        painter.drawText(QRectF(mapX(x) - 40, area.bottom() + 2, 80, 16), Qt::AlignCenter, QString::number(x, 'g', 4));
+    }
+    double yStep = niceStep(m_bounds.height(), 6);
+    for (double y = qCeil(m_bounds.top() / yStep) * yStep; y <= m_bounds.bottom(); y += yStep) {
+        painter.setPen(gridPen);
+        painter.drawLine(QPointF(area.left(), mapY(y)), QPointF(area.right(), mapY(y)));
+        painter.setPen(palette().color(QPalette::Text));
+        painter.drawText(QRectF(0, mapY(y) - 8, area.left() - 4, 16), Qt::AlignRight | Qt::AlignVCenter, QString::number(y, 'g', 4));
+    }
+    painter.drawRect(area);
+    painter.drawText(QRectF(area.left(), area.bottom() + 18, area.width(), 18), Qt::AlignCenter, m_xLabel);
+    painter.save();
+    painter.translate(12, area.center().y());
+    painter.rotate(-90);
+    painter.drawText(QRectF(-area.height() / 2, -10, area.height(), 20), Qt::AlignCenter, m_yLabel);
+    painter.restore();
+
+    painter.drawImage(area.topLeft(), m_image);
+
+    if (m_trend.size() > 1) {
+        painter.setRenderHint(QPainter::Antialiasing);
+        QPolygonF polyline;
+        for (const QPointF &point : m_trend) {
+            polyline.append(QPointF(mapX(point.x()), mapY(point.y())));
+        }
+        painter.setPen(QPen(QColor(255, 140, 0), 2));
+        painter.drawPolyline(polyline);
+    }
+}
+
+bool SweepPlot::event(QEvent *event)
+{
+    if (event->type() == QEvent::ToolTip) {
+        auto helpEvent = static_cast<QHelpEvent*>(event);
+        const QRectF area = plotArea();
+        if (!m_points.isEmpty() && area.contains(helpEvent->pos()) && !m_bins.isEmpty()) {
+            int column = int(helpEvent->pos().x() - area.left()) / kBinSize;
+            int row = int(helpEvent->pos().y() - area.top()) / kBinSize;
+            int index = row * m_binColumns + column;
+            if (column < m_binColumns && index < m_bins.size()) {
+                QPointF value = toData(helpEvent->pos());
+                QToolTip::showText(helpEvent->globalPos(),
+                    QString("%1: %2\n%3: %4\n%5 个点")
+                        .arg(m_xLabel).arg(value.x(), 0, 'g', 5)
+                        .arg(m_yLabel).arg(value.y(), 0, 'g', 5)
+                        .arg(m_bins[index]), this);
+                return true;
+            }
+        }
+        QToolTip::hideText();
+        event->ignore();
+        return true;
+    }
+    return QWidget::event(event);
+}
+
+SweepDashboard::SweepDashboard(QWidget *parent)
+    : QWidget(parent, Qt::Window)
+    , m_loader(new SweepLoader(&m_table, this))
+    , m_knownColumns(-1)
+{
+    setWindowTitle("参数扫描");
+    resize(1000, 700);
+
+    m_openButton = new QPushButton("打开运行目录...", this);
+    m_progressBar = new QProgressBar(this);
+    m_progressBar->setRange(0, 1);
+    m_progressBar->setValue(0);
+    m_statusLabel = new QLabel("未加载", this);
+
+    m_xCombo = new QComboBox(this);
+    m_yCombo = new QComboBox(this);
+    m_typeCombo = new QComboBox(this);
+    m_typeCombo->addItem("全部");
+    m_moduleFilter = new QLineEdit(this);
+    m_moduleFilter->setPlaceholderText("模块名通配符，如 L2Cache*");
+    m_runFilter = new QLineEdit(this);
+    m_runFilter->setPlaceholderText("运行名通配符");
+    m_aggregationCombo = new QComboBox(this);
+    m_aggregationCombo->addItem("无", NONE);
+    m_aggregationCombo->addItem("每次运行平均", RUN_MEAN);
+    m_aggregationCombo->addItem("每次运行求和", RUN_SUM);
+    for (QComboBox *combo : {m_xCombo, m_yCombo}) {
+        combo->setMinimumContentsLength(24);
+        combo->setSizeAdjustPolicy(QComboBox::AdjustToMinimumContentsLengthWithIcon);
+    }
+
+    m_plot = new SweepPlot(this);
+
+    QHBoxLayout *loadLayout = new QHBoxLayout;
+    loadLayout->addWidget(m_openButton);
+    loadLayout->addWidget(m_progressBar, 1);
+    loadLayout->addWidget(m_statusLabel);
+
+    QFormLayout *axisLayout = new QFormLayout;
+    axisLayout->addRow("X 轴：", m_xCombo);
+    axisLayout->addRow("Y 轴：", m_yCombo);
+    axisLayout->addRow("聚合：", m_aggregationCombo);
+    QFormLayout *filterLayout = new QFormLayout;
+    filterLayout->addRow("模块类型：", m_typeCombo);
+    filterLayout->addRow("模块：", m_moduleFilter);
+    filterLayout->addRow("运行：", m_runFilter);
+    QHBoxLayout *controlLayout = new QHBoxLayout;
+    controlLayout->addLayout(axisLayout, 1);
+    controlLayout->addLayout(filterLayout, 1);
+
+    QVBoxLayout *layout = new QVBoxLayout(this);
+    layout->addLayout(loadLayout);
+    layout->addLayout(controlLayout);
+    layout->addWidget(m_plot, 1);
+
+    m_replotTimer.setSingleShot(true);
+    m_replotTimer.setInterval(150);
+    connect(&m_replotTimer, &QTimer::timeout, this, &SweepDashboard::replot);
+
+    connect(m_openButton, &QPushButton::clicked, this, &SweepDashboard::chooseDirectory);
+    connect(m_loader, &SweepLoader::progress, this, &SweepDashboard::onProgress);
+    connect(m_loader, &SweepLoader::finished, this, &SweepDashboard::onFinished);
+    connect(m_xCombo, QOverload<int>::of(&QComboBox::currentIndexChanged), this, &SweepDashboard::scheduleReplot);
+    connect(m_yCombo, QOverload<int>::of(&QComboBox::currentIndexChanged), this, &SweepDashboard::scheduleReplot);
+    connect(m_typeCombo, QOverload<int>::of(&QComboBox::currentIndexChanged), this, &SweepDashboard::scheduleReplot);
+    connect(m_aggregationCombo, QOverload<int>::of(&QComboBox::currentIndexChanged), this, &SweepDashboard::scheduleReplot);
+    connect(m_moduleFilter, &QLineEdit::textChanged, this, &SweepDashboard::scheduleReplot);
+    connect(m_runFilter, &QLineEdit::textChanged, this, &SweepDashboard::scheduleReplot);
+}
+
+SweepDashboard::~SweepDashboard()
+{
+    // 先停止加载器，工作线程不再访问表
+    delete m_loader;
+}
+
+void SweepDashboard::chooseDirectory()
+{
+    QString directory = QFileDialog::getExistingDirectory(this, "选择运行目录");
+    if (!directory.isEmpty()) {
+        openDirectory(directory);
+    }
+}
+
+void SweepDashboard::openDirectory(const QString &directory)
+{
+    m_knownColumns = -1;
+    m_statusLabel->setText("正在加载: " + directory);
+    m_loader->start(directory);
+}
+
+void SweepDashboard::onProgress(int done, int total)
+{
+    m_progressBar->setRange(0, qMax(1, total));
+    m_progressBar->setValue(done);
+    // 加载过程中逐步显示已解析的运行
+    if (!m_replotTimer.isActive()) {
+        m_replotTimer.start(500);
+    }
+}
+
+void SweepDashboard::onFinished()
+{
+    m_replotTimer.stop();
+    replot();
+
+    QStringList errors = m_loader->errors();
+    if (!errors.isEmpty()) {
+        m_statusLabel->setToolTip(errors.join('\n'));
+    } else {
+        m_statusLabel->setToolTip(QString());
+    }
+}
+
+void SweepDashboard::scheduleReplot()
+{
+    m_replotTimer.start(150);
+}
+
+int SweepDashboard::selectedColumn(QComboBox *combo) const
+{
+    if (combo->currentIndex() < 0) return -1;
+    auto kind = SweepTable::ColumnKind(combo->currentData(Qt::UserRole).toInt());
+    return m_table.columnIndex(kind, combo->currentData(Qt::UserRole + 1).toString());
+}
+
+void SweepDashboard::fillColumnCombo(QComboBox *combo, const QVector<int> &columns)
+{
+    QString previous = combo->currentText();
+    QSignalBlocker blocker(combo);
+    combo->clear();
+    for (int index : columns) {
+        const SweepTable::Column &column = m_table.column(index);
+        QString label = column.kind == SweepTable::PARAMETER ? column.name + " (配置)" : column.name;
+        combo->addItem(label);
+        combo->setItemData(combo->count() - 1, int(column.kind), Qt::UserRole);
+        combo->setItemData(combo->count() - 1, column.name, Qt::UserRole + 1);
+    }
+    int restored = combo->findText(previous);
+    if (restored >= 0) {
+        combo->setCurrentIndex(restored);
+    }
+}
+
+void SweepDashboard::refreshColumns()
+{
+    // 调用方持有读锁；列只会追加，列数不变时无需重建选项
+    if (m_table.columnCount() != m_knownColumns) {
+        m_knownColumns = m_table.columnCount();
+
+        QVector<int> parameters, statistics;
+        for (int i = 0; i < m_table.columnCount(); ++i) {
+            const SweepTable::Column &column = m_table.column(i);
+            if (column.kind == SweepTable::PARAMETER) {
+                parameters.append(i);
+            } else if (column.kind == SweepTable::STATISTIC) {
+                statistics.append(i);
+            }
+        }
+        auto byName = [this](int a, int b) { return m_table.column(a).name < m_table.column(b).name; };
+        std::sort(parameters.begin(), parameters.end(), byName);
+        std::sort(statistics.begin(), statistics.end(), byName);
+
+        // X 轴优先列出配置参数，Y 轴优先列出统计项
+        bool xWasEmpty = m_xCombo->count() == 0;
+        bool yWasEmpty = m_yCombo->count() == 0;
+        fillColumnCombo(m_xCombo, parameters + statistics);
+        fillColumnCombo(m_yCombo, statistics + parameters);
+        if (xWasEmpty) m_xCombo->setCurrentIndex(0);
+        if (yWasEmpty) m_yCombo->setCurrentIndex(0);
+    }
+
+    int typeColumn = m_table.columnIndex(SweepTable::CATEGORY, "type");
+    if (typeColumn >= 0 && m_typeCombo->count() - 1 != m_table.column(typeColumn).dictionary.size()) {
+        QString previous = m_typeCombo->currentText();
+        QSignalBlocker blocker(m_typeCombo);
+        m_typeCombo->clear();
+        m_typeCombo->addItem("全部");
+        m_typeCombo->addItems(m_table.column(typeColumn).dictionary);
+        m_typeCombo->setCurrentIndex(qMax(0, m_typeCombo->findText(previous)));
+    }
+}
+
+void SweepDashboard::replot()
+{
+    QReadLocker locker(&m_table.lock());
+    refreshColumns();
+
+    const int runColumn = m_table.columnIndex(SweepTable::CATEGORY, "run");
+    const int moduleColumn = m_table.columnIndex(SweepTable::CATEGORY, "module");
+    const int typeColumn = m_table.columnIndex(SweepTable::CATEGORY, "type");
+    m_statusLabel->setText(QString("%1 次运行，%2 行，%3 列")
+        .arg(runColumn >= 0 ? m_table.column(runColumn).dictionary.size() : 0)
+        .arg(m_table.rowCount()).arg(m_table.columnCount()));
+
+    const int xColumn = selectedColumn(m_xCombo);
+    const int yColumn = selectedColumn(m_yCombo);
+    if (xColumn < 0 || yColumn < 0) {
+        m_plot->setData({}, QString(), QString());
+        return;
+    }
+
+    // 筛选条件先作用于字典，逐行只需查表
+    QVector<bool> typeMask;
+    if (typeColumn >= 0 && m_typeCombo->currentIndex() > 0) {
+        typeMask.fill(false, m_table.column(typeColumn).dictionary.size());
+        typeMask[m_typeCombo->currentIndex() - 1] = true;
+    }
+    QVector<bool> moduleMask = dictionaryMask(m_table, moduleColumn, m_moduleFilter->text());
+    QVector<bool> runMask = dictionaryMask(m_table, runColumn, m_runFilter->text());
+
+    const SweepTable::Column *types = typeColumn >= 0 ? &m_table.column(typeColumn) : nullptr;
+    const SweepTable::Column *modules = moduleColumn >= 0 ? &m_table.column(moduleColumn) : nullptr;
+    const SweepTable::Column *runNames = runColumn >= 0 ? &m_table.column(runColumn) : nullptr;
+    const double *xs = m_table.column(xColumn).values.constData();
+    const double *ys = m_table.column(yColumn).values.constData();
+    auto aggregation = Aggregation(m_aggregationCombo->currentData().toInt());
+    if (!runNames) {
+        aggregation = NONE;
+    }
+
+    QVector<QPointF> points;
+    struct RunAccumulator { double x = 0; double y = 0; int count = 0; };
+    QVector<RunAccumulator> perRun(aggregation == NONE ? 0 : runNames->dictionary.size());
+
+    for (int row = 0; row < m_table.rowCount(); ++row) {
+        if (qIsNaN(xs[row]) || qIsNaN(ys[row])) continue;
+        if (!passes(typeMask, types, row) || !passes(moduleMask, modules, row) || !passes(runMask, runNames, row)) {
+            continue;
+        }
+
+        if (aggregation == NONE) {
+            points.append(QPointF(xs[row], ys[row]));
+        } else if (!qIsNaN(runNames->values[row])) {
+            RunAccumulator &acc = perRun[int(runNames->values[row])];
+            acc.x += xs[row];
+            acc.y += ys[row];
+            ++acc.count;
+        }
+    }
+    for (const RunAccumulator &acc : perRun) {
+        if (acc.count == 0) continue;
+        double y = aggregation == RUN_SUM ? acc.y : acc.y / acc.count;
+        points.append(QPointF(acc.x / acc.count, y));
+    }
+
+    m_plot->setData(points, m_xCombo->currentText(), m_yCombo->currentText());
+}
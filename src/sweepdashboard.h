@@ -0,0 +1,98 @@
+#ifndef SWEEPDASHBOARD_H
+#define SWEEPDASHBOARD_H
+
+#include <QWidget>
+#include <QImage>
+#include <QVector>
+#include <QPointF>
+#include <QRectF>
+#include <QTimer>
+#include "sweeptable.h"
+
+class QComboBox;
+class QLineEdit;
+class QLabel;
+class QProgressBar;
+class QPushButton;
+class SweepLoader;
+
+// 散点图：点按像素分箱后绘制，百万级数据点仍可流畅重绘
+class SweepPlot : public QWidget
+{
+    Q_OBJECT
+
+public:
+    explicit SweepPlot(QWidget *parent = nullptr);
+
+    void setData(const QVector<QPointF> &points, const QString &xLabel, const QString &yLabel);
+
+protected:
+    void paintEvent(QPaintEvent *event) override;
+    void resizeEvent(QResizeEvent *event) override;
+    bool event(QEvent *event) override;
+
+private:
+    void renderImage();
+    QRectF plotArea() const;
+    QPointF toData(const QPointF &pos) const;
+
+    QVector<QPointF> m_points;
+    QVector<QPointF> m_trend;     // 每个 x 取值上 y 的平均值
+    QString m_xLabel;
+    QString m_yLabel;
+    QRectF m_bounds;
+    QImage m_image;               // 缓存的散点层
+    QVector<int> m_bins;          // 每个像素格中的点数，用于提示
+    int m_binColumns;
+    bool m_imageDirty;
+};
+
+// 参数扫描面板：加载一个目录下的所有运行，按任意参数绘制任意统计项并筛选
+class SweepDashboard : public QWidget
+{
+    Q_OBJECT
+
+public:
+    enum Aggregation {
+        NONE,       // 每个模块一个点
+        RUN_MEAN,   // 每次运行取平均
+        RUN_SUM     // 每次运行求和
+    };
+
+    explicit SweepDashboard(QWidget *parent = nullptr);
+    ~SweepDashboard();
+
+    void openDirectory(const QString &directory);
+
+private slots:
+    void chooseDirectory();
+    void onProgress(int done, int total);
+    void onFinished();
+    void refreshColumns();
+    void scheduleReplot();
+    void replot();
+
+private:
+    // 组合框中保存列的类别与名称，表被清空重建后仍可解析
+    int selectedColumn(QComboBox *combo) const;
+    void fillColumnCombo(QComboBox *combo, const QVector<int> &columns);
+
+    SweepTable m_table;
+    SweepLoader *m_loader;
+
+    QPushButton *m_openButton;
+    QProgressBar *m_progressBar;
+    QLabel *m_statusLabel;
+    QComboBox *m_xCombo;
+    QComboBox *m_yCombo;
+    QComboBox *m_typeCombo;
+    QLineEdit *m_moduleFilter;
+    QLineEdit *m_runFilter;
+    QComboBox *m_aggregationCombo;
+    SweepPlot *m_plot;
+
+    QTimer m_replotTimer;         // 合并频繁的筛选与加载进度触发的重绘
+    int m_knownColumns;
+};
+
+#endif // SWEEPDASHBOARD_H
@@ -0,0 +1,168 @@
+#include "sweeploader.h"
+#include "workstealingpool.h"
+#include "setupparser.h"
+#include "statisticparser.h"
+#include <QDir>
+#include <QFileInfo>
+#include <QHash>
+#include <QThread>
+
+SweepLoader::SweepLoader(SweepTable *table, QObject *parent)
+    : QObject(parent)
+    , m_table(table)
+    , m_thread(nullptr)
+    , m_cancelled(false)
+    , m_running(false)
+    , m_done(0)
+{
+}
+
+SweepLoader::~SweepLoader()
+{
+    cancel();
+    if (m_thread) {
+        m_thread->wait();
+        delete m_thread;
+    }
+}
+
+QVector<SweepRun> SweepLoader::discoverRuns(const QString &directory)
+{
+    QVector<SweepRun> runs;
+    QDir dir(directory);
+
+    const QStringList subdirs = dir.entryList(QDir::Dirs | QDir::NoDotAndDotDot, QDir::Name);
+    for (const QString &subdir : subdirs) {
+        QDir runDir(dir.filePath(subdir));
+        if (runDir.exists("setup.txt") && runDir.exists("statistic.txt")) {
+            runs.append({subdir, runDir.filePath("setup.txt"), runDir.filePath("statistic.txt")});
+        }
+    }
+
+    const QStringList setups = dir.entryList({"*.setup.txt"}, QDir::Files, QDir::Name);
+    for (const QString &setup : setups) {
+        QString name = setup.left(setup.size() - int(qstrlen(".setup.txt")));
+        QString statistic = name + ".statistic.txt";
+        if (dir.exists(statistic)) {
+            runs.append({name, dir.filePath(setup), dir.filePath(statistic)});
+        }
+    }
+
+    return runs;
+}
+
+bool SweepLoader::loadRun(const SweepRun &run, SweepChunk &chunk, QString *error)
+{
+    QVector<ModuleSetup> setups;
+    QVector<ModuleStatistics> statistics;
+    if (!SetupParser::parseFile(run.setupFile, setups, error) ||
+        !StatisticParser::parseFile(run.statisticFile, statistics, error)) {
+        return false;
+    }
+
+    QHash<QString, const ModuleStatistics*> statsByModule;
+    for (const ModuleStatistics &stats : statistics) {
+        statsByModule.insert(stats.module, &stats);
+    }
+
+    // 总线连接集合作用于整次运行，便于按拓扑筛选
+    QStringList edgeSets;
+    for (const ModuleSetup &setup : setups) {
+        if (setup.type == HardwareModule::BUS) {
+            edgeSets.append(SetupParser::edgeSetText(setup));
+        }
+    }
+    const QString edgeSet = edgeSets.join(';');
+
+    for (const ModuleSetup &setup : setups) {
+        chunk.addRow();
+        chunk.setCategory("run", run.name);
+        chunk.setCategory("module", setup.name);
+        chunk.setCategory("type", SetupParser::typeName(setup.type));
+        chunk.setCategory("edge_set", edgeSet);
+
+        for (const auto &param : SetupParser::parameters(setup)) {
+            chunk.setParameter(param.first, param.second);
+        }
+
+        const ModuleStatistics *stats = statsByModule.value(setup.name);
+        if (!stats) continue;
+        for (const auto &value : stats->values) {
+            chunk.setStatistic(value.first, value.second);
+        }
+    }
+    return true;
+}
+
+void SweepLoader::start(const QString &directory)
+{
+    cancel();
+    if (m_thread) {
+        m_thread->wait();
+        delete m_thread;
+        m_thread = nullptr;
+    }
+
+    m_table->clear();
+    {
+        QMutexLocker locker(&m_errorMutex);
+        m_errors.clear();
+    }
+
+    QVector<SweepRun> runs = discoverRuns(directory);
+    if (runs.isEmpty()) {
+        QMutexLocker locker(&m_errorMutex);
+        m_errors.append("No runs found in: " + directory);
+        locker.unlock();
+        emit progress(0, 0);
+        emit finished();
+        return;
+    }
+
+    if (!m_pool) {
+        m_pool = std::make_unique<WorkStealingPool>();
+    }
+    m_cancelled = false;
+    m_running = true;
+    m_done = 0;
+    emit progress(0, runs.size());
+
+    // 在协调线程中提交并等待，界面线程不会阻塞
+    m_thread = QThread::create([this, runs]() { runAll(runs); });
+    m_thread->start();
+}
+
+void SweepLoader::cancel()
+{
+    m_cancelled = true;
+}
+
+QStringList SweepLoader::errors() const
+{
+    QMutexLocker locker(&m_errorMutex);
+    return m_errors;
+}
+
+void SweepLoader::runAll(QVector<SweepRun> runs)
+{
+    const int total = runs.size();
+    for (const SweepRun &run : runs) {
+        m_pool->submit([this, run, total]() {
+            if (!m_cancelled) {
+                SweepChunk chunk;
+                QString error;
+                if (loadRun(run, chunk, &error)) {
+                    m_table->append(chunk);
+                } else {
+                    QMutexLocker locker(&m_errorMutex);
+                    m_errors.append(run.name + ": " + error);
+                }
+            }
+            emit progress(++m_done, total);
+        });
+    }
+
+    m_pool->waitForDone();
+    m_running = false;
+    emit finished();
+}
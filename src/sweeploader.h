@@ -0,0 +1,62 @@
+#ifndef SWEEPLOADER_H
+#define SWEEPLOADER_H
+
+#include <QObject>
+#include <QString>
+#include <QStringList>
+#include <QVector>
+#include <QMutex>
+#include <atomic>
+#include <memory>
+#include "sweeptable.h"
+
+class WorkStealingPool;
+class QThread;
+
+// 一次模拟运行的输入文件
+struct SweepRun {
+    QString name;
+    QString setupFile;
+    QString statisticFile;
+};
+
+// 参数扫描加载器：在工作窃取线程池中并行解析目录下的所有运行，写入共享的列式表
+class SweepLoader : public QObject
+{
+    Q_OBJECT
+
+public:
+    explicit SweepLoader(SweepTable *table, QObject *parent = nullptr);
+    ~SweepLoader();
+
+    // 在目录中查找运行：含 setup.txt 与 statistic.txt 的子目录，
+    // 或同目录下成对的 <运行名>.setup.txt / <运行名>.statistic.txt
+    static QVector<SweepRun> discoverRuns(const QString &directory);
+    // 解析一次运行并生成每个模块一行的数据块，失败时返回 false
+    static bool loadRun(const SweepRun &run, SweepChunk &chunk, QString *error = nullptr);
+
+    // 清空表并开始加载目录，之前未完成的加载会被取消
+    void start(const QString &directory);
+    void cancel();
+    bool isRunning() const { return m_running; }
+    QStringList errors() const;
+
+signals:
+    // 以下信号可能从工作线程发出，跨线程连接时自动排队
+    void progress(int done, int total);
+    void finished();
+
+private:
+    void runAll(QVector<SweepRun> runs);
+
+    SweepTable *m_table;
+    std::unique_ptr<WorkStealingPool> m_pool;
+    QThread *m_thread;                 // 提交任务并等待完成的协调线程
+    std::atomic<bool> m_cancelled;
+    std::atomic<bool> m_running;
+    std::atomic<int> m_done;
+    mutable QMutex m_errorMutex;
+    QStringList m_errors;
+};
+
+#endif // SWEEPLOADER_H
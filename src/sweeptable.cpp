@@ -0,0 +1,133 @@
+#include "sweeptable.h"
+#include "statkeyregistry.h"
+#include <QtMath>
+#include <algorithm>
+
+namespace {
+
+QString columnKey(SweepTable::ColumnKind kind, const QString &name)
+{
+    return QString::number(int(kind)) + ':' + name;
+}
+
+} // namespace
+
+void SweepChunk::addRow()
+{
+    ++m_rows;
+}
+
+QVector<double>& SweepChunk::numericColumn(QVector<double> &column)
+{
+    // 新列或此前行没有值时以 NaN 补齐
+    while (column.size() < m_rows) {
+        column.append(qQNaN());
+    }
+    return column;
+}
+
+void SweepChunk::setCategory(const QString &column, const QString &value)
+{
+    if (m_rows == 0) return;
+
+    QVector<QString> &values = m_categories[column];
+    values.resize(m_rows);
+    values[m_rows - 1] = value;
+}
+
+void SweepChunk::setParameter(const QString &column, double value)
+{
+    if (m_rows == 0) return;
+    numericColumn(m_parameters[column])[m_rows - 1] = value;
+}
+
+void SweepChunk::setStatistic(int keyId, double value)
+{
+    if (m_rows == 0) return;
+    numericColumn(m_statistics[keyId])[m_rows - 1] = value;
+}
+
+SweepTable::SweepTable()
+    : m_rowCount(0)
+{
+}
+
+int SweepTable::columnIndex(ColumnKind kind, const QString &name) const
+{
+    return m_columnIndex.value(columnKey(kind, name), -1);
+}
+
+int SweepTable::ensureColumn(ColumnKind kind, const QString &name)
+{
+    QString key = columnKey(kind, name);
+    auto it = m_columnIndex.constFind(key);
+    if (it != m_columnIndex.constEnd()) return it.value();
+
+    Column column;
+    column.name = name;
+    column.kind = kind;
+    column.values.fill(qQNaN(), m_rowCount);
+    m_columns.append(column);
+    m_columnIndex.insert(key, m_columns.size() - 1);
+    return m_columns.size() - 1;
+}
+
+void SweepTable::append(const SweepChunk &chunk)
+{
+    if (chunk.m_rows == 0) return;
+
+    QWriteLocker locker(&m_lock);
+    const int begin = m_rowCount;
+    const int end = begin + chunk.m_rows;
+
+    auto copyNumeric = [&](int index, const QVector<double> &values) {
+        double *out = m_columns[index].values.data() + begin;
+        std::copy(values.begin(), values.end(), out);
+    };
+
+    // 先确定列，再统一扩展行数，最后逐列整段拷贝
+    QVector<QPair<int, const QVector<double>*>> numeric;
+    for (auto it = chunk.m_parameters.begin(); it != chunk.m_parameters.end(); ++it) {
+        numeric.append({ensureColumn(PARAMETER, it.key()), &it.value()});
+    }
+    const StatKeyRegistry &registry = StatKeyRegistry::instance();
+    for (auto it = chunk.m_statistics.begin(); it != chunk.m_statistics.end(); ++it) {
+        numeric.append({ensureColumn(STATISTIC, registry.name(it.key())), &it.value()});
+    }
+    QVector<QPair<int, const QVector<QString>*>> categories;
+    for (auto it = chunk.m_categories.begin(); it != chunk.m_categories.end(); ++it) {
+        categories.append({ensureColumn(CATEGORY, it.key()), &it.value()});
+    }
+
+    for (auto &column : m_columns) {
+        column.values.resize(end);
+        std::fill(column.values.begin() + begin, column.values.end(), qQNaN());
+    }
+    m_rowCount = end;
+
+    for (const auto &entry : numeric) {
+        copyNumeric(entry.first, *entry.second);
+    }
+    for (const auto &entry : categories) {
+        Column &column = m_columns[entry.first];
+        const QVector<QString> &values = *entry.second;
+        for (int i = 0; i < values.size(); ++i) {
+            if (values[i].isNull()) continue;
+
+            auto it = column.dictionaryIndex.constFind(values[i]);
+            if (it == column.dictionaryIndex.constEnd()) {
+                it = column.dictionaryIndex.insert(values[i], column.dictionary.size());
+                column.dictionary.append(values[i]);
+            }
+            column.values[begin + i] = it.value();
+        }
+    }
+}
+
+void SweepTable::clear()
+{
+    QWriteLocker locker(&m_lock);
+    m_columns.clear();
+    m_columnIndex.clear();
+    m_rowCount = 0;
+}
@@ -0,0 +1,76 @@
+#ifndef SWEEPTABLE_H
+#define SWEEPTABLE_H
+
+#include <QString>
+#include <QStringList>
+#include <QVector>
+#include <QHash>
+#include <QReadWriteLock>
+
+// 一次运行的解析结果：按列组织的若干行（每个模块一行），由工作线程独立构建
+class SweepChunk
+{
+public:
+    // 开始新的一行，之后的 set* 写入这一行
+    void addRow();
+    void setCategory(const QString &column, const QString &value);
+    void setParameter(const QString &column, double value);
+    void setStatistic(int keyId, double value);
+
+    int rowCount() const { return m_rows; }
+
+private:
+    friend class SweepTable;
+
+    QVector<double>& numericColumn(QVector<double> &column);
+
+    int m_rows = 0;
+    QHash<QString, QVector<QString>> m_categories;
+    QHash<QString, QVector<double>> m_parameters;
+    QHash<int, QVector<double>> m_statistics;  // 统计项驻留ID -> 列
+};
+
+// 参数扫描的列式表：每个运行的每个模块一行，每个配置参数或统计项一列
+// 缺失值为 NaN；字符串列（运行名、模块名等）以字典编码存储
+// 多个工作线程可同时追加，读取时需持有读锁
+class SweepTable
+{
+public:
+    enum ColumnKind {
+        CATEGORY,   // 字典编码的字符串列
+        PARAMETER,  // setup 中的配置参数
+        STATISTIC   // statistic 中的统计项
+    };
+
+    struct Column {
+        QString name;
+        ColumnKind kind;
+        QVector<double> values;     // 字符串列为字典下标
+        QStringList dictionary;     // 仅字符串列使用
+        QHash<QString, int> dictionaryIndex;
+    };
+
+    SweepTable();
+
+    // 追加一次运行的全部行（线程安全）
+    void append(const SweepChunk &chunk);
+    void clear();
+
+    // 以下访问需要在 lock() 的读锁内进行
+    QReadWriteLock& lock() const { return m_lock; }
+    int rowCount() const { return m_rowCount; }
+    int columnCount() const { return m_columns.size(); }
+    const Column& column(int index) const { return m_columns[index]; }
+    // 按类别与名称查找列，不存在时返回-1
+    int columnIndex(ColumnKind kind, const QString &name) const;
+
+private:
+    int ensureColumn(ColumnKind kind, const QString &name);
+
+    mutable QReadWriteLock m_lock;
+    QVector<Column> m_columns;
+    QHash<QString, int> m_columnIndex;  // 类别前缀 + 名称 -> 列下标
+    int m_rowCount;
+};
+
+#endif // SWEEPTABLE_H
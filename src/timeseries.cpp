@@ -0,0 +1,179 @@
+#include "timeseries.h"
+#include "memoryaccounting.h"
+#include <QtGlobal>
+#include <algorithm>
+#include <cmath>
+
+namespace {
+
+SeriesBucket sampleBucket(double time, double value)
+{
+    return {time, time, value, value, value, 1};
+}
+
+void mergeInto(SeriesBucket &bucket, const SeriesBucket &other)
+{
+    bucket.end = other.end;
+    bucket.min = qMin(bucket.min, other.min);
+    bucket.max = qMax(bucket.max, other.max);
+    bucket.sum += other.sum;
+    bucket.count += other.count;
+}
+
+} // namespace
+
+void TimeSeries::append(double time, double value)
+{
+    if (!m_times.isEmpty()) {
+        time = qMax(time, m_times.last());
+    }
+    m_times.append(time);
+    m_values.append(value);
+
+    // 新样本只落入各层的最后一个桶，或开启一个新桶
+    const qint64 index = m_times.size() - 1;
+    qint64 span = kFanout;
+    const SeriesBucket sample = sampleBucket(time, value);
+    for (auto &level : m_levels) {
+        if (index / span == level.size()) {
+            level.append(sample);
+        } else {
+            mergeInto(level.last(), sample);
+        }
+        span *= kFanout;
+    }
+
+    // 最高层超过 kFanout 个桶时再加一层，最高层始终不超过 kFanout 个桶
+    const int topCount = m_levels.isEmpty() ? m_times.size() : m_levels.last().size();
+    if (topCount > kFanout) {
+        buildLevel();
+    }
+}
+
+void TimeSeries::buildLevel()
+{
+    QVector<SeriesBucket> level;
+    if (m_levels.isEmpty()) {
+        level.reserve((m_times.size() + kFanout - 1) / kFanout);
+        for (int i = 0; i < m_times.size(); ++i) {
+            const SeriesBucket sample = sampleBucket(m_times[i], m_values[i]);
+            if (i % kFanout == 0) {
+                level.append(sample);
+            } else {
+                mergeInto(level.last(), sample);
+            }
+        }
+    } else {
+        const QVector<SeriesBucket> &lower = m_levels.last();
+        level.reserve((lower.size() + kFanout - 1) / kFanout);
+        for (int i = 0; i < lower.size(); ++i) {
+            if (i % kFanout == 0) {
+                level.append(lower[i]);
+            } else {
+                mergeInto(level.last(), lower[i]);
+            }
+        }
+    }
+    m_levels.append(level);
+}
+
+QVector<SeriesBucket> TimeSeries::query(double begin, double end, int maxBuckets, int *level) const
+{
+    QVector<SeriesBucket> result;
+    if (level) *level = 0;
+    if (m_times.isEmpty() || maxBuckets <= 0 || end < begin) return result;
+
+    qint64 first = std::lower_bound(m_times.begin(), m_times.end(), begin) - m_times.begin();
+    qint64 last = std::upper_bound(m_times.begin(), m_times.end(), end) - m_times.begin();
+    first = qMax<qint64>(0, first - 1);
+    last = qMin<qint64>(m_times.size() - 1, last);
+
+    // 从原始样本开始向上，直到桶数不超过 maxBuckets
+    int chosen = 0;
+    qint64 span = 1;
+    while (chosen < m_levels.size() && last / span - first / span + 1 > maxBuckets) {
+        ++chosen;
+        span *= kFanout;
+    }
+    if (level) *level = chosen;
+
+    const qint64 from = first / span;
+    const qint64 to = last / span;
+    result.reserve(int(to - from + 1));
+    if (chosen == 0) {
+        for (qint64 i = from; i <= to; ++i) {
+            result.append(sampleBucket(m_times[int(i)], m_values[int(i)]));
+        }
+    } else {
+        const QVector<SeriesBucket> &buckets = m_levels[chosen - 1];
+        for (qint64 i = from; i <= to; ++i) {
+            result.append(buckets[int(i)]);
+        }
+    }
+    return result;
+}
+
+QVector<QPointF> TimeSeries::lttb(const QVector<QPointF> &points, int threshold)
+{
+    const int count = points.size();
+    if (threshold < 3 || threshold >= count) return points;
+
+    QVector<QPointF> sampled;
+    sampled.reserve(threshold);
+    sampled.append(points.first());
+
+    // 首尾点之外的点均分到 threshold - 2 个桶
+    const double every = double(count - 2) / double(threshold - 2);
+    int selected = 0;
+    for (int bucket = 0; bucket < threshold - 2; ++bucket) {
+        // 下一个桶的平均点作为三角形的第三个顶点
+        int nextBegin = int(std::floor((bucket + 1) * every)) + 1;
+        int nextEnd = qMin(count, int(std::floor((bucket + 2) * every)) + 1);
+        if (bucket == threshold - 3) {
+            nextBegin = count - 1;
+            nextEnd = count;
+        }
+        double avgX = 0.0;
+        double avgY = 0.0;
+        for (int i = nextBegin; i < nextEnd; ++i) {
+            avgX += points[i].x();
+            avgY += points[i].y();
+        }
+        const int nextCount = qMax(1, nextEnd - nextBegin);
+        avgX /= nextCount;
+        avgY /= nextCount;
+
+        const int begin = int(std::floor(bucket * every)) + 1;
+        const int end = int(std::floor((bucket + 1) * every)) + 1;
+        const QPointF &a = points[selected];
+        double maxArea = -1.0;
+        int maxIndex = begin;
+        for (int i = begin; i < end; ++i) {
+            const double area = std::abs((a.x() - avgX) * (points[i].y() - a.y())
+                                         - (a.x() - points[i].x()) * (avgY - a.y()));
+            if (area > maxArea) {
+                maxArea = area;
+                maxIndex = i;
+            }
+        }
+        sampled.append(points[maxIndex]);
+        selected = maxIndex;
+    }
+
+    sampled.append(points.last());
+    return sampled;
+}
+
+void TimeSeries::accountMemory(MemoryAccounting &accounting) const
+{
+    accounting.add(MemoryAccounting::STATISTIC_HISTORY, "samples", m_times.size(),
+                   sizeof(TimeSeries) + MemoryAccounting::vectorBytes(m_times) + MemoryAccounting::vectorBytes(m_values)
+                   - 2 * qint64(sizeof(m_times)));
+    qint64 buckets = 0;
+    qint64 bytes = MemoryAccounting::vectorBytes(m_levels) - qint64(sizeof(m_levels));
+    for (const auto &level : m_levels) {
+        buckets += level.size();
+        bytes += MemoryAccounting::vectorBytes(level) - qint64(sizeof(level));
+    }
+    accounting.add(MemoryAccounting::STATISTIC_HISTORY, "pyramid buckets", buckets, bytes);
+}
@@ -0,0 +1,60 @@
+#ifndef TIMESERIES_H
+#define TIMESERIES_H
+
+#include <QVector>
+#include <QPointF>
+
+class MemoryAccounting;
+
+// 一个汇总桶：[begin, end] 时间范围内若干连续样本的最小、最大与平均值
+struct SeriesBucket {
+    double begin;
+    double end;
+    double min;
+    double max;
+    double sum;
+    int count;
+
+    double mean() const { return count > 0 ? sum / count : 0.0; }
+};
+
+// 统计项的时间序列：保存原始样本，并维护逐层按 kFanout 合并的最小/最大/平均值金字塔
+// 追加样本只更新各层的最后一个桶，查询时按可显示的点数选择层级，绘制代价与样本总数无关
+class TimeSeries
+{
+public:
+    static constexpr int kFanout = 4;  // 每个汇总桶合并下一层的桶数
+
+    // 时间不递减，早于最后一个样本的时间按最后时间记录
+    void append(double time, double value);
+
+    int size() const { return m_times.size(); }
+    bool isEmpty() const { return m_times.isEmpty(); }
+    double firstTime() const { return m_times.isEmpty() ? 0.0 : m_times.first(); }
+    double lastTime() const { return m_times.isEmpty() ? 0.0 : m_times.last(); }
+    double lastValue() const { return m_values.isEmpty() ? 0.0 : m_values.last(); }
+    // 第 index 个原始样本
+    double timeAt(int index) const { return m_times[index]; }
+    double valueAt(int index) const { return m_values[index]; }
+    // 原始样本算作第 0 层
+    int levelCount() const { return m_levels.size() + 1; }
+
+    // 返回覆盖 [begin, end] 的桶（两端各多取一个，使折线延伸到边缘），
+    // 选择桶数不超过 maxBuckets 的最细层级，level 返回所用层级
+    QVector<SeriesBucket> query(double begin, double end, int maxBuckets, int *level = nullptr) const;
+
+    // 最大三角形三桶（LTTB）降采样：保留首尾点，每个桶选出与相邻桶构成最大三角形的点
+    static QVector<QPointF> lttb(const QVector<QPointF> &points, int threshold);
+
+    // 上报原始样本与金字塔占用的内存
+    void accountMemory(MemoryAccounting &accounting) const;
+
+private:
+    void buildLevel();
+
+    QVector<double> m_times;
+    QVector<double> m_values;
+    QVector<QVector<SeriesBucket>> m_levels;  // m_levels[k] 的每个桶汇总 kFanout^(k+1) 个原始样本
+};
+
+#endif // TIMESERIES_H
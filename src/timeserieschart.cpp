@@ -0,0 +1,296 @@
+#include "timeserieschart.h"
+#include <QPainter>
+#include <QFontMetrics>
+#include <QWheelEvent>
+#include <QMouseEvent>
+#include <cmath>
+#include <limits>
+
+namespace {
+
+const int kMargin = 8;
+const int kAxisWidth = 64;
+const int kAxisHeight = 20;
+const int kLegendHeight = 18;
+const int kBucketsPerColumn = 4;  // 每个像素列最多取用的汇总桶数
+const int kGridLines = 4;
+
+QString formatValue(double value)
+{
+    return std::abs(value) >= 1e5 || (value != 0.0 && std::abs(value) < 1e-2)
+        ? QString::number(value, 'g', 3)
+        : QString::number(value, 'f', std::abs(value) < 10 ? 2 : 0);
+}
+
+QString formatTime(double seconds)
+{
+    return seconds >= 120 ? QString("%1 min").arg(seconds / 60.0, 0, 'f', 1)
+                          : QString("%1 s").arg(seconds, 0, 'f', seconds < 10 ? 2 : 1);
+}
+
+} // namespace
+
+TimeSeriesChart::TimeSeriesChart(QWidget *parent)
+    : QWidget(parent)
+    , m_series(nullptr)
+    , m_color(30, 144, 255)
+    , m_follow(true)
+    , m_span(0.0)
+    , m_viewBegin(0.0)
+    , m_viewEnd(0.0)
+    , m_dragging(false)
+    , m_dragX(0.0)
+    , m_dragBegin(0.0)
+    , m_dragEnd(0.0)
+{
+    setMinimumHeight(160);
+}
+
+void TimeSeriesChart::setSeries(const TimeSeries* series, const QString &label)
+{
+    m_series = series;
+    m_label = label;
+    m_dragging = false;
+    resetView();
+}
+
+void TimeSeriesChart::seriesUpdated()
+{
+    // 不跟随时视窗固定，新样本只影响视窗外的部分
+    if (m_follow) {
+        update();
+    }
+}
+
+void TimeSeriesChart::resetView()
+{
+    m_follow = true;
+    m_span = 0.0;
+    update();
+}
+
+QSize TimeSeriesChart::sizeHint() const
+{
+    return QSize(480, 240);
+}
+
+QRectF TimeSeriesChart::plotRect() const
+{
+    return QRectF(kAxisWidth, kMargin + kLegendHeight,
+                  qMax(10, width() - kAxisWidth - kMargin),
+                  qMax(10, height() - kMargin * 2 - kLegendHeight - kAxisHeight));
+}
+
+void TimeSeriesChart::viewRange(double &begin, double &end) const
+{
+    if (!m_series || m_series->isEmpty()) {
+        begin = 0.0;
+        end = 1.0;
+        return;
+    }
+    if (m_follow) {
+        end = m_series->lastTime();
+        begin = m_span > 0.0 ? end - m_span : m_series->firstTime();
+    } else {
+        begin = m_viewBegin;
+        end = m_viewEnd;
+    }
+    if (end - begin < 1e-6) {
+        begin = end - 1.0;
+    }
+}
+
+void TimeSeriesChart::setView(double begin, double end)
+{
+    if (!m_series || m_series->isEmpty()) return;
+
+    // 视窗右端越过最新样本时转为跟随，左端也越过首个样本时显示全部范围
+    if (end >= m_series->lastTime()) {
+        m_follow = true;
+        m_span = begin <= m_series->firstTime() ? 0.0 : end - begin;
+    } else {
+        m_follow = false;
+        m_viewBegin = begin;
+        m_viewEnd = end;
+    }
+    update();
+}
+
+void TimeSeriesChart::paintEvent(QPaintEvent *event)
+{
+    Q_UNUSED(event);
+
+    QPainter painter(this);
+    painter.fillRect(rect(), palette().color(QPalette::Base));
+    painter.setPen(palette().color(QPalette::Text));
+
+    if (!m_series || m_series->isEmpty()) {
+        painter.drawText(rect(), Qt::AlignCenter, "无历史数据");
+        return;
+    }
+
+    const QRectF plot = plotRect();
+    double begin, end;
+    viewRange(begin, end);
+
+    // 桶数受像素列数限制，与序列长度和缩放无关
+    const int columns = qMax(1, int(plot.width()));
+    int level = 0;
+    const QVector<SeriesBucket> buckets = m_series->query(begin, end, columns * kBucketsPerColumn, &level);
+
+    double low = std::numeric_limits<double>::infinity();
+    double high = -std::numeric_limits<double>::infinity();
+    for (const SeriesBucket &bucket : buckets) {
+        if (bucket.end < begin || bucket.begin > end) continue;
+        low = qMin(low, bucket.min);
+        high = qMax(high, bucket.max);
+    }
+    if (!std::isfinite(low)) {
+        // 视窗内没有样本时按两侧的桶确定范围
+        for (const SeriesBucket &bucket : buckets) {
+            low = qMin(low, bucket.min);
+            high = qMax(high, bucket.max);
+        }
+    }
+    if (high - low < 1e-12) {
+        const double pad = qMax(1.0, std::abs(low) * 0.1);
+        low -= pad;
+        high += pad;
+    } else {
+        const double pad = (high - low) * 0.05;
+        low -= pad;
+        high += pad;
+    }
+
+    auto mapX = [&](double time) {
+        return plot.left() + (time - begin) / (end - begin) * plot.width();
+    };
+    auto mapY = [&](double value) {
+        return plot.bottom() - (value - low) / (high - low) * plot.height();
+    };
+
+    // 坐标网格
+    QFontMetrics fm(font());
+    QColor gridColor = palette().color(QPalette::Mid);
+    gridColor.setAlpha(120);
+    for (int i = 0; i <= kGridLines; ++i) {
+        const double value = low + (high - low) * i / kGridLines;
+        const double y = mapY(value);
+        painter.setPen(gridColor);
+        painter.drawLine(QPointF(plot.left(), y), QPointF(plot.right(), y));
+        painter.setPen(palette().color(QPalette::Text));
+        painter.drawText(QRectF(0, y - 8, kAxisWidth - 4, 16), Qt::AlignRight | Qt::AlignVCenter, formatValue(value));
+    }
+    painter.drawText(QRectF(plot.left(), plot.bottom() + 2, plot.width() / 2, kAxisHeight - 2),
+                     Qt::AlignLeft | Qt::AlignTop, formatTime(begin));
+    painter.drawText(QRectF(plot.center().x(), plot.bottom() + 2, plot.width() / 2, kAxisHeight - 2),
+                     Qt::AlignRight | Qt::AlignTop, m_follow ? formatTime(end) + "（跟随）" : formatTime(end));
+
+    painter.save();
+    painter.setClipRect(plot);
+
+    // 每个像素列一条最小-最大竖线；桶在时间上不重叠，总工作量不超过列数加桶数
+    QVector<double> columnMin(columns, std::numeric_limits<double>::infinity());
+    QVector<double> columnMax(columns, -std::numeric_limits<double>::infinity());
+    for (const SeriesBucket &bucket : buckets) {
+        const int first = int(std::floor(mapX(bucket.begin) - plot.left()));
+        const int last = int(std::floor(mapX(bucket.end) - plot.left()));
+        if (last < 0 || first >= columns) continue;
+        for (int c = qMax(0, first); c <= qMin(columns - 1, last); ++c) {
+            columnMin[c] = qMin(columnMin[c], bucket.min);
+            columnMax[c] = qMax(columnMax[c], bucket.max);
+        }
+    }
+    QColor envelopeColor = m_color;
+    envelopeColor.setAlpha(90);
+    painter.setPen(QPen(envelopeColor, 1.0));
+    for (int c = 0; c < columns; ++c) {
+        if (columnMin[c] > columnMax[c]) continue;
+        const double x = plot.left() + c + 0.5;
+        painter.drawLine(QPointF(x, mapY(columnMin[c])), QPointF(x, mapY(columnMax[c]) - 0.5));
+    }
+
+    // 平均值折线：桶中点经 LTTB 降到每列一个点
+    QVector<QPointF> points;
+    points.reserve(buckets.size());
+    for (const SeriesBucket &bucket : buckets) {
+        points.append(QPointF(mapX((bucket.begin + bucket.end) / 2.0), mapY(bucket.mean())));
+    }
+    points = TimeSeries::lttb(points, columns);
+    painter.setRenderHint(QPainter::Antialiasing);
+    painter.setPen(QPen(m_color, 1.5));
+    if (points.size() == 1) {
+        painter.drawEllipse(points.first(), 2.0, 2.0);
+    } else {
+        painter.drawPolyline(points.constData(), points.size());
+    }
+    painter.restore();
+
+    const QString legend = QString("%1  n=%2  最新 %3  第 %4 层  %5 点")
+                               .arg(m_label)
+                               .arg(m_series->size())
+                               .arg(formatValue(m_series->lastValue()))
+                               .arg(level)
+                               .arg(points.size());
+    painter.fillRect(QRectF(kAxisWidth, kMargin + 4, 10, 10), m_color);
+    painter.setPen(palette().color(QPalette::Text));
+    painter.drawText(QRectF(kAxisWidth + 14, kMargin, plot.width() - 14, kLegendHeight), Qt::AlignLeft | Qt::AlignVCenter,
+                     fm.elidedText(legend, Qt::ElideMiddle, int(plot.width()) - 14));
+}
+
+void TimeSeriesChart::wheelEvent(QWheelEvent *event)
+{
+    if (!m_series || m_series->isEmpty() || event->angleDelta().y() == 0) {
+        event->ignore();
+        return;
+    }
+
+    // 以光标所在时间为中心缩放
+    const QRectF plot = plotRect();
+    double begin, end;
+    viewRange(begin, end);
+    const double ratio = qBound(0.0, (event->position().x() - plot.left()) / plot.width(), 1.0);
+    const double anchor = begin + (end - begin) * ratio;
+    const double factor = event->angleDelta().y() > 0 ? 0.8 : 1.25;
+    const double span = qMax(1e-6, (end - begin) * factor);
+    setView(anchor - span * ratio, anchor + span * (1.0 - ratio));
+    event->accept();
+}
+
+void TimeSeriesChart::mousePressEvent(QMouseEvent *event)
+{
+    if (event->button() != Qt::LeftButton) {
+        QWidget::mousePressEvent(event);
+        return;
+    }
+    m_dragging = true;
+    m_dragX = event->position().x();
+    viewRange(m_dragBegin, m_dragEnd);
+    setCursor(Qt::ClosedHandCursor);
+}
+
+void TimeSeriesChart::mouseMoveEvent(QMouseEvent *event)
+{
+    if (!m_dragging) {
+        QWidget::mouseMoveEvent(event);
+        return;
+    }
+    const double shift = (event->position().x() - m_dragX) / plotRect().width() * (m_dragEnd - m_dragBegin);
+    setView(m_dragBegin - shift, m_dragEnd - shift);
+}
+
+void TimeSeriesChart::mouseReleaseEvent(QMouseEvent *event)
+{
+    if (event->button() == Qt::LeftButton && m_dragging) {
+        m_dragging = false;
+        unsetCursor();
+        return;
+    }
+    QWidget::mouseReleaseEvent(event);
+}
+
+void TimeSeriesChart::mouseDoubleClickEvent(QMouseEvent *event)
+{
+    Q_UNUSED(event);
+    resetView();
+}
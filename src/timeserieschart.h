@@ -0,0 +1,55 @@
+#ifndef TIMESERIESCHART_H
+#define TIMESERIESCHART_H
+
+#include <QWidget>
+#include <QString>
+#include <QColor>
+#include "timeseries.h"
+
+// 时间序列图：每个像素列绘制一条最小-最大竖线，平均值折线经 LTTB 降到每列一个点
+// 滚轮缩放、拖动平移、双击恢复全部范围；视窗右端位于最新样本时跟随新数据滚动
+class TimeSeriesChart : public QWidget
+{
+    Q_OBJECT
+
+public:
+    explicit TimeSeriesChart(QWidget *parent = nullptr);
+
+    // series 为空时清除，序列由调用方持有
+    void setSeries(const TimeSeries* series, const QString &label);
+    // 序列追加了样本
+    void seriesUpdated();
+    void resetView();
+
+    QSize sizeHint() const override;
+
+protected:
+    void paintEvent(QPaintEvent *event) override;
+    void wheelEvent(QWheelEvent *event) override;
+    void mousePressEvent(QMouseEvent *event) override;
+    void mouseMoveEvent(QMouseEvent *event) override;
+    void mouseReleaseEvent(QMouseEvent *event) override;
+    void mouseDoubleClickEvent(QMouseEvent *event) override;
+
+private:
+    QRectF plotRect() const;
+    // 当前视窗的时间范围
+    void viewRange(double &begin, double &end) const;
+    void setView(double begin, double end);
+
+    const TimeSeries* m_series;
+    QString m_label;
+    QColor m_color;
+
+    bool m_follow;       // 视窗右端跟随最新样本
+    double m_span;       // 跟随时的视窗宽度，0 表示全部范围
+    double m_viewBegin;  // 不跟随时的视窗
+    double m_viewEnd;
+
+    bool m_dragging;
+    double m_dragX;
+    double m_dragBegin;
+    double m_dragEnd;
+};
+
+#endif // TIMESERIESCHART_H
@@ -0,0 +1,121 @@
+#include "whatifpanel.h"
+#include <QVBoxLayout>
+#include <QHBoxLayout>
+#include <QHeaderView>
+#include <QtNumeric>
+#include <limits>
+
+namespace {
+
+// 按 UserRole 中的数值排序的表格项
+class NumericItem : public QTableWidgetItem
+{
+public:
+    NumericItem(const QString &text, double value)
+        : QTableWidgetItem(text)
+    {
+        setData(Qt::UserRole, value);
+        setTextAlignment(Qt::AlignRight | Qt::AlignVCenter);
+    }
+
+    bool operator<(const QTableWidgetItem &other) const override
+    {
+        return data(Qt::UserRole).toDouble() < other.data(Qt::UserRole).toDouble();
+    }
+};
+
+// 饱和或拓扑不可达时值为无穷大
+QString formatLatency(double value)
+{
+    return qIsFinite(value) ? QString::number(value, 'f', 2) : QString("饱和/不可达");
+}
+
+// 无穷大按最大值排序
+double sortKey(double value)
+{
+    return qIsFinite(value) ? value : std::numeric_limits<double>::max();
+}
+
+} // namespace
+
+WhatIfPanel::WhatIfPanel(LatencyModel* model, QWidget *parent)
+    : QDockWidget("What-if 延迟模型", parent)
+    , m_model(model)
+{
+    QWidget* content = new QWidget(this);
+    QVBoxLayout* layout = new QVBoxLayout(content);
+    layout->setContentsMargins(4, 4, 4, 4);
+
+    QHBoxLayout* headerLayout = new QHBoxLayout;
+    m_summary = new QLabel(content);
+    m_summary->setWordWrap(true);
+    m_resetButton = new QPushButton("撤销全部修改", content);
+    headerLayout->addWidget(m_summary, 1);
+    headerLayout->addWidget(m_resetButton);
+    layout->addLayout(headerLayout);
+
+    QLabel* hint = new QLabel("双击缓存、内存或总线模块，在模块信息对话框中修改 MSHR 数、索引宽度/延迟、数据位宽或总线连接", content);
+    hint->setWordWrap(true);
+    layout->addWidget(hint);
+
+    m_table = new QTableWidget(0, 5, content);
+    m_table->setHorizontalHeaderLabels({"Module", "Metric", "Baseline", "Predicted", "Change"});
+    m_table->horizontalHeader()->setSectionResizeMode(0, QHeaderView::Stretch);
+    m_table->verticalHeader()->setVisible(false);
+    m_table->setEditTriggers(QAbstractItemView::NoEditTriggers);
+    m_table->setSortingEnabled(true);
+    layout->addWidget(m_table);
+
+    setWidget(content);
+
+    connect(m_model, &LatencyModel::changed, this, &WhatIfPanel::refresh);
+    connect(m_resetButton, &QPushButton::clicked, this, [this]() {
+        m_model->resetParameters();
+    });
+    refresh();
+}
+
+void WhatIfPanel::refresh()
+{
+    const auto &nodes = m_model->nodes();
+
+    m_table->setSortingEnabled(false);
+    m_table->setRowCount(nodes.size());
+    for (int row = 0; row < nodes.size(); ++row) {
+        const LatencyModel::Node &node = nodes[row];
+        const bool changed = node.predicted != node.baseline;
+        const double delta = node.predicted - node.baseline;
+
+        QVector<QTableWidgetItem*> items = {
+            new QTableWidgetItem(node.module ? node.module->name() : QString("System")),
+            new QTableWidgetItem(LatencyModel::kindName(node.kind)),
+            new NumericItem(formatLatency(node.baseline), sortKey(node.baseline)),
+            new NumericItem(formatLatency(node.predicted), sortKey(node.predicted)),
+            new NumericItem(!changed ? QString("-")
+                            : qIsFinite(delta) ? QString("%1%2").arg(delta > 0 ? "+" : "").arg(delta, 0, 'f', 2)
+                                               : QString("∞"),
+                            sortKey(changed ? delta : 0.0)),
+        };
+        for (int column = 0; column < items.size(); ++column) {
+            if (changed) {
+                QFont font = items[column]->font();
+                font.setBold(true);
+                items[column]->setFont(font);
+            }
+            m_table->setItem(row, column, items[column]);
+        }
+    }
+    m_table->setSortingEnabled(true);
+
+    m_resetButton->setEnabled(m_model->hasOverrides());
+    if (m_model->systemNode() < 0) {
+        m_summary->setText("没有可建模的处理器核心");
+        return;
+    }
+    const LatencyModel::Node &system = nodes[m_model->systemNode()];
+    m_summary->setText(QString("系统 AMAT %1 → %2；最近一次重新计算 %3 / %4 个节点")
+        .arg(formatLatency(system.baseline))
+        .arg(formatLatency(system.predicted))
+        .arg(m_model->lastEvaluatedCount())
+        .arg(nodes.size()));
+}
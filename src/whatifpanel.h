@@ -0,0 +1,28 @@
+#ifndef WHATIFPANEL_H
+#define WHATIFPANEL_H
+
+#include <QDockWidget>
+#include <QTableWidget>
+#include <QPushButton>
+#include <QLabel>
+#include "latencymodel.h"
+
+// What-if 延迟模型面板：列出各指标的基准值与修改参数后的预测值，参数在模块信息对话框中编辑
+class WhatIfPanel : public QDockWidget
+{
+    Q_OBJECT
+
+public:
+    explicit WhatIfPanel(LatencyModel* model, QWidget *parent = nullptr);
+
+private slots:
+    void refresh();
+
+private:
+    LatencyModel* m_model;
+    QLabel* m_summary;
+    QTableWidget* m_table;
+    QPushButton* m_resetButton;
+};
+
+#endif // WHATIFPANEL_H
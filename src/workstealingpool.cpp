@@ -0,0 +1,154 @@
+#include "workstealingpool.h"
+#include <algorithm>
+
+namespace {
+
+// 当前线程所属的线程池与队列下标，用于在任务中提交子任务
+thread_local const WorkStealingPool* t_pool = nullptr;
+thread_local int t_index = -1;
+
+} // namespace
+
+WorkStealingPool::WorkStealingPool(int threadCount)
+    : m_nextQueue(0)
+    , m_queued(0)
+    , m_pending(0)
+    , m_stopping(false)
+{
+    if (threadCount <= 0) {
+        threadCount = int(std::thread::hardware_concurrency());
+    }
+    threadCount = std::max(1, threadCount);
+
+    for (int i = 0; i < threadCount; ++i) {
+        m_queues.push_back(std::make_unique<Queue>());
+    }
+    for (int i = 0; i < threadCount; ++i) {
+        m_threads.emplace_back(&WorkStealingPool::run, this, i);
+    }
+}
+
+WorkStealingPool::~WorkStealingPool()
+{
+    {
+        std::lock_guard<std::mutex> lock(m_waitMutex);
+        m_stopping = true;
+    }
+    m_workAvailable.notify_all();
+    for (auto &thread : m_threads) {
+        thread.join();
+    }
+}
+
+void WorkStealingPool::submit(Task task)
+{
+    int index = t_pool == this ? t_index : int(m_nextQueue++ % m_queues.size());
+
+    ++m_pending;
+    {
+        std::lock_guard<std::mutex> lock(m_queues[index]->mutex);
+        m_queues[index]->tasks.push_back(std::move(task));
+    }
+    {
+        std::lock_guard<std::mutex> lock(m_waitMutex);
+        ++m_queued;
+    }
+    m_workAvailable.notify_one();
+}
+
+void WorkStealingPool::waitForDone()
+{
+    std::unique_lock<std::mutex> lock(m_waitMutex);
+    m_done.wait(lock, [this]() { return m_pending.load() == 0; });
+}
+
+void WorkStealingPool::parallelFor(int count, int grain, const std::function<void(int, int)> &body)
+{
+    if (count <= 0) return;
+    grain = std::max(1, grain);
+    const int chunks = (count + grain - 1) / grain;
+    if (chunks == 1) {
+        body(0, count);
+        return;
+    }
+
+    std::mutex mutex;
+    std::condition_variable done;
+    int remaining = chunks - 1;
+    for (int chunk = 1; chunk < chunks; ++chunk) {
+        submit([&, chunk]() {
+            body(chunk * grain, std::min(count, (chunk + 1) * grain));
+            std::lock_guard<std::mutex> lock(mutex);
+            if (--remaining == 0) {
+                done.notify_all();
+            }
+        });
+    }
+
+    body(0, grain);
+    std::unique_lock<std::mutex> lock(mutex);
+    done.wait(lock, [&remaining]() { return remaining == 0; });
+}
+
+WorkStealingPool& WorkStealingPool::shared()
+{
+    static WorkStealingPool pool;
+    return pool;
+}
+
+void WorkStealingPool::run(int index)
+{
+    t_pool = this;
+    t_index = index;
+
+    while (true) {
+        Task task;
+        if (popLocal(index, task) || steal(index, task)) {
+            task();
+            finishTask();
+            continue;
+        }
+
+        std::unique_lock<std::mutex> lock(m_waitMutex);
+        m_workAvailable.wait(lock, [this]() { return m_stopping || m_queued.load() > 0; });
+        if (m_stopping && m_queued.load() <= 0) {
+            return;
+        }
+    }
+}
+
+bool WorkStealingPool::popLocal(int index, Task &task)
+{
+    Queue &queue = *m_queues[index];
+    std::lock_guard<std::mutex> lock(queue.mutex);
+    if (queue.tasks.empty()) return false;
+
+    task = std::move(queue.tasks.back());
+    queue.tasks.pop_back();
+    --m_queued;
+    return true;
+}
+
+bool WorkStealingPool::steal(int index, Task &task)
+{
+    const int count = int(m_queues.size());
+    for (int offset = 1; offset < count; ++offset) {
+        Queue &queue = *m_queues[(index + offset) % count];
+        std::lock_guard<std::mutex> lock(queue.mutex);
+        if (queue.tasks.empty()) continue;
+
+        task = std::move(queue.tasks.front());
+        queue.tasks.pop_front();
+        --m_queued;
+        return true;
+    }
+    return false;
+}
+
+void WorkStealingPool::finishTask()
+{
+    if (--m_pending == 0) {
+        std::lock_guard<std::mutex> lock(m_waitMutex);
+        m_done.notify_all();
+    }
+}
@@ -0,0 +1,64 @@
+#ifndef WORKSTEALINGPOOL_H
+#define WORKSTEALINGPOOL_H
+
+#include <atomic>
+#include <condition_variable>
+#include <deque>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+// 工作窃取线程池：每个工作线程有自己的任务队列，
+// 从自己队列的尾部取任务，空闲时从其它线程队列的头部窃取任务
+// 任务大小差异很大时（如大小不一的运行目录）仍能保持各线程负载均衡
+class WorkStealingPool
+{
+public:
+    using Task = std::function<void()>;
+
+    // threadCount <= 0 时使用硬件线程数
+    explicit WorkStealingPool(int threadCount = 0);
+    ~WorkStealingPool();
+
+    WorkStealingPool(const WorkStealingPool &) = delete;
+    WorkStealingPool &operator=(const WorkStealingPool &) = delete;
+
+    // 提交任务；在工作线程中提交时放入当前线程的队列
+    void submit(Task task);
+    // 阻塞直到所有已提交的任务执行完毕
+    void waitForDone();
+    int threadCount() const { return int(m_threads.size()); }
+
+    // 将 [0, count) 按 grain 分块并行执行 body(begin, end)，调用线程也执行一块
+    // 只等待本次提交的分块，不受池中其它任务影响；不能在本池的工作线程中调用
+    void parallelFor(int count, int grain, const std::function<void(int, int)> &body);
+
+    // 界面中短小计算任务共用的线程池
+    static WorkStealingPool& shared();
+
+private:
+    struct Queue {
+        std::mutex mutex;
+        std::deque<Task> tasks;
+    };
+
+    void run(int index);
+    bool popLocal(int index, Task &task);
+    bool steal(int index, Task &task);
+    void finishTask();
+
+    std::vector<std::unique_ptr<Queue>> m_queues;
+    std::vector<std::thread> m_threads;
+    std::atomic<unsigned> m_nextQueue;
+    std::atomic<int> m_queued;   // 已入队但未被取走的任务数
+    std::atomic<int> m_pending;  // 已提交但未执行完的任务数
+
+    std::mutex m_waitMutex;
+    std::condition_variable m_workAvailable;
+    std::condition_variable m_done;
+    bool m_stopping;
+};
+
+#endif // WORKSTEALINGPOOL_H